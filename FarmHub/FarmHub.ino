@@ -1,10 +1,22 @@
+// Sestavení s mikrobenchmarky (FarmHubBench.h) – jen pro vývojovou desku
+// #define FARMHUB_BENCH
+
 #include <Arduino.h>
 #include "FarmHubWiFi.h"
 #include "FarmHubDisplay.h"
 #include "FarmHubConfig.h"
 #include "FarmHubData.h"
+#include "FarmHubIrrigation.h"
+#include "FarmHubLight.h"
+#include "FarmHubTime.h"
 #include "FarmHubWebServer.h"
 #include "FarmHubWebSocket.h"
+#include "FarmHubScheduler.h"
+#ifdef FARMHUB_BENCH
+#include "FarmHubBench.h"
+#endif
+
+void updateDisplayWithSensorData();
 
 void setup() {
   Serial.begin(115200);
@@ -12,77 +24,201 @@ void setup() {
 
   initFileSystem();
   loadUserConfig();
+  initDataStore();
+  initIrrigation();
+  loadLightWindows();
+
+#ifdef FARMHUB_BENCH
+  runBenchmarks();
+#endif
 
   initDisplay();
   displayInfo("Starting...", "");
 
-  // Nastartujeme AP
+  // Nastartujeme AP a hned webserver, websocket; domácí Wi-Fi a NTP
+  // doběhnou na pozadí (stav na displeji a na hlavní stránce)
   setupWifiAP(); 
-  bool wifiOK = connectToHomeWiFi(homeSsid, homePass);
-  if (wifiOK) {
-    displayInfo("WiFi OK", WiFi.localIP().toString());
-    setupTimeFromNTP();
-  } else {
-    displayInfo("WiFi fail", "AP only");
-  }
-
-  // Spustíme webserver, websocket
   startAsyncWebServer();
   startWebSocket();
+  homeWifiBegin(homeSsid, homePass);
+  startTimeSync();
+  Serial.printf("Hub ready after %lu ms\n", millis());
+
+  // Úlohy hlavní smyčky (sken Wi-Fi si plánuje startAsyncScan sám)
+  schedulerEvery("display", updateDisplayWithSensorData, 2000);
+  schedulerEvery("pumpCmd", pumpCommandLoop, 500);
+  schedulerEvery("irrigation", irrigationCheck, IRRIGATION_CHECK_MS);
+  schedulerEvery("rollup", rollupPersistLoop, 10000);
+  schedulerEvery("metrics", metricsRateTask, METRICS_RATE_PERIOD_MS);
 }
 
-void updateDisplayWithSensorData() {
-  static unsigned long lastUpdate = 0;
-  if (millis() - lastUpdate < 2000) {
-    return; // Aktualizuje jen každé 2s
+// ------------------------------------------------------------
+// Stránky displeje (střídají se po DISPLAY_PAGE_TICKS obnoveních):
+// přehled, uzly, čerpadla a upozornění (jen když nějaká jsou).
+// Font displeje nemá diakritiku, texty jsou proto bez ní.
+// ------------------------------------------------------------
+static const uint8_t  DISPLAY_PAGE_TICKS  = 3;      // 3 x 2 s na stránku
+static const uint32_t DISPLAY_STALE_S     = 900;    // senzor bez dat 15 min = upozornění
+static const uint32_t DISPLAY_LOW_HEAP    = 8192;
+
+enum DisplayPage : uint8_t {
+  PAGE_OVERVIEW,
+  PAGE_NODES,
+  PAGE_PUMPS,
+  PAGE_ALERTS,
+  PAGE_COUNT
+};
+
+// Stáří posledního měření v s (0xFFFFFFFF = žádné / neznámý čas);
+// now = hubNow(), před synchronizací se porovnávají prozatímní časy
+static uint32_t readingAge(const SensorReading *sr, uint32_t now) {
+  if (!sr || isProvisional(sr->timestamp) != isProvisional(now) || sr->timestamp > now) return 0xFFFFFFFF;
+  return now - sr->timestamp;
+}
+
+static void formatAge(uint32_t age, char *buf, size_t len) {
+  if (age == 0xFFFFFFFF)  snprintf(buf, len, "--");
+  else if (age < 120)     snprintf(buf, len, "%lus", (unsigned long)age);
+  else if (age < 7200)    snprintf(buf, len, "%lum", (unsigned long)(age / 60));
+  else                    snprintf(buf, len, "%luh", (unsigned long)(age / 3600));
+}
+
+static bool nodeOnline(uint8_t node) {
+  for (uint8_t i = 0; i < WS_MAX_PEERS; i++) {
+    if (g_wsPeers[i].clientId != 0 && g_wsPeers[i].node == node) return true;
   }
-  lastUpdate = millis();
-
-  // Najdeme poslední měření "soilDHTsensor" a "lightsensor"
-  SensorReading lastSoilDHT;
-  bool foundSoilDHT = false;
-  SensorReading lastLight;
-  bool foundLight   = false;
-
-  for (int i = dataBuffer.size() - 1; i >= 0; i--) {
-    const auto &d = dataBuffer[i];
-    if (!foundSoilDHT && d.sensorID == "soilDHTsensor") {
-      lastSoilDHT  = d;
-      foundSoilDHT = true;
-    }
-    if (!foundLight && d.sensorID == "lightsensor") {
-      lastLight  = d;
-      foundLight = true;
+  return false;
+}
+
+// Řádek upozornění, delší text se ořízne na šířku displeje
+static void alertPrintf(char *line, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(line, DISPLAY_COLS + 1, fmt, args);
+  va_end(args);
+}
+
+// Upozornění do lines[] (max. `max`), vrací počet
+static uint8_t collectAlerts(char lines[][DISPLAY_COLS + 1], uint8_t max) {
+  uint8_t  n   = 0;
+  uint32_t now = hubNow();
+  if (n < max && homeSsid.length() > 0 && WiFi.status() != WL_CONNECTED) {
+    alertPrintf(lines[n++], "Home WiFi down");
+  }
+  if (n < max && !g_timeSynced) {
+    alertPrintf(lines[n++], "Time not synced");
+  }
+  if (n < max && !g_logReady) {
+    alertPrintf(lines[n++], "Log not writable");
+  }
+  if (n < max && g_pumpStats.expired > 0) {
+    alertPrintf(lines[n++], "Pump no ack: %lu", (unsigned long)g_pumpStats.expired);
+  }
+  if (n < max && ESP.getFreeHeap() < DISPLAY_LOW_HEAP) {
+    alertPrintf(lines[n++], "Low heap: %lu B", (unsigned long)ESP.getFreeHeap());
+  }
+  for (uint8_t id = 0; id < g_sensorIdCount && n < max; id++) {
+    uint32_t age = readingAge(getLatestReading(id), now);
+    if (age != 0xFFFFFFFF && age > DISPLAY_STALE_S) {
+      alertPrintf(lines[n++], "Stale %.14s", sensorIdName(id));
     }
-    if (foundSoilDHT && foundLight) break;
   }
+  return n;
+}
 
-  float soilVal  = (foundSoilDHT ? lastSoilDHT.soilMoisture : 0.0f);
-  float tempVal  = (foundSoilDHT ? lastSoilDHT.temperature  : 0.0f);
-  float humVal   = (foundSoilDHT ? lastSoilDHT.humidity     : 0.0f);
-  float lightVal = (foundLight   ? lastLight.lightLevel     : 0.0f);
-
-  // IP domácí Wi-Fi, pokud je připojeno. Pokud ne, "AP only"
-  String wifiIP = (WiFi.status() == WL_CONNECTED) 
-                    ? WiFi.localIP().toString() 
-                    : "AP-only";
-
-  // Vypíšeme na OLED
-  displayStatus(
-    homeSsid,     // WiFi jméno
-    wifiIP,       // IP
-    autoWatering, // Režim (Auto/Manual)
-    soilVal,
-    lightVal,
-    tempVal,
-    humVal
-  );
+static void showOverview() {
+  const SensorReading *soil  = getLatestReading(SENSOR_SOIL_DHT);
+  const SensorReading *light = getLatestReading(SENSOR_LIGHT);
+
+  displayPrintf(0, "WiFi: %s", homeSsid.c_str());
+  if (WiFi.status() == WL_CONNECTED) {
+    displayPrintf(1, "IP:   %s", WiFi.localIP().toString().c_str());
+  } else if (g_homeWifi == HOME_WIFI_JOINING || g_homeWifi == HOME_WIFI_RECONNECTING) {
+    displaySetLine(1, "IP:   joining...");
+  } else {
+    displaySetLine(1, "IP:   AP-only");
+  }
+  displayPrintf(2, "Mode: %s", autoWatering ? "Auto" : "Manual");
+  displayPrintf(3, "Soil=%.1f%%", soil ? soil->soilMoisture : 0.0f);
+  displayPrintf(4, "Light=%.1flx", light ? light->lightLevel : 0.0f);
+  displayPrintf(5, "Temp=%.1fC Hum=%.1f%%",
+                soil ? soil->temperature : 0.0f, soil ? soil->humidity : 0.0f);
+  displaySetLine(6, g_timeSynced ? "Time: NTP" : "Time: waiting for NTP");
+  displaySetLine(7, "");
 }
 
-void loop() {
-  updateDisplayLoop();
-  checkAndIrrigate();
-  updateDisplayWithSensorData();
+static void showNodes() {
+  uint32_t now = hubNow();
+  char age[12];
+  displayPrintf(0, "Nodes   clients: %u", g_metrics.wsClients);
+
+  uint8_t line = 1;
+  for (uint8_t node = NODE_SOIL_DHT; node < NODE_COUNT; node++) {
+    uint8_t id = findSensorID(farmNodeName(node));
+    formatAge(id != SENSOR_ID_UNKNOWN ? readingAge(getLatestReading(id), now) : 0xFFFFFFFF,
+              age, sizeof(age));
+    displayPrintf(line++, "%-13.13s %-3s%4s", farmNodeName(node),
+                  nodeOnline(node) ? "on" : "--", age);
+  }
+  // Další senzory (zóny), které nejsou jednou z rolí výše
+  for (uint8_t id = 0; id < g_sensorIdCount && line < DISPLAY_LINES; id++) {
+    if (farmNodeFromName(sensorIdName(id)) != NODE_HUB) continue;
+    formatAge(readingAge(getLatestReading(id), now), age, sizeof(age));
+    displayPrintf(line++, "%-16.16s %4s", sensorIdName(id), age);
+  }
+  while (line < DISPLAY_LINES) displaySetLine(line++, "");
+}
+
+static void showPumps() {
+  static const char *const STATE[] = { "IDLE", "PUMP", "SOAK" };
+  displayPrintf(0, "Pumps   %s", autoWatering ? "auto" : "manual");
+
+  uint8_t line = 1;
+  for (uint8_t i = 0; i < g_zoneCount && line < DISPLAY_LINES - 2; i++) {
+    const IrrigationZone &z = g_zones[i];
+    const SensorReading *sr = getLatestReading(z.sensorId);
+    displayPrintf(line++, "Z%u P%u %-4s %3.0f/%2.0f%%", i, z.pump, STATE[z.state],
+                  sr ? sr->soilMoisture : 0.0f, zoneThreshold(z));
+  }
+  displayPrintf(line++, "Cmd %lu ack %lu exp %lu", (unsigned long)g_pumpStats.issued,
+                (unsigned long)g_pumpStats.acked, (unsigned long)g_pumpStats.expired);
+  displayPrintf(line++, "Done %lu last %.1fs", (unsigned long)g_pumpStats.completed,
+                g_pumpStats.lastRuntimeMs / 1000.0f);
+  while (line < DISPLAY_LINES) displaySetLine(line++, "");
+}
 
-  delay(50);
+static void showAlerts(char alerts[][DISPLAY_COLS + 1], uint8_t count) {
+  displayPrintf(0, "Alerts (%u)", count);
+  for (uint8_t line = 1; line < DISPLAY_LINES; line++) {
+    displaySetLine(line, line <= count ? alerts[line - 1] : "");
+  }
+}
+
+// Úloha plánovače, běží každé 2 s. Texty se přepočítají vždy, na displej
+// jde jen to, co se změnilo.
+void updateDisplayWithSensorData() {
+  static uint8_t page  = PAGE_OVERVIEW;
+  static uint8_t ticks = 0;
+
+  char    alerts[DISPLAY_LINES - 1][DISPLAY_COLS + 1];
+  uint8_t alertCount = collectAlerts(alerts, DISPLAY_LINES - 1);
+
+  if (++ticks >= DISPLAY_PAGE_TICKS) {
+    ticks = 0;
+    page  = (page + 1) % PAGE_COUNT;
+    if (page == PAGE_ALERTS && alertCount == 0) page = PAGE_OVERVIEW;
+  }
+
+  switch (page) {
+    case PAGE_NODES:  showNodes();                     break;
+    case PAGE_PUMPS:  showPumps();                     break;
+    case PAGE_ALERTS: showAlerts(alerts, alertCount);  break;
+    default:          showOverview();                  break;
+  }
+  displayFlush();
+}
+
+void loop() {
+  // Spustí úlohy na řadě a spí až do termínu další
+  schedulerLoop();
 }
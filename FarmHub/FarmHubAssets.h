@@ -0,0 +1,200 @@
+#ifndef FARM_HUB_ASSETS_H
+#define FARM_HUB_ASSETS_H
+
+// VYGENEROVÁNO skriptem tools/embed_assets.py z adresáře web/ – neupravovat ručně.
+
+#include <Arduino.h>
+
+// charts.js: 4715 B, gzip 2061 B
+#define ASSET_CHARTS_JS_ETAG "9cc38f702f85"
+static const uint8_t ASSET_CHARTS_JS[] PROGMEM = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0xad,0x58,0x49,0x6f,0xdc,0xc8,
+  0x15,0xbe,0xf7,0xaf,0x78,0x41,0x90,0x69,0x72,0xc4,0xa6,0xd8,0xad,0x25,0xb6,0x7a,
+  0x64,0x63,0x6c,0x6b,0xc6,0x4e,0x64,0xc4,0x90,0x04,0x4c,0x02,0xc3,0x07,0x8a,0xac,
+  0x6e,0x96,0x9a,0x4d,0x12,0x64,0xb1,0x17,0x79,0x04,0xe4,0x98,0x4b,0x4e,0x39,0x0d,
+  0xe6,0xa4,0x63,0x0e,0x46,0x72,0x0e,0xe0,0x1c,0xd2,0xd6,0x1f,0xc9,0x2f,0xc9,0xf7,
+  0xaa,0xb8,0x69,0xb1,0x31,0x87,0x34,0x0c,0xb1,0xea,0xd5,0xdb,0xeb,0x6d,0xe5,0xed,
+  0x6d,0xfa,0x3e,0xf7,0x27,0x6b,0xca,0xf2,0x94,0x0a,0x95,0x6f,0xae,0x93,0x59,0x49,
+  0xdb,0x41,0xe4,0xe7,0xaa,0xa0,0xff,0xfe,0xf9,0x6f,0x74,0x2e,0x2e,0x49,0xac,0x94,
+  0xc8,0x93,0xcd,0x87,0x20,0xa2,0x59,0x22,0xa3,0x74,0x21,0x12,0xb2,0x26,0x65,0x32,
+  0x2d,0x2f,0x04,0x49,0x5a,0xd0,0xb7,0x6f,0x28,0x17,0x37,0xff,0x96,0xf3,0xd2,0x76,
+  0x7b,0xdb,0xdb,0xf4,0xc2,0x57,0x3e,0x15,0x02,0x1c,0xfd,0xa8,0xbc,0xd8,0x7c,0xa0,
+  0x4b,0xda,0xf6,0x33,0xb9,0x5d,0x88,0x5c,0x8a,0x82,0x2e,0xfc,0x19,0xa4,0xc5,0x69,
+  0x99,0x05,0x82,0x7c,0xca,0x6e,0x7e,0x92,0x94,0x9e,0x27,0xcc,0x17,0xb8,0xa0,0x0b,
+  0xd3,0x8a,0x90,0x99,0x5d,0x40,0xda,0x79,0x1a,0xae,0x09,0x08,0x9f,0x7e,0xbe,0xb8,
+  0xb9,0x06,0x4e,0x02,0x69,0x94,0xa5,0x45,0x2c,0x42,0x26,0xb9,0x4c,0xcf,0x73,0xff,
+  0x12,0xd4,0x1f,0xdd,0x5e,0x0f,0x8a,0x05,0x4a,0xa6,0x09,0x4d,0xd2,0x7c,0xee,0xab,
+  0x33,0x39,0x17,0xdf,0xe5,0xe9,0xfc,0x54,0x04,0x69,0x12,0x16,0x96,0xc8,0xd2,0x20,
+  0xc2,0xc6,0xa1,0xa5,0x54,0x11,0x34,0x15,0x36,0xbd,0xef,0x11,0xe1,0xb4,0x50,0x14,
+  0x2a,0x3a,0x04,0xf7,0x25,0x9b,0x20,0x1a,0x5c,0xfa,0x9a,0x86,0x9e,0xe7,0xd9,0x63,
+  0x82,0x3e,0x0d,0x10,0xc6,0x2f,0xa0,0xed,0xac,0x4c,0xc2,0xcd,0x75,0x10,0x39,0x9a,
+  0x06,0x5a,0xa9,0x9b,0x9f,0xc4,0x39,0xbb,0x66,0x5e,0x34,0x7c,0x33,0x3f,0x04,0xe3,
+  0x5a,0x35,0x6b,0x01,0x99,0x70,0x99,0x2a,0xf3,0x84,0x4e,0x55,0x2e,0x93,0x29,0x40,
+  0x2e,0x90,0x4e,0x15,0x3c,0x6f,0x8d,0x1c,0xea,0x7b,0x7d,0x88,0xbb,0x1a,0x37,0x1c,
+  0xa2,0x39,0x18,0x00,0xc3,0x0a,0x95,0x3b,0x15,0xea,0x65,0x5a,0xe6,0x85,0x65,0xdb,
+  0xb4,0x45,0xfd,0x83,0x3e,0xfe,0xb6,0x47,0xaf,0x65,0x52,0x2a,0xc1,0x87,0x4c,0x5d,
+  0x49,0xa9,0x8d,0xa5,0xa7,0x64,0xb0,0xb4,0x81,0x9a,0xdc,0x65,0xf2,0x9a,0x36,0x4d,
+  0x54,0xa4,0xc1,0x43,0x73,0x46,0x7c,0x08,0xd9,0x07,0xf8,0x33,0xee,0x5d,0xf5,0xf8,
+  0x46,0x7e,0x07,0xaf,0xa7,0x61,0x19,0x44,0x9b,0x8f,0xf4,0xe9,0xaf,0x9b,0xeb,0x3c,
+  0x5d,0x60,0x35,0x45,0x20,0x51,0xe2,0x53,0xe0,0x27,0x0b,0xbf,0x28,0x0f,0x28,0xe4,
+  0x28,0x38,0xa4,0xb7,0xef,0x57,0x07,0xc6,0x69,0x54,0x38,0xb4,0x06,0xa3,0x14,0xe4,
+  0xca,0xbf,0x7a,0xd7,0x5e,0xd5,0xb1,0x4c,0xc4,0x73,0x0e,0x3a,0xcb,0x50,0x3b,0x94,
+  0x66,0xaa,0x30,0x17,0xa3,0x22,0x59,0xb8,0x06,0x0c,0x6e,0x66,0x31,0xae,0xe1,0x8c,
+  0x06,0x28,0x7f,0x1a,0x58,0x2d,0xf7,0x5d,0xeb,0xbc,0x42,0xc4,0x13,0x80,0xf8,0x98,
+  0x81,0x4b,0x99,0x84,0xe9,0xd2,0xf5,0xc3,0xf0,0x08,0x31,0xa7,0x8e,0x65,0xa1,0x44,
+  0x22,0x72,0xab,0x9f,0x8b,0x42,0x5e,0x8a,0xbe,0xd3,0xde,0x14,0x5f,0x14,0x53,0xbb,
+  0x65,0x16,0x6a,0x8f,0xe1,0x52,0x6c,0xed,0x88,0x46,0x67,0x17,0xc9,0xa3,0x52,0xb5,
+  0xce,0x44,0x85,0xd4,0xbd,0xe9,0x6e,0x70,0x05,0x95,0x0a,0x6e,0x63,0x64,0x0d,0x60,
+  0xfd,0x9d,0xda,0x61,0x8d,0x11,0xad,0xfe,0x61,0x96,0xe3,0xa0,0x52,0x3b,0x14,0x0b,
+  0x19,0x88,0x37,0x72,0x25,0xe2,0x13,0x1f,0x42,0xe8,0xc7,0x1f,0x69,0xd8,0xe2,0x2e,
+  0xd9,0x4b,0x6e,0x10,0x4b,0x58,0xf6,0x83,0x0c,0x15,0x02,0x33,0xea,0x80,0x5e,0x0a,
+  0x39,0x8d,0x94,0x46,0x77,0x97,0x7c,0xcc,0x8c,0x11,0xe0,0x10,0x61,0x80,0x91,0x46,
+  0x00,0x34,0xea,0x40,0x35,0xe7,0xa9,0x66,0x83,0x28,0x79,0x8e,0x28,0x41,0x51,0xb0,
+  0xfa,0xa3,0xb0,0xaf,0x83,0x6c,0xea,0x16,0x42,0x9d,0xe5,0x7e,0x52,0x70,0xd2,0x59,
+  0xa0,0x72,0xc8,0xd3,0xff,0x9a,0x65,0x85,0x17,0xc4,0xc2,0xcf,0x4f,0x44,0xa0,0x2c,
+  0x73,0xbe,0x84,0x76,0xd5,0xd1,0x04,0x5c,0x21,0xa1,0x3f,0x1c,0x66,0x2b,0x2a,0xc0,
+  0x6b,0xc0,0xf5,0x62,0xd2,0xaf,0x4e,0x65,0x1c,0x9f,0xaa,0x75,0xcc,0xde,0xed,0xff,
+  0x7a,0x67,0x67,0xa7,0x03,0x3f,0x63,0x65,0x52,0x37,0xf6,0xcf,0x45,0xec,0xd0,0xee,
+  0xbe,0x43,0xc3,0x11,0x98,0x36,0x8a,0x1f,0x83,0x66,0x77,0xd7,0xa1,0x13,0x7c,0x1f,
+  0x39,0x74,0x86,0xcf,0x08,0xb2,0x9f,0xf1,0x77,0xd4,0xda,0x97,0x2d,0xb5,0x2f,0x06,
+  0xc0,0x1f,0xd0,0x89,0x43,0x59,0xa4,0xbd,0x30,0x00,0xc1,0x80,0x9e,0x31,0x9e,0x9c,
+  0x90,0xf5,0x2b,0xbe,0x1a,0x37,0x16,0xc9,0x14,0xbe,0x83,0xeb,0x41,0xf5,0xcd,0x21,
+  0x79,0x7a,0x19,0xe9,0xa5,0xb9,0xf3,0x5b,0xca,0xf5,0x6f,0x3e,0x6e,0xae,0x51,0xab,
+  0xae,0xf5,0x25,0x23,0xc0,0x8e,0x39,0x65,0x97,0xb4,0x4d,0x23,0xf0,0x1e,0xed,0xb1,
+  0x52,0x5b,0x4c,0x0f,0x80,0x76,0x47,0x9d,0xb8,0xbc,0xbe,0x62,0x4b,0x62,0xa1,0x68,
+  0xe5,0x41,0x21,0x66,0xf0,0xd6,0x7b,0xe7,0xae,0x1c,0x5a,0x0d,0xeb,0x7d,0x57,0xa7,
+  0x01,0x0d,0x71,0x3a,0xae,0x68,0xd6,0x4c,0xf3,0x2a,0x99,0xc8,0x44,0xaa,0x35,0xf2,
+  0x8f,0x49,0x06,0xf5,0x9e,0x91,0x34,0x29,0xae,0xed,0xc8,0x0f,0x22,0xab,0x89,0xdb,
+  0xac,0x36,0x82,0x4d,0xce,0xdc,0x35,0x1d,0x1e,0xa2,0x30,0x96,0x71,0x6c,0x77,0x14,
+  0x6b,0x4f,0xbf,0x81,0x1c,0xdb,0xc8,0xc2,0xf6,0xf6,0xd9,0x13,0x08,0xb5,0x8d,0xe0,
+  0xea,0xec,0xca,0xae,0x9d,0x99,0xba,0x59,0xa0,0x38,0xc7,0x34,0xe9,0x6b,0x5f,0x45,
+  0xee,0x5c,0x26,0xd6,0xda,0x44,0x8c,0x21,0x32,0x50,0x7f,0x65,0xad,0x87,0x0e,0xd7,
+  0x61,0x4e,0xc1,0xfa,0x2e,0x00,0x63,0xfe,0x9e,0x5d,0xf1,0x18,0x1c,0x22,0x15,0x98,
+  0x6c,0x4b,0x2f,0x6a,0x3c,0x76,0x14,0xf4,0x5f,0x41,0x47,0xed,0x33,0x38,0x72,0xab,
+  0x9b,0x33,0xc5,0xaa,0x9b,0xb3,0xab,0x4e,0x75,0xe6,0x7b,0xb2,0x56,0xf0,0x29,0xd3,
+  0x6e,0x6b,0x4e,0x66,0xfd,0x35,0xae,0xef,0x56,0x81,0x2e,0xd6,0x5d,0x1e,0xeb,0x0e,
+  0x0f,0xbe,0x5a,0x56,0x74,0x40,0x6b,0xcd,0xc3,0x2c,0x0d,0x8f,0x48,0xf3,0x00,0x13,
+  0xd4,0xd5,0x3f,0x80,0x05,0xda,0x61,0x9a,0xc9,0x62,0xb6,0x26,0x6b,0x8f,0x36,0xff,
+  0x42,0x69,0xe5,0x06,0x87,0xb2,0x9a,0xa2,0x2f,0xfe,0x09,0xc1,0x8d,0x8a,0xeb,0x03,
+  0xaf,0x82,0xfc,0xd1,0x36,0xd9,0xa7,0xf2,0x74,0x26,0xda,0xf4,0x08,0xc3,0xb0,0x4a,
+  0x8f,0x18,0x55,0xea,0x87,0x2a,0xcd,0x87,0x06,0xc4,0xa9,0xfb,0x6d,0x2c,0xa7,0x09,
+  0xa3,0xe6,0x9c,0xec,0x1a,0x17,0x21,0x40,0x16,0x47,0x8c,0x04,0xdc,0x1b,0xe3,0x83,
+  0x58,0xde,0xc5,0x77,0x6b,0xab,0x8e,0x05,0x63,0xe8,0x02,0xe7,0x6b,0xaf,0xb5,0x49,
+  0x1b,0x22,0x61,0x18,0x32,0x8c,0x7d,0x50,0xac,0xd1,0xcc,0xc6,0x55,0x06,0x9c,0x8b,
+  0xa9,0x4c,0xde,0xf8,0xdc,0x54,0xc6,0xd8,0xce,0xd1,0xe4,0xcf,0x52,0xeb,0x18,0x98,
+  0x7a,0xcf,0xea,0xf1,0x5e,0x67,0x43,0x0d,0x34,0xd6,0x58,0x0d,0x8f,0x26,0x8b,0x16,
+  0xae,0x4a,0xbf,0x43,0xdd,0x0b,0x6b,0xc9,0x88,0xbb,0xa1,0x87,0x96,0x36,0x44,0x7f,
+  0xf2,0x6c,0x47,0x27,0xae,0xd6,0x62,0x8b,0x76,0x6d,0x93,0x3a,0xf7,0x2c,0x0e,0x50,
+  0x04,0x45,0xde,0xef,0x14,0xcc,0xba,0x35,0x1e,0x76,0xae,0xf7,0x09,0x3d,0xda,0xdf,
+  0xf5,0xbc,0xcf,0x3a,0x66,0xe7,0x33,0x8e,0xd1,0x91,0xd5,0x8d,0x12,0x76,0xcc,0xce,
+  0x3d,0x4b,0x1e,0x9e,0x4d,0x16,0x9d,0xa1,0xc4,0x69,0xb3,0xa1,0x49,0x80,0x62,0x05,
+  0xcf,0x9a,0xda,0x31,0xf2,0xec,0xa6,0x88,0x0c,0xcc,0x8e,0x33,0x7f,0xdf,0x6e,0x0a,
+  0x06,0x02,0xea,0xf7,0x98,0xac,0x16,0x33,0x1f,0x41,0x85,0x06,0x9d,0xc5,0x37,0x7f,
+  0x41,0x70,0x85,0x84,0x80,0xea,0xdd,0xbd,0x9a,0xaa,0x58,0x14,0x3c,0x7e,0x08,0x3d,
+  0xaa,0xf8,0x71,0x21,0xfe,0x2f,0xe5,0xa1,0xe2,0xc9,0xf9,0xd0,0xdc,0x37,0x0c,0xc9,
+  0xdc,0x15,0x74,0x46,0xac,0x80,0xda,0xe6,0x94,0x26,0x01,0x89,0x1a,0xa9,0x0a,0x92,
+  0x07,0x90,0x5a,0xfd,0x54,0x5e,0x0a,0x93,0xdf,0x57,0x75,0x07,0xba,0x9d,0x03,0xf9,
+  0xf4,0xdc,0xb7,0x78,0x78,0x49,0xdd,0x20,0x8d,0x71,0x85,0x98,0x66,0x50,0x3e,0xec,
+  0x07,0xf2,0x62,0xd4,0x65,0x60,0xd9,0x2d,0x82,0x51,0xe2,0x33,0x05,0xd6,0xae,0x6b,
+  0xf6,0xc3,0x04,0xde,0x03,0x28,0x41,0x8c,0x9c,0x6d,0x3d,0x7e,0xa7,0xa9,0x3d,0xac,
+  0xb1,0xe7,0x8e,0xec,0x4e,0xab,0x63,0x4a,0x2e,0x18,0x26,0xe2,0x4e,0x8f,0x4e,0x5e,
+  0x1d,0x9d,0xf2,0xb0,0x03,0x84,0xf7,0x24,0xc3,0x03,0xc4,0x37,0xcf,0x24,0xa7,0xa9,
+  0x8c,0x41,0x8c,0xd1,0x25,0x29,0xd2,0x1c,0xd0,0x02,0x80,0x17,0x2f,0xcf,0xcc,0x1e,
+  0x27,0xc0,0x4a,0x12,0x11,0x57,0x27,0x8c,0xaa,0xbb,0x27,0xf6,0x4c,0x4a,0xaf,0x53,
+  0xcc,0x44,0x65,0x2e,0xc8,0xfa,0x8d,0xcd,0xd8,0xac,0x0f,0xce,0x7e,0x8b,0x46,0x35,
+  0x7c,0x3c,0xd2,0x7f,0x00,0x46,0xed,0x3e,0xd0,0x37,0x41,0x57,0xce,0x1d,0x05,0xce,
+  0xc4,0x3c,0xfb,0x85,0x0a,0xa8,0x0a,0xb5,0x56,0x80,0x49,0x45,0xee,0x1b,0xf1,0xff,
+  0xf9,0xe7,0x73,0x56,0xa0,0xd1,0x60,0xb4,0x07,0x15,0x1e,0x3f,0x86,0x06,0x3b,0x8d,
+  0x06,0x3a,0x56,0xef,0xab,0xf0,0xb2,0x9c,0x33,0xe5,0x2f,0x51,0x21,0xaa,0x50,0x6b,
+  0x15,0x40,0x2a,0x43,0xf4,0xc7,0xca,0x7c,0x32,0x39,0x6e,0x34,0xd8,0x43,0x81,0x19,
+  0xee,0xc3,0x07,0xa3,0x9d,0xbd,0x2f,0xfb,0xe0,0x58,0xd7,0x56,0xa7,0x55,0x20,0x66,
+  0x40,0x23,0x9e,0x3a,0x0a,0xc4,0x15,0x6a,0xad,0x40,0x4d,0xda,0xfd,0xdd,0x72,0xc1,
+  0xc8,0xc3,0x94,0xf3,0x68,0xff,0x8e,0x0b,0x7a,0x98,0x79,0xdb,0xa9,0x7a,0xee,0xcf,
+  0xaa,0xa9,0xba,0x1a,0xa5,0x0b,0x8c,0x48,0x85,0x3a,0xd3,0x65,0x4c,0x6f,0xb5,0x9a,
+  0xd5,0x8b,0xa7,0x9d,0xc1,0xc3,0x34,0x28,0xe7,0xa8,0x92,0x3c,0xea,0x1d,0xc5,0x82,
+  0x97,0xcf,0xd6,0xaf,0x42,0xab,0x70,0x65,0xc8,0xe9,0x68,0x77,0x88,0xdb,0xb9,0xb8,
+  0x7a,0x1c,0xbc,0x48,0xd5,0xe6,0x3a,0x4a,0x84,0x79,0xb3,0xa1,0xdc,0x34,0xcf,0xb4,
+  0x28,0xa5,0x4b,0x4c,0x40,0xf3,0xcd,0xdf,0xa3,0x74,0x4c,0x98,0xb8,0xf9,0xa9,0x87,
+  0xc7,0x9f,0xc8,0x36,0x1f,0x6e,0xae,0x71,0xd7,0xe7,0x65,0x30,0x43,0x11,0x9a,0xa7,
+  0x51,0x8c,0xc7,0xd5,0xcd,0xb5,0xfa,0xf4,0x33,0xe5,0x37,0xff,0x28,0x94,0xdd,0xda,
+  0x94,0x8b,0x09,0x86,0x74,0xbc,0xbf,0xf8,0x25,0x69,0x61,0x68,0xc6,0xe8,0x9e,0xc1,
+  0x09,0xa9,0x4c,0xea,0x07,0xc3,0x44,0x28,0x94,0xaa,0x7e,0xe7,0xc5,0xf9,0xd4,0xf8,
+  0xfc,0x90,0x93,0xab,0x70,0xcd,0x86,0xb3,0xeb,0xab,0xea,0x02,0xaa,0x83,0x6a,0x47,
+  0x5b,0xbd,0xda,0xe5,0xfd,0xaf,0x98,0xbd,0x39,0xc6,0x42,0xd3,0x4c,0x50,0xb0,0x2b,
+  0x02,0xed,0x4d,0x5b,0x63,0xbb,0x2a,0x12,0x49,0x5b,0x1f,0xf3,0x4e,0xfb,0xcf,0xdd,
+  0x8b,0x82,0x5f,0x02,0xfc,0x72,0x78,0x08,0x37,0xac,0x6b,0x69,0x33,0xed,0x9b,0x77,
+  0x40,0xed,0xe1,0xfa,0x29,0xc0,0xbf,0x07,0x7a,0x11,0x85,0xae,0xaa,0x2a,0xd3,0xad,
+  0x9e,0xd4,0xf2,0x63,0x35,0xab,0x41,0xb1,0x2e,0x61,0x4f,0x3f,0x37,0x36,0x72,0x23,
+  0x1d,0x37,0xf4,0x5c,0xbf,0xc1,0xfe,0xad,0x7c,0x07,0x39,0xcc,0xc6,0x66,0x96,0x0a,
+  0x0f,0x4c,0xf1,0x20,0x12,0x77,0x01,0x83,0xd6,0xea,0x40,0x9f,0x11,0xc5,0xa3,0x42,
+  0xe8,0xfa,0x8b,0x29,0x08,0x5b,0x66,0x75,0x1b,0xb8,0x43,0xee,0x66,0x65,0x11,0x59,
+  0xef,0x09,0x4f,0x49,0x23,0x4a,0xbf,0x24,0x6b,0xf2,0xaa,0x07,0x54,0x1c,0x7a,0xb7,
+  0xbf,0xcb,0x48,0xa2,0xbe,0x5a,0x5d,0xf9,0x4f,0x9a,0x78,0xd1,0xd0,0x22,0x92,0x13,
+  0x65,0x35,0x2c,0xb4,0x3d,0x2d,0xb6,0xdd,0x49,0x9b,0x2f,0xcc,0xda,0xfc,0xbb,0x9f,
+  0x13,0x5a,0x91,0xea,0xd6,0x03,0x5f,0x75,0x5b,0x28,0x7c,0x54,0xbd,0x24,0x9b,0xe0,
+  0xd6,0xed,0x4d,0xe7,0x20,0x42,0xfb,0x5e,0x5c,0x9b,0x62,0xdf,0xf4,0xe2,0x26,0xbb,
+  0xed,0x76,0x94,0x51,0x32,0x98,0xdd,0x7f,0x7d,0xde,0x23,0x6d,0xce,0x0b,0x13,0xa6,
+  0x5f,0x4a,0xa9,0x71,0xe5,0x5c,0x3d,0xe9,0x32,0x7f,0x63,0x16,0xde,0x7b,0xaf,0x78,
+  0x8e,0x5a,0xf8,0xb1,0xc5,0xd0,0xce,0xb8,0x62,0xc8,0x77,0x3c,0x3d,0xfe,0x98,0xff,
+  0x37,0x81,0x95,0xff,0x03,0xbf,0x2d,0xdd,0xec,0x6b,0x12,0x00,0x00,
+};
+
+// style.css: 1460 B, gzip 621 B
+#define ASSET_STYLE_CSS_ETAG "506c39f522f3"
+static const uint8_t ASSET_STYLE_CSS[] PROGMEM = {
+  0x1f,0x8b,0x08,0x00,0x00,0x00,0x00,0x00,0x02,0x03,0x7d,0x54,0x5f,0x6f,0xdb,0x20,
+  0x10,0x7f,0xcf,0xa7,0xb0,0x34,0x4d,0xdd,0xa4,0xda,0xc2,0x4d,0x5a,0x35,0x58,0x7b,
+  0x98,0x26,0xed,0x4b,0x4c,0x7b,0x38,0x0c,0x8e,0x51,0x31,0x58,0x40,0x1a,0xa7,0x56,
+  0xbf,0xfb,0x0e,0x6c,0x37,0xb8,0x4d,0x27,0xa4,0x04,0x2e,0x77,0xc7,0xef,0xcf,0x11,
+  0x66,0xf8,0x79,0x6c,0x8c,0xf6,0x79,0x03,0x9d,0x54,0x67,0xea,0x40,0xbb,0xdc,0x09,
+  0x2b,0x9b,0xaa,0x03,0x7b,0x90,0x9a,0x92,0xaa,0x07,0xce,0xa5,0x3e,0xe0,0x8e,0x41,
+  0xfd,0x74,0xb0,0xe6,0xa8,0x39,0xfd,0xd2,0x90,0xb0,0xaa,0xd7,0x4d,0xa1,0xe1,0x99,
+  0x81,0x1d,0x7b,0xe3,0xa4,0x97,0x46,0xd3,0x46,0x0e,0x82,0x57,0xde,0xf4,0x58,0xa1,
+  0x44,0xe3,0xf1,0xeb,0x24,0xb9,0x6f,0x69,0x49,0xc8,0xd7,0x55,0x8f,0xdd,0xaf,0x9f,
+  0xbf,0xef,0x2f,0x17,0x94,0xa4,0x1f,0xb2,0x3b,0xfc,0xa8,0x98,0x19,0x72,0x27,0x5f,
+  0x42,0x90,0x19,0xcb,0x85,0xcd,0x31,0x52,0xbd,0xe4,0x52,0x73,0x31,0xd0,0xfd,0x7e,
+  0x7f,0xb9,0x37,0x83,0xb1,0x36,0xca,0x58,0x44,0xd4,0x34,0x95,0x17,0x83,0xcf,0xb9,
+  0xa8,0x8d,0x85,0x88,0x45,0x1b,0x2d,0x66,0x26,0xb9,0x95,0x87,0xd6,0xd3,0xd8,0x3f,
+  0x52,0x3e,0x89,0x18,0x60,0x46,0xf1,0x37,0x08,0x0f,0x88,0xa0,0xbc,0x8b,0x08,0xe2,
+  0xb5,0x16,0xb8,0x3c,0x3a,0xba,0xc3,0x88,0xb7,0xa8,0xcd,0xc4,0xf0,0xc2,0x21,0x23,
+  0xc5,0xd6,0xa5,0x60,0x68,0x6b,0x9e,0x85,0x1d,0x57,0x2c,0xef,0x81,0xec,0x22,0xe2,
+  0x1a,0xaf,0x05,0xa9,0xf1,0xf7,0x0e,0x86,0xfc,0x4d,0x94,0x80,0x68,0x56,0xfb,0x31,
+  0x48,0x00,0x47,0x6f,0xa2,0x0e,0x71,0xf7,0x86,0x6d,0x52,0x26,0xb5,0x00,0x09,0xaf,
+  0x71,0x3e,0x2e,0xda,0xb5,0xc0,0xcd,0x89,0x92,0x8c,0x64,0x81,0x91,0x3d,0x30,0xf8,
+  0x46,0x6e,0xe3,0x2a,0xca,0xef,0x08,0xa5,0x2d,0xc7,0x59,0x95,0xc9,0xa7,0x6c,0x3e,
+  0x31,0xe3,0xbd,0xe9,0x28,0x29,0xee,0x45,0x17,0xd2,0xb6,0x69,0x5a,0x59,0xdc,0x61,
+  0xf4,0x93,0xd4,0x7e,0x5c,0x06,0xa6,0x78,0x14,0x5d,0x86,0x2d,0x15,0x32,0xcd,0xdb,
+  0x49,0xe4,0xb2,0xd8,0x85,0x76,0x76,0x49,0x2a,0x43,0x55,0x48,0x9a,0xf0,0x4f,0x3e,
+  0xcd,0x87,0xe9,0x2e,0x84,0xed,0x8c,0x92,0x3c,0xfb,0xc2,0x39,0x0f,0xe2,0x31,0xaf,
+  0xc7,0x2b,0xc3,0x93,0x98,0xff,0x89,0x89,0x53,0xf3,0xfa,0x68,0x1d,0x26,0xf6,0x46,
+  0x6a,0x2f,0xec,0x15,0x7f,0xa7,0x2b,0xfe,0xeb,0x9f,0x07,0xa6,0x44,0x7e,0x71,0x31,
+  0x19,0xeb,0x50,0xd5,0x28,0x73,0xca,0x07,0x1a,0x4d,0x4b,0x65,0x23,0xb1,0x7b,0x2c,
+  0x1e,0xe7,0x7b,0x11,0xb5,0x82,0xde,0x09,0xba,0x6c,0xaa,0x0e,0xb3,0xa7,0x7e,0x0f,
+  0x71,0x20,0x92,0xde,0x58,0xdb,0xde,0x7a,0x3e,0xd7,0xa6,0xd2,0xd4,0x75,0x9d,0xb2,
+  0x9e,0xc6,0x1f,0x94,0x3c,0x68,0x1a,0x5e,0x5e,0xac,0x5c,0x71,0x69,0xf6,0x61,0x05,
+  0x2e,0x8d,0xb1,0x5d,0x1e,0xc2,0x8b,0x71,0x8b,0xa1,0x65,0xb4,0x53,0x01,0x13,0x6a,
+  0xfc,0xf0,0x4e,0xb8,0x74,0xbd,0x82,0x33,0x65,0xca,0xd4,0x4f,0xd5,0xfb,0x49,0xd8,
+  0xc6,0x52,0xa9,0xfb,0xa3,0xff,0xe3,0xcf,0xbd,0xf8,0x71,0x13,0x00,0xdd,0xfc,0xbd,
+  0x4d,0x43,0x3d,0x38,0x77,0x42,0x26,0xef,0xc2,0xfa,0xd8,0x31,0x61,0x31,0xe8,0x84,
+  0x12,0xb5,0x1f,0x37,0x59,0x96,0x48,0x70,0x79,0x2f,0xdb,0xa8,0x4e,0x4a,0xfa,0xda,
+  0x3c,0x5e,0xff,0x03,0xb9,0x2e,0xe0,0xc7,0x51,0xd8,0x84,0xb7,0xda,0x82,0xf5,0x89,
+  0xd7,0x6b,0x3c,0x78,0xba,0x40,0x9a,0x0c,0xc3,0xd0,0x3c,0xec,0xdb,0xe5,0xbc,0x46,
+  0xb6,0x25,0xd7,0x5b,0x67,0x35,0xe8,0x67,0x70,0xe9,0x34,0x2d,0xaf,0x26,0xec,0xd7,
+  0x92,0xbf,0x6e,0xfe,0x01,0x90,0x6f,0xe2,0xe6,0xb4,0x05,0x00,0x00,
+};
+
+struct StaticAsset {
+  const char    *path;         // URL bez query (?v=ETag)
+  const char    *contentType;
+  const uint8_t *data;         // gzip v PROGMEM
+  size_t         length;
+  const char    *etag;
+};
+
+static const StaticAsset STATIC_ASSETS[] = {
+  { "/static/charts.js", "application/javascript", ASSET_CHARTS_JS, sizeof(ASSET_CHARTS_JS), ASSET_CHARTS_JS_ETAG },
+  { "/static/style.css", "text/css", ASSET_STYLE_CSS, sizeof(ASSET_STYLE_CSS), ASSET_STYLE_CSS_ETAG },
+};
+static const uint8_t STATIC_ASSET_COUNT = sizeof(STATIC_ASSETS) / sizeof(STATIC_ASSETS[0]);
+
+#endif // FARM_HUB_ASSETS_H
@@ -0,0 +1,341 @@
+#ifndef FARM_HUB_BENCH_H
+#define FARM_HUB_BENCH_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <sys/time.h>
+#include <FarmProto.h>
+#include "FarmHubConfig.h"
+#include "FarmHubData.h"
+#include "FarmHubScheduler.h"
+#include "FarmHubWebServer.h"
+#include "FarmHubWebSocket.h"
+
+// ------------------------------------------------------------
+// Mikrobenchmarky horkých cest hubu (sestavení s FARMHUB_BENCH)
+//
+// Běží přímo na ESP8266 v setup() před spuštěním sítě, výsledky jdou
+// na Serial jako řádky "BENCH {json}" a na konci "BENCH_DONE".
+// tools/bench_report.py z nich udělá JSON soubor a porovná ho
+// s předchozím během (regrese při review).
+//
+// POZOR: zapisuje syntetická měření (senzory "benchN") do logu,
+// rollupů a config.json – jen pro vývojovou desku.
+// ------------------------------------------------------------
+
+static const uint32_t BENCH_EPOCH       = 1700000000;  // čas, pokud ještě není NTP
+static const size_t   BENCH_PAGE_WINDOW = 1460;        // chunk odpovědi ~ 1 TCP segment
+
+struct BenchTimer {
+  const char *name;
+  uint32_t    param;
+  uint32_t    startUs;
+  uint32_t    startHeap;
+};
+
+static inline void benchBegin(BenchTimer &t, const char *name, uint32_t param) {
+  t.name      = name;
+  t.param     = param;
+  t.startHeap = ESP.getFreeHeap();
+  t.startUs   = micros();
+}
+
+// ops = počet operací (záznamů, zpráv, ...), bytes = volitelně objem dat
+static inline void benchEnd(BenchTimer &t, uint32_t ops, uint32_t bytes = 0) {
+  uint32_t us   = micros() - t.startUs;
+  int32_t  heap = (int32_t)ESP.getFreeHeap() - (int32_t)t.startHeap;
+  Serial.printf("BENCH {\"name\":\"%s\",\"param\":%lu,\"ops\":%lu,\"us\":%lu,\"usPerOp\":%.2f,"
+                "\"bytes\":%lu,\"heapDelta\":%ld}\n",
+                t.name, (unsigned long)t.param, (unsigned long)ops, (unsigned long)us,
+                ops ? (double)us / ops : 0.0, (unsigned long)bytes, (long)heap);
+  yield();
+}
+
+static inline SensorReading benchReading(uint8_t sensorId, uint32_t ts, uint32_t i) {
+  SensorReading sr;
+  sr.sensorId     = sensorId;
+  sr.fields       = (1 << FIELD_SOIL) | (1 << FIELD_TEMP) | (1 << FIELD_HUM);
+  sr.soilMoisture = 30.0f + (i % 200) * 0.1f;
+  sr.temperature  = 18.0f + (i % 70) * 0.1f;
+  sr.humidity     = 40.0f + (i % 300) * 0.1f;
+  sr.lightLevel   = 0.0f;
+  sr.timestamp    = ts;
+  return sr;
+}
+
+// storeSensorBatch (RAM + rollupy + log) po dávkách 8 a čtení logu kurzorem
+static inline void benchDataStore(uint32_t records) {
+  uint8_t  sensorId = internSensorID("bench0");
+  uint32_t ts0      = (uint32_t)time(nullptr) - records * 60;
+
+  BenchTimer t;
+  benchBegin(t, "storeSensorBatch", records);
+  SensorReading batch[8];
+  for (uint32_t i = 0; i < records; i += 8) {
+    uint8_t n = (records - i < 8) ? records - i : 8;
+    for (uint8_t k = 0; k < n; k++) batch[k] = benchReading(sensorId, ts0 + (i + k) * 60, i + k);
+    storeSensorBatch(batch, n);
+    if ((i & 63) == 0) yield();
+  }
+  benchEnd(t, records, records * sizeof(LogRecord));
+
+  // Celý log (odpovídá /datalog.csv)
+  LogCursor cur;
+  LogRecord rec;
+  uint32_t  n = 0;
+  benchBegin(t, "logQueryAll", logUsedBytes() / sizeof(LogRecord));
+  logCursorBegin(cur);
+  while (logCursorNext(cur, rec)) {
+    if ((++n & 255) == 0) yield();
+  }
+  logCursorEnd(cur);
+  benchEnd(t, n, n * sizeof(LogRecord));
+
+  // Poslední hodina (odpovídá /api/history?from=..), přeskakuje bloky
+  n = 0;
+  benchBegin(t, "logQueryHour", logUsedBytes() / sizeof(LogRecord));
+  logCursorBegin(cur, ts0 + records * 60 - 3600, 0xFFFFFFFF);
+  while (logCursorNext(cur, rec)) n++;
+  logCursorEnd(cur);
+  benchEnd(t, n, n * sizeof(LogRecord));
+}
+
+// Příjem dávky od `nodes` uzlů: JSON (parse + převod) proti binárnímu
+// FarmProto (parse + převod); decode = bez uložení, ingest = včetně commitBatch
+static inline void benchIngest(uint8_t nodes, uint8_t samples, uint16_t rounds) {
+  static char json[1280];      // 16 vzorků ~ 1 kB; statické kvůli zásobníku
+  static char scratch[sizeof(json)];
+  uint8_t  frame[FARM_MAX_FRAME];
+  uint32_t now = (uint32_t)time(nullptr);
+  // Víc uzlů, než pojme tabulka ID, se o ID dělí (zpráv je stejně)
+  uint8_t  ids[MAX_SENSOR_IDS];
+  uint8_t  distinct = 0;
+  char     name[SENSOR_ID_LEN];
+  while (distinct < nodes && distinct < MAX_SENSOR_IDS) {
+    snprintf(name, sizeof(name), "bench%u", distinct);
+    uint8_t id = internSensorID(name);
+    if (id == SENSOR_ID_UNKNOWN) break;
+    ids[distinct++] = id;
+  }
+  if (distinct == 0) return;
+
+  // Zprávy se staví předem, měří se jen příjem
+  size_t jsonLen = snprintf(json, sizeof(json), "{\"sensorID\":\"bench0\",\"boot\":1,\"seq\":1,\"batch\":[");
+  FarmWriter w;
+  farmBegin(w, frame, sizeof(frame), MSG_READINGS, NODE_SOIL_DHT, 1);
+  farmPutU32(w, 1);
+  farmPutU8(w, samples);
+  for (uint8_t s = 0; s < samples; s++) {
+    SensorReading sr = benchReading(0, now - (samples - s) * 60, s);
+    jsonLen += snprintf(json + jsonLen, sizeof(json) - jsonLen,
+                        "%s{\"ts\":%lu,\"soil\":%.1f,\"temp\":%.1f,\"hum\":%.1f}", s ? "," : "",
+                        sr.timestamp, sr.soilMoisture, sr.temperature, sr.humidity);
+    FarmSample fs = { (uint32_t)sr.timestamp, sr.fields,
+                      { sr.soilMoisture, sr.temperature, sr.humidity, 0.0f } };
+    farmPutSample(w, fs);
+  }
+  jsonLen += snprintf(json + jsonLen, sizeof(json) - jsonLen, "]}");
+  size_t frameLen = farmEnd(w);
+
+  SensorReading readings[WS_MAX_BATCH];
+  uint32_t msgs = (uint32_t)nodes * rounds;
+  uint32_t param = (uint32_t)nodes * 1000 + samples;   // uzly * 1000 + vzorků ve zprávě
+  BenchTimer t;
+
+  benchBegin(t, "jsonDecode", param);
+  for (uint32_t m = 0; m < msgs; m++) {
+    memcpy(scratch, json, jsonLen);   // parse probíhá v místě, jako v onWsEvent
+    deserializeJson(g_wsDoc, scratch, jsonLen);
+    uint8_t taken = 0;
+    for (JsonVariant v : g_wsDoc["batch"].as<JsonArray>()) {
+      if (taken >= WS_MAX_BATCH) break;
+      readingFromJson(v, ids[m % distinct], now, readings[taken++]);
+    }
+    if ((m & 31) == 0) yield();
+  }
+  benchEnd(t, msgs, msgs * jsonLen);
+
+  benchBegin(t, "binaryDecode", param);
+  for (uint32_t m = 0; m < msgs; m++) {
+    FarmHeader hdr;
+    FarmReader r;
+    if (!farmParse(frame, frameLen, hdr, r)) break;
+    farmGetU32(r);
+    uint8_t n = farmGetU8(r);
+    uint8_t taken = 0;
+    FarmSample s;
+    while (taken < n && taken < WS_MAX_BATCH && farmGetSample(r, s)) {
+      readingFromSample(s, ids[m % distinct], now, readings[taken++]);
+    }
+    if ((m & 31) == 0) yield();
+  }
+  benchEnd(t, msgs, msgs * frameLen);
+
+  // Celý příjem včetně uložení. Každé volání má vlastní boot a seq roste,
+  // aby se dávky nevyřadily jako duplicity.
+  static uint32_t benchBoot = 0;
+  benchBoot += 2;
+  uint32_t ingestMsgs = nodes * 4;
+  benchBegin(t, "jsonIngest", param);
+  for (uint32_t m = 0; m < ingestMsgs; m++) {
+    memcpy(scratch, json, jsonLen);
+    deserializeJson(g_wsDoc, scratch, jsonLen);
+    g_wsDoc["boot"] = benchBoot;
+    g_wsDoc["seq"]  = 1000 + m * samples;
+    ingestBatch(g_wsDoc, ids[m % distinct]);
+    yield();
+  }
+  benchEnd(t, ingestMsgs, ingestMsgs * jsonLen);
+
+  benchBegin(t, "binaryIngest", param);
+  for (uint32_t m = 0; m < ingestMsgs; m++) {
+    FarmHeader hdr;
+    FarmReader r;
+    if (!farmParse(frame, frameLen, hdr, r)) break;
+    farmGetU32(r);
+    uint32_t boot = benchBoot + 1;   // jiný běh než JSON dávky
+    uint8_t  n    = farmGetU8(r);
+    uint8_t  taken = 0;
+    FarmSample s;
+    while (taken < n && taken < WS_MAX_BATCH && farmGetSample(r, s)) {
+      readingFromSample(s, ids[m % distinct], now, readings[taken++]);
+    }
+    commitBatch(ids[m % distinct], boot, 1000 + m * samples, readings, taken);
+    yield();
+  }
+  benchEnd(t, ingestMsgs, ingestMsgs * frameLen);
+}
+
+static inline void benchConfig(uint8_t rounds) {
+  BenchTimer t;
+  benchBegin(t, "saveUserConfig", rounds);
+  for (uint8_t i = 0; i < rounds; i++) {
+    saveUserConfig();
+    yield();
+  }
+  benchEnd(t, rounds);
+
+  benchBegin(t, "loadUserConfig", rounds);
+  for (uint8_t i = 0; i < rounds; i++) {
+    loadUserConfig();
+    yield();
+  }
+  benchEnd(t, rounds);
+}
+
+// Vygeneruje celou odpověď po oknech BENCH_PAGE_WINDOW, jako chunked response
+static inline uint32_t benchRenderAll(const PageRenderer &render, uint8_t *buf) {
+  uint32_t total = 0;
+  for (;;) {
+    PageWriter w(buf, BENCH_PAGE_WINDOW, total);
+    render(w);
+    if (w.length() == 0) break;
+    total += w.length();
+  }
+  return total;
+}
+
+static inline void benchPages(uint8_t rounds) {
+  uint8_t *buf = (uint8_t *)malloc(BENCH_PAGE_WINDOW);
+  if (!buf) return;
+
+  std::shared_ptr<MetricsSnapshot> m = takeMetricsSnapshot();
+  SeriesSnapshot series;
+  const RollupChannel *ch = findRollup(internSensorID("bench0"), FIELD_SOIL);
+  if (ch) {
+    series.channel = *ch;
+    series.tier    = ROLLUP_HOUR;
+    series.fromTs  = 0;
+    series.toTs    = 0xFFFFFFFF;
+  }
+
+  struct Page {
+    const char  *name;
+    PageRenderer render;
+  };
+  Page pages[] = {
+    { "renderMetricsProm", [m](PageWriter &w) { writeMetricsProm(w, *m); } },
+    { "renderMetricsJson", [m](PageWriter &w) { writeMetricsJson(w, *m); } },
+    { "renderSeriesJson",  [&series, ch](PageWriter &w) { if (ch) writeSeriesJson(w, series); } },
+  };
+
+  BenchTimer t;
+  for (const Page &p : pages) {
+    uint32_t bytes = 0;
+    benchBegin(t, p.name, BENCH_PAGE_WINDOW);
+    for (uint8_t i = 0; i < rounds; i++) {
+      bytes += benchRenderAll(p.render, buf);
+      yield();
+    }
+    benchEnd(t, rounds, bytes);
+  }
+  free(buf);
+}
+
+// Režie plánovače: plná tabulka úloh s periodou 1 ms, měří se průchody
+// schedulerRunDue() a zpoždění úloh proti termínu
+static uint32_t g_benchTaskRuns = 0;
+static inline void benchNoopTask() { g_benchTaskRuns++; }
+
+static inline void benchScheduler(uint32_t durationMs) {
+  uint8_t ids[SCHED_MAX_TASKS];
+  uint8_t added = 0;
+  while (added < SCHED_MAX_TASKS) {
+    uint8_t id = schedulerEvery("bench", benchNoopTask, 1 + added % 4);
+    if (id == SCHED_NONE) break;
+    ids[added++] = id;
+  }
+
+  // Započítají se jen průchody, které něco spustily (bez prázdného čekání)
+  g_benchTaskRuns = 0;
+  uint32_t busyUs = 0;
+  uint32_t passes = 0;
+  uint32_t start  = millis();
+  while (millis() - start < durationMs) {
+    uint32_t runs = g_benchTaskRuns;
+    uint32_t t0   = micros();
+    schedulerRunDue();
+    if (g_benchTaskRuns != runs) busyUs += micros() - t0;
+    if ((++passes & 255) == 0) yield();
+  }
+
+  uint32_t maxLate = 0;
+  uint32_t taskUs  = 0;
+  for (uint8_t i = 0; i < added; i++) {
+    if (g_tasks[ids[i]].maxLateMs > maxLate) maxLate = g_tasks[ids[i]].maxLateMs;
+    taskUs += g_tasks[ids[i]].totalUs;
+    schedulerCancel(ids[i]);
+  }
+  // us = režie plánovače bez doby běhu samotných úloh
+  uint32_t overheadUs = busyUs > taskUs ? busyUs - taskUs : 0;
+  Serial.printf("BENCH {\"name\":\"schedulerDispatch\",\"param\":%u,\"ops\":%lu,\"us\":%lu,"
+                "\"usPerOp\":%.2f,\"bytes\":0,\"heapDelta\":0,\"maxLateMs\":%lu}\n",
+                added, (unsigned long)g_benchTaskRuns, (unsigned long)overheadUs,
+                g_benchTaskRuns ? (double)overheadUs / g_benchTaskRuns : 0.0,
+                (unsigned long)maxLate);
+}
+
+static inline void runBenchmarks() {
+  if (time(nullptr) < (time_t)ROLLUP_MIN_EPOCH) {
+    struct timeval tv = { (time_t)BENCH_EPOCH, 0 };
+    settimeofday(&tv, nullptr);
+  }
+  Serial.println("BENCH_START");
+
+  benchDataStore(1000);
+  benchDataStore(9000);     // log pak drží ~10k záznamů (strop daný logBudgetKB)
+
+  static const uint8_t NODES[]   = { 1, 4, 16 };
+  static const uint8_t SAMPLES[] = { 1, 4, 16 };
+  for (uint8_t n : NODES) {
+    for (uint8_t s : SAMPLES) benchIngest(n, s, 50);
+  }
+
+  benchConfig(10);
+  benchPages(5);
+  benchScheduler(2000);
+
+  Serial.println("BENCH_DONE");
+}
+
+#endif // FARM_HUB_BENCH_H
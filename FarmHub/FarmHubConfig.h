@@ -5,6 +5,8 @@
 #include <FS.h>
 #include <ArduinoJson.h>
 #include <time.h>
+#include <FarmProto.h>
+#include <FarmWifiCache.h>
 
 // Globální proměnné
 static String homeSsid          = "";
@@ -12,13 +14,19 @@ static String homePass          = "";
 static float  moistureThreshold = 40.0; 
 static int    waterAmountML     = 100;
 static bool   autoWatering      = false;
+static int    soakMinutes       = 30;    // po zalití se měření ignorují (vsakování)
+static int    maxPumpSecPerHour = 120;   // max. doba čerpání za hodinu na zónu
 static bool  autoLight        = false; // zapíná/vypíná automatické svícení
 static int   lightStartHour   = 8;     // hodina začátku svícení (0-23)
 static int   lightStartMinute = 0;     // minuta začátku
 static int   lightEndHour     = 20;    // hodina konce svícení
 static int   lightEndMinute   = 0;     // minuta konce
+static uint8_t lightDays      = 0x7F;  // dny hlavního okna (bit = tm_wday)
 static bool  lightOnlyIfDark  = false; // svítit jen když < 50 lux
 static bool  manualLightOn    = false; // manuální zapnutí/vypnutí
+static uint32_t logBudgetKB   = 256;   // max. velikost binárního logu na SPIFFS
+static FarmReportPolicy reportPolicy = FARM_REPORT_DEFAULT; // kdy senzory hlásí měření
+static FarmWifiProfile  homeWifiProfile;  // rychlé připojení k domácí síti (FarmWifiCache.h)
 
 // Nastavení NTP pro ČR
 static const long  gmtOffset_sec      = 3600;    
@@ -34,21 +42,49 @@ static inline bool initFileSystem() {
   return true;
 }
 
+// Kapacita dokumentu /config.json (politika hlášení + profil Wi-Fi
+// zabírají přes 1 kB; větší dokument by už zbytečně zatěžoval zásobník)
+static const size_t CONFIG_JSON_CAPACITY = 1536;
+
 // Uložení parametrů do /config.json
 static inline void saveUserConfig() {
-  StaticJsonDocument<256> doc;
+  StaticJsonDocument<CONFIG_JSON_CAPACITY> doc;
   doc["homeSsid"]          = homeSsid;
   doc["homePass"]          = homePass;
   doc["moistureThreshold"] = moistureThreshold;
   doc["waterAmountML"]     = waterAmountML;
   doc["autoWatering"]      = autoWatering;
+  doc["soakMinutes"]       = soakMinutes;
+  doc["maxPumpSecPerHour"] = maxPumpSecPerHour;
   doc["autoLight"]        = autoLight;
   doc["lightStartHour"]   = lightStartHour;
   doc["lightStartMinute"] = lightStartMinute;
   doc["lightEndHour"]     = lightEndHour;
   doc["lightEndMinute"]   = lightEndMinute;
+  doc["lightDays"]        = lightDays;
   doc["lightOnlyIfDark"]  = lightOnlyIfDark;
   doc["manualLightOn"]    = manualLightOn;
+  doc["logBudgetKB"]      = logBudgetKB;
+  doc["reportSampleSec"]    = reportPolicy.sampleSec;
+  doc["reportHeartbeatSec"] = reportPolicy.heartbeatSec;
+  JsonArray deadband = doc.createNestedArray("reportDeadband");
+  JsonArray urgent   = doc.createNestedArray("reportUrgent");
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    deadband.add(reportPolicy.deadband[f]);
+    urgent.add(reportPolicy.urgent[f]);
+  }
+  if (farmWifiProfileValid(homeWifiProfile, homeSsid.c_str())) {
+    JsonObject wp = doc.createNestedObject("wifiProfile");
+    JsonArray bssid = wp.createNestedArray("bssid");
+    for (uint8_t i = 0; i < 6; i++) bssid.add(homeWifiProfile.bssid[i]);
+    wp["channel"] = homeWifiProfile.channel;
+  }
+
+  // Přetečený dokument by tiše vynechal klíče – radši ponechat starý soubor
+  if (doc.overflowed()) {
+    Serial.println("Config exceeds JSON capacity, config.json not written");
+    return;
+  }
 
   File file = SPIFFS.open("/config.json", "w");
   if (!file) {
@@ -71,7 +107,7 @@ static inline void loadUserConfig() {
     Serial.println("Failed to open config.json");
     return;
   }
-  StaticJsonDocument<256> doc;
+  StaticJsonDocument<CONFIG_JSON_CAPACITY> doc;
   DeserializationError err = deserializeJson(doc, file);
   file.close();
 
@@ -85,45 +121,49 @@ static inline void loadUserConfig() {
   moistureThreshold = doc["moistureThreshold"] | 40.0;
   waterAmountML     = doc["waterAmountML"]     | 100;
   autoWatering      = doc["autoWatering"]      | false;
+  soakMinutes       = doc["soakMinutes"]       | 30;
+  maxPumpSecPerHour = doc["maxPumpSecPerHour"] | 120;
   autoLight         = doc["autoLight"]        | false;
   lightStartHour    = doc["lightStartHour"]   | 8;
   lightStartMinute  = doc["lightStartMinute"] | 0;
   lightEndHour      = doc["lightEndHour"]     | 20;
   lightEndMinute    = doc["lightEndMinute"]   | 0;
+  lightDays         = doc["lightDays"]        | 0x7F;
   lightOnlyIfDark   = doc["lightOnlyIfDark"]  | false;
   manualLightOn     = doc["manualLightOn"]    | false;
-
-
-  Serial.println("Config loaded.");
-}
-
-// Nastavení času přes NTP
-static inline void setupTimeFromNTP() {
-  configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
-  Serial.println("Connecting to NTP...");
-
-  struct tm timeinfo;
-  while (!getLocalTime(&timeinfo)) {
-    Serial.println("Waiting for time...");
-    delay(1000);
+  logBudgetKB       = doc["logBudgetKB"]      | 256;
+  reportPolicy.sampleSec    = doc["reportSampleSec"]    | FARM_REPORT_DEFAULT.sampleSec;
+  reportPolicy.heartbeatSec = doc["reportHeartbeatSec"] | FARM_REPORT_DEFAULT.heartbeatSec;
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    reportPolicy.deadband[f] = doc["reportDeadband"][f] | FARM_REPORT_DEFAULT.deadband[f];
+    reportPolicy.urgent[f]   = doc["reportUrgent"][f]   | FARM_REPORT_DEFAULT.urgent[f];
+  }
+  farmWifiProfileInvalidate(homeWifiProfile);
+  if (doc.containsKey("wifiProfile")) {
+    JsonObject wp = doc["wifiProfile"];
+    uint8_t bssid[6];
+    for (uint8_t i = 0; i < 6; i++) bssid[i] = wp["bssid"][i] | 0;
+    farmWifiProfileStore(homeWifiProfile, homeSsid.c_str(), bssid, wp["channel"] | 0);
   }
 
-  Serial.println("Time synced.");
-  char buf[32];
-  strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &timeinfo);
-  Serial.println(buf);
+  Serial.println("Config loaded.");
 }
 
-// Formátování epochového času
-static inline String formatEpochTime(unsigned long epochSeconds) {
+// Formátování epochového času do bufferu (bez alokace)
+static inline const char *formatEpochTime(unsigned long epochSeconds, char *buf, size_t len) {
   time_t rawTime = (time_t)epochSeconds;
   struct tm* ti  = localtime(&rawTime);
   if (!ti) {
     return "N/A";
   }
+  strftime(buf, len, "%Y-%m-%d %H:%M:%S", ti);
+  return buf;
+}
+
+// Formátování epochového času
+static inline String formatEpochTime(unsigned long epochSeconds) {
   char buf[32];
-  strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", ti);
-  return String(buf);
+  return String(formatEpochTime(epochSeconds, buf, sizeof(buf)));
 }
 
 #endif // FARM_HUB_CONFIG_H
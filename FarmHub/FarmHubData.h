@@ -2,120 +2,401 @@
 #define FARM_HUB_DATA_H
 
 #include <Arduino.h>
-#include <vector>
 #include <FS.h>
-#include <ArduinoJson.h>
+#include "FarmHubRingBuffer.h"
+#include "FarmHubLog.h"
+#include "FarmHubRollup.h"
 
 static const int PIN_PUMP = 5; // Pin pro čerpadlo
 
-// Struktura pro hodnoty senzorů
+// ------------------------------------------------------------
+// Tabulka ID senzorů (interning)
+// Každé sensorID se uloží jen jednou, záznamy pak nesou jen 1B index.
+// ------------------------------------------------------------
+static const uint8_t MAX_SENSOR_IDS    = 16;
+static const uint8_t SENSOR_ID_LEN     = 24;   // vč. ukončovací nuly
+static const uint8_t SENSOR_ID_UNKNOWN = 0xFF; // tabulka plná / neznámé ID
+
+// Známé senzory mají pevné indexy (předvyplněno níže)
+static const uint8_t SENSOR_SOIL_DHT = 0;
+static const uint8_t SENSOR_LIGHT    = 1;
+
+static char    g_sensorIds[MAX_SENSOR_IDS][SENSOR_ID_LEN] = {
+  "soilDHTsensor",
+  "lightsensor"
+};
+static uint8_t g_sensorIdCount = 2;
+
+// Tabulka se ukládá na SPIFFS, aby indexy v binárním logu platily i po restartu
+static const char SENSOR_IDS_PATH[] = "/sensorids.txt";
+
+static inline void saveSensorIDs() {
+  File file = SPIFFS.open(SENSOR_IDS_PATH, "w");
+  if (!file) {
+    Serial.println("Failed to open sensorids.txt for writing");
+    return;
+  }
+  for (uint8_t i = 0; i < g_sensorIdCount; i++) {
+    file.printf("%s\n", g_sensorIds[i]);
+  }
+  file.close();
+}
+
+// Najde index sensorID, nebo SENSOR_ID_UNKNOWN (nic nepřidává)
+static inline uint8_t findSensorID(const char *id) {
+  for (uint8_t i = 0; i < g_sensorIdCount; i++) {
+    if (strncmp(g_sensorIds[i], id, SENSOR_ID_LEN - 1) == 0) {
+      return i;
+    }
+  }
+  return SENSOR_ID_UNKNOWN;
+}
+
+// Vrátí index sensorID, případně ho do tabulky přidá (a uloží tabulku)
+static inline uint8_t internSensorID(const char *id, bool persist = true) {
+  uint8_t idx = findSensorID(id);
+  if (idx != SENSOR_ID_UNKNOWN) return idx;
+  if (g_sensorIdCount >= MAX_SENSOR_IDS) {
+    Serial.printf("Sensor ID table full, '%s' stored as unknown\n", id);
+    return SENSOR_ID_UNKNOWN;
+  }
+  // Delší ID se ořízne
+  size_t len = strnlen(id, SENSOR_ID_LEN - 1);
+  memcpy(g_sensorIds[g_sensorIdCount], id, len);
+  g_sensorIds[g_sensorIdCount][len] = 0;
+  uint8_t newIdx = g_sensorIdCount++;
+  if (persist) saveSensorIDs();
+  return newIdx;
+}
+
+// Načtení tabulky ID ze SPIFFS (pořadí v souboru = index)
+static inline void loadSensorIDs() {
+  File file = SPIFFS.open(SENSOR_IDS_PATH, "r");
+  if (!file) return;
+  while (file.available()) {
+    String line = file.readStringUntil('\n');
+    line.trim();
+    if (line.length() > 0) internSensorID(line.c_str(), false);
+  }
+  file.close();
+}
+
+// Jméno senzoru podle indexu
+static inline const char *sensorIdName(uint8_t idx) {
+  if (idx >= g_sensorIdCount) return "unknown";
+  return g_sensorIds[idx];
+}
+
+// Struktura pro hodnoty senzorů (POD, bez alokací)
+// Veličiny měření (bit ve SensorReading::fields)
+static const uint8_t FIELD_SOIL  = 0;
+static const uint8_t FIELD_TEMP  = 1;
+static const uint8_t FIELD_HUM   = 2;
+static const uint8_t FIELD_LIGHT = 3;
+static const uint8_t FIELD_COUNT = 4;
+
 struct SensorReading {
-  String sensorID;
-  float  soilMoisture;
-  float  temperature;
-  float  humidity;
-  float  lightLevel;
+  uint8_t sensorId;     // index do g_sensorIds
+  uint8_t fields;       // přítomné veličiny (1 << FIELD_x), 0 = jen ohlášení senzoru
+  float   soilMoisture;
+  float   temperature;
+  float   humidity;
+  float   lightLevel;
   unsigned long timestamp;
 };
 
-// Buffer naměřených dat v RAM
-static std::vector<SensorReading> dataBuffer;
+// Názvy veličin (shodné s klíči v JSON od senzorů)
+static const char *const FIELD_NAMES[FIELD_COUNT] = { "soil", "temp", "hum", "light" };
 
-// Uložení dat do RAM + CSV
-static inline void storeSensorData(const SensorReading &sr) {
-  dataBuffer.push_back(sr);
-  if (dataBuffer.size() > 300) {
-    dataBuffer.erase(dataBuffer.begin(), dataBuffer.begin() + 100);
+static inline uint8_t fieldFromName(const char *name) {
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (strcmp(FIELD_NAMES[f], name) == 0) return f;
   }
-  File file = SPIFFS.open("/datalog.csv", "a");
-  if (file) {
-    file.printf("%s,%lu,%.2f,%.2f,%.2f,%.2f\n",
-                sr.sensorID.c_str(),
-                sr.timestamp,
-                sr.soilMoisture,
-                sr.temperature,
-                sr.humidity,
-                sr.lightLevel);
-    file.close();
+  return FIELD_COUNT;
+}
+
+static inline float readingField(const SensorReading &sr, uint8_t field) {
+  switch (field) {
+    case FIELD_SOIL:  return sr.soilMoisture;
+    case FIELD_TEMP:  return sr.temperature;
+    case FIELD_HUM:   return sr.humidity;
+    default:          return sr.lightLevel;
   }
 }
 
-// Vrací JSON se záznamy z CSV v daném časovém intervalu
-static inline String getDataForPeriod(unsigned long fromMs, unsigned long toMs) {
-  StaticJsonDocument<1024> doc;
-  JsonArray arr = doc.createNestedArray("readings");
+// Měřítko pro int16 rollupy: setiny u %/°C, světlo po 2 lx (do 65 klx)
+static inline float fieldRollupScale(uint8_t field) {
+  return (field == FIELD_LIGHT) ? 0.5f : 100.0f;
+}
+
+// Buffer naměřených dat v RAM (pevná kapacita, nejstarší se přepisují)
+static const size_t DATA_BUFFER_CAPACITY = 300;
+static RingBuffer<SensorReading, DATA_BUFFER_CAPACITY> dataBuffer;
 
-  File file = SPIFFS.open("/datalog.csv", "r");
-  if (!file) {
-    Serial.println("datalog.csv not found");
-    return "";
+// Poslední měření každého senzoru (indexováno sensorId), O(1) přístup
+static SensorReading g_latestReading[MAX_SENSOR_IDS];
+static bool          g_hasLatest[MAX_SENSOR_IDS] = { false };
+
+// Vrátí poslední měření daného senzoru, nebo nullptr pokud zatím nepřišlo
+static inline const SensorReading *getLatestReading(uint8_t sensorId) {
+  if (sensorId >= MAX_SENSOR_IDS || !g_hasLatest[sensorId]) return nullptr;
+  return &g_latestReading[sensorId];
+}
+
+static inline LogRecord toLogRecord(const SensorReading &sr) {
+  LogRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.timestamp    = (uint32_t)sr.timestamp;
+  rec.sensorId     = sr.sensorId;
+  rec.fields       = sr.fields;
+  rec.soilMoisture = sr.soilMoisture;
+  rec.temperature  = sr.temperature;
+  rec.humidity     = sr.humidity;
+  rec.lightLevel   = sr.lightLevel;
+  return rec;
+}
+
+// ------------------------------------------------------------
+// Převod CSV logu ze starších verzí
+//
+// Dřívější firmware psal měření do /datalog.csv (sensorID,timestamp,
+// soil,temperature,humidity,light). Soubor by jinak na flash zůstal
+// navždy mimo retenci logu a pod stejnou adresou se už servíruje binární
+// log. Při prvním startu se proto záznamy se skutečným časem převedou
+// do logu (retence podle limitu platí i pro ně) a soubor se smaže.
+// ------------------------------------------------------------
+static const char LEGACY_CSV_PATH[] = "/datalog.csv";
+
+// Řádek starého CSV na záznam logu, false = poškozený nebo bez času z NTP
+static inline bool parseLegacyCsvLine(char *line, LogRecord &rec) {
+  char *comma = strchr(line, ',');
+  if (!comma) return false;
+  *comma = 0;
+  char *p = comma + 1;
+  char *end;
+  unsigned long ts = strtoul(p, &end, 10);
+  if (end == p || *end != ',' || ts < ROLLUP_MIN_EPOCH) return false;
+  float values[4];
+  for (uint8_t i = 0; i < 4; i++) {
+    p = end + 1;
+    values[i] = (float)strtod(p, &end);
+    if (end == p || (i < 3 && *end != ',')) return false;
   }
+  memset(&rec, 0, sizeof(rec));
+  rec.timestamp    = (uint32_t)ts;
+  rec.sensorId     = internSensorID(line);
+  rec.fields       = (1 << FIELD_SOIL) | (1 << FIELD_TEMP) | (1 << FIELD_HUM) | (1 << FIELD_LIGHT);
+  rec.soilMoisture = values[0];
+  rec.temperature  = values[1];
+  rec.humidity     = values[2];
+  rec.lightLevel   = values[3];
+  return true;
+}
+
+static inline void importLegacyCsv(uint32_t budgetBytes) {
+  File file = SPIFFS.open(LEGACY_CSV_PATH, "r");
+  if (!file) return;
+  LogRecord recs[8];
+  size_t    pending  = 0;
+  uint32_t  imported = 0;
+  uint32_t  skipped  = 0;
+  char      line[96];
   while (file.available()) {
-    String line = file.readStringUntil('\n');
-    if (line.length() < 5) continue;
-
-    // CSV: sensorID,timestamp,soil,temperature,humidity,light
-    int idx1 = line.indexOf(',');
-    int idx2 = line.indexOf(',', idx1 + 1);
-    int idx3 = line.indexOf(',', idx2 + 1);
-    int idx4 = line.indexOf(',', idx3 + 1);
-    int idx5 = line.indexOf(',', idx4 + 1);
-    if (idx5 < 0) continue;
-
-    String sID = line.substring(0, idx1);
-    unsigned long ts = line.substring(idx1 + 1, idx2).toInt();
-    float sm = line.substring(idx2 + 1, idx3).toFloat();
-    float te = line.substring(idx3 + 1, idx4).toFloat();
-    float hu = line.substring(idx4 + 1, idx5).toFloat();
-    float li = line.substring(idx5 + 1).toFloat();
-
-    if (ts >= fromMs && ts <= toMs) {
-      JsonObject obj = arr.createNestedObject();
-      obj["sensorID"]     = sID;
-      obj["timestamp"]    = ts;
-      obj["soilMoisture"] = sm;
-      obj["temperature"]  = te;
-      obj["humidity"]     = hu;
-      obj["lightLevel"]   = li;
+    size_t n = file.readBytesUntil('\n', line, sizeof(line) - 1);
+    line[n] = 0;
+    if (n == 0) continue;
+    if (!parseLegacyCsvLine(line, recs[pending])) {
+      skipped++;
+      continue;
+    }
+    if (++pending == 8) {
+      imported += logAppendBatch(recs, pending, budgetBytes);
+      pending = 0;
     }
   }
+  if (pending > 0) imported += logAppendBatch(recs, pending, budgetBytes);
   file.close();
+  // Smaže se i při plné flash – převede se, co se vešlo
+  SPIFFS.remove(LEGACY_CSV_PATH);
+  Serial.printf("Log: imported %lu records from %s, %lu skipped\n",
+                (unsigned long)imported, LEGACY_CSV_PATH, (unsigned long)skipped);
+}
 
-  String output;
-  serializeJson(doc, output);
-  return output;
+// Inicializace úložiště dat (tabulka ID + binární log + rollupy)
+static inline void initDataStore() {
+  extern uint32_t logBudgetKB;
+  loadSensorIDs();
+  logInit(logBudgetKB * 1024UL);
+  importLegacyCsv(logBudgetKB * 1024UL);
+  loadRollups();
 }
 
-// Funkce z WebSocketu pro spuštění čerpadla
-extern void broadcastRunPump(int durationSec);
-extern void broadcastLightSettings();
+// Řízení zalévání reaguje na nová měření (FarmHubIrrigation.h)
+extern void irrigationOnReading(const SensorReading &sr);
+extern void irrigationOnPumpDone(uint32_t seq, uint32_t runtimeMs);
+extern void irrigationOnPumpExpired(uint32_t seq);
+
+// ------------------------------------------------------------
+// Prozatímní čas
+//
+// Dokud hub nemá čas z NTP, měření nesou prozatímní čas = sekundy od
+// startu hubu (vždy < ROLLUP_MIN_EPOCH). V RAM se zobrazují hned, do
+// logu a rollupů ale jdou až po synchronizaci s opraveným časem
+// (correctProvisionalReadings). Když synchronizace dlouho nepřichází
+// a odložená měření přetečou, nejstarší se zapíše s prozatímním časem.
+// ------------------------------------------------------------
+static const size_t PROVISIONAL_CAPACITY = 64;
+static RingBuffer<SensorReading, PROVISIONAL_CAPACITY> g_provisional;
+
+static inline bool isProvisional(uint32_t ts) {
+  return ts < ROLLUP_MIN_EPOCH;
+}
+
+// Zápis do rollupů a logu po LOG_CHUNK záznamech (flush = zapsat zbytek)
+static const size_t STORE_LOG_CHUNK = 8;
 
-// Kontrola vlhkosti a případné spuštění čerpadla
-static inline void checkAndIrrigate() {
-  if (dataBuffer.empty()) return;
+static inline void persistReading(const SensorReading &sr, LogRecord *recs, size_t &pending) {
+  extern uint32_t logBudgetKB;
+  for (uint8_t f = 0; f < FIELD_COUNT; f++) {
+    if (sr.fields & (1 << f)) {
+      rollupAdd(sr.sensorId, f, fieldRollupScale(f), (uint32_t)sr.timestamp, readingField(sr, f));
+    }
+  }
+  recs[pending++] = toLogRecord(sr);
+  if (pending == STORE_LOG_CHUNK) {
+    logAppendBatch(recs, pending, logBudgetKB * 1024UL);
+    pending = 0;
+  }
+}
+
+static inline void persistFlush(LogRecord *recs, size_t &pending) {
+  extern uint32_t logBudgetKB;
+  if (pending > 0) {
+    logAppendBatch(recs, pending, logBudgetKB * 1024UL);
+    pending = 0;
+  }
+}
+
+// Uložení dávky měření do RAM + binárního logu. Měření mohou přijít
+// zpětně (doplnění po výpadku spojení), proto "poslední hodnota" senzoru
+// se přepíše jen novějším záznamem.
+static inline void storeSensorBatch(const SensorReading *readings, size_t count) {
+  LogRecord recs[STORE_LOG_CHUNK];
+  size_t pending = 0;
+  uint16_t updated = 0;  // senzory s novou poslední hodnotou (bit = sensorId)
 
-  extern bool  autoWatering;
-  extern float moistureThreshold;
-  extern int   waterAmountML;
+  for (size_t i = 0; i < count; i++) {
+    const SensorReading &sr = readings[i];
+    dataBuffer.push(sr);
+    if (sr.sensorId < MAX_SENSOR_IDS &&
+        (!g_hasLatest[sr.sensorId] || sr.timestamp >= g_latestReading[sr.sensorId].timestamp)) {
+      g_latestReading[sr.sensorId] = sr;
+      g_hasLatest[sr.sensorId]     = true;
+      updated |= (1 << sr.sensorId);
+    }
+    if (isProvisional(sr.timestamp)) {
+      if (g_provisional.full()) persistReading(g_provisional.at(0), recs, pending);
+      g_provisional.push(sr);
+    } else {
+      persistReading(sr, recs, pending);
+    }
+  }
+  persistFlush(recs, pending);
 
-  if (!autoWatering) return;
+  for (uint8_t id = 0; updated != 0; id++, updated >>= 1) {
+    if (updated & 1) irrigationOnReading(g_latestReading[id]);
+  }
+}
 
-  const SensorReading* lastSoilReading = nullptr;
-  for (auto it = dataBuffer.rbegin(); it != dataBuffer.rend(); ++it) {
-    if (it->sensorID == "soilDHTsensor") {
-      lastSoilReading = &(*it);
-      break;
+/**
+ * @brief Po synchronizaci času: prozatímní časy (s od startu) převede na
+ *        epoch (bootEpoch = epoch startu hubu) v RAM a odložená měření
+ *        zapíše do logu a rollupů.
+ */
+static inline void correctProvisionalReadings(uint32_t bootEpoch) {
+  for (size_t i = 0; i < dataBuffer.size(); i++) {
+    SensorReading &sr = dataBuffer.at(i);
+    if (isProvisional(sr.timestamp)) sr.timestamp += bootEpoch;
+  }
+  for (uint8_t id = 0; id < MAX_SENSOR_IDS; id++) {
+    if (g_hasLatest[id] && isProvisional(g_latestReading[id].timestamp)) {
+      g_latestReading[id].timestamp += bootEpoch;
     }
   }
-  if (!lastSoilReading) return;
 
-  if (lastSoilReading->soilMoisture < moistureThreshold) {
-    double secondsFloat = waterAmountML * 0.03; 
-    int secInt = (int)round(secondsFloat);
-    Serial.printf("[Auto] Soil=%.1f%% < %.1f%% => Pump for %d s\n",
-                  lastSoilReading->soilMoisture, moistureThreshold, secInt);
-    broadcastRunPump(secInt);
+  LogRecord recs[STORE_LOG_CHUNK];
+  size_t pending = 0;
+  for (size_t i = 0; i < g_provisional.size(); i++) {
+    SensorReading sr = g_provisional.at(i);
+    sr.timestamp += bootEpoch;
+    persistReading(sr, recs, pending);
   }
+  persistFlush(recs, pending);
+  Serial.printf("Time synced, %u provisional readings corrected\n", (unsigned)g_provisional.size());
+  g_provisional.clear();
+}
+
+static inline void storeSensorData(const SensorReading &sr) {
+  storeSensorBatch(&sr, 1);
+}
+
+// Jeden řádek v původním CSV formátu:
+// sensorID,timestamp,soil,temperature,humidity,light
+static inline size_t formatCsvLine(const LogRecord &rec, char *buf, size_t len) {
+  int n = snprintf(buf, len, "%s,%lu,%.2f,%.2f,%.2f,%.2f\n",
+                   sensorIdName(rec.sensorId),
+                   (unsigned long)rec.timestamp,
+                   rec.soilMoisture,
+                   rec.temperature,
+                   rec.humidity,
+                   rec.lightLevel);
+  if (n < 0) return 0;
+  return ((size_t)n < len) ? (size_t)n : len - 1;
+}
+
+// Číslo pro JSON (NaN/inf nejsou v JSON povolené => null)
+static inline const char *jsonFloat(float v, char *buf, size_t len) {
+  if (isnan(v) || isinf(v)) return "null";
+  snprintf(buf, len, "%.2f", v);
+  return buf;
+}
+
+// Jeden záznam jako JSON objekt (čárky mezi prvky pole doplní stream)
+static inline size_t formatJsonReading(const LogRecord &rec, char *buf, size_t len) {
+  char f[4][16];
+  int n = snprintf(buf, len,
+                   "{\"sensorID\":\"%s\",\"timestamp\":%lu,"
+                   "\"soilMoisture\":%s,\"temperature\":%s,"
+                   "\"humidity\":%s,\"lightLevel\":%s}",
+                   sensorIdName(rec.sensorId),
+                   (unsigned long)rec.timestamp,
+                   jsonFloat(rec.soilMoisture, f[0], sizeof(f[0])),
+                   jsonFloat(rec.temperature,  f[1], sizeof(f[1])),
+                   jsonFloat(rec.humidity,     f[2], sizeof(f[2])),
+                   jsonFloat(rec.lightLevel,   f[3], sizeof(f[3])));
+  if (n < 0) return 0;
+  return ((size_t)n < len) ? (size_t)n : len - 1;
 }
 
+// Počítadla doručení příkazu RUN_PUMP (plní FarmHubWebSocket.h)
+struct PumpStats {
+  uint32_t      issued;          // nové příkazy
+  uint32_t      transmissions;   // všechna odeslání včetně opakování
+  uint32_t      acked;           // potvrzené příkazy
+  uint32_t      expired;         // nepotvrzené do PUMP_CMD_TIMEOUT_MS
+  uint32_t      completed;       // PUMP_DONE
+  unsigned long lastLatencyMs;   // příkaz -> spuštění čerpadla
+  unsigned long totalLatencyMs;  // součet pro průměr (acked)
+  unsigned long lastRuntimeMs;   // skutečná doba chodu z PUMP_DONE
+};
+
+static PumpStats g_pumpStats = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+// Funkce z WebSocketu pro spuštění čerpadla
+extern void broadcastRunPump(int durationSec);
+extern uint32_t sendRunPump(uint8_t pump, int durationSec);
+extern void broadcastLightSettings();
+extern void broadcastTime();
+extern void broadcastReportPolicy();
+
 #endif // FARM_HUB_DATA_H
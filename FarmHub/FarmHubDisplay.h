@@ -2,6 +2,7 @@
 #define FARM_HUB_DISPLAY_H
 
 #include <Arduino.h>
+#include <stdarg.h>
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
@@ -9,82 +10,113 @@
 // 128x64 OLED displej
 static Adafruit_SSD1306 display(128, 64, &Wire, -1);
 
+// ------------------------------------------------------------
+// Textový displej s překreslováním jen změněných řádků
+//
+// Displej je 8 řádků po 21 znacích (font 6x8), každý řádek leží přesně
+// v jedné stránce paměti SSD1306 (8 px). Poslední zobrazený text řádku
+// se drží v RAM; displaySetLine() překreslí a označí stránku jen při
+// změně textu a displayFlush() pošle po I2C jen označené stránky
+// (128 B místo 1 KB celého framebufferu), případně nic.
+// ------------------------------------------------------------
+
+static const uint8_t DISPLAY_ADDR  = 0x3C;
+static const uint8_t DISPLAY_LINES = 8;
+static const uint8_t DISPLAY_COLS  = 21;
+static const uint8_t DISPLAY_I2C_CHUNK = 16;   // bajtů dat v jednom I2C přenosu
+
+struct DisplayStats {
+  uint32_t flushes;     // volání displayFlush() se změnou
+  uint32_t skipped;     // volání bez změny (nic se neposílá)
+  uint32_t pagesSent;   // odeslané stránky (po 128 B)
+};
+
+static char         g_displayText[DISPLAY_LINES][DISPLAY_COLS + 1];
+static uint8_t      g_displayDirty = 0;   // bit = stránka k odeslání
+static bool         g_displayReady = false;
+static DisplayStats g_displayStats;
+
 // Inicializace displeje
 static inline void initDisplay() {
   Wire.begin();
-  if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+  if (!display.begin(SSD1306_SWITCHCAPVCC, DISPLAY_ADDR)) {
     Serial.println("SSD1306 allocation failed");
     return;
   }
-  display.clearDisplay();
-  display.display();
-}
-
-// Rychlá funkce pro zobrazení dvou řádků (ponechána)
-static inline void displayInfo(const String &line1, const String &line2) {
+  g_displayReady = true;
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(WHITE);
-  display.setCursor(0, 0);
-  display.println(line1);
-  display.setCursor(0, 16);
-  display.println(line2);
   display.display();
+  memset(g_displayText, 0, sizeof(g_displayText));
 }
 
 /**
- * @brief Zobrazí SSID, IP, režim (Auto/Manual) a poslední data senzorů.
- *        Půdní vlhkost a světlo na jednom řádku, teplota a vlhkost vzduchu na dalším.
+ * @brief Nastaví text řádku (0-7). Delší text se ořízne, při shodě
+ *        s tím, co už na displeji je, se nic nekreslí.
  */
-static inline void displayStatus(const String &wifiName,
-                                 const String &wifiIP,
-                                 bool autoMode,
-                                 float soilVal,
-                                 float lightVal,
-                                 float tempVal,
-                                 float humVal)
-{
-  display.clearDisplay();
-  display.setTextSize(1);
-  display.setTextColor(WHITE);
+static inline void displaySetLine(uint8_t line, const char *text) {
+  if (line >= DISPLAY_LINES) return;
+  char buf[DISPLAY_COLS + 1];
+  strncpy(buf, text, DISPLAY_COLS);
+  buf[DISPLAY_COLS] = 0;
+  if (strcmp(buf, g_displayText[line]) == 0) return;
 
-  // 1. řádek: WiFi SSID
-  display.setCursor(0, 0);
-  display.print("WiFi: ");
-  display.println(wifiName);
-
-  // 2. řádek: IP adresa
-  display.setCursor(0, 10);
-  display.print("IP:   ");
-  display.println(wifiIP);
+  memcpy(g_displayText[line], buf, sizeof(buf));
+  display.fillRect(0, line * 8, display.width(), 8, BLACK);
+  display.setCursor(0, line * 8);
+  display.print(buf);
+  g_displayDirty |= (1 << line);
+}
 
-  // 3. řádek: Režim zalévání
-  display.setCursor(0, 20);
-  display.print("Mode: ");
-  display.println(autoMode ? "Auto" : "Manual");
+static inline void displayPrintf(uint8_t line, const char *fmt, ...) {
+  char buf[DISPLAY_COLS + 1];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  displaySetLine(line, buf);
+}
 
-  // 4. řádek: Půdní vlhkost a světlo (např. "Soil=35%  Light=52lx")
-  display.setCursor(0, 30);
-  display.print("Soil=");
-  display.print(soilVal, 1);
-  display.print("%  Light=");
-  display.print(lightVal, 1);
-  display.println("lx");
+/**
+ * @brief Odešle změněné stránky framebufferu (adresování stránek SSD1306).
+ */
+static inline void displayFlush() {
+  if (!g_displayReady) return;
+  if (g_displayDirty == 0) {
+    g_displayStats.skipped++;
+    return;
+  }
+  const uint8_t *buffer = display.getBuffer();
+  for (uint8_t page = 0; page < DISPLAY_LINES; page++) {
+    if (!(g_displayDirty & (1 << page))) continue;
 
-  // 5. řádek: Teplota a vlhkost vzduchu (např. "Temp=21.5C Hum=40%")
-  display.setCursor(0, 40);
-  display.print("Temp=");
-  display.print(tempVal, 1);
-  display.print("C  Hum=");
-  display.print(humVal, 1);
-  display.println("%");
+    display.ssd1306_command(SSD1306_PAGEADDR);
+    display.ssd1306_command(page);
+    display.ssd1306_command(page);
+    display.ssd1306_command(SSD1306_COLUMNADDR);
+    display.ssd1306_command(0);
+    display.ssd1306_command(127);
 
-  display.display();
+    const uint8_t *data = buffer + page * 128;
+    for (uint8_t col = 0; col < 128; col += DISPLAY_I2C_CHUNK) {
+      Wire.beginTransmission(DISPLAY_ADDR);
+      Wire.write((uint8_t)0x40);   // Co = 0, D/C = 1: následují data
+      Wire.write(data + col, DISPLAY_I2C_CHUNK);
+      Wire.endTransmission();
+    }
+    g_displayStats.pagesSent++;
+  }
+  g_displayDirty = 0;
+  g_displayStats.flushes++;
 }
 
-// Pokud potřebujete něco obsluhovat v loopu (animace apod.)
-static inline void updateDisplayLoop() {
-  // Prázdné nebo vlastní logika
+// Rychlá funkce pro zobrazení dvou řádků (start, stav Wi-Fi)
+static inline void displayInfo(const String &line1, const String &line2) {
+  for (uint8_t line = 0; line < DISPLAY_LINES; line++) {
+    displaySetLine(line, line == 0 ? line1.c_str() : (line == 2 ? line2.c_str() : ""));
+  }
+  displayFlush();
 }
 
 #endif // FARM_HUB_DISPLAY_H
@@ -0,0 +1,243 @@
+#ifndef FARM_HUB_IRRIGATION_H
+#define FARM_HUB_IRRIGATION_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ArduinoJson.h>
+#include <time.h>
+#include <FarmProto.h>
+#include "FarmHubConfig.h"
+#include "FarmHubData.h"
+
+// ------------------------------------------------------------
+// Automatické zalévání po zónách
+//
+// Zóna = půdní senzor -> čerpadlo. O spuštění se rozhoduje jen při
+// příchodu nového měření vlhkosti (irrigationOnReading) a při hlášeních
+// čerpadla, po síti tak nejde nic navíc. Vypršení stavů (ztracené
+// PUMP_DONE, konec vsakování) a posun okna limitu hlídá i úloha
+// plánovače irrigationCheck, takže nezávisí na tom, kdy přijde měření.
+//
+//   IDLE     – při měření pod prahem spustí čerpadlo => PUMPING
+//   PUMPING  – čeká na PUMP_DONE (nebo vypršení příkazu => IDLE);
+//              když hlášení nepřijde, po době chodu + rezervě => SOAKING
+//   SOAKING  – voda se vsakuje, měření se ignorují soakMinutes minut
+//
+// Navíc se hlídá max. doba čerpání za hodinu (maxPumpSecPerHour) v klouzavém
+// okně: sekundy čerpání se sčítají po IRRIGATION_DUTY_SLOT_MS slotech
+// a limit platí pro součet aktuálního a 12 předchozích slotů, takže
+// žádná hodina (ani přes hranici slotů) limit nepřekročí.
+// Zóna 0 je vždy soilDHTsensor -> čerpadlo 0 s prahem a množstvím
+// z nastavení na stránce Zalévání. Další zóny lze zadat v /zones.json:
+//   [{"sensor":"soil2","pump":1,"threshold":35,"waterML":150}, ...]
+// (threshold/waterML lze vynechat => globální hodnoty)
+// ------------------------------------------------------------
+
+static const uint8_t       IRRIGATION_MAX_ZONES = FARM_MAX_PUMPS;
+static const char          IRRIGATION_ZONES_PATH[] = "/zones.json";
+static const unsigned long IRRIGATION_DONE_GRACE_MS = 60000;  // rezerva na PUMP_DONE
+static const unsigned long IRRIGATION_DUTY_WINDOW_MS = 3600000UL;
+static const uint8_t       IRRIGATION_DUTY_SLOTS     = 12;    // okno = sloty + aktuální
+static const unsigned long IRRIGATION_DUTY_SLOT_MS   = IRRIGATION_DUTY_WINDOW_MS / IRRIGATION_DUTY_SLOTS;
+static const unsigned long IRRIGATION_CHECK_MS       = 10000;
+static const uint32_t      IRRIGATION_MAX_READING_AGE = 600;  // starší (doplněná) měření neřídí
+
+enum ZoneState : uint8_t {
+  ZONE_IDLE,
+  ZONE_PUMPING,
+  ZONE_SOAKING
+};
+
+struct IrrigationZone {
+  uint8_t       sensorId;
+  uint8_t       pump;
+  float         threshold;    // NAN = globální moistureThreshold
+  int           waterML;      // 0 = globální waterAmountML
+
+  ZoneState     state;
+  uint32_t      cmdSeq;       // příkaz čerpadla v běhu
+  uint16_t      pumpSec;      // doba posledního spuštění
+  unsigned long stateSince;   // millis() vstupu do stavu
+  uint32_t      dutySlot;     // číslo aktuálního slotu (millis() / IRRIGATION_DUTY_SLOT_MS)
+  uint16_t      dutySlots[IRRIGATION_DUTY_SLOTS + 1];  // sekundy čerpání, index slot % počet
+  uint16_t      dutySec;      // součet za poslední hodinu
+  uint32_t      runs;         // počet spuštění
+  uint32_t      dutySkips;    // odmítnuto kvůli limitu za hodinu
+};
+
+static IrrigationZone g_zones[IRRIGATION_MAX_ZONES];
+static uint8_t        g_zoneCount = 0;
+
+static inline const char *zoneStateName(ZoneState s) {
+  switch (s) {
+    case ZONE_PUMPING: return "zalévá";
+    case ZONE_SOAKING: return "vsakování";
+    default:           return "čeká";
+  }
+}
+
+static inline float zoneThreshold(const IrrigationZone &z) {
+  extern float moistureThreshold;
+  return isnan(z.threshold) ? moistureThreshold : z.threshold;
+}
+
+static inline int zoneWaterML(const IrrigationZone &z) {
+  extern int waterAmountML;
+  return (z.waterML > 0) ? z.waterML : waterAmountML;
+}
+
+// 1 ml = 0.03 s (příklad, stejně jako u ručního zalití)
+static inline uint16_t zonePumpSeconds(const IrrigationZone &z) {
+  return (uint16_t)round(zoneWaterML(z) * 0.03);
+}
+
+static inline bool addIrrigationZone(uint8_t sensorId, uint8_t pump, float threshold, int waterML) {
+  if (g_zoneCount >= IRRIGATION_MAX_ZONES || sensorId == SENSOR_ID_UNKNOWN || pump >= FARM_MAX_PUMPS) {
+    return false;
+  }
+  IrrigationZone &z = g_zones[g_zoneCount++];
+  memset(&z, 0, sizeof(z));
+  z.sensorId  = sensorId;
+  z.pump      = pump;
+  z.threshold = threshold;
+  z.waterML   = waterML;
+  z.state     = ZONE_IDLE;
+  return true;
+}
+
+// Zóna 0 + další zóny z /zones.json
+static inline void initIrrigation() {
+  g_zoneCount = 0;
+  addIrrigationZone(SENSOR_SOIL_DHT, 0, NAN, 0);
+
+  File file = SPIFFS.open(IRRIGATION_ZONES_PATH, "r");
+  if (!file) return;
+  StaticJsonDocument<512> doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+  if (err) {
+    Serial.println("Failed to parse zones.json");
+    return;
+  }
+  for (JsonVariant z : doc.as<JsonArray>()) {
+    addIrrigationZone(internSensorID(z["sensor"] | "unknown"),
+                      z["pump"] | 0,
+                      z["threshold"] | NAN,
+                      z["waterML"] | 0);
+  }
+  Serial.printf("Irrigation: %u zones\n", g_zoneCount);
+}
+
+// Posune klouzavé okno limitu na aktuální slot (staré sloty se vynulují)
+static inline void zoneDutyAdvance(IrrigationZone &z, unsigned long now) {
+  const uint8_t n = IRRIGATION_DUTY_SLOTS + 1;
+  uint32_t slot  = now / IRRIGATION_DUTY_SLOT_MS;
+  uint32_t steps = slot - z.dutySlot;   // přetečení millis() => vše vynulovat
+  if (steps > n) steps = n;
+  for (uint32_t k = 1; k <= steps; k++) {
+    z.dutySlots[(z.dutySlot + k) % n] = 0;
+  }
+  z.dutySlot = slot;
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < n; i++) sum += z.dutySlots[i];
+  z.dutySec = (sum > 0xFFFF) ? 0xFFFF : (uint16_t)sum;
+}
+
+// Vypršení stavů PUMPING a SOAKING, vrací true, když zóna může rozhodovat
+static inline bool zoneUpdateState(IrrigationZone &z, unsigned long now) {
+  extern int soakMinutes;
+
+  if (z.state == ZONE_PUMPING) {
+    // PUMP_DONE se ztratilo (např. restart čerpadla) – bereme chod jako skončený
+    if (now - z.stateSince < z.pumpSec * 1000UL + IRRIGATION_DONE_GRACE_MS) return false;
+    Serial.printf("[Auto] Zone %u: no PUMP_DONE for cmd %lu, soaking\n",
+                  (unsigned)(&z - g_zones), (unsigned long)z.cmdSeq);
+    z.state      = ZONE_SOAKING;
+    z.stateSince = now;
+  }
+  if (z.state == ZONE_SOAKING) {
+    if (now - z.stateSince < (unsigned long)soakMinutes * 60000UL) return false;
+    z.state      = ZONE_IDLE;
+    z.stateSince = now;
+  }
+  return true;
+}
+
+// Rozhodnutí zóny při novém měření
+static inline void zoneEvaluate(IrrigationZone &z, const SensorReading &sr) {
+  extern bool autoWatering;
+  extern int  maxPumpSecPerHour;
+  unsigned long now = millis();
+
+  if (!zoneUpdateState(z, now)) return;
+  if (!autoWatering || sr.soilMoisture >= zoneThreshold(z)) return;
+
+  // Limit čerpání za (klouzavou) hodinu
+  zoneDutyAdvance(z, now);
+  uint16_t sec = zonePumpSeconds(z);
+  if (z.dutySec + sec > maxPumpSecPerHour) {
+    z.dutySkips++;
+    Serial.printf("[Auto] Zone %u: duty limit %d s/h reached\n",
+                  (unsigned)(&z - g_zones), maxPumpSecPerHour);
+    return;
+  }
+
+  Serial.printf("[Auto] Zone %u: soil=%.1f%% < %.1f%% => pump %u for %u s\n",
+                (unsigned)(&z - g_zones), sr.soilMoisture, zoneThreshold(z), z.pump, sec);
+  z.cmdSeq     = sendRunPump(z.pump, sec);
+  z.pumpSec    = sec;
+  z.dutySlots[z.dutySlot % (IRRIGATION_DUTY_SLOTS + 1)] += sec;
+  z.dutySec   += sec;
+  z.runs++;
+  z.state      = ZONE_PUMPING;
+  z.stateSince = now;
+}
+
+// Nové měření (volá storeSensorBatch pro nejnovější měření senzoru)
+void irrigationOnReading(const SensorReading &sr) {
+  if (!(sr.fields & (1 << FIELD_SOIL))) return;
+
+  // Měření doplněná po výpadku spojení už nejsou aktuální
+  uint32_t now = (uint32_t)time(nullptr);
+  if (now >= ROLLUP_MIN_EPOCH && sr.timestamp + IRRIGATION_MAX_READING_AGE < now) return;
+
+  for (uint8_t i = 0; i < g_zoneCount; i++) {
+    if (g_zones[i].sensorId == sr.sensorId) {
+      zoneEvaluate(g_zones[i], sr);
+    }
+  }
+}
+
+// Čerpadlo doběhlo => vsakování
+void irrigationOnPumpDone(uint32_t seq, uint32_t runtimeMs) {
+  for (uint8_t i = 0; i < g_zoneCount; i++) {
+    IrrigationZone &z = g_zones[i];
+    if (z.state == ZONE_PUMPING && z.cmdSeq == seq) {
+      z.state      = ZONE_SOAKING;
+      z.stateSince = millis();
+    }
+  }
+}
+
+// Příkaz nebyl potvrzen => při dalším měření znovu. Sekundy zůstávají
+// v limitu: ztratit se mohlo i PUMP_ACK od čerpadla, které už běželo.
+void irrigationOnPumpExpired(uint32_t seq) {
+  for (uint8_t i = 0; i < g_zoneCount; i++) {
+    IrrigationZone &z = g_zones[i];
+    if (z.state == ZONE_PUMPING && z.cmdSeq == seq) {
+      z.state      = ZONE_IDLE;
+      z.stateSince = millis();
+    }
+  }
+}
+
+// Úloha plánovače: vypršení stavů a posun okna limitu i bez nových měření
+static inline void irrigationCheck() {
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < g_zoneCount; i++) {
+    zoneUpdateState(g_zones[i], now);
+    zoneDutyAdvance(g_zones[i], now);
+  }
+}
+
+#endif // FARM_HUB_IRRIGATION_H
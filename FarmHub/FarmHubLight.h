@@ -0,0 +1,120 @@
+#ifndef FARM_HUB_LIGHT_H
+#define FARM_HUB_LIGHT_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ArduinoJson.h>
+#include <FarmProto.h>
+#include "FarmHubConfig.h"
+
+// ------------------------------------------------------------
+// Okna svícení
+//
+// Hlavní okno je lightStart*/lightEnd* z /config.json (dny lightDays),
+// další okna jsou v /light.json jako [[dny, start h, start m, konec h,
+// konec m], ...]. Modul světla dostane všechna okna v LIGHT_SETTINGS
+// a přepnutí si plánuje sám.
+// ------------------------------------------------------------
+
+static const char    LIGHT_WINDOWS_PATH[] = "/light.json";
+static const uint8_t LIGHT_EXTRA_WINDOWS  = FARM_LIGHT_MAX_WINDOWS - 1;
+
+static FarmLightWindow g_lightWindows[LIGHT_EXTRA_WINDOWS];
+static uint8_t         g_lightWindowCount = 0;
+
+// Dny v pořadí Po..Ne (index = tm_wday)
+static const uint8_t LIGHT_DAY_ORDER[7] = { 1, 2, 3, 4, 5, 6, 0 };
+static const char *const LIGHT_DAY_NAMES[7] = { "Ne", "Po", "Út", "St", "Čt", "Pá", "So" };
+
+// Hlavní okno + další okna do out[FARM_LIGHT_MAX_WINDOWS], vrací počet
+static inline uint8_t lightAllWindows(FarmLightWindow *out) {
+  out[0].days        = lightDays;
+  out[0].startHour   = lightStartHour;
+  out[0].startMinute = lightStartMinute;
+  out[0].endHour     = lightEndHour;
+  out[0].endMinute   = lightEndMinute;
+  memcpy(out + 1, g_lightWindows, g_lightWindowCount * sizeof(FarmLightWindow));
+  return 1 + g_lightWindowCount;
+}
+
+static inline bool lightWindowValid(const FarmLightWindow &lw) {
+  return lw.days != 0 && lw.startHour < 24 && lw.endHour < 24 &&
+         lw.startMinute < 60 && lw.endMinute < 60;
+}
+
+static inline bool addLightWindow(const FarmLightWindow &lw) {
+  if (g_lightWindowCount >= LIGHT_EXTRA_WINDOWS || !lightWindowValid(lw)) return false;
+  g_lightWindows[g_lightWindowCount++] = lw;
+  return true;
+}
+
+static inline void removeLightWindow(uint8_t index) {
+  if (index >= g_lightWindowCount) return;
+  memmove(g_lightWindows + index, g_lightWindows + index + 1,
+          (g_lightWindowCount - index - 1) * sizeof(FarmLightWindow));
+  g_lightWindowCount--;
+}
+
+static inline void saveLightWindows() {
+  StaticJsonDocument<768> doc;
+  JsonArray arr = doc.to<JsonArray>();
+  for (uint8_t i = 0; i < g_lightWindowCount; i++) {
+    const FarmLightWindow &lw = g_lightWindows[i];
+    JsonArray a = arr.createNestedArray();
+    a.add(lw.days);
+    a.add(lw.startHour);
+    a.add(lw.startMinute);
+    a.add(lw.endHour);
+    a.add(lw.endMinute);
+  }
+  File file = SPIFFS.open(LIGHT_WINDOWS_PATH, "w");
+  if (!file) {
+    Serial.println("Failed to open light.json for writing");
+    return;
+  }
+  serializeJson(doc, file);
+  file.close();
+}
+
+static inline void loadLightWindows() {
+  g_lightWindowCount = 0;
+  File file = SPIFFS.open(LIGHT_WINDOWS_PATH, "r");
+  if (!file) return;
+  StaticJsonDocument<768> doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+  if (err) {
+    Serial.println("Failed to parse light.json");
+    return;
+  }
+  for (JsonArray a : doc.as<JsonArray>()) {
+    FarmLightWindow lw;
+    lw.days        = a[0] | 0;
+    lw.startHour   = a[1] | 0;
+    lw.startMinute = a[2] | 0;
+    lw.endHour     = a[3] | 0;
+    lw.endMinute   = a[4] | 0;
+    addLightWindow(lw);
+  }
+  Serial.printf("Light: %u extra windows\n", g_lightWindowCount);
+}
+
+// "Po St Pá", "denně"
+static inline const char *lightDaysText(uint8_t days, char *buf, size_t len) {
+  if ((days & FARM_LIGHT_ALL_DAYS) == FARM_LIGHT_ALL_DAYS) {
+    snprintf(buf, len, "denně");
+    return buf;
+  }
+  size_t pos = 0;
+  buf[0] = 0;
+  for (uint8_t i = 0; i < 7; i++) {
+    uint8_t d = LIGHT_DAY_ORDER[i];
+    if (!(days & (1 << d))) continue;
+    int n = snprintf(buf + pos, len - pos, pos ? " %s" : "%s", LIGHT_DAY_NAMES[d]);
+    if (n < 0 || (size_t)n >= len - pos) break;
+    pos += n;
+  }
+  return buf;
+}
+
+#endif // FARM_HUB_LIGHT_H
@@ -0,0 +1,545 @@
+#ifndef FARM_HUB_LOG_H
+#define FARM_HUB_LOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "FarmHubMetrics.h"
+
+// ------------------------------------------------------------
+// Segmentovaný binární log měření na SPIFFS
+//
+// Soubory /log/NNNNNNNN.bin, každý = hlavička + index bloků + max.
+// LOG_SEGMENT_RECORDS záznamů pevné délky. Zápis je vždy jen append na konec
+// aktivního segmentu, při zaplnění se segment uzavře (doplní se hlavička
+// a index) a založí se nový. Nejstarší segmenty se mažou po překročení
+// limitu v bajtech. Uzavřené segmenty se při startu ověří (hlavička a CRC
+// záznamů); neplatné se zahodí a zůstávají v číslování jako díry, do
+// obsazeného místa se nepočítají.
+//
+// Časový index je řídký: pro každý segment (v RAM) a pro každý blok
+// LOG_BLOCK_RECORDS záznamů (v souboru segmentu) se drží min/max timestamp.
+// Dotaz na interval tak čte jen segmenty a bloky, které se s ním překrývají.
+// ------------------------------------------------------------
+
+static const uint32_t LOG_MAGIC           = 0x474C4846; // "FHLG"
+static const uint16_t LOG_VERSION         = 2;
+static const uint16_t LOG_SEGMENT_RECORDS = 512;
+static const uint16_t LOG_BLOCK_RECORDS   = 64;
+static const uint16_t LOG_SEGMENT_BLOCKS  = LOG_SEGMENT_RECORDS / LOG_BLOCK_RECORDS;
+// Strop pro tabulku v RAM; lze změnit při překladu (-DFARMHUB_LOG_MAX_SEGMENTS=N),
+// např. pro benchmark hostitelského sestavení s logem o 1M záznamech
+#ifndef FARMHUB_LOG_MAX_SEGMENTS
+#define FARMHUB_LOG_MAX_SEGMENTS 64
+#endif
+static const uint16_t LOG_MAX_SEGMENTS    = FARMHUB_LOG_MAX_SEGMENTS;
+static const char     LOG_DIR[]           = "/log/";
+
+// Jeden záznam v logu (24 B)
+struct __attribute__((packed)) LogRecord {
+  uint32_t timestamp;
+  uint8_t  sensorId;      // index do tabulky ID senzorů
+  uint8_t  fields;        // přítomné veličiny (bitová maska)
+  uint8_t  reserved[2];
+  float    soilMoisture;
+  float    temperature;
+  float    humidity;
+  float    lightLevel;
+};
+
+// Hlavička segmentu (24 B), plně vyplněná až při uzavření segmentu
+struct __attribute__((packed)) LogSegmentHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recordSize;
+  uint32_t minTimestamp;
+  uint32_t maxTimestamp;
+  uint32_t recordCount;   // 0 = segment je aktivní (neuzavřený)
+  uint32_t crc;           // CRC32 všech záznamů segmentu
+};
+
+// Časový rozsah segmentu nebo bloku (prázdný: min > max)
+struct __attribute__((packed)) LogTimeSpan {
+  uint32_t minTs;
+  uint32_t maxTs;
+};
+
+static const size_t LOG_INDEX_OFFSET   = sizeof(LogSegmentHeader);
+static const size_t LOG_RECORDS_OFFSET = LOG_INDEX_OFFSET + LOG_SEGMENT_BLOCKS * sizeof(LogTimeSpan);
+static const size_t LOG_SEGMENT_BYTES  =
+  LOG_RECORDS_OFFSET + (size_t)LOG_SEGMENT_RECORDS * sizeof(LogRecord);
+
+// Stav logu v RAM
+static bool        g_logReady       = false;
+static uint32_t    g_logFirstSeq    = 0;  // nejstarší segment
+static uint32_t    g_logLastSeq     = 0;  // aktivní segment
+static uint32_t    g_logActiveCount = 0;
+static uint32_t    g_logHoles       = 0;  // chybějící segmenty mezi first a last
+static uint32_t    g_logCorrupt     = 0;  // segmenty zahozené při startu kvůli CRC
+static uint32_t    g_logActiveCrc   = 0xFFFFFFFF;
+static LogTimeSpan g_logActiveBlocks[LOG_SEGMENT_BLOCKS];  // index aktivního segmentu
+static LogTimeSpan g_logSpans[LOG_MAX_SEGMENTS];           // rozsah segmentu, index seq % MAX
+
+// CRC32 (IEEE), průběžný výpočet: začít 0xFFFFFFFF, na konci negovat
+static inline uint32_t logCrc32Update(uint32_t crc, const uint8_t *data, size_t len) {
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return crc;
+}
+
+static inline void logSpanReset(LogTimeSpan &span) {
+  span.minTs = 0xFFFFFFFF;
+  span.maxTs = 0;
+}
+
+static inline void logSpanAdd(LogTimeSpan &span, uint32_t ts) {
+  if (ts < span.minTs) span.minTs = ts;
+  if (ts > span.maxTs) span.maxTs = ts;
+}
+
+static inline bool logSpanEmpty(const LogTimeSpan &span) {
+  return span.minTs > span.maxTs;
+}
+
+static inline bool logSpanOverlaps(const LogTimeSpan &span, uint32_t fromTs, uint32_t toTs) {
+  return span.minTs <= span.maxTs && span.minTs <= toTs && span.maxTs >= fromTs;
+}
+
+static inline LogTimeSpan &logSegmentSpan(uint32_t seq) {
+  return g_logSpans[seq % LOG_MAX_SEGMENTS];
+}
+
+// Započítá nový záznam do stavu aktivního segmentu
+static inline void logTrackActive(const LogRecord &rec) {
+  logSpanAdd(g_logActiveBlocks[g_logActiveCount / LOG_BLOCK_RECORDS], rec.timestamp);
+  logSpanAdd(logSegmentSpan(g_logLastSeq), rec.timestamp);
+  g_logActiveCrc = logCrc32Update(g_logActiveCrc, (const uint8_t *)&rec, sizeof(rec));
+  g_logActiveCount++;
+}
+
+static inline void logResetActive() {
+  g_logActiveCount = 0;
+  g_logActiveCrc   = 0xFFFFFFFF;
+  for (uint16_t b = 0; b < LOG_SEGMENT_BLOCKS; b++) {
+    logSpanReset(g_logActiveBlocks[b]);
+  }
+  logSpanReset(logSegmentSpan(g_logLastSeq));
+}
+
+// Cesta k segmentu podle pořadového čísla
+static inline void logSegmentPath(uint32_t seq, char *buf, size_t len) {
+  snprintf(buf, len, "%s%08lu.bin", LOG_DIR, (unsigned long)seq);
+}
+
+static inline bool logReadHeader(File &file, LogSegmentHeader &hdr) {
+  file.seek(0, SeekSet);
+  if (file.read((uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+  return hdr.magic == LOG_MAGIC &&
+         hdr.version == LOG_VERSION &&
+         hdr.recordSize == sizeof(LogRecord);
+}
+
+// Založí nový (prázdný) aktivní segment
+static inline bool logCreateSegment(uint32_t seq) {
+  char path[32];
+  logSegmentPath(seq, path, sizeof(path));
+  File file = SPIFFS.open(path, "w");
+  if (!file) {
+    Serial.printf("Log: cannot create %s\n", path);
+    return false;
+  }
+  // Hlavička a místo pro index bloků, vyplní se při uzavření
+  uint8_t zeros[LOG_RECORDS_OFFSET];
+  memset(zeros, 0, sizeof(zeros));
+  LogSegmentHeader hdr = { LOG_MAGIC, LOG_VERSION, sizeof(LogRecord), 0, 0, 0, 0 };
+  memcpy(zeros, &hdr, sizeof(hdr));
+  size_t written = file.write(zeros, sizeof(zeros));
+  file.close();
+  if (written != sizeof(zeros)) {
+    // Plná flash – záznamy za neúplnou hlavičkou by nebyly zarovnané
+    SPIFFS.remove(path);
+    Serial.printf("Log: no space for %s\n", path);
+    return false;
+  }
+
+  logResetActive();
+  return true;
+}
+
+// Uzavře aktivní segment – zapíše časový rozsah, počet, CRC a index bloků
+static inline void logSealActive() {
+  char path[32];
+  logSegmentPath(g_logLastSeq, path, sizeof(path));
+  File file = SPIFFS.open(path, "r+");
+  if (!file) return;
+  const LogTimeSpan &span = logSegmentSpan(g_logLastSeq);
+  LogSegmentHeader hdr = {
+    LOG_MAGIC, LOG_VERSION, sizeof(LogRecord),
+    span.minTs, span.maxTs,
+    g_logActiveCount, ~g_logActiveCrc
+  };
+  file.seek(0, SeekSet);
+  file.write((const uint8_t *)&hdr, sizeof(hdr));
+  file.write((const uint8_t *)g_logActiveBlocks, sizeof(g_logActiveBlocks));
+  file.close();
+}
+
+// Počet segmentů, které na flash skutečně jsou (vč. aktivního)
+static inline uint32_t logStoredSegments() {
+  return g_logLastSeq - g_logFirstSeq + 1 - g_logHoles;
+}
+
+// Smaže nejstarší segmenty, dokud log nepřesahuje budgetBytes
+// (tabulka rozsahů v RAM navíc omezuje rozpětí čísel segmentů)
+static inline void logEnforceRetention(uint32_t budgetBytes) {
+  while (g_logFirstSeq < g_logLastSeq &&
+         (logStoredSegments() * LOG_SEGMENT_BYTES > budgetBytes ||
+          g_logLastSeq - g_logFirstSeq + 1 > LOG_MAX_SEGMENTS)) {
+    if (g_logHoles > 0 && logSpanEmpty(logSegmentSpan(g_logFirstSeq))) {
+      g_logHoles--;   // díra po zahozeném segmentu, není co mazat
+    } else {
+      char path[32];
+      logSegmentPath(g_logFirstSeq, path, sizeof(path));
+      SPIFFS.remove(path);
+      Serial.printf("Log: dropped %s\n", path);
+    }
+    g_logFirstSeq++;
+  }
+  // Začátek logu vždy na existujícím segmentu
+  while (g_logHoles > 0 && g_logFirstSeq < g_logLastSeq &&
+         logSpanEmpty(logSegmentSpan(g_logFirstSeq))) {
+    g_logFirstSeq++;
+    g_logHoles--;
+  }
+}
+
+// CRC32 prvních `count` záznamů segmentu (čte po blocích)
+static inline bool logSegmentCrc(File &file, uint32_t count, uint32_t &crc) {
+  LogRecord recs[8];
+  crc = 0xFFFFFFFF;
+  file.seek(LOG_RECORDS_OFFSET, SeekSet);
+  while (count > 0) {
+    uint32_t n = count < 8 ? count : 8;
+    size_t bytes = n * sizeof(LogRecord);
+    if (file.read((uint8_t *)recs, bytes) != bytes) return false;
+    crc = logCrc32Update(crc, (const uint8_t *)recs, bytes);
+    count -= n;
+  }
+  crc = ~crc;
+  return true;
+}
+
+// Načte časový rozsah uzavřeného segmentu do tabulky v RAM,
+// vrací false, když segment chybí nebo byl zahozen (rozsah zůstane prázdný)
+static inline bool logLoadSpan(uint32_t seq) {
+  char path[32];
+  logSegmentPath(seq, path, sizeof(path));
+  LogTimeSpan &span = logSegmentSpan(seq);
+  logSpanReset(span);
+
+  File file = SPIFFS.open(path, "r");
+  if (!file) return false;
+  LogSegmentHeader hdr;
+  bool     valid = logReadHeader(file, hdr) && hdr.recordCount != 0 &&
+                   hdr.recordCount <= LOG_SEGMENT_RECORDS;
+  uint32_t crc   = 0;
+  bool     intact = valid && logSegmentCrc(file, hdr.recordCount, crc) && crc == hdr.crc;
+  file.close();
+  if (!intact) {
+    // Neplatný nebo starý formát, případně poškozené záznamy – segment zahodíme
+    SPIFFS.remove(path);
+    if (valid) g_logCorrupt++;
+    Serial.printf("Log: %s %s removed\n", valid ? "corrupt" : "invalid", path);
+    return false;
+  }
+  span.minTs = hdr.minTimestamp;
+  span.maxTs = hdr.maxTimestamp;
+  return true;
+}
+
+// Obnoví stav aktivního segmentu po restartu (projde jeho záznamy)
+static inline bool logResumeActive() {
+  char path[32];
+  logSegmentPath(g_logLastSeq, path, sizeof(path));
+  File file = SPIFFS.open(path, "r");
+  if (!file) return logCreateSegment(g_logLastSeq);
+
+  LogSegmentHeader hdr;
+  if (!logReadHeader(file, hdr)) {
+    file.close();
+    return logCreateSegment(g_logLastSeq);
+  }
+  if (hdr.recordCount != 0) {
+    // Segment už byl uzavřen, pokračujeme novým
+    file.close();
+    logLoadSpan(g_logLastSeq);
+    g_logLastSeq++;
+    return logCreateSegment(g_logLastSeq);
+  }
+
+  // Rozsahy, index bloků i CRC se spočítají znovu ze všech záznamů
+  logResetActive();
+  size_t size = file.size();
+  file.seek(LOG_RECORDS_OFFSET, SeekSet);
+  LogRecord rec;
+  while (g_logActiveCount < LOG_SEGMENT_RECORDS &&
+         file.read((uint8_t *)&rec, sizeof(rec)) == sizeof(rec)) {
+    logTrackActive(rec);
+  }
+  file.close();
+
+  // Neúplný záznam na konci (výpadek napájení při zápisu) by posunul
+  // všechny další – soubor se zkrátí na hranici záznamu. Když to nejde,
+  // segment se uzavře (hlavička nese počet platných záznamů).
+  size_t valid = LOG_RECORDS_OFFSET + g_logActiveCount * sizeof(LogRecord);
+  if (size > valid) {
+    file = SPIFFS.open(path, "r+");
+    bool cut = file && file.truncate(valid);
+    if (file) file.close();
+    Serial.printf("Log: %s tail of %u B %s\n", path, (unsigned)(size - valid),
+                  cut ? "truncated" : "left, segment sealed");
+    if (!cut) {
+      if (g_logActiveCount == 0) return logCreateSegment(g_logLastSeq);
+      logSealActive();
+      g_logLastSeq++;
+      return logCreateSegment(g_logLastSeq);
+    }
+  }
+
+  if (g_logActiveCount >= LOG_SEGMENT_RECORDS) {
+    logSealActive();
+    g_logLastSeq++;
+    return logCreateSegment(g_logLastSeq);
+  }
+  return true;
+}
+
+// Inicializace logu – najde existující segmenty a naváže na poslední
+static inline bool logInit(uint32_t budgetBytes) {
+  g_logFirstSeq = 0;
+  g_logLastSeq  = 0;
+  g_logHoles    = 0;
+
+  Dir dir = SPIFFS.openDir(LOG_DIR);
+  while (dir.next()) {
+    String name = dir.fileName();
+    int slash = name.lastIndexOf('/');
+    uint32_t seq = (uint32_t)name.substring(slash + 1).toInt();
+    if (seq == 0) continue;
+    if (g_logFirstSeq == 0 || seq < g_logFirstSeq) g_logFirstSeq = seq;
+    if (seq > g_logLastSeq) g_logLastSeq = seq;
+  }
+
+  if (g_logLastSeq == 0) {
+    g_logFirstSeq = g_logLastSeq = 1;
+    g_logReady = logCreateSegment(g_logLastSeq);
+  } else {
+    logEnforceRetention(budgetBytes);
+    for (uint32_t seq = g_logFirstSeq; seq < g_logLastSeq; seq++) {
+      if (!logLoadSpan(seq)) g_logHoles++;
+    }
+    // Zahozené segmenty na začátku jen posunou začátek logu
+    while (g_logFirstSeq < g_logLastSeq && logSpanEmpty(logSegmentSpan(g_logFirstSeq))) {
+      g_logFirstSeq++;
+      g_logHoles--;
+    }
+    g_logReady = logResumeActive();
+  }
+  logEnforceRetention(budgetBytes);
+
+  Serial.printf("Log: segments %lu..%lu, active has %lu records, %lu corrupt\n",
+                (unsigned long)g_logFirstSeq, (unsigned long)g_logLastSeq,
+                (unsigned long)g_logActiveCount, (unsigned long)g_logCorrupt);
+  return g_logReady;
+}
+
+// Přidání záznamů na konec aktivního segmentu. Dávka se zapíše jedním
+// otevřením souboru (při rotaci po částech), vrací počet uložených záznamů.
+static inline size_t logAppendBatch(const LogRecord *recs, size_t count, uint32_t budgetBytes) {
+  size_t stored = 0;
+  while (stored < count && g_logReady) {
+    size_t n = LOG_SEGMENT_RECORDS - g_logActiveCount;
+    if (n > count - stored) n = count - stored;
+
+    char path[32];
+    logSegmentPath(g_logLastSeq, path, sizeof(path));
+    uint32_t start = micros();
+    File file = SPIFFS.open(path, "a");
+    if (!file) break;
+    size_t written  = file.write((const uint8_t *)(recs + stored), n * sizeof(LogRecord));
+    size_t complete = written / sizeof(LogRecord);
+    bool   torn     = false;
+    if (written % sizeof(LogRecord) != 0) {
+      // Kus záznamu (plná flash) se odřízne, jinak by posunul všechny další
+      torn = !file.truncate(LOG_RECORDS_OFFSET + (g_logActiveCount + complete) * sizeof(LogRecord));
+    }
+    file.close();
+    latencyRecord(g_metrics.logAppend, micros() - start);
+
+    for (size_t i = 0; i < complete; i++) {
+      logTrackActive(recs[stored + i]);
+    }
+    stored += complete;
+    if (complete != n) {
+      Serial.printf("Log: short write to %s (%u of %u B)\n", path,
+                    (unsigned)written, (unsigned)(n * sizeof(LogRecord)));
+      if (torn && g_logActiveCount == 0) {
+        g_logReady = logCreateSegment(g_logLastSeq);   // prázdný segment znovu
+      } else if (torn) {
+        // Zbytek nejde odříznout – segment se uzavře s počtem platných
+        // záznamů a další zápis začne v novém
+        logSealActive();
+        g_logLastSeq++;
+        g_logReady = logCreateSegment(g_logLastSeq);
+        logEnforceRetention(budgetBytes);
+      }
+      break;
+    }
+
+    // Rotace
+    if (g_logActiveCount >= LOG_SEGMENT_RECORDS) {
+      logSealActive();
+      g_logLastSeq++;
+      g_logReady = logCreateSegment(g_logLastSeq);
+      logEnforceRetention(budgetBytes);
+    }
+  }
+  return stored;
+}
+
+static inline bool logAppend(const LogRecord &rec, uint32_t budgetBytes) {
+  return logAppendBatch(&rec, 1, budgetBytes) == 1;
+}
+
+// Přibližná velikost logu na flash
+static inline uint32_t logUsedBytes() {
+  if (g_logLastSeq == 0) return 0;
+  return (logStoredSegments() - 1) * LOG_SEGMENT_BYTES +
+         LOG_RECORDS_OFFSET + g_logActiveCount * sizeof(LogRecord);
+}
+
+// ------------------------------------------------------------
+// Čtení logu v časovém intervalu <fromTs, toTs>
+//
+// Záznamy se vrací v pořadí uložení. Segmenty a bloky mimo interval se
+// přeskočí bez čtení, cena dotazu tak odpovídá velikosti výsledku.
+// Pro celý log stačí interval <0, 0xFFFFFFFF>.
+// ------------------------------------------------------------
+struct LogCursor {
+  uint32_t    fromTs;
+  uint32_t    toTs;
+  uint32_t    seq;        // aktuální segment
+  uint16_t    nextBlock;  // první blok, který se ještě nezkoumal
+  uint16_t    index;      // další záznam v aktuálním bloku
+  bool        blocksLoaded;
+  bool        blocksFromActive;  // index zkopírován z RAM aktivního segmentu
+  LogTimeSpan blocks[LOG_SEGMENT_BLOCKS];
+  File        file;
+};
+
+static inline void logCursorBegin(LogCursor &cur,
+                                  uint32_t fromTs = 0,
+                                  uint32_t toTs   = 0xFFFFFFFF) {
+  cur.fromTs       = fromTs;
+  cur.toTs         = toTs;
+  cur.seq          = g_logFirstSeq;
+  cur.nextBlock    = 0;
+  cur.index        = LOG_BLOCK_RECORDS;
+  cur.blocksLoaded = false;
+  cur.blocksFromActive = false;
+  cur.file         = File();
+}
+
+static inline void logCursorNextSegment(LogCursor &cur) {
+  if (cur.file) cur.file.close();
+  cur.seq++;
+  cur.nextBlock    = 0;
+  cur.index        = LOG_BLOCK_RECORDS;
+  cur.blocksLoaded = false;
+  cur.blocksFromActive = false;
+}
+
+// Načte další záznam v intervalu, vrací false na konci
+static inline bool logCursorNext(LogCursor &cur, LogRecord &rec) {
+  while (cur.seq != 0 && cur.seq <= g_logLastSeq) {
+    if (cur.seq < g_logFirstSeq) {
+      // Segment mezitím smazala retence
+      cur.seq = g_logFirstSeq - 1;
+      logCursorNextSegment(cur);
+      continue;
+    }
+    bool active = (cur.seq == g_logLastSeq);
+
+    if (!cur.blocksLoaded) {
+      // Celý segment mimo interval – přeskočit bez otevření souboru
+      if (!logSpanOverlaps(logSegmentSpan(cur.seq), cur.fromTs, cur.toTs)) {
+        if (active) break;
+        logCursorNextSegment(cur);
+        continue;
+      }
+      char path[32];
+      logSegmentPath(cur.seq, path, sizeof(path));
+      cur.file = SPIFFS.open(path, "r");
+      if (!cur.file) {
+        if (active) break;
+        logCursorNextSegment(cur);
+        continue;
+      }
+      cur.blocksFromActive = active;
+      if (active) {
+        memcpy(cur.blocks, g_logActiveBlocks, sizeof(cur.blocks));
+      } else {
+        cur.file.seek(LOG_INDEX_OFFSET, SeekSet);
+        cur.file.read((uint8_t *)cur.blocks, sizeof(cur.blocks));
+      }
+      cur.blocksLoaded = true;
+    }
+
+    // Posun na další blok, který se s intervalem překrývá
+    if (cur.index >= LOG_BLOCK_RECORDS) {
+      uint16_t b = cur.nextBlock;
+      if (active) {
+        // Index aktivního segmentu se mezitím mohl rozšířit
+        memcpy(cur.blocks, g_logActiveBlocks, sizeof(cur.blocks));
+      } else if (cur.blocksFromActive) {
+        // Segment se mezitím uzavřel, index je už v souboru
+        cur.file.seek(LOG_INDEX_OFFSET, SeekSet);
+        cur.file.read((uint8_t *)cur.blocks, sizeof(cur.blocks));
+        cur.blocksFromActive = false;
+      }
+      while (b < LOG_SEGMENT_BLOCKS && !logSpanOverlaps(cur.blocks[b], cur.fromTs, cur.toTs)) {
+        b++;
+      }
+      if (b >= LOG_SEGMENT_BLOCKS) {
+        if (active) break;
+        logCursorNextSegment(cur);
+        continue;
+      }
+      cur.nextBlock = b + 1;
+      cur.index     = 0;
+      cur.file.seek(LOG_RECORDS_OFFSET +
+                    ((size_t)b * LOG_BLOCK_RECORDS) * sizeof(LogRecord), SeekSet);
+    }
+
+    if (cur.file.read((uint8_t *)&rec, sizeof(rec)) != sizeof(rec)) {
+      // Konec dat (u aktivního segmentu konec logu)
+      if (active) break;
+      logCursorNextSegment(cur);
+      continue;
+    }
+    cur.index++;
+    if (rec.timestamp >= cur.fromTs && rec.timestamp <= cur.toTs) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline void logCursorEnd(LogCursor &cur) {
+  if (cur.file) cur.file.close();
+}
+
+#endif // FARM_HUB_LOG_H
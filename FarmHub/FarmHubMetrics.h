@@ -0,0 +1,104 @@
+#ifndef FARM_HUB_METRICS_H
+#define FARM_HUB_METRICS_H
+
+#include <Arduino.h>
+#include <FarmProto.h>
+
+// ------------------------------------------------------------
+// Provozní metriky hubu (endpoint /metrics)
+//
+// Jen čítače a součty v RAM bez alokací – záznam stojí pár instrukcí,
+// takže mohou zůstat zapnuté i v provozu. Doby se měří v µs (micros()).
+// Rychlosti zpráv za sekundu se přepočítávají jednou za
+// METRICS_RATE_PERIOD_MS úlohou plánovače (metricsRateTask).
+// ------------------------------------------------------------
+
+static const uint8_t  METRICS_MAX_ROUTES     = 24;
+static const uint32_t METRICS_RATE_PERIOD_MS = 10000;
+
+// Histogram doby průchodu loop() (horní meze v µs, poslední koš = +Inf)
+static const uint8_t  METRICS_LOOP_BUCKETS = 6;
+static const uint32_t METRICS_LOOP_BOUNDS_US[METRICS_LOOP_BUCKETS - 1] = {
+  100, 1000, 5000, 20000, 100000
+};
+
+struct LatencyStat {
+  uint32_t count;
+  uint64_t totalUs;
+  uint32_t maxUs;
+};
+
+struct RouteMetric {
+  const char *path;
+  LatencyStat latency;   // čas v handleru (bez odesílání chunků odpovědi)
+};
+
+struct HubMetrics {
+  uint32_t    loopHist[METRICS_LOOP_BUCKETS];
+  LatencyStat loop;
+
+  // WebSocket podle role uzlu (index FarmNodeId, NODE_HUB = neohlášený)
+  uint32_t    wsIn[NODE_COUNT];
+  uint32_t    wsOut[NODE_COUNT];
+  uint32_t    wsBytesIn;
+  float       wsInRate[NODE_COUNT];    // zpráv/s za poslední období
+  float       wsOutRate[NODE_COUNT];
+  uint32_t    wsInPrev[NODE_COUNT];
+  uint32_t    wsOutPrev[NODE_COUNT];
+  uint16_t    wsClients;
+  uint32_t    wsRejected;               // spojení odmítnutá pro plné sloty
+
+  LatencyStat jsonParse;
+  uint32_t    jsonErrors;
+  LatencyStat logAppend;                // open + write + close segmentu
+
+  RouteMetric routes[METRICS_MAX_ROUTES];
+  uint8_t     routeCount;
+};
+
+static HubMetrics g_metrics;
+
+static inline void latencyRecord(LatencyStat &s, uint32_t us) {
+  s.count++;
+  s.totalUs += us;
+  if (us > s.maxUs) s.maxUs = us;
+}
+
+static inline void metricsLoopPass(uint32_t us) {
+  uint8_t b = 0;
+  while (b < METRICS_LOOP_BUCKETS - 1 && us > METRICS_LOOP_BOUNDS_US[b]) b++;
+  g_metrics.loopHist[b]++;
+  latencyRecord(g_metrics.loop, us);
+}
+
+static inline void metricsWsIn(uint8_t node, size_t len) {
+  if (node >= NODE_COUNT) node = NODE_HUB;
+  g_metrics.wsIn[node]++;
+  g_metrics.wsBytesIn += len;
+}
+
+static inline void metricsWsOut(uint8_t node) {
+  if (node >= NODE_COUNT) node = NODE_HUB;
+  g_metrics.wsOut[node]++;
+}
+
+// Slot pro latenci HTTP routy (registruje se při startu serveru)
+static inline RouteMetric *metricsRoute(const char *path) {
+  if (g_metrics.routeCount >= METRICS_MAX_ROUTES) return nullptr;
+  RouteMetric *r = &g_metrics.routes[g_metrics.routeCount++];
+  r->path = path;
+  return r;
+}
+
+// Úloha plánovače: přepočet zpráv/s podle přírůstku čítačů
+static inline void metricsRateTask() {
+  const float period = METRICS_RATE_PERIOD_MS / 1000.0f;
+  for (uint8_t n = 0; n < NODE_COUNT; n++) {
+    g_metrics.wsInRate[n]  = (g_metrics.wsIn[n]  - g_metrics.wsInPrev[n])  / period;
+    g_metrics.wsOutRate[n] = (g_metrics.wsOut[n] - g_metrics.wsOutPrev[n]) / period;
+    g_metrics.wsInPrev[n]  = g_metrics.wsIn[n];
+    g_metrics.wsOutPrev[n] = g_metrics.wsOut[n];
+  }
+}
+
+#endif // FARM_HUB_METRICS_H
@@ -0,0 +1,113 @@
+#ifndef FARM_HUB_PAGE_H
+#define FARM_HUB_PAGE_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <functional>
+#include "FarmHubConfig.h"
+
+/**
+ * @brief Zápis HTML stránky po částech do chunked odpovědi.
+ *
+ * Stránka se při každém volání chunked callbacku vykreslí znovu od začátku,
+ * ale do výstupu se zkopírují jen bajty v okně <skip, skip + maxLen).
+ * Nic se tak nealokuje na haldě – texty jdou přímo z PROGMEM a čísla se
+ * formátují do malého bufferu na zásobníku. Vykreslení proto musí být pro
+ * daný request deterministické (proměnlivé hodnoty si handler zafixuje
+ * předem a předá je do renderu).
+ */
+class PageWriter {
+public:
+  PageWriter(uint8_t *buffer, size_t maxLen, size_t skip)
+    : _buf(buffer), _max(maxLen), _skip(skip), _pos(0), _out(0) {}
+
+  // Bajty zapsané do výstupního bufferu v tomto volání
+  size_t length() const { return _out; }
+
+  // Okno je plné – zbytek stránky už není potřeba generovat
+  bool done() const { return _pos >= _skip + _max; }
+
+  void write(const char *data, size_t len, bool progmem) {
+    size_t end = _pos + len;
+    if (end > _skip && _pos < _skip + _max) {
+      size_t from = (_pos < _skip) ? _skip - _pos : 0;
+      size_t n    = std::min(len - from, _max - _out);
+      if (progmem) {
+        memcpy_P(_buf + _out, data + from, n);
+      } else {
+        memcpy(_buf + _out, data + from, n);
+      }
+      _out += n;
+    }
+    _pos = end;
+  }
+
+  void print(const __FlashStringHelper *s) {
+    PGM_P p = reinterpret_cast<PGM_P>(s);
+    write(p, strlen_P(p), true);
+  }
+  void print(const char *s)   { write(s, strlen(s), false); }
+  void print(const String &s) { write(s.c_str(), s.length(), false); }
+
+  void printInt(long v) {
+    char tmp[16];
+    writeFormatted(tmp, sizeof(tmp), snprintf(tmp, sizeof(tmp), "%ld", v));
+  }
+  void printUInt(unsigned long v) {
+    char tmp[16];
+    writeFormatted(tmp, sizeof(tmp), snprintf(tmp, sizeof(tmp), "%lu", v));
+  }
+  void printULL(unsigned long long v) {
+    char tmp[24];
+    writeFormatted(tmp, sizeof(tmp), snprintf(tmp, sizeof(tmp), "%llu", v));
+  }
+  // Stejný formát jako String(float) – 2 desetinná místa. Hodnota přichází
+  // od uzlu, i FLT_MAX (39 číslic) se proto musí do bufferu vejít.
+  void printFloat(float v, uint8_t digits = 2) {
+    char tmp[48];
+    if (digits > PAGE_FLOAT_MAX_DIGITS) digits = PAGE_FLOAT_MAX_DIGITS;
+    writeFormatted(tmp, sizeof(tmp), snprintf(tmp, sizeof(tmp), "%.*f", digits, v));
+  }
+  void printIP(const IPAddress &ip) {
+    char tmp[16];
+    writeFormatted(tmp, sizeof(tmp),
+                   snprintf(tmp, sizeof(tmp), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]));
+  }
+  void printTime(unsigned long epochSeconds) {
+    char tmp[32];
+    print(formatEpochTime(epochSeconds, tmp, sizeof(tmp)));
+  }
+
+  // Text od uživatele/okolí (SSID apod.) s HTML escapováním
+  void printEscaped(const char *s) {
+    for (; *s && !done(); s++) {
+      switch (*s) {
+        case '<':  print("&lt;");   break;
+        case '>':  print("&gt;");   break;
+        case '&':  print("&amp;");  break;
+        case '\'': print("&#39;");  break;
+        case '"':  print("&quot;"); break;
+        default:   write(s, 1, false); break;
+      }
+    }
+  }
+
+private:
+  static const uint8_t PAGE_FLOAT_MAX_DIGITS = 6;
+
+  // snprintf vrací délku celého textu, ne zapsaného: oříznout na buffer
+  void writeFormatted(const char *tmp, size_t cap, int n) {
+    if (n < 0) n = 0;
+    write(tmp, std::min((size_t)n, cap - 1), false);
+  }
+
+  uint8_t *_buf;
+  size_t   _max;
+  size_t   _skip;  // bajty odeslané v předchozích voláních
+  size_t   _pos;   // logická pozice v celé stránce
+  size_t   _out;   // zapsáno v tomto volání
+};
+
+typedef std::function<void(PageWriter &w)> PageRenderer;
+
+#endif // FARM_HUB_PAGE_H
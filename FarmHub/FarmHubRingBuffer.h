@@ -0,0 +1,68 @@
+#ifndef FARM_HUB_RING_BUFFER_H
+#define FARM_HUB_RING_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Kruhový buffer s pevnou kapacitou (bez alokací na haldě).
+ *
+ * Paměť je rezervována staticky při překladu, push() je O(1) a při
+ * zaplnění přepíše nejstarší záznam. Index 0 v at() je nejstarší
+ * záznam, fromNewest(0) je nejnovější.
+ */
+template <typename T, size_t N>
+class RingBuffer {
+public:
+  RingBuffer() : _head(0), _count(0), _pushed(0) {}
+
+  // Vloží záznam, při plném bufferu přepíše nejstarší
+  void push(const T &item) {
+    _items[_head] = item;
+    _head = (_head + 1) % N;
+    if (_count < N) {
+      _count++;
+    }
+    _pushed++;
+  }
+
+  size_t size() const     { return _count; }
+  size_t capacity() const { return N; }
+  bool   empty() const    { return _count == 0; }
+  bool   full() const     { return _count == N; }
+
+  // Celkový počet vložení od startu (pro snapshot při postupném čtení)
+  uint32_t pushedCount() const { return _pushed; }
+
+  void clear() {
+    _head  = 0;
+    _count = 0;
+  }
+
+  // Přístup v časovém pořadí: 0 = nejstarší, size()-1 = nejnovější
+  const T &at(size_t i) const {
+    return _items[(_head + N - _count + i) % N];
+  }
+
+  T &at(size_t i) {
+    return _items[(_head + N - _count + i) % N];
+  }
+
+  // Přístup od konce: 0 = nejnovější
+  const T &fromNewest(size_t i) const {
+    return _items[(_head + N - 1 - i) % N];
+  }
+
+  // Poslední vložený záznam (volat jen pokud !empty())
+  const T &newest() const {
+    return fromNewest(0);
+  }
+
+private:
+  T        _items[N];
+  size_t   _head;    // pozice pro další zápis
+  size_t   _count;   // počet platných záznamů
+  uint32_t _pushed;  // počet všech vložení
+};
+
+#endif // FARM_HUB_RING_BUFFER_H
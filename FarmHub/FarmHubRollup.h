@@ -0,0 +1,244 @@
+#ifndef FARM_HUB_ROLLUP_H
+#define FARM_HUB_ROLLUP_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+// ------------------------------------------------------------
+// Agregace měření (rollupy) pro grafy
+//
+// Pro každý kanál (senzor + veličina) se při příjmu měření průběžně
+// aktualizují tři úrovně kruhových bufferů: minuty, hodiny a dny.
+// Každý bucket drží min/max jako int16 ve fixní řádové čárce (měřítko
+// podle veličiny), součet jako int32 a počet; průměr = součet / počet
+// se počítá až při čtení. Graf za den, týden nebo měsíc má tak vždy
+// pevnou cenu bez ohledu na počet měření.
+//
+// Kanálů je nejvýš ROLLUP_MAX_CHANNELS (RAM); měření dalších kanálů
+// se neagregují, jen počítají (g_rollupDropped, /metrics).
+// ------------------------------------------------------------
+
+static const uint8_t  ROLLUP_MAX_CHANNELS = 6;
+static const uint8_t  ROLLUP_TIERS        = 3;
+static const uint8_t  ROLLUP_MINUTE       = 0;
+static const uint8_t  ROLLUP_HOUR         = 1;
+static const uint8_t  ROLLUP_DAY          = 2;
+
+static const uint32_t ROLLUP_PERIOD[ROLLUP_TIERS]  = { 60, 3600, 86400 };
+static const uint16_t ROLLUP_BUCKETS[ROLLUP_TIERS] = { 60, 168, 62 };   // 1 h, 7 dní, ~2 měsíce
+static const uint16_t ROLLUP_TOTAL_BUCKETS         = 60 + 168 + 62;
+
+static const uint32_t ROLLUP_MAGIC     = 0x524C4846; // "FHLR"
+static const uint16_t ROLLUP_VERSION   = 2;   // 2: součet místo průměru v bucketu
+static const char     ROLLUP_PATH[]    = "/rollup.bin";
+
+// Měření s časem před tímto okamžikem (neseřízené hodiny) se neagregují
+static const uint32_t ROLLUP_MIN_EPOCH = 1600000000;
+
+struct __attribute__((packed)) RollupBucket {
+  int16_t  minV;
+  int16_t  maxV;
+  int32_t  sum;    // součet hodnot (int16 * 0xFFFF se vejde)
+  uint16_t count;  // 0 = prázdný bucket
+};
+
+struct __attribute__((packed)) RollupTierState {
+  uint32_t headPeriod;  // číslo periody nejnovějšího bucketu (ts / perioda)
+  uint16_t headPos;     // pozice nejnovějšího bucketu v poli
+};
+
+struct RollupChannel {
+  uint8_t         sensorId;
+  uint8_t         field;
+  float           scale;  // uložená hodnota = skutečná * scale
+  RollupTierState tiers[ROLLUP_TIERS];
+  RollupBucket    buckets[ROLLUP_TOTAL_BUCKETS];  // všechny úrovně za sebou
+};
+
+// Jeden bod pro graf
+struct RollupPoint {
+  uint32_t start;  // začátek bucketu (epoch s)
+  float    minV;
+  float    maxV;
+  float    avgV;
+  uint16_t count;
+};
+
+// Kanály se alokují až při prvním použití (nevyužité nezabírají RAM)
+static RollupChannel *g_rollups[ROLLUP_MAX_CHANNELS] = { nullptr };
+static uint8_t        g_rollupCount  = 0;
+static bool           g_rollupDirty  = false;  // hodinový bucket se posunul => uložit
+static uint32_t       g_rollupDropped = 0;     // měření bez kanálu (tabulka plná)
+
+static inline RollupBucket *rollupTierBuckets(RollupChannel *ch, uint8_t tier) {
+  uint16_t offset = 0;
+  for (uint8_t t = 0; t < tier; t++) offset += ROLLUP_BUCKETS[t];
+  return ch->buckets + offset;
+}
+
+static inline const RollupBucket *rollupTierBuckets(const RollupChannel *ch, uint8_t tier) {
+  return rollupTierBuckets(const_cast<RollupChannel *>(ch), tier);
+}
+
+static inline int16_t rollupEncode(const RollupChannel *ch, float v) {
+  float s = v * ch->scale;
+  if (s >  32767.0f) s =  32767.0f;
+  if (s < -32768.0f) s = -32768.0f;
+  return (int16_t)lroundf(s);
+}
+
+static inline float rollupDecode(const RollupChannel *ch, int16_t v) {
+  return (float)v / ch->scale;
+}
+
+static inline RollupChannel *findRollup(uint8_t sensorId, uint8_t field) {
+  for (uint8_t i = 0; i < g_rollupCount; i++) {
+    if (g_rollups[i]->sensorId == sensorId && g_rollups[i]->field == field) {
+      return g_rollups[i];
+    }
+  }
+  return nullptr;
+}
+
+static inline RollupChannel *createRollup(uint8_t sensorId, uint8_t field, float scale) {
+  if (g_rollupCount >= ROLLUP_MAX_CHANNELS) {
+    if (g_rollupDropped == 0) {
+      Serial.printf("Rollup channels full (%u), sensor %u field %u not aggregated\n",
+                    (unsigned)ROLLUP_MAX_CHANNELS, sensorId, field);
+    }
+    g_rollupDropped++;
+    return nullptr;
+  }
+  RollupChannel *ch = new RollupChannel;
+  memset(ch, 0, sizeof(RollupChannel));
+  ch->sensorId = sensorId;
+  ch->field    = field;
+  ch->scale    = scale;
+  g_rollups[g_rollupCount++] = ch;
+  return ch;
+}
+
+// Přidá hodnotu do jedné úrovně
+static inline void rollupAddTier(RollupChannel *ch, uint8_t tier, uint32_t ts, int16_t v) {
+  RollupTierState &st = ch->tiers[tier];
+  RollupBucket *buckets = rollupTierBuckets(ch, tier);
+  uint16_t n      = ROLLUP_BUCKETS[tier];
+  uint32_t period = ts / ROLLUP_PERIOD[tier];
+
+  if (st.headPeriod == 0) {
+    st.headPeriod = period;
+  } else if (period > st.headPeriod) {
+    // Posun hlavy, přeskočené buckety vyprázdníme
+    uint32_t steps = period - st.headPeriod;
+    if (steps > n) steps = n;
+    for (uint32_t k = 0; k < steps; k++) {
+      st.headPos = (st.headPos + 1) % n;
+      memset(&buckets[st.headPos], 0, sizeof(RollupBucket));
+    }
+    st.headPeriod = period;
+    if (tier == ROLLUP_HOUR) g_rollupDirty = true;
+  } else if (st.headPeriod - period >= n) {
+    return; // příliš staré
+  }
+
+  uint16_t pos = (st.headPos + n - (st.headPeriod - period)) % n;
+  RollupBucket &b = buckets[pos];
+  if (b.count == 0) {
+    b.minV = b.maxV = v;
+    b.sum   = v;
+    b.count = 1;
+  } else {
+    if (v < b.minV) b.minV = v;
+    if (v > b.maxV) b.maxV = v;
+    if (b.count < 0xFFFF) {   // plný bucket drží průměr prvních 65535 hodnot
+      b.sum += v;
+      b.count++;
+    }
+  }
+}
+
+// Zaznamená hodnotu do všech úrovní kanálu (kanál se případně založí)
+static inline void rollupAdd(uint8_t sensorId, uint8_t field, float scale,
+                             uint32_t ts, float value) {
+  if (ts < ROLLUP_MIN_EPOCH || isnan(value)) return;
+  RollupChannel *ch = findRollup(sensorId, field);
+  if (!ch) ch = createRollup(sensorId, field, scale);
+  if (!ch) return;
+  int16_t v = rollupEncode(ch, value);
+  for (uint8_t t = 0; t < ROLLUP_TIERS; t++) {
+    rollupAddTier(ch, t, ts, v);
+  }
+}
+
+// Bucket podle stáří (0 = nejnovější), vrací false pro prázdný bucket
+static inline bool rollupGet(const RollupChannel *ch, uint8_t tier, uint16_t age, RollupPoint &pt) {
+  const RollupTierState &st = ch->tiers[tier];
+  uint16_t n = ROLLUP_BUCKETS[tier];
+  if (age >= n || st.headPeriod < age) return false;
+  const RollupBucket &b = rollupTierBuckets(ch, tier)[(st.headPos + n - age) % n];
+  if (b.count == 0) return false;
+  pt.start = (st.headPeriod - age) * ROLLUP_PERIOD[tier];
+  pt.minV  = rollupDecode(ch, b.minV);
+  pt.maxV  = rollupDecode(ch, b.maxV);
+  pt.avgV  = (float)b.sum / b.count / ch->scale;
+  pt.count = b.count;
+  return true;
+}
+
+// ------------------------------------------------------------
+// Uložení / načtení všech kanálů (/rollup.bin)
+// ------------------------------------------------------------
+struct __attribute__((packed)) RollupFileHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t  channels;
+  uint8_t  reserved;
+  uint16_t totalBuckets;
+};
+
+static inline void saveRollups() {
+  File file = SPIFFS.open(ROLLUP_PATH, "w");
+  if (!file) {
+    Serial.println("Failed to open rollup.bin for writing");
+    return;
+  }
+  RollupFileHeader hdr = { ROLLUP_MAGIC, ROLLUP_VERSION, g_rollupCount, 0, ROLLUP_TOTAL_BUCKETS };
+  file.write((const uint8_t *)&hdr, sizeof(hdr));
+  for (uint8_t i = 0; i < g_rollupCount; i++) {
+    file.write((const uint8_t *)g_rollups[i], sizeof(RollupChannel));
+  }
+  file.close();
+  g_rollupDirty = false;
+}
+
+static inline void loadRollups() {
+  File file = SPIFFS.open(ROLLUP_PATH, "r");
+  if (!file) return;
+  RollupFileHeader hdr;
+  if (file.read((uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+      hdr.magic != ROLLUP_MAGIC || hdr.version != ROLLUP_VERSION ||
+      hdr.totalBuckets != ROLLUP_TOTAL_BUCKETS) {
+    file.close();
+    Serial.println("rollup.bin invalid, starting empty");
+    return;
+  }
+  for (uint8_t i = 0; i < hdr.channels && g_rollupCount < ROLLUP_MAX_CHANNELS; i++) {
+    RollupChannel *ch = new RollupChannel;
+    if (file.read((uint8_t *)ch, sizeof(RollupChannel)) != sizeof(RollupChannel)) {
+      delete ch;
+      break;
+    }
+    g_rollups[g_rollupCount++] = ch;
+  }
+  file.close();
+  Serial.printf("Rollups loaded: %u channels\n", g_rollupCount);
+}
+
+// Volat z loop() – uloží rollupy po uzavření hodinového bucketu
+static inline void rollupPersistLoop() {
+  if (g_rollupDirty) {
+    saveRollups();
+  }
+}
+
+#endif // FARM_HUB_ROLLUP_H
@@ -0,0 +1,222 @@
+#ifndef FARM_HUB_SCHEDULER_H
+#define FARM_HUB_SCHEDULER_H
+
+#include <Arduino.h>
+#include "FarmHubMetrics.h"
+
+// ------------------------------------------------------------
+// Kooperativní plánovač úloh pro loop()
+//
+// Úlohy jsou obyčejné funkce bez parametrů, buď periodické, nebo
+// jednorázové. Čekající úlohy drží min-halda seřazená podle termínu,
+// takže loop() spustí jen ty, které jsou na řadě, a pak spí přesně
+// do termínu další (nejvýš SCHED_MAX_SLEEP_MS, aby se projevily úlohy
+// naplánované z asynchronních callbacků webserveru během spánku).
+//
+// Každá úloha si vede počet běhů, celkovou a max. dobu běhu v µs
+// a max. zpoždění proti termínu v ms (jitter).
+// ------------------------------------------------------------
+
+// Velikost tabulky lze při překladu zvětšit (-DFARMHUB_SCHED_MAX_TASKS=N);
+// id úloh a pozice v haldě jsou uint8_t, 0xFF je SCHED_NONE
+#ifndef FARMHUB_SCHED_MAX_TASKS
+#define FARMHUB_SCHED_MAX_TASKS 16
+#endif
+static_assert(FARMHUB_SCHED_MAX_TASKS > 0 && FARMHUB_SCHED_MAX_TASKS < 255, "max. 254 úloh");
+
+static const uint8_t  SCHED_MAX_TASKS    = FARMHUB_SCHED_MAX_TASKS;
+static const uint32_t SCHED_MAX_SLEEP_MS = 1000;
+static const uint8_t  SCHED_NONE         = 0xFF;
+
+typedef void (*SchedFn)();
+
+struct SchedTask {
+  const char *name;
+  SchedFn     fn;
+  uint32_t    periodMs;   // 0 = jednorázová
+  uint32_t    due;        // millis() termínu
+  uint8_t     heapPos;    // pozice v haldě, SCHED_NONE = nečeká
+  bool        used;
+
+  uint32_t    runs;
+  uint32_t    totalUs;
+  uint32_t    maxUs;
+  uint32_t    maxLateMs;
+};
+
+struct SchedStats {
+  uint32_t wakeups;   // průchody loop()
+  uint32_t tasksRun;
+  uint32_t busyUs;    // čas strávený v úlohách
+  uint32_t sleptMs;   // čas prospaný v delay()
+};
+
+static SchedTask  g_tasks[SCHED_MAX_TASKS];
+static uint8_t    g_schedHeap[SCHED_MAX_TASKS];
+static uint8_t    g_schedHeapSize = 0;
+static SchedStats g_schedStats;
+
+// Porovnání termínů odolné proti přetečení millis()
+static inline bool schedBefore(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+static inline void schedHeapSet(uint8_t pos, uint8_t id) {
+  g_schedHeap[pos]     = id;
+  g_tasks[id].heapPos  = pos;
+}
+
+static inline void schedSiftUp(uint8_t pos) {
+  uint8_t id = g_schedHeap[pos];
+  while (pos > 0) {
+    uint8_t parent = (pos - 1) / 2;
+    if (!schedBefore(g_tasks[id].due, g_tasks[g_schedHeap[parent]].due)) break;
+    schedHeapSet(pos, g_schedHeap[parent]);
+    pos = parent;
+  }
+  schedHeapSet(pos, id);
+}
+
+static inline void schedSiftDown(uint8_t pos) {
+  uint8_t id = g_schedHeap[pos];
+  for (;;) {
+    uint16_t child = 2 * pos + 1;
+    if (child >= g_schedHeapSize) break;
+    if (child + 1 < g_schedHeapSize &&
+        schedBefore(g_tasks[g_schedHeap[child + 1]].due, g_tasks[g_schedHeap[child]].due)) {
+      child++;
+    }
+    if (!schedBefore(g_tasks[g_schedHeap[child]].due, g_tasks[id].due)) break;
+    schedHeapSet(pos, g_schedHeap[child]);
+    pos = child;
+  }
+  schedHeapSet(pos, id);
+}
+
+static inline void schedHeapRemove(uint8_t id) {
+  uint8_t pos = g_tasks[id].heapPos;
+  if (pos == SCHED_NONE) return;
+  g_tasks[id].heapPos = SCHED_NONE;
+  g_schedHeapSize--;
+  if (pos == g_schedHeapSize) return;
+  uint8_t moved = g_schedHeap[g_schedHeapSize];
+  schedHeapSet(pos, moved);
+  schedSiftDown(pos);
+  schedSiftUp(g_tasks[moved].heapPos);
+}
+
+static inline void schedHeapPush(uint8_t id) {
+  uint8_t pos = g_schedHeapSize++;
+  schedHeapSet(pos, id);
+  schedSiftUp(pos);
+}
+
+/**
+ * @brief Naplánuje (nebo přeplánuje) úlohu id na millis() + delayMs.
+ */
+static inline void schedulerRunIn(uint8_t id, uint32_t delayMs) {
+  if (id >= SCHED_MAX_TASKS || !g_tasks[id].used) return;
+  schedHeapRemove(id);
+  g_tasks[id].due = millis() + delayMs;
+  schedHeapPush(id);
+}
+
+/**
+ * @brief Přidá úlohu. periodMs = 0 => jednorázová, po doběhnutí se slot uvolní
+ *        (pokud se sama nepřeplánuje přes schedulerRunIn).
+ * @return id úlohy, nebo SCHED_NONE když je tabulka plná
+ */
+static inline uint8_t schedulerAdd(const char *name, SchedFn fn, uint32_t periodMs, uint32_t firstDelayMs) {
+  for (uint8_t id = 0; id < SCHED_MAX_TASKS; id++) {
+    if (g_tasks[id].used) continue;
+    SchedTask &t = g_tasks[id];
+    memset(&t, 0, sizeof(t));
+    t.name     = name;
+    t.fn       = fn;
+    t.periodMs = periodMs;
+    t.heapPos  = SCHED_NONE;
+    t.used     = true;
+    schedulerRunIn(id, firstDelayMs);
+    return id;
+  }
+  Serial.printf("Scheduler full, task %s dropped\n", name);
+  return SCHED_NONE;
+}
+
+static inline uint8_t schedulerEvery(const char *name, SchedFn fn, uint32_t periodMs) {
+  return schedulerAdd(name, fn, periodMs, 0);
+}
+
+static inline uint8_t schedulerOnce(const char *name, SchedFn fn, uint32_t delayMs) {
+  return schedulerAdd(name, fn, 0, delayMs);
+}
+
+// Zrušení úlohy (lze volat i z ní samotné)
+static inline void schedulerCancel(uint8_t id) {
+  if (id >= SCHED_MAX_TASKS || !g_tasks[id].used) return;
+  schedHeapRemove(id);
+  g_tasks[id].used = false;
+}
+
+/**
+ * @brief Spustí všechny úlohy, jejichž termín nastal.
+ * @return ms do termínu další úlohy (max. SCHED_MAX_SLEEP_MS)
+ */
+static inline uint32_t schedulerRunDue() {
+  g_schedStats.wakeups++;
+  // Průchod obslouží jen úlohy splatné při vstupu; úloha, která běží
+  // déle než její perioda, tak nezablokuje ostatní ani WiFi stack.
+  const uint32_t passStart = millis();
+  for (;;) {
+    if (g_schedHeapSize == 0) return SCHED_MAX_SLEEP_MS;
+
+    uint8_t  id  = g_schedHeap[0];
+    uint32_t now = millis();
+    if (schedBefore(passStart, g_tasks[id].due)) {
+      if (!schedBefore(now, g_tasks[id].due)) return 0;
+      uint32_t wait = g_tasks[id].due - now;
+      return wait < SCHED_MAX_SLEEP_MS ? wait : SCHED_MAX_SLEEP_MS;
+    }
+
+    SchedTask &t    = g_tasks[id];
+    uint32_t   late = now - t.due;
+    if (late > t.maxLateMs) t.maxLateMs = late;
+    schedHeapRemove(id);
+
+    // Periodická úloha se vrací do haldy ještě před během, takže se
+    // může sama zrušit nebo přeplánovat. Termíny se neposouvají
+    // o dobu běhu; když úloha zaostane o celou periodu, vynechá se.
+    if (t.periodMs) {
+      t.due += t.periodMs;
+      if (!schedBefore(now, t.due)) t.due = now + t.periodMs;
+      schedHeapPush(id);
+    }
+
+    uint32_t start = micros();
+    t.fn();
+    uint32_t took = micros() - start;
+
+    t.runs++;
+    t.totalUs += took;
+    if (took > t.maxUs) t.maxUs = took;
+    g_schedStats.tasksRun++;
+    g_schedStats.busyUs += took;
+
+    // Jednorázová úloha se uvolní, pokud se během sama znovu nenaplánovala
+    if (!t.periodMs && t.heapPos == SCHED_NONE) t.used = false;
+  }
+}
+
+/**
+ * @brief Jeden průchod loop(): spustí úlohy na řadě a uspí se do další.
+ *        delay() na ESP8266 předává řízení WiFi stacku a async serveru.
+ */
+static inline void schedulerLoop() {
+  uint32_t start   = micros();
+  uint32_t sleepMs = schedulerRunDue();
+  metricsLoopPass(micros() - start);
+  g_schedStats.sleptMs += sleepMs;
+  delay(sleepMs);
+}
+
+#endif // FARM_HUB_SCHEDULER_H
@@ -0,0 +1,57 @@
+#ifndef FARM_HUB_TIME_H
+#define FARM_HUB_TIME_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "FarmHubConfig.h"
+#include "FarmHubData.h"
+#include "FarmHubRollup.h"
+#include "FarmHubScheduler.h"
+
+// ------------------------------------------------------------
+// Čas hubu
+//
+// startTimeSync() jen nastaví NTP (SNTP v SDK se ptá na pozadí a sám
+// opakuje), start hubu na něj nečeká. Do synchronizace vrací hubNow()
+// prozatímní čas = sekundy od startu; ten dostanou i uzly (MSG_TIME),
+// takže jejich měření jsou ve stejné časové ose a po synchronizaci se
+// dají opravit přičtením epochy startu hubu.
+// ------------------------------------------------------------
+
+static const uint32_t TIME_SYNC_POLL_MS = 1000;
+
+static bool     g_timeSynced   = false;
+static uint32_t g_bootEpoch    = 0;   // epoch okamžiku startu (po synchronizaci)
+static uint32_t g_timeSyncedMs = 0;   // millis() synchronizace
+static uint8_t  g_timeSyncTask = SCHED_NONE;
+
+static inline uint32_t hubNow() {
+  return g_timeSynced ? (uint32_t)time(nullptr) : millis() / 1000;
+}
+
+static inline void timeSyncPoll() {
+  time_t now = time(nullptr);
+  if (now < (time_t)ROLLUP_MIN_EPOCH) return;
+
+  g_timeSynced   = true;
+  g_timeSyncedMs = millis();
+  g_bootEpoch    = (uint32_t)now - g_timeSyncedMs / 1000;
+  schedulerCancel(g_timeSyncTask);
+  g_timeSyncTask = SCHED_NONE;
+
+  char buf[32];
+  Serial.printf("Time synced after %lu s: %s\n", (unsigned long)(g_timeSyncedMs / 1000),
+                formatEpochTime((unsigned long)now, buf, sizeof(buf)));
+  correctProvisionalReadings(g_bootEpoch);
+  broadcastTime();   // uzly přejdou z prozatímního času na skutečný
+}
+
+// Nastaví NTP a začne hlídat synchronizaci (neblokuje)
+static inline void startTimeSync() {
+  configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
+  if (g_timeSyncTask == SCHED_NONE && !g_timeSynced) {
+    g_timeSyncTask = schedulerEvery("timeSync", timeSyncPoll, TIME_SYNC_POLL_MS);
+  }
+}
+
+#endif // FARM_HUB_TIME_H
@@ -4,16 +4,23 @@
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
 #include <time.h>
+#include <vector>
 #include "FarmHubWiFi.h"
 #include "FarmHubConfig.h"
 #include "FarmHubData.h"
+#include "FarmHubIrrigation.h"
+#include "FarmHubLight.h"
+#include "FarmHubPage.h"
+#include "FarmHubAssets.h"
+#include "FarmHubMetrics.h"
+#include "FarmHubScheduler.h"
+#include "FarmHubTime.h"
 
 
 
 extern bool autoWatering;
 extern float moistureThreshold;
 extern int waterAmountML;
-extern std::vector<SensorReading> dataBuffer;
 
 // Vytvoříme statický server na portu 80
 static AsyncWebServer server(80);
@@ -28,35 +35,14 @@ static const char PAGE_HEAD[] PROGMEM = R"rawliteral(
 <head>
   <meta charset="utf-8">
   <meta name="viewport" content="width=device-width,initial-scale=1.0">
-  <title>%TITLE%</title>
-  <style>
-    body{font-family:sans-serif;margin:0;padding:0;background:#f0f0f0;}
-    .navbar{position:fixed;top:0;left:0;width:100%;background:#4CAF50;padding:10px 20px;box-sizing:border-box;z-index:999;}
-    .navbar a{color:#fff;text-decoration:none;margin-right:20px;font-weight:bold;padding:6px 12px;border-radius:4px;transition:background 0.3s;}
-    .navbar a:hover{background:#45a049;}
-    .container{max-width:1000px;margin:80px auto 20px auto;padding:20px;background:#fff;border-radius:8px;box-shadow:0 0 6px rgba(0,0,0,0.1);}
-    h1{margin-top:0; margin-bottom:0.5em;}
-    h3{margin-top:1.2em; margin-bottom:0.5em;}
-    p{margin:0.8em 0; line-height:1.4;}
-    hr{margin:1.5em 0; border:none; border-top:1px solid #ddd;}
-    .btn{background:#4CAF50;color:#fff;padding:6px 12px;border:none;cursor:pointer;border-radius:4px;}
-    .btn:hover{background:#45a049;}
-    .table-container{width:100%;overflow-x:auto;margin-top:10px;}
-    table{border-collapse:collapse;min-width:600px;width:100%;}
-    th,td{border:1px solid #ccc;padding:6px;text-align:left;}
-    th{background:#f9f9f9;}
-    .form-group{margin-bottom:1em;}
-    label{font-weight:bold;display:block;margin-bottom:0.3em;}
-    input[type='text'],input[type='password'],input[type='number'],select{
-      width:100%;max-width:300px;padding:6px;margin-bottom:0.5em;box-sizing:border-box;border:1px solid #ccc;border-radius:4px;
-    }
-    .chart-container{
-      width:100%;
-      max-width:600px;
-      height:300px;
-      margin-bottom:30px;
-    }
-  </style>
+  <title>)rawliteral";
+
+/**
+ * Za PAGE_HEAD se vloží titulek stránky, pak pokračuje PAGE_HEAD_BODY
+ * (zbytek <head>, navigace a otevření <h1>).
+ */
+static const char PAGE_HEAD_BODY[] PROGMEM = R"rawliteral(</title>
+  <link rel="stylesheet" href="/static/style.css?v=)rawliteral" ASSET_STYLE_CSS_ETAG R"rawliteral(">
 </head>
 <body>
   <nav class="navbar">
@@ -66,6 +52,7 @@ static const char PAGE_HEAD[] PROGMEM = R"rawliteral(
     <a href="/wifi">Nastavení Wi-Fi</a>
     <a href="/watering">Zalévání</a>
     <a href="/lighting">Svícení</a>
+    <a href="/sensors">Senzory</a>
   </nav>
   <div class="container">
   <h1>
@@ -88,173 +75,608 @@ static const char PAGE_FOOTER[] PROGMEM = R"rawliteral(
 )rawliteral";
 
 /**
- * Volitelný JavaScript pro Chart.js. (Můžete dát i do externího .js)
+ * Skript pro grafy (web/charts.js) – servíruje se gzipem z flash a cachuje
+ * se v prohlížeči, stránka /charts tak nepotřebuje internet.
  */
-static const char CHART_JS[] PROGMEM = R"rawliteral(
-<script src="https://cdn.jsdelivr.net/npm/chart.js"></script>
-<script>
-function formatTimeFromSeconds(epochSec) {
-  const dt = new Date(epochSec * 1000); // epochSec je v sekundách, Date potřebuje ms
-  const h = String(dt.getHours()).padStart(2, '0');
-  const m = String(dt.getMinutes()).padStart(2, '0');
-  const s = String(dt.getSeconds()).padStart(2, '0');
-  return h + ':' + m + ':' + s;
+static const char CHART_JS[] PROGMEM =
+  "<script src='/static/charts.js?v=" ASSET_CHARTS_JS_ETAG "'></script>";
+
+// Statický soubor z FarmHubAssets.h (gzip, silný ETag, dlouhá cache).
+// Odkazy ze stránek obsahují ?v=ETag, takže se soubor při změně firmwaru
+// stáhne znovu; jinak prohlížeč při revalidaci dostane jen 304.
+static inline void sendStaticAsset(AsyncWebServerRequest *request, const StaticAsset &asset) {
+  char etag[20];
+  snprintf(etag, sizeof(etag), "\"%s\"", asset.etag);
+
+  if (request->hasHeader("If-None-Match") &&
+      request->getHeader("If-None-Match")->value() == etag) {
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "public, max-age=31536000, immutable");
+    request->send(response);
+    return;
+  }
+
+  AsyncWebServerResponse *response =
+    request->beginResponse_P(200, asset.contentType, asset.data, asset.length);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", etag);
+  response->addHeader("Cache-Control", "public, max-age=31536000, immutable");
+  request->send(response);
 }
-function drawSoilChart(labels, dataSoil) {
-  const ctxSoil = document.getElementById('chartSoil').getContext('2d');
-  new Chart(ctxSoil, {
-    type: 'line',
-    data: {
-      labels: labels,
-      datasets: [{
-        label: 'Soil Moisture (%)',
-        data: dataSoil,
-        borderColor: 'rgba(75, 192, 192, 1)',
-        backgroundColor: 'rgba(75, 192, 192, 0.2)',
-        tension: 0.1
-      }]
-    },
-    options: {
-      responsive: true,
-      maintainAspectRatio: false,
-      scales: {
-        x: {
-          type: 'linear',
-          title: { display: true, text: 'Čas' },
-          ticks: {
-            // value je číslo z "labels" (epoch time v sekundách)
-            callback: function(value, index, ticks) {
-              return formatTimeFromSeconds(value);
-            }
-          }
-        },
-        y: { suggestedMin: 0, suggestedMax: 100 }
-      }
-    }
-  });
+
+// Sítě ze skenu na stránce /wifi (snapshot po 33 B na SSID)
+static const uint8_t WIFI_PAGE_MAX_NETWORKS = 16;
+
+// Odeslání obsahu vykresleného přes PageWriter jako chunked odpověď
+static inline void sendRendered(AsyncWebServerRequest *request, const char *contentType,
+                                PageRenderer render) {
+  AsyncWebServerResponse *response = request->beginChunkedResponse(contentType,
+    [render](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      PageWriter w(buffer, maxLen, index);
+      render(w);
+      return w.length();
+    });
+  request->send(response);
 }
-function drawTempChart(labels, dataTemp) {
-  const ctxTemp = document.getElementById('chartTemp').getContext('2d');
-  new Chart(ctxTemp, {
-    type: 'line',
-    data: {
-      labels: labels,
-      datasets: [{
-        label: 'Temperature (°C)',
-        data: dataTemp,
-        borderColor: 'rgba(255, 99, 132, 1)',
-        backgroundColor: 'rgba(255, 99, 132, 0.2)',
-        tension: 0.1
-      }]
-    },
-    options: {
-      responsive: true,
-      maintainAspectRatio: false,
-      scales: {
-        x: {
-          type: 'linear',
-          title: { display: true, text: 'Čas' },
-          ticks: {
-            callback: function(value, index, ticks) {
-              return formatTimeFromSeconds(value);
-            }
-          }
-        }
-      }
-    }
+
+// Odeslání HTML stránky po částech (hlavička + render + patička)
+static inline void sendPage(AsyncWebServerRequest *request, const char *title, PageRenderer render) {
+  sendRendered(request, "text/html", [title, render](PageWriter &w) {
+    w.print(FPSTR(PAGE_HEAD));
+    w.print(title);
+    w.print(FPSTR(PAGE_HEAD_BODY));
+    w.print(title);
+    w.print(FPSTR(PAGE_HEAD_END));
+    if (!w.done()) render(w);
+    w.print(FPSTR(PAGE_FOOTER));
   });
 }
-function drawHumChart(labels, dataHum) {
-  const ctxHum = document.getElementById('chartHum').getContext('2d');
-  new Chart(ctxHum, {
-    type: 'line',
-    data: {
-      labels: labels,
-      datasets: [{
-        label: 'Humidity (%)',
-        data: dataHum,
-        borderColor: 'rgba(54, 162, 235, 1)',
-        backgroundColor: 'rgba(54, 162, 235, 0.2)',
-        tension: 0.1
-      }]
-    },
-    options: {
-      responsive: true,
-      maintainAspectRatio: false,
-      scales: {
-        x: {
-          type: 'linear',
-          title: { display: true, text: 'Čas' },
-          ticks: {
-            callback: function(value, index, ticks) {
-              return formatTimeFromSeconds(value);
-            }
-          }
-        },
-        y: { suggestedMin: 0, suggestedMax: 100 }
+
+// Rozsahy grafů – úroveň rollupu a počet bucketů
+struct ChartRange {
+  const char *name;   // PROGMEM
+  const char *label;  // PROGMEM
+  uint8_t     tier;
+  uint16_t    points;
+};
+
+static const char CHART_NAME_HOUR[]   PROGMEM = "hour";
+static const char CHART_NAME_DAY[]    PROGMEM = "day";
+static const char CHART_NAME_WEEK[]   PROGMEM = "week";
+static const char CHART_NAME_MONTH[]  PROGMEM = "month";
+static const char CHART_LABEL_HOUR[]  PROGMEM = "Hodina";
+static const char CHART_LABEL_DAY[]   PROGMEM = "Den";
+static const char CHART_LABEL_WEEK[]  PROGMEM = "Týden";
+static const char CHART_LABEL_MONTH[] PROGMEM = "Měsíc";
+
+static const uint8_t CHART_RANGE_HOUR  = 0;
+static const uint8_t CHART_RANGE_DAY   = 1;
+static const uint8_t CHART_RANGE_COUNT = 4;
+static const ChartRange CHART_RANGES[CHART_RANGE_COUNT] = {
+  { CHART_NAME_HOUR,  CHART_LABEL_HOUR,  ROLLUP_MINUTE, 60  },
+  { CHART_NAME_DAY,   CHART_LABEL_DAY,   ROLLUP_HOUR,   24  },
+  { CHART_NAME_WEEK,  CHART_LABEL_WEEK,  ROLLUP_HOUR,   168 },
+  { CHART_NAME_MONTH, CHART_LABEL_MONTH, ROLLUP_DAY,    31  },
+};
+
+static inline uint8_t chartRangeFromName(const char *name) {
+  for (uint8_t r = 0; r < CHART_RANGE_COUNT; r++) {
+    if (strcmp_P(name, CHART_RANGES[r].name) == 0) return r;
+  }
+  return CHART_RANGE_DAY;
+}
+
+// Úroveň rollupu pro požadovaný krok v sekundách (nejjemnější, která stačí)
+static inline uint8_t rollupTierForStep(uint32_t step) {
+  for (uint8_t t = 0; t < ROLLUP_TIERS; t++) {
+    if (ROLLUP_PERIOD[t] >= step) return t;
+  }
+  return ROLLUP_TIERS - 1;
+}
+
+// Série jednoho kanálu pro /api/series – kopie kanálu pořízená při requestu,
+// aby se data během odesílání po částech neměnila
+struct SeriesSnapshot {
+  RollupChannel channel;
+  uint8_t       tier;
+  uint32_t      fromTs;
+  uint32_t      toTs;
+};
+
+// Sloupcový JSON: {"sensor":..,"channel":..,"step":..,"t":[],"min":[],"max":[],"avg":[],"n":[]}
+static inline void writeSeriesJson(PageWriter &w, const SeriesSnapshot &snap) {
+  const RollupChannel &ch = snap.channel;
+  w.print(F("{\"sensor\":\""));
+  w.print(sensorIdName(ch.sensorId));
+  w.print(F("\",\"channel\":\""));
+  w.print(FIELD_NAMES[ch.field]);
+  w.print(F("\",\"step\":"));
+  w.printUInt(ROLLUP_PERIOD[snap.tier]);
+
+  static const char *const COLUMNS[] = { "t", "min", "max", "avg", "n" };
+  for (uint8_t col = 0; col < 5; col++) {
+    w.print(F(",\""));
+    w.print(COLUMNS[col]);
+    w.print(F("\":["));
+    bool first = true;
+    for (int age = (int)ROLLUP_BUCKETS[snap.tier] - 1; age >= 0; age--) {
+      RollupPoint pt;
+      if (!rollupGet(&ch, snap.tier, (uint16_t)age, pt)) continue;
+      if (pt.start < snap.fromTs || pt.start > snap.toTs) continue;
+      if (!first) w.print(F(","));
+      first = false;
+      switch (col) {
+        case 0: w.printUInt(pt.start);  break;
+        case 1: w.printFloat(pt.minV);  break;
+        case 2: w.printFloat(pt.maxV);  break;
+        case 3: w.printFloat(pt.avgV);  break;
+        case 4: w.printUInt(pt.count);  break;
       }
     }
-  });
+    w.print(F("]"));
+  }
+  w.print(F("}"));
 }
-function drawLightChart(labels, dataLight) {
-  const ctxLight = document.getElementById('chartLight').getContext('2d');
-  new Chart(ctxLight, {
-    type: 'line',
-    data: {
-      labels: labels,
-      datasets: [{
-        label: 'Light',
-        data: dataLight,
-        borderColor: 'rgba(255, 206, 86, 1)',
-        backgroundColor: 'rgba(255, 206, 86, 0.2)',
-        tension: 0.1
-      }]
-    },
-    options: {
-      responsive: true,
-      maintainAspectRatio: false,
-      scales: {
-        x: {
-          type: 'linear',
-          title: { display: true, text: 'Čas' },
-          ticks: {
-            callback: function(value, index, ticks) {
-              return formatTimeFromSeconds(value);
-            }
-          }
+
+// Ohlášení senzoru bez hodnot (nezobrazuje se)
+static inline bool isEmptyReading(const SensorReading &d) {
+  return d.fields == 0;
+}
+
+// ------------------------------------------------------------
+// Streamování záznamů z logu do chunked odpovědi
+//
+// Záznamy se formátují po jednom do malého bufferu a kopírují do
+// odesílacího bufferu AsyncWebServeru, celý výsledek se nikdy nedrží v RAM.
+// ------------------------------------------------------------
+typedef size_t (*LogRecordFormatter)(const LogRecord &rec, char *buf, size_t len);
+
+struct LogStreamState {
+  LogCursor          cursor;
+  LogRecordFormatter format;
+  uint8_t            sensorFilter;  // SENSOR_ID_UNKNOWN = všechny senzory
+  const char        *separator;     // mezi záznamy (JSON pole: ",")
+  const char        *suffix;
+  bool               first;
+  bool               finished;
+  char               line[192];
+  size_t             lineLen;
+  size_t             linePos;
+};
+
+// Kolik záznamů max. projít v jednom volání (aby filtr neblokoval síť)
+static const uint16_t LOG_STREAM_SCAN_LIMIT = 256;
+
+static inline void beginLogStream(LogStreamState &st, uint32_t fromTs, uint32_t toTs,
+                                  uint8_t sensorFilter, LogRecordFormatter format,
+                                  const char *prefix, const char *separator,
+                                  const char *suffix) {
+  logCursorBegin(st.cursor, fromTs, toTs);
+  st.format       = format;
+  st.sensorFilter = sensorFilter;
+  st.separator    = separator;
+  st.suffix       = suffix;
+  st.first        = true;
+  st.finished     = false;
+  strncpy(st.line, prefix, sizeof(st.line) - 1);
+  st.line[sizeof(st.line) - 1] = 0;
+  st.lineLen = strlen(st.line);
+  st.linePos = 0;
+}
+
+static inline size_t fillLogStream(LogStreamState &st, uint8_t *buffer, size_t maxLen) {
+  size_t   out     = 0;
+  uint16_t scanned = 0;
+  while (out < maxLen) {
+    if (st.linePos >= st.lineLen) {
+      if (st.finished) break;
+      LogRecord rec;
+      bool found = false;
+      while (scanned < LOG_STREAM_SCAN_LIMIT && logCursorNext(st.cursor, rec)) {
+        scanned++;
+        if (st.sensorFilter == SENSOR_ID_UNKNOWN || rec.sensorId == st.sensorFilter) {
+          found = true;
+          break;
         }
       }
+      if (found) {
+        size_t sep = st.first ? 0 : strlen(st.separator);
+        memcpy(st.line, st.separator, sep);
+        st.lineLen = sep + st.format(rec, st.line + sep, sizeof(st.line) - sep);
+        st.first   = false;
+      } else if (scanned >= LOG_STREAM_SCAN_LIMIT) {
+        // Pokračujeme v dalším volání
+        return out > 0 ? out : RESPONSE_TRY_AGAIN;
+      } else {
+        logCursorEnd(st.cursor);
+        st.finished = true;
+        st.lineLen  = strlen(st.suffix);
+        memcpy(st.line, st.suffix, st.lineLen);
+      }
+      st.linePos = 0;
     }
-  });
+    size_t n = std::min(st.lineLen - st.linePos, maxLen - out);
+    memcpy(buffer + out, st.line + st.linePos, n);
+    st.linePos += n;
+    out        += n;
+  }
+  return out;
+}
+
+static inline void sendLogStream(AsyncWebServerRequest *request, const char *contentType,
+                                 std::shared_ptr<LogStreamState> st) {
+  AsyncWebServerResponse *response = request->beginChunkedResponse(contentType,
+    [st](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      return fillLogStream(*st, buffer, maxLen);
+    });
+  request->send(response);
+}
+
+// ------------------------------------------------------------
+// Metriky: /metrics (Prometheus text) a /metrics?format=json
+//
+// Všechny hodnoty se zkopírují při requestu a odpověď se pak generuje
+// po částech ze snapshotu. Doby jsou v µs, pokud název neříká jinak.
+// ------------------------------------------------------------
+struct MetricsSnapshot {
+  HubMetrics     hub;
+  SchedTask      tasks[SCHED_MAX_TASKS];
+  SchedStats     sched;
+  PumpStats      pump;
+  IrrigationZone zones[IRRIGATION_MAX_ZONES];
+  uint8_t        zoneCount;
+  uint32_t       uptimeMs;
+  uint32_t       freeHeap;
+  uint32_t       maxFreeBlock;
+  uint8_t        heapFragmentation;  // %
+  uint32_t       logBytes;
+  uint8_t        rollupChannels;
+  uint32_t       rollupDropped;
+};
+
+static inline std::shared_ptr<MetricsSnapshot> takeMetricsSnapshot() {
+  std::shared_ptr<MetricsSnapshot> m = std::make_shared<MetricsSnapshot>();
+  m->hub   = g_metrics;
+  memcpy(m->tasks, g_tasks, sizeof(g_tasks));
+  m->sched = g_schedStats;
+  m->pump  = g_pumpStats;
+  memcpy(m->zones, g_zones, sizeof(g_zones));
+  m->zoneCount         = g_zoneCount;
+  m->uptimeMs          = millis();
+  m->freeHeap          = ESP.getFreeHeap();
+  m->maxFreeBlock      = ESP.getMaxFreeBlockSize();
+  m->heapFragmentation = ESP.getHeapFragmentation();
+  m->logBytes          = logUsedBytes();
+  m->rollupChannels    = g_rollupCount;
+  m->rollupDropped     = g_rollupDropped;
+  return m;
 }
-</script>
-)rawliteral";
 
-// Vytvoření HTML hlavičky
-String makeHtmlHeader(const String &title) {
-    String html;
-    html.reserve(2048);
+static const char *const LATENCY_SUFFIX[3] = { "_count", "_sum", "_max" };
 
-    // 1) Načteme z PROGMEM úvod HTML s <head> a CSS
-    html = FPSTR(PAGE_HEAD);
+static inline unsigned long long latencyPart(const LatencyStat &s, uint8_t part) {
+  return part == 0 ? s.count : (part == 1 ? s.totalUs : s.maxUs);
+}
 
-    // 2) Nahradíme %TITLE% v textu skutečným `title`
-    html.replace("%TITLE%", title);
+// Jeden řádek Prometheus formátu: name[suffix][{key="val"}] value
+static inline void promName(PageWriter &w, const __FlashStringHelper *name, const char *suffix,
+                            const char *key, const char *val) {
+  w.print(name);
+  if (suffix) w.print(suffix);
+  if (key) {
+    w.print("{");
+    w.print(key);
+    w.print("=\"");
+    w.print(val);
+    w.print("\"}");
+  }
+  w.print(" ");
+}
 
-    // 3) Pak doplníme text do <h1> (část je už v PAGE_HEAD)
-    html += title;
+static inline void promLine(PageWriter &w, const __FlashStringHelper *name, const char *suffix,
+                            const char *key, const char *val, unsigned long long v) {
+  promName(w, name, suffix, key, val);
+  w.printULL(v);
+  w.print("\n");
+}
 
-    // 4) Vložíme pokračování (uzavření <h1>)
-    html += FPSTR(PAGE_HEAD_END);
+static inline void promGauge(PageWriter &w, const __FlashStringHelper *name,
+                             const char *key, const char *val, float v) {
+  promName(w, name, nullptr, key, val);
+  w.printFloat(v, 3);
+  w.print("\n");
+}
 
-    return html;
+static inline void promLatency(PageWriter &w, const __FlashStringHelper *name, const LatencyStat &s) {
+  for (uint8_t part = 0; part < 3; part++) {
+    promLine(w, name, LATENCY_SUFFIX[part], nullptr, nullptr, latencyPart(s, part));
+  }
 }
 
-/**
- * Funkce, která vrátí základní HTML patičku (uloženou v PROGMEM).
- */
-String makeHtmlFooter() {
-    return FPSTR(PAGE_FOOTER);
+static inline void writeMetricsProm(PageWriter &w, const MetricsSnapshot &m) {
+  const HubMetrics &h = m.hub;
+  char label[12];
+
+  promLine(w, F("farmhub_uptime_seconds"), nullptr, nullptr, nullptr, m.uptimeMs / 1000);
+  promLine(w, F("farmhub_heap_free_bytes"), nullptr, nullptr, nullptr, m.freeHeap);
+  promLine(w, F("farmhub_heap_max_block_bytes"), nullptr, nullptr, nullptr, m.maxFreeBlock);
+  promLine(w, F("farmhub_heap_fragmentation_percent"), nullptr, nullptr, nullptr, m.heapFragmentation);
+
+  // Průchod loop()
+  w.print(F("# TYPE farmhub_loop_microseconds histogram\n"));
+  uint32_t cumulative = 0;
+  for (uint8_t b = 0; b < METRICS_LOOP_BUCKETS; b++) {
+    cumulative += h.loopHist[b];
+    if (b < METRICS_LOOP_BUCKETS - 1) {
+      snprintf(label, sizeof(label), "%lu", (unsigned long)METRICS_LOOP_BOUNDS_US[b]);
+    } else {
+      strcpy(label, "+Inf");
+    }
+    promLine(w, F("farmhub_loop_microseconds"), "_bucket", "le", label, cumulative);
+  }
+  promLine(w, F("farmhub_loop_microseconds"), "_sum", nullptr, nullptr, h.loop.totalUs);
+  promLine(w, F("farmhub_loop_microseconds"), "_count", nullptr, nullptr, h.loop.count);
+  promLine(w, F("farmhub_loop_max_microseconds"), nullptr, nullptr, nullptr, h.loop.maxUs);
+  promLine(w, F("farmhub_scheduler_wakeups_total"), nullptr, nullptr, nullptr, m.sched.wakeups);
+  promLine(w, F("farmhub_scheduler_sleep_milliseconds_total"), nullptr, nullptr, nullptr, m.sched.sleptMs);
+
+  // Úlohy plánovače
+  for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+    if (m.tasks[i].used) promLine(w, F("farmhub_task_runs_total"), nullptr, "task", m.tasks[i].name, m.tasks[i].runs);
+  }
+  for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+    if (m.tasks[i].used) promLine(w, F("farmhub_task_microseconds_total"), nullptr, "task", m.tasks[i].name, m.tasks[i].totalUs);
+  }
+  for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+    if (m.tasks[i].used) promLine(w, F("farmhub_task_max_microseconds"), nullptr, "task", m.tasks[i].name, m.tasks[i].maxUs);
+  }
+  for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+    if (m.tasks[i].used) promLine(w, F("farmhub_task_max_late_milliseconds"), nullptr, "task", m.tasks[i].name, m.tasks[i].maxLateMs);
+  }
+
+  // WebSocket
+  promLine(w, F("farmhub_ws_clients"), nullptr, nullptr, nullptr, h.wsClients);
+  promLine(w, F("farmhub_ws_rejected_total"), nullptr, nullptr, nullptr, h.wsRejected);
+  promLine(w, F("farmhub_ws_in_bytes_total"), nullptr, nullptr, nullptr, h.wsBytesIn);
+  for (uint8_t n = 0; n < NODE_COUNT; n++) {
+    promLine(w, F("farmhub_ws_messages_in_total"), nullptr, "node", farmNodeName(n), h.wsIn[n]);
+  }
+  for (uint8_t n = 0; n < NODE_COUNT; n++) {
+    promLine(w, F("farmhub_ws_messages_out_total"), nullptr, "node", farmNodeName(n), h.wsOut[n]);
+  }
+  for (uint8_t n = 0; n < NODE_COUNT; n++) {
+    promGauge(w, F("farmhub_ws_messages_in_per_second"), "node", farmNodeName(n), h.wsInRate[n]);
+  }
+  for (uint8_t n = 0; n < NODE_COUNT; n++) {
+    promGauge(w, F("farmhub_ws_messages_out_per_second"), "node", farmNodeName(n), h.wsOutRate[n]);
+  }
+
+  // Parsování JSON a zápis do logu
+  promLatency(w, F("farmhub_json_parse_microseconds"), h.jsonParse);
+  promLine(w, F("farmhub_json_parse_errors_total"), nullptr, nullptr, nullptr, h.jsonErrors);
+  promLatency(w, F("farmhub_log_append_microseconds"), h.logAppend);
+  promLine(w, F("farmhub_log_bytes"), nullptr, nullptr, nullptr, m.logBytes);
+  promLine(w, F("farmhub_rollup_channels"), nullptr, nullptr, nullptr, m.rollupChannels);
+  promLine(w, F("farmhub_rollup_dropped_total"), nullptr, nullptr, nullptr, m.rollupDropped);
+
+  // HTTP handlery
+  for (uint8_t part = 0; part < 3; part++) {
+    for (uint8_t i = 0; i < h.routeCount; i++) {
+      promLine(w, F("farmhub_http_handler_microseconds"), LATENCY_SUFFIX[part], "route",
+               h.routes[i].path, latencyPart(h.routes[i].latency, part));
+    }
+  }
+
+  // Čerpadla a zóny
+  promLine(w, F("farmhub_pump_commands_total"), nullptr, "result", "issued", m.pump.issued);
+  promLine(w, F("farmhub_pump_commands_total"), nullptr, "result", "acked", m.pump.acked);
+  promLine(w, F("farmhub_pump_commands_total"), nullptr, "result", "expired", m.pump.expired);
+  promLine(w, F("farmhub_pump_commands_total"), nullptr, "result", "completed", m.pump.completed);
+  promLine(w, F("farmhub_pump_transmissions_total"), nullptr, nullptr, nullptr, m.pump.transmissions);
+  promLine(w, F("farmhub_pump_ack_latency_milliseconds"), nullptr, nullptr, nullptr, m.pump.lastLatencyMs);
+  for (uint8_t i = 0; i < m.zoneCount; i++) {
+    snprintf(label, sizeof(label), "%u", i);
+    promLine(w, F("farmhub_zone_state"), nullptr, "zone", label, m.zones[i].state);
+  }
+  for (uint8_t i = 0; i < m.zoneCount; i++) {
+    snprintf(label, sizeof(label), "%u", i);
+    promLine(w, F("farmhub_zone_runs_total"), nullptr, "zone", label, m.zones[i].runs);
+  }
+  for (uint8_t i = 0; i < m.zoneCount; i++) {
+    snprintf(label, sizeof(label), "%u", i);
+    promLine(w, F("farmhub_zone_duty_skips_total"), nullptr, "zone", label, m.zones[i].dutySkips);
+  }
+  for (uint8_t i = 0; i < m.zoneCount; i++) {
+    snprintf(label, sizeof(label), "%u", i);
+    promLine(w, F("farmhub_zone_duty_seconds"), nullptr, "zone", label, m.zones[i].dutySec);
+  }
+}
+
+// "key":{"count":..,"sumUs":..,"maxUs":..}
+static inline void jsonLatency(PageWriter &w, const __FlashStringHelper *key, const LatencyStat &s) {
+  w.print(key);
+  w.print(F("{\"count\":"));
+  w.printUInt(s.count);
+  w.print(F(",\"sumUs\":"));
+  w.printULL(s.totalUs);
+  w.print(F(",\"maxUs\":"));
+  w.printUInt(s.maxUs);
+  w.print("}");
+}
+
+static inline void writeMetricsJson(PageWriter &w, const MetricsSnapshot &m) {
+  const HubMetrics &h = m.hub;
+
+  w.print(F("{\"uptimeMs\":"));
+  w.printUInt(m.uptimeMs);
+  w.print(F(",\"heap\":{\"free\":"));
+  w.printUInt(m.freeHeap);
+  w.print(F(",\"maxBlock\":"));
+  w.printUInt(m.maxFreeBlock);
+  w.print(F(",\"fragPct\":"));
+  w.printUInt(m.heapFragmentation);
+
+  w.print(F("},\"loop\":{\"boundsUs\":["));
+  for (uint8_t b = 0; b < METRICS_LOOP_BUCKETS - 1; b++) {
+    if (b) w.print(",");
+    w.printUInt(METRICS_LOOP_BOUNDS_US[b]);
+  }
+  w.print(F("],\"hist\":["));
+  for (uint8_t b = 0; b < METRICS_LOOP_BUCKETS; b++) {
+    if (b) w.print(",");
+    w.printUInt(h.loopHist[b]);
+  }
+  w.print("],");
+  jsonLatency(w, F("\"pass\":"), h.loop);
+  w.print(F(",\"wakeups\":"));
+  w.printUInt(m.sched.wakeups);
+  w.print(F(",\"sleptMs\":"));
+  w.printUInt(m.sched.sleptMs);
+
+  w.print(F("},\"tasks\":["));
+  bool first = true;
+  for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) {
+    const SchedTask &t = m.tasks[i];
+    if (!t.used) continue;
+    if (!first) w.print(",");
+    first = false;
+    w.print(F("{\"name\":\""));
+    w.print(t.name);
+    w.print(F("\",\"runs\":"));
+    w.printUInt(t.runs);
+    w.print(F(",\"sumUs\":"));
+    w.printUInt(t.totalUs);
+    w.print(F(",\"maxUs\":"));
+    w.printUInt(t.maxUs);
+    w.print(F(",\"maxLateMs\":"));
+    w.printUInt(t.maxLateMs);
+    w.print("}");
+  }
+
+  w.print(F("],\"ws\":{\"clients\":"));
+  w.printUInt(h.wsClients);
+  w.print(F(",\"rejected\":"));
+  w.printUInt(h.wsRejected);
+  w.print(F(",\"bytesIn\":"));
+  w.printUInt(h.wsBytesIn);
+  w.print(F(",\"nodes\":["));
+  for (uint8_t n = 0; n < NODE_COUNT; n++) {
+    if (n) w.print(",");
+    w.print(F("{\"node\":\""));
+    w.print(farmNodeName(n));
+    w.print(F("\",\"in\":"));
+    w.printUInt(h.wsIn[n]);
+    w.print(F(",\"out\":"));
+    w.printUInt(h.wsOut[n]);
+    w.print(F(",\"inPerSec\":"));
+    w.printFloat(h.wsInRate[n], 3);
+    w.print(F(",\"outPerSec\":"));
+    w.printFloat(h.wsOutRate[n], 3);
+    w.print("}");
+  }
+  w.print("]},");
+
+  jsonLatency(w, F("\"jsonParse\":"), h.jsonParse);
+  w.print(F(",\"jsonErrors\":"));
+  w.printUInt(h.jsonErrors);
+  w.print(",");
+  jsonLatency(w, F("\"logAppend\":"), h.logAppend);
+  w.print(F(",\"logBytes\":"));
+  w.printUInt(m.logBytes);
+  w.print(F(",\"rollup\":{\"channels\":"));
+  w.printUInt(m.rollupChannels);
+  w.print(F(",\"dropped\":"));
+  w.printUInt(m.rollupDropped);
+  w.print("}");
+
+  w.print(F(",\"http\":["));
+  for (uint8_t i = 0; i < h.routeCount; i++) {
+    if (i) w.print(",");
+    w.print(F("{\"route\":\""));
+    w.print(h.routes[i].path);
+    w.print("\",");
+    jsonLatency(w, F("\"handler\":"), h.routes[i].latency);
+    w.print("}");
+  }
+
+  w.print(F("],\"pump\":{\"issued\":"));
+  w.printUInt(m.pump.issued);
+  w.print(F(",\"transmissions\":"));
+  w.printUInt(m.pump.transmissions);
+  w.print(F(",\"acked\":"));
+  w.printUInt(m.pump.acked);
+  w.print(F(",\"expired\":"));
+  w.printUInt(m.pump.expired);
+  w.print(F(",\"completed\":"));
+  w.printUInt(m.pump.completed);
+  w.print(F(",\"lastLatencyMs\":"));
+  w.printUInt(m.pump.lastLatencyMs);
+
+  w.print(F("},\"zones\":["));
+  for (uint8_t i = 0; i < m.zoneCount; i++) {
+    const IrrigationZone &z = m.zones[i];
+    if (i) w.print(",");
+    w.print(F("{\"sensor\":\""));
+    w.print(sensorIdName(z.sensorId));
+    w.print(F("\",\"pump\":"));
+    w.printUInt(z.pump);
+    w.print(F(",\"state\":\""));
+    w.print(zoneStateName(z.state));
+    w.print(F("\",\"runs\":"));
+    w.printUInt(z.runs);
+    w.print(F(",\"dutySec\":"));
+    w.printUInt(z.dutySec);
+    w.print(F(",\"dutySkips\":"));
+    w.printUInt(z.dutySkips);
+    w.print("}");
+  }
+  w.print("]}");
+}
+
+// Registrace routy s měřením doby handleru (latence podle routy v /metrics)
+// ------------------------------------------------------------
+// Okna svícení ve formulářích (zaškrtávátka d0..d6 = tm_wday)
+// ------------------------------------------------------------
+static inline uint8_t lightDaysFromRequest(AsyncWebServerRequest *request) {
+  uint8_t days = 0;
+  char name[3] = { 'd', '0', 0 };
+  for (uint8_t d = 0; d < 7; d++) {
+    name[1] = '0' + d;
+    if (request->hasParam(name, true)) days |= (1 << d);
+  }
+  return days;
+}
+
+static inline void writeLightDays(PageWriter &w, uint8_t days) {
+  w.print(F("<div class='form-group'><label>Dny:</label>"));
+  for (uint8_t i = 0; i < 7; i++) {
+    uint8_t d = LIGHT_DAY_ORDER[i];
+    w.print(F("<label><input type='checkbox' name='d"));
+    w.printUInt(d);
+    w.print(F("' value='1'"));
+    if (days & (1 << d)) w.print(F(" checked"));
+    w.print(F("> "));
+    w.print(LIGHT_DAY_NAMES[d]);
+    w.print(F("</label> "));
+  }
+  w.print(F("</div>"));
+}
+
+static inline void writeHourMinute(PageWriter &w, uint8_t h, uint8_t m) {
+  char buf[8];  // i 255:255 z poškozeného configu
+  snprintf(buf, sizeof(buf), "%02u:%02u", h, m);
+  w.print(buf);
+}
+
+static inline void onRoute(const char *path, WebRequestMethodComposite method,
+                           ArRequestHandlerFunction handler) {
+  RouteMetric *metric = metricsRoute(path);
+  server.on(path, method, [metric, handler](AsyncWebServerRequest *request) {
+    uint32_t start = micros();
+    handler(request);
+    if (metric) latencyRecord(metric->latency, micros() - start);
+  });
 }
 
 // ------------------------------------------------------------
@@ -264,347 +686,421 @@ static inline void startAsyncWebServer() {
 
     // Hlavní stránka "/"
     // ==================================================
-    server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
-      String html = makeHtmlHeader("FarmHub - Přehled");
-
-      // Zobrazení stavu AP
-      html += "<p>AP SSID: <strong>" + String(AP_SSID) + "</strong>, "
-              "heslo: <strong>" + String(AP_PASS) + "</strong></p>";
-      html += "<p>AP IP: <strong>" + WiFi.softAPIP().toString() + "</strong></p>";
-
-      // Zobrazení stavu STA (domácí Wi-Fi)
-      if(WiFi.status() == WL_CONNECTED) {
-        html += "<p><strong>Připojeno k domácí síti:</strong> "
-                + homeSsid + " (IP: " + WiFi.localIP().toString() + ")</p>";
-      } else {
-        html += "<p><strong>Nepřipojeno k domácí Wi-Fi.</strong></p>";
-      }
-
-      // Najdeme poslední data senzorů (soilDHT a light)
-      SensorReading lastSoilDHT;
-      bool foundSoilDHT = false;
-      SensorReading lastLight;
-      bool foundLight   = false;
-
-      for (int i = dataBuffer.size() - 1; i >= 0; i--) {
-        const auto &d = dataBuffer[i];
-        if (!foundSoilDHT && d.sensorID == "soilDHTsensor") {
-          lastSoilDHT = d;
-          foundSoilDHT = true;
-        }
-        if (!foundLight && d.sensorID == "lightsensor") {
-          lastLight = d;
-          foundLight = true;
+    onRoute("/", HTTP_GET, [](AsyncWebServerRequest *request){
+      // Stránka se posílá po částech a každá část ji vykreslí znovu,
+      // všechno proměnlivé (měření, čas, stav sítě) si proto zafixujeme
+      struct OverviewSnapshot {
+        SensorReading soil;
+        SensorReading light;
+        bool          hasSoil;
+        bool          hasLight;
+        bool          staOk;
+        HomeWifiState staState;
+        IPAddress     apIP;
+        IPAddress     staIP;
+        char          ssid[33];
+        bool          timeSynced;
+        uint32_t      now;
+        uint32_t      syncedMs;
+        uint32_t      freeHeap;
+      };
+      std::shared_ptr<OverviewSnapshot> os = std::make_shared<OverviewSnapshot>();
+      const SensorReading *soil  = getLatestReading(SENSOR_SOIL_DHT);
+      const SensorReading *light = getLatestReading(SENSOR_LIGHT);
+      os->hasSoil  = (soil != nullptr);
+      os->hasLight = (light != nullptr);
+      if (soil)  os->soil  = *soil;
+      if (light) os->light = *light;
+      os->staOk      = (WiFi.status() == WL_CONNECTED);
+      os->staState   = g_homeWifi;
+      os->apIP       = WiFi.softAPIP();
+      os->staIP      = WiFi.localIP();
+      strncpy(os->ssid, homeSsid.c_str(), sizeof(os->ssid) - 1);
+      os->ssid[sizeof(os->ssid) - 1] = 0;
+      os->timeSynced = g_timeSynced;
+      os->now        = hubNow();
+      os->syncedMs   = g_timeSyncedMs;
+      os->freeHeap   = ESP.getFreeHeap();
+
+      sendPage(request, "FarmHub - Přehled", [os](PageWriter &w) {
+        // Zobrazení stavu AP
+        w.print(F("<p>AP SSID: <strong>"));
+        w.print(AP_SSID);
+        w.print(F("</strong>, heslo: <strong>"));
+        w.print(AP_PASS);
+        w.print(F("</strong></p><p>AP IP: <strong>"));
+        w.printIP(os->apIP);
+        w.print(F("</strong></p>"));
+
+        // Zobrazení stavu STA (domácí Wi-Fi)
+        if (os->staOk) {
+          w.print(F("<p><strong>Připojeno k domácí síti:</strong> "));
+          w.printEscaped(os->ssid);
+          w.print(F(" (IP: "));
+          w.printIP(os->staIP);
+          w.print(F(")</p>"));
+        } else {
+          w.print(F("<p><strong>Nepřipojeno k domácí Wi-Fi</strong> ("));
+          w.print(homeWifiStateName(os->staState));
+          w.print(F(").</p>"));
         }
-        if (foundSoilDHT && foundLight) break;
-      }
 
-      html += "<hr><h3>Aktuální hodnoty</h3>";
-      html += "<div class='table-container'><table>";
-      html += "<tr><th>Půdní vlhkost (%)</th><th>Teplota (°C)</th><th>Vlhkost (%)</th><th>Světlo</th><th>Naposledy přijato</th></tr>";
-      html += "<tr>";
-
-      float soilVal = (foundSoilDHT ? lastSoilDHT.soilMoisture : 0.0);
-      float tempVal = (foundSoilDHT ? lastSoilDHT.temperature : 0.0);
-      float humVal  = (foundSoilDHT ? lastSoilDHT.humidity : 0.0);
-      float lightVal= (foundLight   ? lastLight.lightLevel : 0.0);
-
-      // Čas, který zobrazíme
-      unsigned long latestTs = 0;
-      if (foundSoilDHT) latestTs = lastSoilDHT.timestamp;
-      if (foundLight && lastLight.timestamp > latestTs) {
-        latestTs = lastLight.timestamp;
-      }
+        // Čas: NTP běží na pozadí, do té doby mají měření prozatímní čas
+        w.print(F("<p>Čas: "));
+        if (os->timeSynced) {
+          w.printTime(os->now);
+          w.print(F(" (NTP, synchronizováno "));
+          w.printUInt(os->syncedMs / 1000);
+          w.print(F(" s po startu)</p>"));
+        } else {
+          w.print(F("<strong>čeká na NTP</strong>, měření se opraví po synchronizaci</p>"));
+        }
 
-      html += "<td>" + String(soilVal)  + "</td>";
-      html += "<td>" + String(tempVal)  + "</td>";
-      html += "<td>" + String(humVal)   + "</td>";
-      html += "<td>" + String(lightVal) + "</td>";
-      if (latestTs > 0) {
-        html += "<td>" + formatEpochTime(latestTs) + "</td>";
-      } else {
-        html += "<td>N/A</td>";
-      }
-      html += "</tr></table></div>";
+        // Poslední data senzorů (soilDHT a light)
+        float soilVal = (os->hasSoil  ? os->soil.soilMoisture : 0.0);
+        float tempVal = (os->hasSoil  ? os->soil.temperature : 0.0);
+        float humVal  = (os->hasSoil  ? os->soil.humidity : 0.0);
+        float lightVal= (os->hasLight ? os->light.lightLevel : 0.0);
+
+        // Čas, který zobrazíme
+        unsigned long latestTs = 0;
+        if (os->hasSoil) latestTs = os->soil.timestamp;
+        if (os->hasLight && os->light.timestamp > latestTs) {
+          latestTs = os->light.timestamp;
+        }
 
-      // Zobrazíme volnou RAM (pro kontrolu)
-      html += "<p>Volné místo v RAM: " + String(ESP.getFreeHeap()) + " B</p>";
+        w.print(F("<hr><h3>Aktuální hodnoty</h3>"
+                  "<div class='table-container'><table>"
+                  "<tr><th>Půdní vlhkost (%)</th><th>Teplota (°C)</th><th>Vlhkost (%)</th><th>Světlo</th><th>Naposledy přijato</th></tr>"
+                  "<tr><td>"));
+        w.printFloat(soilVal);
+        w.print(F("</td><td>"));
+        w.printFloat(tempVal);
+        w.print(F("</td><td>"));
+        w.printFloat(humVal);
+        w.print(F("</td><td>"));
+        w.printFloat(lightVal);
+        w.print(F("</td><td>"));
+        if (latestTs > 0 && isProvisional(latestTs)) {
+          w.printUInt(latestTs);
+          w.print(F(" s po startu (čas se doplní)"));
+        } else if (latestTs > 0) {
+          w.printTime(latestTs);
+        } else {
+          w.print(F("N/A"));
+        }
+        w.print(F("</td></tr></table></div>"));
 
-      // Dokončíme stránku
-      html += makeHtmlFooter();
-      request->send(200, "text/html", html);
+        // Zobrazíme volnou RAM (pro kontrolu)
+        w.print(F("<p>Volné místo v RAM: "));
+        w.printUInt(os->freeHeap);
+        w.print(F(" B</p>"));
+      });
     });
 
-    // Stránka "/charts" - pouze grafy
+    // Stránka "/charts" - pouze grafy (z rollupů, ?range=hour|day|week|month)
     // ==================================================
-    server.on("/charts", HTTP_GET, [](AsyncWebServerRequest *request){
-      String html = makeHtmlHeader("FarmHub - Grafy");
-
-      if(WiFi.status() != WL_CONNECTED){
-        // Pokud není Wi-Fi, jen upozorníme, že grafy budou prázdné
-        html += "<p><strong>Není připojení k Wi-Fi, grafy se nemusí vykreslit.</strong></p>";
-      }
-
-      // Vložíme 4 plátna pro 4 grafy
-      html += "<hr><h3>Grafy senzorů</h3>";
-      html += "<div class='chart-container'><canvas id='chartSoil'></canvas></div>";
-      html += "<div class='chart-container'><canvas id='chartTemp'></canvas></div>";
-      html += "<div class='chart-container'><canvas id='chartHum'></canvas></div>";
-      html += "<div class='chart-container'><canvas id='chartLight'></canvas></div>";
-
-      // Vložíme kód pro Chart.js
-      html += FPSTR(CHART_JS);
-
-      // Připravíme data pro JavaScript
-      std::vector<float> soilTimes;
-      std::vector<float> soilValues;
-      std::vector<float> tempValues;
-      std::vector<float> humValues;
-      std::vector<float> lightTimes;
-      std::vector<float> lightValues;
-
-      // Projdeme celý dataBuffer a rozdělíme data podle sensorID
-      for (auto &d : dataBuffer) {
-        if(d.soilMoisture == 0 && d.temperature == 0 &&
-           d.humidity == 0 && d.lightLevel == 0) {
-          continue;
-        }
-        if(d.sensorID == "soilDHTsensor") {
-          soilTimes.push_back((float)d.timestamp);
-          soilValues.push_back(d.soilMoisture);
-          tempValues.push_back(d.temperature);
-          humValues.push_back(d.humidity);
-        }
-        else if(d.sensorID == "lightsensor") {
-          lightTimes.push_back((float)d.timestamp);
-          lightValues.push_back(d.lightLevel);
-        }
+    onRoute("/charts", HTTP_GET, [](AsyncWebServerRequest *request){
+      uint8_t range = CHART_RANGE_DAY;
+      if (request->hasParam("range")) {
+        range = chartRangeFromName(request->getParam("range")->value().c_str());
       }
 
-      // Omezení počtu bodů
-      auto keepLastN = [&](std::vector<float> &times,
-                           std::vector<float> &v1,
-                           std::vector<float> &v2,
-                           std::vector<float> &v3)
-      {
-        const size_t CHART_MAX_POINTS = 6; 
-        if(times.size() > CHART_MAX_POINTS) {
-          size_t startIndex = times.size() - CHART_MAX_POINTS;
-          times.erase(times.begin(), times.begin() + startIndex);
-          v1.erase(v1.begin(), v1.begin() + startIndex);
-          if(!v2.empty()) v2.erase(v2.begin(), v2.begin() + startIndex);
-          if(!v3.empty()) v3.erase(v3.begin(), v3.begin() + startIndex);
+      sendPage(request, "FarmHub - Grafy", [range](PageWriter &w) {
+        // Výběr rozsahu
+        w.print(F("<p>"));
+        for (uint8_t r = 0; r < CHART_RANGE_COUNT; r++) {
+          w.print(F("<a class='btn' href='/charts?range="));
+          w.print(FPSTR(CHART_RANGES[r].name));
+          w.print(F("'>"));
+          if (r == range) w.print(F("<strong>"));
+          w.print(FPSTR(CHART_RANGES[r].label));
+          if (r == range) w.print(F("</strong>"));
+          w.print(F("</a> "));
         }
-      };
-      keepLastN(soilTimes, soilValues, tempValues, humValues);
-      {
-        std::vector<float> dummy2, dummy3;
-        keepLastN(lightTimes, lightValues, dummy2, dummy3);
-      }
-
-      // Seřadíme podle času (vzestupně)
-      auto sortByTime = [](std::vector<float> &times,
-                           std::vector<float> &v1,
-                           std::vector<float> &v2,
-                           std::vector<float> &v3){
-        for(size_t i=0; i < times.size(); i++){
-          for(size_t j=0; j < times.size()-1; j++){
-            if(times[j] > times[j+1]) {
-              std::swap(times[j], times[j+1]);
-              std::swap(v1[j], v1[j+1]);
-              if(!v2.empty()) std::swap(v2[j], v2[j+1]);
-              if(!v3.empty()) std::swap(v3[j], v3[j+1]);
-            }
-          }
-        }
-      };
-      if(!soilTimes.empty()) {
-        sortByTime(soilTimes, soilValues, tempValues, humValues);
-      }
-      {
-        std::vector<float> dummy2, dummy3;
-        sortByTime(lightTimes, lightValues, dummy2, dummy3);
-      }
-
-      // Vygenerujeme JavaScript s poli dat
-      html += "<script>";
-      // soilTimes
-      html += "const soilLabels = [";
-      for(size_t i=0; i < soilTimes.size(); i++){
-        html += String(soilTimes[i]);
-        if(i < soilTimes.size() - 1) html += ",";
-      }
-      html += "];";
-      // soilValues
-      html += "const soilData = [";
-      for(size_t i=0; i < soilValues.size(); i++){
-        html += String(soilValues[i]);
-        if(i < soilValues.size() - 1) html += ",";
-      }
-      html += "];";
-      // tempValues
-      html += "const tempData = [";
-      for(size_t i=0; i < tempValues.size(); i++){
-        html += String(tempValues[i]);
-        if(i < tempValues.size() - 1) html += ",";
-      }
-      html += "];";
-      // humValues
-      html += "const humData = [";
-      for(size_t i=0; i < humValues.size(); i++){
-        html += String(humValues[i]);
-        if(i < humValues.size() - 1) html += ",";
-      }
-      html += "];";
-      // lightTimes
-      html += "const lightLabels = [";
-      for(size_t i=0; i < lightTimes.size(); i++){
-        html += String(lightTimes[i]);
-        if(i < lightTimes.size() - 1) html += ",";
-      }
-      html += "];";
-      // lightValues
-      html += "const lightData = [";
-      for(size_t i=0; i < lightValues.size(); i++){
-        html += String(lightValues[i]);
-        if(i < lightValues.size() - 1) html += ",";
-      }
-      html += "];";
-
-      // Zavoláme funkce pro vykreslení
-      html += R"(
-        drawSoilChart(soilLabels, soilData);
-        drawTempChart(soilLabels, tempData);
-        drawHumChart(soilLabels, humData);
-        drawLightChart(lightLabels, lightData);
-      )";
-      html += "</script>";
-
-      // Dokončení stránky
-      html += makeHtmlFooter();
-      request->send(200, "text/html", html);
+        w.print(F("</p>"));
+
+        // Vložíme 4 plátna pro 4 grafy
+        w.print(F("<hr><h3>Grafy senzorů</h3>"
+                  "<div class='chart-container'><canvas id='chartSoil'></canvas></div>"
+                  "<div class='chart-container'><canvas id='chartTemp'></canvas></div>"
+                  "<div class='chart-container'><canvas id='chartHum'></canvas></div>"
+                  "<div class='chart-container'><canvas id='chartLight'></canvas></div>"));
+
+        // Vložíme kód pro grafy; data si stránka stáhne z /api/series
+        const ChartRange &cr = CHART_RANGES[range];
+        w.print(FPSTR(CHART_JS));
+        w.print(F("<script>startCharts("));
+        w.printUInt(ROLLUP_PERIOD[cr.tier]);
+        w.print(F(","));
+        w.printUInt(cr.points);
+        w.print(F(");</script>"));
+      });
     });
 
     // Stránka "/history" - poslední záznamy s volitelným limitem
     // ==================================================
-    server.on("/history", HTTP_GET, [](AsyncWebServerRequest *request){
+    onRoute("/history", HTTP_GET, [](AsyncWebServerRequest *request){
       // Zkusíme načíst GET parametr "limit"
       int limit = 10; 
       if (request->hasParam("limit")) {
         limit = request->getParam("limit")->value().toInt();
         if (limit <= 0) limit = 10; // ochrana proti nesmyslu
       }
+      // Řádky i stav logu se zkopírují hned: correctProvisionalReadings
+      // a nová měření by jinak měnily stránku mezi jednotlivými částmi
+      struct HistorySnapshot {
+        std::vector<SensorReading> rows;
+        uint32_t firstSeq;
+        uint32_t lastSeq;
+        uint32_t usedBytes;
+        uint32_t budgetKB;
+      };
+      std::shared_ptr<HistorySnapshot> hs = std::make_shared<HistorySnapshot>();
+      hs->rows.reserve(std::min((size_t)limit, dataBuffer.size()));
+      for (size_t age = 0; age < dataBuffer.size() && hs->rows.size() < (size_t)limit; age++) {
+        const SensorReading &d = dataBuffer.fromNewest(age);
+        if (!isEmptyReading(d)) hs->rows.push_back(d);
+      }
+      hs->firstSeq  = g_logFirstSeq;
+      hs->lastSeq   = g_logLastSeq;
+      hs->usedBytes = logUsedBytes();
+      hs->budgetKB  = logBudgetKB;
+
+      sendPage(request, "Poslední data", [limit, hs](PageWriter &w) {
+        w.print(F("<hr><h3>Poslední záznamy senzorů</h3>"
+                  // Form pro nastavení počtu řádků
+                  "<form method='GET' action='/history'>"
+                  "  <label>Počet záznamů k zobrazení:</label>"
+                  "  <input type='number' name='limit' value='"));
+        w.printInt(limit);
+        w.print(F("'>"
+                  "  <input type='submit' class='btn' value='Zobrazit'>"
+                  "</form>"
+                  // Tabulka
+                  "<div class='table-container'><table>"
+                  "<tr><th>SensorID</th><th>Soil(%)</th><th>Temp(°C)</th><th>Hum(%)</th><th>Light</th><th>Time</th></tr>"));
+
+        for (size_t i = 0; i < hs->rows.size() && !w.done(); i++) {
+          const SensorReading &d = hs->rows[i];
+          w.print(F("<tr><td>"));
+          w.print(sensorIdName(d.sensorId));
+          w.print(F("</td><td>"));
+          w.printFloat(d.soilMoisture);
+          w.print(F("</td><td>"));
+          w.printFloat(d.temperature);
+          w.print(F("</td><td>"));
+          w.printFloat(d.humidity);
+          w.print(F("</td><td>"));
+          w.printFloat(d.lightLevel);
+          w.print(F("</td><td>"));
+          w.printTime(d.timestamp);
+          w.print(F("</td></tr>"));
+        }
+        w.print(F("</table></div>"));
+
+        // Stav binárního logu na flash
+        w.print(F("<hr><h3>Log na flash</h3><p>Segmenty: "));
+        w.printUInt(hs->firstSeq);
+        w.print(F(" - "));
+        w.printUInt(hs->lastSeq);
+        w.print(F(", obsazeno: "));
+        w.printUInt(hs->usedBytes / 1024);
+        w.print(F(" KB z "));
+        w.printUInt(hs->budgetKB);
+        w.print(F(" KB</p>"
+                  "<p><a class='btn' href='/datalog.csv'>Stáhnout CSV</a> "
+                  "<a class='btn' href='/api/history'>Stáhnout JSON</a></p>"
+                  "<form method='POST' action='/setlog'>"
+                  "<div class='form-group'><label>Limit logu (KB):</label>"
+                  "<input type='number' step='1' min='16' name='logBudgetKB' value='"));
+        w.printUInt(hs->budgetKB);
+        w.print(F("'></div>"
+                  "<input type='submit' class='btn' value='Uložit'>"
+                  "</form>"));
+      });
+    });
 
-      String html = makeHtmlHeader("Poslední data");
-
-      html += "<hr><h3>Poslední záznamy senzorů</h3>";
-      // Form pro nastavení počtu řádků
-      html += "<form method='GET' action='/history'>";
-      html += "  <label>Počet záznamů k zobrazení:</label>";
-      html += "  <input type='number' name='limit' value='" + String(limit) + "'>";
-      html += "  <input type='submit' class='btn' value='Zobrazit'>";
-      html += "</form>";
-
-      // Tabulka
-      html += "<div class='table-container'><table>";
-      html += "<tr><th>SensorID</th><th>Soil(%)</th><th>Temp(°C)</th><th>Hum(%)</th><th>Light</th><th>Time</th></tr>";
-
-      int count = dataBuffer.size();
-      int rowsPrinted = 0;
-      for(int i = count - 1; i >= 0 && rowsPrinted < limit; i--) {
-        const auto &d = dataBuffer[i];
-        if(d.soilMoisture == 0 &&
-           d.temperature  == 0 &&
-           d.humidity     == 0 &&
-           d.lightLevel   == 0)
-        {
-          continue;
+    // Export celého logu v původním CSV formátu (streamovaně po částech)
+    // ==================================================
+    onRoute("/datalog.csv", HTTP_GET, [](AsyncWebServerRequest *request){
+      std::shared_ptr<LogStreamState> st = std::make_shared<LogStreamState>();
+      beginLogStream(*st, 0, 0xFFFFFFFF, SENSOR_ID_UNKNOWN, formatCsvLine, "", "", "");
+      sendLogStream(request, "text/csv", st);
+    });
+
+    // Historie měření jako JSON (?from=&to= v epoch s, volitelně &sensor=)
+    // Streamuje se přímo z logu, velikost výsledku není omezena.
+    // ==================================================
+    onRoute("/api/history", HTTP_GET, [](AsyncWebServerRequest *request){
+      uint32_t fromTs = 0;
+      uint32_t toTs   = 0xFFFFFFFF;
+      if (request->hasParam("from")) {
+        fromTs = (uint32_t)strtoul(request->getParam("from")->value().c_str(), nullptr, 10);
+      }
+      if (request->hasParam("to")) {
+        toTs = (uint32_t)strtoul(request->getParam("to")->value().c_str(), nullptr, 10);
+      }
+      uint8_t sensorFilter = SENSOR_ID_UNKNOWN;
+      if (request->hasParam("sensor")) {
+        sensorFilter = findSensorID(request->getParam("sensor")->value().c_str());
+        if (sensorFilter == SENSOR_ID_UNKNOWN) {
+          request->send(200, "application/json", "{\"readings\":[]}");
+          return;
         }
-        html += "<tr>";
-        html += "<td>" + d.sensorID             + "</td>";
-        html += "<td>" + String(d.soilMoisture) + "</td>";
-        html += "<td>" + String(d.temperature)  + "</td>";
-        html += "<td>" + String(d.humidity)     + "</td>";
-        html += "<td>" + String(d.lightLevel)   + "</td>";
-        html += "<td>" + formatEpochTime(d.timestamp) + "</td>";
-        html += "</tr>";
-        rowsPrinted++;
-      }
-      html += "</table></div>";
-
-      // Dokončení
-      html += makeHtmlFooter();
-      request->send(200, "text/html", html);
+      }
+
+      std::shared_ptr<LogStreamState> st = std::make_shared<LogStreamState>();
+      beginLogStream(*st, fromTs, toTs, sensorFilter, formatJsonReading,
+                     "{\"readings\":[", ",", "]}");
+      sendLogStream(request, "application/json", st);
+    });
+
+    // Časová řada z rollupů ve sloupcích
+    // (?sensor=&channel=soil|temp|hum|light&from=&to=&step= v sekundách)
+    // ==================================================
+    onRoute("/api/series", HTTP_GET, [](AsyncWebServerRequest *request){
+      if (!request->hasParam("sensor") || !request->hasParam("channel")) {
+        request->send(400, "application/json", "{\"error\":\"sensor and channel required\"}");
+        return;
+      }
+      uint8_t sensorId = findSensorID(request->getParam("sensor")->value().c_str());
+      uint8_t field    = fieldFromName(request->getParam("channel")->value().c_str());
+      if (sensorId == SENSOR_ID_UNKNOWN || field >= FIELD_COUNT) {
+        request->send(404, "application/json", "{\"error\":\"unknown sensor or channel\"}");
+        return;
+      }
+
+      std::shared_ptr<SeriesSnapshot> snap = std::make_shared<SeriesSnapshot>();
+      snap->tier   = ROLLUP_HOUR;
+      snap->fromTs = 0;
+      snap->toTs   = 0xFFFFFFFF;
+      if (request->hasParam("step")) {
+        snap->tier = rollupTierForStep(strtoul(request->getParam("step")->value().c_str(), nullptr, 10));
+      }
+      if (request->hasParam("from")) {
+        snap->fromTs = strtoul(request->getParam("from")->value().c_str(), nullptr, 10);
+      }
+      if (request->hasParam("to")) {
+        snap->toTs = strtoul(request->getParam("to")->value().c_str(), nullptr, 10);
+      }
+      const RollupChannel *ch = findRollup(sensorId, field);
+      if (ch) {
+        snap->channel = *ch;
+      } else {
+        // Kanál zatím nemá data – prázdné sloupce
+        memset(&snap->channel, 0, sizeof(RollupChannel));
+        snap->channel.sensorId = sensorId;
+        snap->channel.field    = field;
+        snap->channel.scale    = 1.0f;
+      }
+
+      sendRendered(request, "application/json", [snap](PageWriter &w) {
+        writeSeriesJson(w, *snap);
+      });
+    });
+
+    onRoute("/setlog", HTTP_POST, [](AsyncWebServerRequest *request){
+      if (request->hasParam("logBudgetKB", true)) {
+        long kb = request->getParam("logBudgetKB", true)->value().toInt();
+        if (kb < 16) kb = 16; // aspoň jeden segment + rezerva
+        logBudgetKB = (uint32_t)kb;
+        saveUserConfig();
+        logEnforceRetention(logBudgetKB * 1024UL);
+        Serial.printf("Uloženo: logBudgetKB=%lu\n", (unsigned long)logBudgetKB);
+      }
+      request->redirect("/history");
     });
 
     // Stránka "/wifi"
     // ==================================================
-    server.on("/wifi", HTTP_GET, [](AsyncWebServerRequest *request){
+    onRoute("/wifi", HTTP_GET, [](AsyncWebServerRequest *request){
       // Nejdříve zkontrolujeme stav asynchronního skenování
       checkAsyncScan();
 
-      String html = makeHtmlHeader("Nastavení Wi-Fi");
-      html += "<p><a class='btn' href='/startscan'>Načíst seznam sítí (async)</a></p>";
-
-      if (g_isScanning) {
-        html += "<p><strong>Probíhá skenování sítí...</strong></p>";
-        html += "<p>Stránka se obnoví za <span id='timer'>10</span> s.</p>";
-        html += "<script>"
-                "var countdown = 10;"
-                "var x = setInterval(function(){"
-                "  countdown--;"
-                "  if(countdown <= 0){"
-                "    clearInterval(x);"
-                "    location.reload();"
-                "  }"
-                "  document.getElementById('timer').textContent = countdown;"
-                "}, 1000);"
-                "</script>";
-      } else if (g_scanComplete) {
-        if (g_foundNetworks <= 0) {
-          html += "<p>Nebyly nalezeny žádné sítě, nebo sken selhal.</p>";
-        } else {
-          html += "<p>Nalezené sítě v okolí (" + String(g_foundNetworks) + "):</p>";
-          html += "<form method='POST' action='/setwifi'>";
-          html += "<div class='form-group'><label>Vyberte síť:</label>";
-          html += "<select name='ssid'>";
-          for (int i = 0; i < g_foundNetworks; i++) {
-            String ssidFound = g_scannedSSIDs[i];
-            html += "<option value='" + ssidFound + "'>";
-            html += ssidFound;
-            html += "</option>";
-          }
-          html += "</select></div>";
-          html += "<div class='form-group'><label>Heslo:</label>";
-          html += "<input type='password' name='pass'></div>";
-          html += "<input type='submit' class='btn' value='Uložit Wi-Fi'>";
-          html += "</form>";
-        }
-      } else {
-        html += "<p>Nebylo spuštěno skenování, klikněte výše na tlačítko \"Načíst seznam sítí\".</p>";
+      // Sken může doběhnout (a přestavět g_scannedSSIDs) mezi částmi
+      struct WifiSnapshot {
+        bool    scanning;
+        bool    complete;
+        int     found;
+        uint8_t count;
+        char    ssids[WIFI_PAGE_MAX_NETWORKS][33];
+      };
+      std::shared_ptr<WifiSnapshot> ws = std::make_shared<WifiSnapshot>();
+      ws->scanning = g_isScanning;
+      ws->complete = g_scanComplete;
+      ws->found    = g_foundNetworks;
+      ws->count    = 0;
+      for (size_t i = 0; i < g_scannedSSIDs.size() && (int)i < g_foundNetworks &&
+                         ws->count < WIFI_PAGE_MAX_NETWORKS; i++) {
+        strncpy(ws->ssids[ws->count], g_scannedSSIDs[i].c_str(), sizeof(ws->ssids[0]) - 1);
+        ws->ssids[ws->count][sizeof(ws->ssids[0]) - 1] = 0;
+        ws->count++;
       }
 
-      // Formulář pro ruční zadání
-      html += "<hr><p>Nebo zadat ručně (skrytou síť):</p>";
-      html += "<form method='POST' action='/setwifi'>";
-      html += "<div class='form-group'><label>SSID:</label>";
-      html += "<input type='text' name='ssid'></div>";
-      html += "<div class='form-group'><label>Heslo:</label>";
-      html += "<input type='password' name='pass'></div>";
-      html += "<input type='submit' class='btn' value='Uložit Wi-Fi'>";
-      html += "</form>";
+      sendPage(request, "Nastavení Wi-Fi", [ws](PageWriter &w) {
+        w.print(F("<p><a class='btn' href='/startscan'>Načíst seznam sítí (async)</a></p>"));
+
+        if (ws->scanning) {
+          w.print(F("<p><strong>Probíhá skenování sítí...</strong></p>"
+                    "<p>Stránka se obnoví za <span id='timer'>10</span> s.</p>"
+                    "<script>"
+                    "var countdown = 10;"
+                    "var x = setInterval(function(){"
+                    "  countdown--;"
+                    "  if(countdown <= 0){"
+                    "    clearInterval(x);"
+                    "    location.reload();"
+                    "  }"
+                    "  document.getElementById('timer').textContent = countdown;"
+                    "}, 1000);"
+                    "</script>"));
+        } else if (ws->complete) {
+          if (ws->found <= 0) {
+            w.print(F("<p>Nebyly nalezeny žádné sítě, nebo sken selhal.</p>"));
+          } else {
+            w.print(F("<p>Nalezené sítě v okolí ("));
+            w.printInt(ws->found);
+            w.print(F("):</p>"
+                      "<form method='POST' action='/setwifi'>"
+                      "<div class='form-group'><label>Vyberte síť:</label>"
+                      "<select name='ssid'>"));
+            for (uint8_t i = 0; i < ws->count; i++) {
+              w.print(F("<option value='"));
+              w.printEscaped(ws->ssids[i]);
+              w.print(F("'>"));
+              w.printEscaped(ws->ssids[i]);
+              w.print(F("</option>"));
+            }
+            w.print(F("</select></div>"
+                      "<div class='form-group'><label>Heslo:</label>"
+                      "<input type='password' name='pass'></div>"
+                      "<input type='submit' class='btn' value='Uložit Wi-Fi'>"
+                      "</form>"));
+          }
+        } else {
+          w.print(F("<p>Nebylo spuštěno skenování, klikněte výše na tlačítko \"Načíst seznam sítí\".</p>"));
+        }
 
-      html += makeHtmlFooter();
-      request->send(200, "text/html", html);
+        // Formulář pro ruční zadání
+        w.print(F("<hr><p>Nebo zadat ručně (skrytou síť):</p>"
+                  "<form method='POST' action='/setwifi'>"
+                  "<div class='form-group'><label>SSID:</label>"
+                  "<input type='text' name='ssid'></div>"
+                  "<div class='form-group'><label>Heslo:</label>"
+                  "<input type='password' name='pass'></div>"
+                  "<input type='submit' class='btn' value='Uložit Wi-Fi'>"
+                  "</form>"));
+      });
     });
 
-    server.on("/startscan", HTTP_GET, [](AsyncWebServerRequest *request){
+    onRoute("/startscan", HTTP_GET, [](AsyncWebServerRequest *request){
       startAsyncScan();
       request->redirect("/wifi");
     });
 
     // Pro manuální zapnutí/vypnutí
-    server.on("/setlightmanual", HTTP_POST, [](AsyncWebServerRequest *request){
+    onRoute("/setlightmanual", HTTP_POST, [](AsyncWebServerRequest *request){
       if (request->hasParam("action", true)) {
         String act = request->getParam("action", true)->value();
         if (act == "on") {
@@ -622,7 +1118,7 @@ static inline void startAsyncWebServer() {
     });
 
     // Pro automatický režim
-    server.on("/setlightauto", HTTP_POST, [](AsyncWebServerRequest *request){
+    onRoute("/setlightauto", HTTP_POST, [](AsyncWebServerRequest *request){
       if (request->hasParam("autoLight", true)) {
         autoLight = (request->getParam("autoLight", true)->value() == "true");
       }
@@ -643,12 +1139,14 @@ static inline void startAsyncWebServer() {
       } else {
         lightOnlyIfDark = false;
       }
+      uint8_t days = lightDaysFromRequest(request);
+      if (days != 0) lightDays = days;
 
       saveUserConfig();
-      Serial.printf("Nastaveno: autoLight=%s, %02d:%02d - %02d:%02d, onlyDark=%s\n",
+      Serial.printf("Nastaveno: autoLight=%s, %02d:%02d - %02d:%02d (dny 0x%02X), onlyDark=%s\n",
         autoLight ? "true":"false",
         lightStartHour, lightStartMinute,
-        lightEndHour, lightEndMinute,
+        lightEndHour, lightEndMinute, lightDays,
         lightOnlyIfDark ? "true":"false");
         
       // po změně nastavní také odešleme modulům
@@ -657,93 +1155,335 @@ static inline void startAsyncWebServer() {
       request->redirect("/lighting");
     });
 
-    server.on("/lighting", HTTP_GET, [](AsyncWebServerRequest *request){
-      String html = makeHtmlHeader("Ovládání světla");
-
-      // Formulář pro manuální zapnutí/vypnutí
-      html += "<h3>Manuální ovládání</h3>";
-      html += "<form method='POST' action='/setlightmanual'>";
-      html += "  <label>Světlo je teď: <strong>" + String(manualLightOn ? "ZAPNUTÉ" : "VYPNUTÉ") + "</strong></label><br>";
-      // Vložíme dvě tlačítka
-      html += "  <button class='btn' name='action' value='on'>Zapnout</button> ";
-      html += "  <button class='btn' name='action' value='off'>Vypnout</button>";
-      html += "</form>";
-
-      // Formulář pro automatický režim
-      html += "<hr><h3>Automatické svícení</h3>";
-      html += "<form method='POST' action='/setlightauto'>";
-      // Zapnout/vypnout autoLight
-      html += "<div class='form-group'><label>Režim:</label>";
-      html += "<select name='autoLight'>";
-      html += "<option value='false' " + String(!autoLight ? "selected":"") + ">Vypnuto</option>";
-      html += "<option value='true' "  + String( autoLight ? "selected":"") + ">Zapnuto</option>";
-      html += "</select></div>";
-
-      // Hodina/minuta start
-      html += "<div class='form-group'><label>Začátek (hh:mm):</label>";
-      html += "<input type='number' name='startH' value='" + String(lightStartHour) + "' min='0' max='23'>";
-      html += "<input type='number' name='startM' value='" + String(lightStartMinute) + "' min='0' max='59'>";
-      html += "</div>";
-
-      // Hodina/minuta konec
-      html += "<div class='form-group'><label>Konec (hh:mm):</label>";
-      html += "<input type='number' name='endH' value='" + String(lightEndHour) + "' min='0' max='23'>";
-      html += "<input type='number' name='endM' value='" + String(lightEndMinute) + "' min='0' max='59'>";
-      html += "</div>";
-
-      // Podmínka "jen když je tma" (light < 50)
-      //html += "<div class='form-group'>";
-      //html += "<label><input type='checkbox' name='onlyDark' value='1' " + String(lightOnlyIfDark ? "checked":"") + "> Svítit jen když je pod 50 lux</label>";
-      //html += "</div>";
-
-      html += "<input type='submit' class='btn' value='Uložit nastavení'>";
-      html += "</form>";
-
-      html += makeHtmlFooter();
-      request->send(200, "text/html", html);
+    // Další okna svícení
+    onRoute("/addlightwindow", HTTP_POST, [](AsyncWebServerRequest *request){
+      FarmLightWindow lw;
+      lw.days        = lightDaysFromRequest(request);
+      lw.startHour   = request->hasParam("startH", true) ? request->getParam("startH", true)->value().toInt() : 0;
+      lw.startMinute = request->hasParam("startM", true) ? request->getParam("startM", true)->value().toInt() : 0;
+      lw.endHour     = request->hasParam("endH", true)   ? request->getParam("endH", true)->value().toInt()   : 0;
+      lw.endMinute   = request->hasParam("endM", true)   ? request->getParam("endM", true)->value().toInt()   : 0;
+      if (addLightWindow(lw)) {
+        saveLightWindows();
+        broadcastLightSettings();
+      }
+      request->redirect("/lighting");
+    });
+
+    onRoute("/dellightwindow", HTTP_POST, [](AsyncWebServerRequest *request){
+      if (request->hasParam("index", true)) {
+        removeLightWindow(request->getParam("index", true)->value().toInt());
+        saveLightWindows();
+        broadcastLightSettings();
+      }
+      request->redirect("/lighting");
+    });
+
+    onRoute("/lighting", HTTP_GET, [](AsyncWebServerRequest *request){
+      // Nastavení se může změnit formulářem během odesílání
+      struct LightSnapshot {
+        FarmLightWindow windows[LIGHT_EXTRA_WINDOWS];
+        uint8_t         count;
+        bool            manualOn;
+        bool            autoOn;
+        int             startHour, startMinute;
+        int             endHour, endMinute;
+        uint8_t         days;
+      };
+      std::shared_ptr<LightSnapshot> ls = std::make_shared<LightSnapshot>();
+      memcpy(ls->windows, g_lightWindows, sizeof(g_lightWindows));
+      ls->count       = g_lightWindowCount;
+      ls->manualOn    = manualLightOn;
+      ls->autoOn      = autoLight;
+      ls->startHour   = lightStartHour;
+      ls->startMinute = lightStartMinute;
+      ls->endHour     = lightEndHour;
+      ls->endMinute   = lightEndMinute;
+      ls->days        = lightDays;
+
+      sendPage(request, "Ovládání světla", [ls](PageWriter &w) {
+        // Formulář pro manuální zapnutí/vypnutí
+        w.print(F("<h3>Manuální ovládání</h3>"
+                  "<form method='POST' action='/setlightmanual'>"
+                  "  <label>Světlo je teď: <strong>"));
+        w.print(ls->manualOn ? F("ZAPNUTÉ") : F("VYPNUTÉ"));
+        w.print(F("</strong></label><br>"
+                  // Vložíme dvě tlačítka
+                  "  <button class='btn' name='action' value='on'>Zapnout</button> "
+                  "  <button class='btn' name='action' value='off'>Vypnout</button>"
+                  "</form>"));
+
+        // Formulář pro automatický režim
+        w.print(F("<hr><h3>Automatické svícení</h3>"
+                  "<form method='POST' action='/setlightauto'>"
+                  // Zapnout/vypnout autoLight
+                  "<div class='form-group'><label>Režim:</label>"
+                  "<select name='autoLight'>"
+                  "<option value='false' "));
+        w.print(!ls->autoOn ? F("selected") : F(""));
+        w.print(F(">Vypnuto</option><option value='true' "));
+        w.print( ls->autoOn ? F("selected") : F(""));
+        w.print(F(">Zapnuto</option></select></div>"));
+
+        // Hodina/minuta start
+        w.print(F("<div class='form-group'><label>Začátek (hh:mm):</label>"
+                  "<input type='number' name='startH' value='"));
+        w.printInt(ls->startHour);
+        w.print(F("' min='0' max='23'><input type='number' name='startM' value='"));
+        w.printInt(ls->startMinute);
+        w.print(F("' min='0' max='59'></div>"));
+
+        // Hodina/minuta konec
+        w.print(F("<div class='form-group'><label>Konec (hh:mm):</label>"
+                  "<input type='number' name='endH' value='"));
+        w.printInt(ls->endHour);
+        w.print(F("' min='0' max='23'><input type='number' name='endM' value='"));
+        w.printInt(ls->endMinute);
+        w.print(F("' min='0' max='59'></div>"));
+        writeLightDays(w, ls->days);
+
+        // Podmínka "jen když je tma" (light < 50)
+        //w.print(F("<div class='form-group'><label><input type='checkbox' name='onlyDark' value='1'"));
+        //w.print(lightOnlyIfDark ? F(" checked") : F(""));
+        //w.print(F("> Svítit jen když je pod 50 lux</label></div>"));
+
+        w.print(F("<input type='submit' class='btn' value='Uložit nastavení'>"
+                  "</form>"));
+
+        // Další okna (konec <= začátek = přes půlnoc)
+        w.print(F("<hr><h3>Další okna svícení</h3>"
+                  "<div class='table-container'><table>"
+                  "<tr><th>Dny</th><th>Od</th><th>Do</th><th></th></tr>"));
+        char days[32];
+        for (uint8_t i = 0; i < ls->count; i++) {
+          const FarmLightWindow &lw = ls->windows[i];
+          w.print(F("<tr><td>"));
+          w.print(lightDaysText(lw.days, days, sizeof(days)));
+          w.print(F("</td><td>"));
+          writeHourMinute(w, lw.startHour, lw.startMinute);
+          w.print(F("</td><td>"));
+          writeHourMinute(w, lw.endHour, lw.endMinute);
+          w.print(F("</td><td><form method='POST' action='/dellightwindow'>"
+                    "<input type='hidden' name='index' value='"));
+          w.printUInt(i);
+          w.print(F("'><button class='btn'>Smazat</button></form></td></tr>"));
+        }
+        w.print(F("</table></div>"));
+
+        if (ls->count < LIGHT_EXTRA_WINDOWS) {
+          w.print(F("<form method='POST' action='/addlightwindow'>"
+                    "<div class='form-group'><label>Od (hh:mm):</label>"
+                    "<input type='number' name='startH' value='6' min='0' max='23'>"
+                    "<input type='number' name='startM' value='0' min='0' max='59'></div>"
+                    "<div class='form-group'><label>Do (hh:mm):</label>"
+                    "<input type='number' name='endH' value='8' min='0' max='23'>"
+                    "<input type='number' name='endM' value='0' min='0' max='59'></div>"));
+          writeLightDays(w, FARM_LIGHT_ALL_DAYS);
+          w.print(F("<input type='submit' class='btn' value='Přidat okno'></form>"));
+        }
+      });
     });
 
 
     // Stránka "/watering"
     // ==================================================
-    server.on("/watering", HTTP_GET, [](AsyncWebServerRequest *request){
-      String html = makeHtmlHeader("Nastavení zalévání");
-
-      html += "<h3>Základní nastavení</h3>";
-      html += "<form method='POST' action='/setwatering'>";
-      // Režim zalévání
-      html += "<div class='form-group'><label>Režim zalévání:</label>";
-      html += "<select name='autoWatering'>";
-      html += "<option value='false' " + String(!autoWatering ? "selected" : "") + ">Manuální</option>";
-      html += "<option value='true' "  + String( autoWatering ? "selected" : "") + ">Automatický</option>";
-      html += "</select></div>";
-      // Prahová vlhkost
-      html += "<div class='form-group'><label>Prahová vlhkost půdy (%):</label>";
-      html += "<input type='number' step='1' name='moistureThreshold' value='" + String(moistureThreshold) + "'>";
-      html += "</div>";
-      // Množství vody
-      html += "<div class='form-group'><label>Množství vody na jedno zalití (ml):</label>";
-      html += "<input type='number' step='1' name='waterAmountML' value='" + String(waterAmountML) + "'>";
-      html += "</div>";
-      html += "<input type='submit' class='btn' value='Uložit nastavení'>";
-      html += "</form>";
-
-      if(!autoWatering) {
-        html += "<hr><h3>Jednorázové zalití (manuální)</h3>";
-        html += "<form method='POST' action='/runoneshot'>";
-        html += "<div class='form-group'><label>Množství vody (ml):</label>";
-        html += "<input type='number' step='1' name='oneTimeML' value='100'>";
-        html += "</div>";
-        html += "<input type='submit' class='btn' value='Zalít'>";
-        html += "</form>";
-      }
-
-      html += makeHtmlFooter();
-      request->send(200, "text/html", html);
+    onRoute("/watering", HTTP_GET, [](AsyncWebServerRequest *request){
+      // Zóny i nastavení (formulář /setwatering) zafixované pro všechny části
+      struct ZonesSnapshot {
+        IrrigationZone zones[IRRIGATION_MAX_ZONES];
+        float          thresholds[IRRIGATION_MAX_ZONES];
+        uint8_t        count;
+        unsigned long  now;
+        bool           autoOn;
+        float          threshold;
+        int            waterML;
+        int            soakMin;
+        int            maxPumpSec;
+      };
+      std::shared_ptr<ZonesSnapshot> zs = std::make_shared<ZonesSnapshot>();
+      memcpy(zs->zones, g_zones, sizeof(g_zones));
+      zs->count = g_zoneCount;
+      for (uint8_t i = 0; i < zs->count; i++) zs->thresholds[i] = zoneThreshold(g_zones[i]);
+      zs->now        = millis();
+      zs->autoOn     = autoWatering;
+      zs->threshold  = moistureThreshold;
+      zs->waterML    = waterAmountML;
+      zs->soakMin    = soakMinutes;
+      zs->maxPumpSec = maxPumpSecPerHour;
+      PumpStats stats = g_pumpStats;
+
+      sendPage(request, "Nastavení zalévání", [stats, zs](PageWriter &w) {
+        w.print(F("<h3>Základní nastavení</h3>"
+                  "<form method='POST' action='/setwatering'>"
+                  // Režim zalévání
+                  "<div class='form-group'><label>Režim zalévání:</label>"
+                  "<select name='autoWatering'>"
+                  "<option value='false' "));
+        w.print(!zs->autoOn ? F("selected") : F(""));
+        w.print(F(">Manuální</option><option value='true' "));
+        w.print( zs->autoOn ? F("selected") : F(""));
+        w.print(F(">Automatický</option></select></div>"
+                  // Prahová vlhkost
+                  "<div class='form-group'><label>Prahová vlhkost půdy (%):</label>"
+                  "<input type='number' step='1' name='moistureThreshold' value='"));
+        w.printFloat(zs->threshold);
+        w.print(F("'></div>"
+                  // Množství vody
+                  "<div class='form-group'><label>Množství vody na jedno zalití (ml):</label>"
+                  "<input type='number' step='1' name='waterAmountML' value='"));
+        w.printInt(zs->waterML);
+        w.print(F("'></div>"
+                  // Vsakování a limit
+                  "<div class='form-group'><label>Vsakování po zalití (min):</label>"
+                  "<input type='number' step='1' min='0' name='soakMinutes' value='"));
+        w.printInt(zs->soakMin);
+        w.print(F("'></div>"
+                  "<div class='form-group'><label>Max. čerpání za hodinu (s):</label>"
+                  "<input type='number' step='1' min='1' name='maxPumpSecPerHour' value='"));
+        w.printInt(zs->maxPumpSec);
+        w.print(F("'></div>"
+                  "<input type='submit' class='btn' value='Uložit nastavení'>"
+                  "</form>"));
+
+        // Stav zón
+        w.print(F("<hr><h3>Zóny</h3>"
+                  "<div class='table-container'><table>"
+                  "<tr><th>Zóna</th><th>Senzor</th><th>Čerpadlo</th><th>Práh (%)</th>"
+                  "<th>Stav</th><th>Ve stavu (s)</th><th>Čerpání za poslední hodinu (s)</th>"
+                  "<th>Spuštění</th><th>Odmítnuto limitem</th></tr>"));
+        for (uint8_t i = 0; i < zs->count; i++) {
+          const IrrigationZone &z = zs->zones[i];
+          w.print(F("<tr><td>"));
+          w.printUInt(i);
+          w.print(F("</td><td>"));
+          w.printEscaped(sensorIdName(z.sensorId));
+          w.print(F("</td><td>"));
+          w.printUInt(z.pump);
+          w.print(F("</td><td>"));
+          w.printFloat(zs->thresholds[i], 1);
+          w.print(F("</td><td>"));
+          w.print(zoneStateName(z.state));
+          w.print(F("</td><td>"));
+          w.printUInt((zs->now - z.stateSince) / 1000);
+          w.print(F("</td><td>"));
+          w.printUInt(z.dutySec);
+          w.print(F("</td><td>"));
+          w.printUInt(z.runs);
+          w.print(F("</td><td>"));
+          w.printUInt(z.dutySkips);
+          w.print(F("</td></tr>"));
+        }
+        w.print(F("</table></div>"));
+
+        if (!zs->autoOn) {
+          w.print(F("<hr><h3>Jednorázové zalití (manuální)</h3>"
+                    "<form method='POST' action='/runoneshot'>"
+                    "<div class='form-group'><label>Množství vody (ml):</label>"
+                    "<input type='number' step='1' name='oneTimeML' value='100'>"
+                    "</div>"
+                    "<input type='submit' class='btn' value='Zalít'>"
+                    "</form>"));
+        }
+
+        // Doručování příkazů čerpadlu
+        w.print(F("<hr><h3>Čerpadlo</h3>"
+                  "<div class='table-container'><table>"
+                  "<tr><th>Příkazů</th><th>Odesláno (vč. opakování)</th><th>Potvrzeno</th>"
+                  "<th>Nepotvrzeno</th><th>Dokončeno</th><th>Zpoždění spuštění (ms)</th>"
+                  "<th>Poslední chod (s)</th></tr><tr><td>"));
+        w.printUInt(stats.issued);
+        w.print(F("</td><td>"));
+        w.printUInt(stats.transmissions);
+        w.print(F("</td><td>"));
+        w.printUInt(stats.acked);
+        w.print(F("</td><td>"));
+        w.printUInt(stats.expired);
+        w.print(F("</td><td>"));
+        w.printUInt(stats.completed);
+        w.print(F("</td><td>"));
+        if (stats.acked > 0) {
+          w.printUInt(stats.lastLatencyMs);
+          w.print(F(" (průměr "));
+          w.printUInt(stats.totalLatencyMs / stats.acked);
+          w.print(F(")"));
+        } else {
+          w.print(F("N/A"));
+        }
+        w.print(F("</td><td>"));
+        w.printFloat(stats.lastRuntimeMs / 1000.0f, 1);
+        w.print(F("</td></tr></table></div>"));
+      });
+    });
+
+    // Stránka "/sensors" – kdy senzory hlásí měření
+    // ==================================================
+    onRoute("/sensors", HTTP_GET, [](AsyncWebServerRequest *request){
+      FarmReportPolicy policy = reportPolicy;
+      sendPage(request, "Hlášení senzorů", [policy](PageWriter &w) {
+        static const char *const labels[FARM_FIELD_COUNT] = {
+          "Vlhkost půdy (%)", "Teplota (°C)", "Vlhkost vzduchu (%)", "Světlo (lux)"
+        };
+        w.print(F("<p>Senzor měří po zadané periodě, ale hodnotu pošle jen při změně "
+                  "větší než pásmo necitlivosti, při skoku hned a jinak nejpozději "
+                  "po max. době ticha.</p>"
+                  "<form method='POST' action='/setreporting'>"
+                  "<div class='form-group'><label>Perioda měření (s):</label>"
+                  "<input type='number' step='1' min='1' max='3600' name='sampleSec' value='"));
+        w.printUInt(policy.sampleSec);
+        w.print(F("'></div>"
+                  "<div class='form-group'><label>Max. doba ticha (s):</label>"
+                  "<input type='number' step='1' min='10' max='65535' name='heartbeatSec' value='"));
+        w.printUInt(policy.heartbeatSec);
+        w.print(F("'></div>"
+                  "<div class='table-container'><table>"
+                  "<tr><th>Veličina</th><th>Pásmo necitlivosti</th><th>Skok (hned, 0 = vypnuto)</th></tr>"));
+        for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+          w.print(F("<tr><td>"));
+          w.print(labels[f]);
+          w.print(F("</td><td><input type='number' step='0.1' min='0' name='db"));
+          w.printUInt(f);
+          w.print(F("' value='"));
+          w.printFloat(policy.deadband[f], 1);
+          w.print(F("'></td><td><input type='number' step='0.1' min='0' name='ur"));
+          w.printUInt(f);
+          w.print(F("' value='"));
+          w.printFloat(policy.urgent[f], 1);
+          w.print(F("'></td></tr>"));
+        }
+        w.print(F("</table></div>"
+                  "<input type='submit' class='btn' value='Uložit a odeslat senzorům'>"
+                  "</form>"));
+      });
+    });
+
+    onRoute("/setreporting", HTTP_POST, [](AsyncWebServerRequest *request){
+      FarmReportPolicy p = reportPolicy;
+      if (request->hasParam("sampleSec", true)) {
+        p.sampleSec = constrain(request->getParam("sampleSec", true)->value().toInt(), 1L, 3600L);
+      }
+      if (request->hasParam("heartbeatSec", true)) {
+        p.heartbeatSec = constrain(request->getParam("heartbeatSec", true)->value().toInt(), 10L, 65535L);
+      }
+      char name[4];
+      for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+        snprintf(name, sizeof(name), "db%u", f);
+        if (request->hasParam(name, true)) {
+          p.deadband[f] = fabsf(request->getParam(name, true)->value().toFloat());
+        }
+        snprintf(name, sizeof(name), "ur%u", f);
+        if (request->hasParam(name, true)) {
+          p.urgent[f] = fabsf(request->getParam(name, true)->value().toFloat());
+        }
+      }
+      reportPolicy = p;
+      saveUserConfig();
+      Serial.printf("Hlášení: měření po %u s, ticho max. %u s\n", p.sampleSec, p.heartbeatSec);
+      broadcastReportPolicy();
+      request->redirect("/sensors");
     });
 
     // ----- POST Endpointy -----
-    server.on("/setwifi", HTTP_POST, [](AsyncWebServerRequest *request){
+    onRoute("/setwifi", HTTP_POST, [](AsyncWebServerRequest *request){
       if(request->hasParam("ssid", true) && request->hasParam("pass", true)) {
         homeSsid = request->getParam("ssid", true)->value();
         homePass = request->getParam("pass", true)->value();
@@ -751,15 +1491,14 @@ static inline void startAsyncWebServer() {
         saveUserConfig();
         request->redirect("/wifi");
 
-        WiFi.disconnect();
-        bool ok = connectToHomeWiFi(homeSsid, homePass);
-        Serial.printf("connectToHomeWiFi => %s\n", ok ? "OK" : "FAIL");
+        // Připojení doběhne na pozadí, stav je na hlavní stránce
+        homeWifiBegin(homeSsid, homePass);
       } else {
         request->redirect("/wifi");
       }
     });
 
-    server.on("/setwatering", HTTP_POST, [](AsyncWebServerRequest *request){
+    onRoute("/setwatering", HTTP_POST, [](AsyncWebServerRequest *request){
       if(request->hasParam("autoWatering", true) &&
          request->hasParam("moistureThreshold", true) &&
          request->hasParam("waterAmountML", true))
@@ -767,6 +1506,12 @@ static inline void startAsyncWebServer() {
         autoWatering      = (request->getParam("autoWatering", true)->value() == "true");
         moistureThreshold = request->getParam("moistureThreshold", true)->value().toFloat();
         waterAmountML     = request->getParam("waterAmountML", true)->value().toInt();
+        if (request->hasParam("soakMinutes", true)) {
+          soakMinutes = max(0L, request->getParam("soakMinutes", true)->value().toInt());
+        }
+        if (request->hasParam("maxPumpSecPerHour", true)) {
+          maxPumpSecPerHour = max(1L, request->getParam("maxPumpSecPerHour", true)->value().toInt());
+        }
 
         saveUserConfig();
         Serial.printf("Uloženo: autoWatering=%s, threshold=%.1f, waterML=%d\n",
@@ -777,7 +1522,7 @@ static inline void startAsyncWebServer() {
       request->redirect("/watering");
     });
 
-    server.on("/runoneshot", HTTP_POST, [](AsyncWebServerRequest *request){
+    onRoute("/runoneshot", HTTP_POST, [](AsyncWebServerRequest *request){
       if(request->hasParam("oneTimeML", true)) {
         double oneTimeML = request->getParam("oneTimeML", true)->value().toFloat();
         double secondsFloat = oneTimeML * 0.03; // 1 ml = 0.03 s (příklad)
@@ -789,8 +1534,30 @@ static inline void startAsyncWebServer() {
       request->redirect("/watering");
     });
 
+    // Metriky pro monitoring (Prometheus, ?format=json => JSON)
+    onRoute("/metrics", HTTP_GET, [](AsyncWebServerRequest *request){
+      std::shared_ptr<MetricsSnapshot> m = takeMetricsSnapshot();
+      if (request->hasParam("format") && request->getParam("format")->value() == "json") {
+        sendRendered(request, "application/json", [m](PageWriter &w) {
+          writeMetricsJson(w, *m);
+        });
+      } else {
+        sendRendered(request, "text/plain; version=0.0.4", [m](PageWriter &w) {
+          writeMetricsProm(w, *m);
+        });
+      }
+    });
+
+    // Statické soubory (CSS, JS) z flash
+    for (uint8_t i = 0; i < STATIC_ASSET_COUNT; i++) {
+      const StaticAsset *asset = &STATIC_ASSETS[i];
+      onRoute(asset->path, HTTP_GET, [asset](AsyncWebServerRequest *request) {
+        sendStaticAsset(request, *asset);
+      });
+    }
+
     // Dummy favicon
-    server.on("/favicon.ico", HTTP_GET, [](AsyncWebServerRequest *request) {
+    onRoute("/favicon.ico", HTTP_GET, [](AsyncWebServerRequest *request) {
       request->send(200, "image/x-icon", "");
     });
 
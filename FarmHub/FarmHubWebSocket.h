@@ -8,19 +8,210 @@
 #include "FarmHubConfig.h"
 #include "FarmHubWebSocket.h"
 #include "FarmHubData.h"
+#include "FarmHubMetrics.h"
+#include "FarmHubLight.h"
+#include "FarmHubTime.h"
+#include <FarmProto.h>
 
 // Jedna instance WebSocketu na endpointu /ws
 static AsyncWebSocket ws("/ws");
 
-// Odeslání příkazu RUN_PUMP všem klientům (JSON: { "cmd":"RUN_PUMP", "duration":X })
+// ------------------------------------------------------------
+// Registr připojených uzlů: role (FarmNodeId), odebíraná témata
+// a protokol (JSON / binární FarmProto). Příkazy se posílají jen
+// odběratelům daného tématu.
+// ------------------------------------------------------------
+// Počet slotů lze při překladu změnit (-DFARMHUB_WS_MAX_PEERS=N, max. 254),
+// např. pro zátěžový test hostitelského sestavení se stovkami uzlů
+#ifndef FARMHUB_WS_MAX_PEERS
+#define FARMHUB_WS_MAX_PEERS 6
+#endif
+static_assert(FARMHUB_WS_MAX_PEERS > 0 && FARMHUB_WS_MAX_PEERS < 255, "max. 254 uzlů");
+static const uint8_t WS_MAX_PEERS     = FARMHUB_WS_MAX_PEERS;
+static const size_t  WS_RX_BUFFER     = 1024;  // max. velikost fragmentované zprávy
+
+struct WsPeer {
+  uint32_t clientId;  // 0 = volné místo
+  uint8_t  proto;     // 0 = JSON, jinak verze binárního protokolu
+  uint8_t  node;      // FarmNodeId (NODE_HUB = neznámý)
+  uint8_t  topics;    // FARM_TOPIC_* maska
+  bool     acks;      // uzel potvrzuje příkazy (jinak se neopakují)
+
+  // Skládání zprávy rozdělené do více rámců / TCP paketů
+  uint8_t  rxOpcode;
+  bool     rxOverflow;
+  size_t   rxLen;
+  uint8_t  rx[WS_RX_BUFFER];
+};
+static WsPeer g_wsPeers[WS_MAX_PEERS];
+
+static inline WsPeer *findPeer(uint32_t clientId) {
+  for (uint8_t i = 0; i < WS_MAX_PEERS; i++) {
+    if (g_wsPeers[i].clientId == clientId) return &g_wsPeers[i];
+  }
+  return nullptr;
+}
+
+static inline WsPeer *addPeer(uint32_t clientId) {
+  WsPeer *p = findPeer(clientId);
+  if (!p) p = findPeer(0);
+  if (p) {
+    p->clientId   = clientId;
+    p->proto      = 0;
+    p->node       = NODE_HUB;
+    p->topics     = FARM_TOPIC_ALL;  // do ohlášení jako starý klient
+    p->acks       = false;
+    p->rxLen      = 0;
+    p->rxOverflow = false;
+  }
+  return p;
+}
+
+static inline void removePeer(uint32_t clientId) {
+  WsPeer *p = findPeer(clientId);
+  if (p) p->clientId = 0;
+}
+
+// Odeslání jednomu klientovi (započte se do metrik podle role uzlu)
+static inline void wsSendText(AsyncWebSocketClient *client, const char *msg) {
+  WsPeer *peer = findPeer(client->id());
+  metricsWsOut(peer ? peer->node : NODE_HUB);
+  client->text(msg);
+}
+
+static inline void wsSendBinary(AsyncWebSocketClient *client, const uint8_t *frame, size_t len) {
+  WsPeer *peer = findPeer(client->id());
+  metricsWsOut(peer ? peer->node : NODE_HUB);
+  client->binary((const char *)frame, len);
+}
+
+// Odešle zprávu odběratelům tématu, každému v jeho protokolu
+// (onlyAcking = jen uzlům, které potvrzují příkazy – pro opakované odeslání)
+static inline void publish(uint8_t topic, const uint8_t *frame, size_t frameLen, const char *json,
+                           bool onlyAcking = false) {
+  for (uint8_t i = 0; i < WS_MAX_PEERS; i++) {
+    if (g_wsPeers[i].clientId == 0 || !(g_wsPeers[i].topics & topic)) continue;
+    if (onlyAcking && !g_wsPeers[i].acks) continue;
+    AsyncWebSocketClient *client = ws.client(g_wsPeers[i].clientId);
+    if (!client) continue;
+    metricsWsOut(g_wsPeers[i].node);
+    if (g_wsPeers[i].proto > 0) {
+      client->binary((const char *)frame, frameLen);
+    } else {
+      client->text(json);
+    }
+  }
+}
+
+// ------------------------------------------------------------
+// Příkaz RUN_PUMP s potvrzením
+//
+// Každý příkaz má pořadové číslo (počáteční hodnota je po startu náhodná,
+// aby ji čerpadlo nezaměnilo s příkazem z minulého běhu hubu). Dokud uzel
+// nepotvrdí PUMP_ACK, hub příkaz opakuje po PUMP_RETRY_MS, nejdéle
+// PUMP_CMD_TIMEOUT_MS – tím přečká i reconnect čerpadla. Uzel duplicitní
+// seq nespustí znovu, jen ho znovu potvrdí. Po doběhnutí pošle PUMP_DONE
+// se skutečnou dobou chodu. Nový příkaz nahrazuje dosud nepotvrzený.
+// ------------------------------------------------------------
+static const unsigned long PUMP_RETRY_MS       = 2000;
+static const unsigned long PUMP_CMD_TIMEOUT_MS = 30000;
+
+struct PumpCommand {
+  uint32_t      seq;
+  uint16_t      durationSec;
+  bool          pending;     // čeká na PUMP_ACK
+  unsigned long issuedMs;
+  unsigned long lastSentMs;
+};
+
+// Jeden rozpracovaný příkaz na čerpadlo (index = číslo čerpadla)
+static PumpCommand g_pumpCmd[FARM_MAX_PUMPS];
+static uint32_t    g_pumpSeq  = 0;
+static uint32_t    g_pumpLastDoneSeq = 0;
+
+static inline void sendPumpCommand(uint8_t pump, bool retransmit) {
+  PumpCommand &cmd = g_pumpCmd[pump];
+  char msg[80];
+  snprintf(msg, sizeof(msg), "{\"cmd\":\"RUN_PUMP\",\"duration\":%u,\"seq\":%lu,\"pump\":%u}",
+           cmd.durationSec, (unsigned long)cmd.seq, pump);
+
+  uint8_t frame[FARM_HEADER_SIZE + 3];
+  FarmWriter w;
+  farmBegin(w, frame, sizeof(frame), MSG_RUN_PUMP, NODE_PUMP, cmd.seq);
+  farmPutU16(w, cmd.durationSec);
+  farmPutU8(w, pump);
+  publish(FARM_TOPIC_PUMP, frame, farmEnd(w), msg, retransmit);
+
+  cmd.lastSentMs = millis();
+  g_pumpStats.transmissions++;
+}
+
+// Odeslání příkazu RUN_PUMP pro dané čerpadlo odběratelům tématu "pump"
+// (JSON: { "cmd":"RUN_PUMP", "duration":X, "seq":N, "pump":P }), vrací seq
+uint32_t sendRunPump(uint8_t pump, int durationSec) {
+  if (pump >= FARM_MAX_PUMPS) return 0;
+  if (g_pumpSeq == 0) g_pumpSeq = ESP.random() | 1;
+  PumpCommand &cmd = g_pumpCmd[pump];
+  cmd.seq         = g_pumpSeq++;
+  if (g_pumpSeq == 0) g_pumpSeq = 1;  // 0 = příkaz bez potvrzování
+  cmd.durationSec = (uint16_t)constrain(durationSec, 0, 0xFFFF);
+  cmd.pending     = true;
+  cmd.issuedMs    = millis();
+  g_pumpStats.issued++;
+  sendPumpCommand(pump, false);
+  return cmd.seq;
+}
+
+// Ruční zalití – čerpadlo 0
 void broadcastRunPump(int durationSec) {
-  String msg = "{\"cmd\":\"RUN_PUMP\",\"duration\":";
-  msg += durationSec;
-  msg += "}";
-  ws.textAll(msg);
+  sendRunPump(0, durationSec);
 }
 
-void broadcastLightSettings() {
+// PUMP_ACK od čerpadla
+static inline void onPumpAck(uint32_t seq) {
+  for (uint8_t p = 0; p < FARM_MAX_PUMPS; p++) {
+    PumpCommand &cmd = g_pumpCmd[p];
+    if (!cmd.pending || seq != cmd.seq) continue;  // starý / duplicitní
+    cmd.pending = false;
+    g_pumpStats.acked++;
+    g_pumpStats.lastLatencyMs   = millis() - cmd.issuedMs;
+    g_pumpStats.totalLatencyMs += g_pumpStats.lastLatencyMs;
+    Serial.printf("Pump %u cmd %lu acked after %lu ms\n",
+                  p, (unsigned long)seq, g_pumpStats.lastLatencyMs);
+  }
+}
+
+// PUMP_DONE od čerpadla
+static inline void onPumpDone(uint32_t seq, uint32_t runtimeMs) {
+  if (seq == g_pumpLastDoneSeq) return;  // opakované hlášení
+  g_pumpLastDoneSeq = seq;
+  g_pumpStats.completed++;
+  g_pumpStats.lastRuntimeMs = runtimeMs;
+  Serial.printf("Pump cmd %lu done, ran %lu ms\n", (unsigned long)seq, (unsigned long)runtimeMs);
+  irrigationOnPumpDone(seq, runtimeMs);
+}
+
+// Volat z loop() – opakování nepotvrzených příkazů
+static inline void pumpCommandLoop() {
+  unsigned long now = millis();
+  for (uint8_t p = 0; p < FARM_MAX_PUMPS; p++) {
+    PumpCommand &cmd = g_pumpCmd[p];
+    if (!cmd.pending) continue;
+    if (now - cmd.issuedMs >= PUMP_CMD_TIMEOUT_MS) {
+      cmd.pending = false;
+      g_pumpStats.expired++;
+      Serial.printf("Pump %u cmd %lu not acknowledged, giving up\n", p, (unsigned long)cmd.seq);
+      irrigationOnPumpExpired(cmd.seq);
+    } else if (now - cmd.lastSentMs >= PUMP_RETRY_MS) {
+      sendPumpCommand(p, true);
+    }
+  }
+}
+
+static const size_t LIGHT_SETTINGS_FRAME =
+  FARM_HEADER_SIZE + 6 + FARM_LIGHT_MAX_WINDOWS * sizeof(FarmLightWindow);
+
+static inline size_t buildLightSettings(uint8_t *frame, char *msg, size_t msgLen) {
   // JSON s klíči definujícími stav
   // (manuální on/off a automatický režim a parametry)
   StaticJsonDocument<256> doc;
@@ -35,16 +226,104 @@ void broadcastLightSettings() {
   doc["onlyIfDark"]     = lightOnlyIfDark;
 
   // Převedeme do stringu
-  String msg;
-  serializeJson(doc, msg);
+  serializeJson(doc, msg, msgLen);
+
+  // Totéž binárně, navíc se všemi okny (JSON uzly znají jen hlavní okno)
+  FarmLightWindow windows[FARM_LIGHT_MAX_WINDOWS];
+  uint8_t count = lightAllWindows(windows);
+  FarmWriter w;
+  farmBegin(w, frame, LIGHT_SETTINGS_FRAME, MSG_LIGHT_SETTINGS, NODE_LIGHT_MODULE, 0);
+  farmPutU8(w, (manualLightOn   ? FARM_LIGHT_MANUAL_ON : 0) |
+               (autoLight       ? FARM_LIGHT_AUTO      : 0) |
+               (lightOnlyIfDark ? FARM_LIGHT_ONLY_DARK : 0));
+  farmPutU8(w, lightStartHour);
+  farmPutU8(w, lightStartMinute);
+  farmPutU8(w, lightEndHour);
+  farmPutU8(w, lightEndMinute);
+  farmPutU8(w, count);
+  for (uint8_t i = 0; i < count; i++) farmPutLightWindow(w, windows[i]);
+  return farmEnd(w);
+}
 
-  // Odeslání všem připojeným WebSocket klientům
-  ws.textAll(msg);
+// Po změně nastavení všem odběratelům tématu "light"
+void broadcastLightSettings() {
+  uint8_t frame[LIGHT_SETTINGS_FRAME];
+  char msg[192];
+  size_t len = buildLightSettings(frame, msg, sizeof(msg));
+  publish(FARM_TOPIC_LIGHT, frame, len, msg);
+}
+
+// Jen uzlu, který se právě ohlásil
+static inline void sendLightSettings(AsyncWebSocketClient *client, WsPeer *peer) {
+  uint8_t frame[LIGHT_SETTINGS_FRAME];
+  char msg[192];
+  size_t len = buildLightSettings(frame, msg, sizeof(msg));
+  if (peer->proto > 0) {
+    wsSendBinary(client, frame, len);
+  } else {
+    wsSendText(client, msg);
+  }
+}
+
+// ------------------------------------------------------------
+// Pravidla hlášení senzorů (REPORT_POLICY)
+//
+// Senzory měří po sampleSec, ale hlásí jen změnu větší než pásmo
+// necitlivosti, skok nad "urgent" hned a jinak nejpozději po
+// heartbeatSec. Hub je pošle při ohlášení uzlu a po každé změně.
+// ------------------------------------------------------------
+static const size_t REPORT_POLICY_FRAME = FARM_HEADER_SIZE + 4 + FARM_FIELD_COUNT * 8;
+
+static inline size_t buildReportPolicy(uint8_t *frame, char *msg, size_t msgLen) {
+  StaticJsonDocument<384> doc;
+  doc["cmd"]          = "REPORT_POLICY";
+  doc["sampleSec"]    = reportPolicy.sampleSec;
+  doc["heartbeatSec"] = reportPolicy.heartbeatSec;
+  JsonArray deadband = doc.createNestedArray("deadband");
+  JsonArray urgent   = doc.createNestedArray("urgent");
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    deadband.add(reportPolicy.deadband[f]);
+    urgent.add(reportPolicy.urgent[f]);
+  }
+  serializeJson(doc, msg, msgLen);
+
+  FarmWriter w;
+  farmBegin(w, frame, REPORT_POLICY_FRAME, MSG_REPORT_POLICY, NODE_HUB, 0);
+  farmPutReportPolicy(w, reportPolicy);
+  return farmEnd(w);
+}
+
+void broadcastReportPolicy() {
+  uint8_t frame[REPORT_POLICY_FRAME];
+  char msg[256];
+  size_t len = buildReportPolicy(frame, msg, sizeof(msg));
+  publish(FARM_TOPIC_REPORT, frame, len, msg);
+}
+
+static inline void sendReportPolicy(AsyncWebSocketClient *client, WsPeer *peer) {
+  uint8_t frame[REPORT_POLICY_FRAME];
+  char msg[256];
+  size_t len = buildReportPolicy(frame, msg, sizeof(msg));
+  if (peer->proto > 0) {
+    wsSendBinary(client, frame, len);
+  } else {
+    wsSendText(client, msg);
+  }
 }
 
 void sendInitTime(AsyncWebSocketClient *client) {
-  // Získání aktuálního času (epoch time) z interního RTC/časového nastavení
-  time_t now = time(nullptr);
+  // Epoch, před synchronizací NTP prozatímní čas (FarmHubTime.h)
+  uint32_t now = hubNow();
+  WsPeer *peer = findPeer(client->id());
+
+  if (peer && peer->proto > 0) {
+    uint8_t frame[FARM_HEADER_SIZE + 4];
+    FarmWriter w;
+    farmBegin(w, frame, sizeof(frame), MSG_TIME, peer->node, 0);
+    farmPutU32(w, now);
+    wsSendBinary(client, frame, farmEnd(w));
+    return;
+  }
 
   StaticJsonDocument<128> doc;
   doc["cmd"] = "INIT_TIME";
@@ -52,7 +331,288 @@ void sendInitTime(AsyncWebSocketClient *client) {
 
   String msg;
   serializeJson(doc, msg);
-  client->text(msg); // Odeslání danému klientovi
+  wsSendText(client, msg.c_str()); // Odeslání danému klientovi
+}
+
+// Čas všem připojeným (po synchronizaci NTP nahradí prozatímní čas)
+void broadcastTime() {
+  for (uint8_t i = 0; i < WS_MAX_PEERS; i++) {
+    if (g_wsPeers[i].clientId == 0) continue;
+    AsyncWebSocketClient *client = ws.client(g_wsPeers[i].clientId);
+    if (client) sendInitTime(client);
+  }
+}
+
+// Přepnutí klienta na binární protokol (uzel ho nabídl v ohlášení)
+static inline void acceptBinaryProto(AsyncWebSocketClient *client, WsPeer *peer, uint8_t version) {
+  if (version < 1) return;
+  peer->proto = (version < FARM_PROTO_VERSION) ? version : FARM_PROTO_VERSION;
+
+  uint8_t frame[FARM_HEADER_SIZE + 1];
+  FarmWriter w;
+  farmBegin(w, frame, sizeof(frame), MSG_WELCOME, peer->node, 0);
+  farmPutU8(w, peer->proto);
+  wsSendBinary(client, frame, farmEnd(w));
+  sendInitTime(client);
+  Serial.printf("Client #%u (%s) uses binary protocol v%u\n",
+                client->id(), farmNodeName(peer->node), peer->proto);
+}
+
+// Ohlášení uzlu: {"sensorID":"x"[,"node":N][,"topics":["pump",..]][,"proto":V]}
+static inline void identifyPeer(AsyncWebSocketClient *client, JsonDocument &doc) {
+  WsPeer *peer = findPeer(client->id());
+  if (!peer) return;
+
+  peer->node = doc["node"] | farmNodeFromName(doc["sensorID"] | "");
+  if (peer->node >= NODE_COUNT) peer->node = NODE_HUB;
+
+  if (doc.containsKey("topics")) {
+    peer->topics = 0;
+    for (JsonVariant t : doc["topics"].as<JsonArray>()) {
+      peer->topics |= farmTopicFromName(t | "");
+    }
+  } else {
+    peer->topics = farmNodeTopics(peer->node);
+  }
+  peer->acks = doc["acks"] | false;
+  Serial.printf("Client #%u is %s, topics 0x%02X\n",
+                client->id(), farmNodeName(peer->node), peer->topics);
+
+  if (doc.containsKey("proto")) {
+    acceptBinaryProto(client, peer, doc["proto"] | 0);
+  }
+
+  // Nastavení uzlu hned po (re)connectu, ne až při další změně
+  // (prohlížeč s FARM_TOPIC_ALL je nepotřebuje)
+  if (peer->topics == FARM_TOPIC_ALL) return;
+  if (peer->topics & FARM_TOPIC_REPORT) sendReportPolicy(client, peer);
+  if (peer->topics & FARM_TOPIC_LIGHT)  sendLightSettings(client, peer);
+}
+
+// ------------------------------------------------------------
+// Příjem měření
+//
+// Jednotlivé měření: {"sensorID":"x","soil":..,"temp":..,...}
+// Dávka:             {"sensorID":"x","boot":B,"seq":S,"batch":[{"ts":..,"soil":..},...]}
+//
+// V dávce nese každé měření čas pořízení od senzoru ("ts", epoch s),
+// vzorky mají po sobě jdoucí pořadová čísla od S. Hub odpoví
+// {"status":"OK","ack":N} a senzor smaže vzorky do N. Pokud se potvrzení
+// ztratí a dávka přijde znovu, už uložené vzorky se podle (boot, seq)
+// přeskočí.
+// ------------------------------------------------------------
+static const uint8_t  WS_MAX_BATCH      = 16;    // max. vzorků zpracovaných z jedné zprávy
+static const size_t   WS_JSON_CAPACITY  = 2048;
+
+// Dokument pro parsování příchozího JSON – jeden pro všechny klienty
+// (události WebSocketu se zpracovávají postupně), aby příjem nealokoval
+// na haldě ani nezabíral 2 kB zásobníku.
+static StaticJsonDocument<WS_JSON_CAPACITY> g_wsDoc;
+static const uint32_t WS_MAX_CLOCK_SKEW = 300;   // čas senzoru smí předbíhat hub max. o 5 min
+
+struct UplinkState {
+  bool     valid;
+  uint32_t boot;     // náhodné ID běhu senzoru (po restartu začíná seq znovu)
+  uint32_t lastSeq;  // poslední uložený vzorek
+};
+static UplinkState g_uplink[MAX_SENSOR_IDS];
+
+// Čas od senzoru se použije, jen pokud je uvěřitelný; jinak čas příjmu.
+// Před synchronizací hubu jsou oba prozatímní (s od startu hubu, viz
+// FarmHubTime.h); čas z jiné osy než má hub se nahradí časem příjmu.
+static inline uint32_t sanitizeTimestamp(uint32_t ts, uint32_t now) {
+  if (ts == 0 || ts > now + WS_MAX_CLOCK_SKEW) return now;
+  if (isProvisional(ts) != isProvisional(now)) return now;
+  return ts;
+}
+
+// Které veličiny zpráva obsahuje (0 = žádné, tj. jen ohlášení)
+static inline uint8_t jsonReadingFields(JsonVariant v) {
+  return (v.containsKey("soil")  ? (1 << FIELD_SOIL)  : 0) |
+         (v.containsKey("temp")  ? (1 << FIELD_TEMP)  : 0) |
+         (v.containsKey("hum")   ? (1 << FIELD_HUM)   : 0) |
+         (v.containsKey("light") ? (1 << FIELD_LIGHT) : 0);
+}
+
+// Převod jednoho měření z JSON
+static inline void readingFromJson(JsonVariant v, uint8_t sensorId, uint32_t now, SensorReading &sr) {
+  sr.sensorId     = sensorId;
+  sr.soilMoisture = v["soil"]  | 0.0;
+  sr.temperature  = v["temp"]  | 0.0;
+  sr.humidity     = v["hum"]   | 0.0;
+  sr.lightLevel   = v["light"] | 0.0;
+  sr.fields       = jsonReadingFields(v);
+  sr.timestamp    = sanitizeTimestamp(v["ts"] | 0UL, now);
+}
+
+// Převod jednoho vzorku z binárního rámce (bity masky odpovídají FIELD_*)
+static inline void readingFromSample(const FarmSample &s, uint8_t sensorId, uint32_t now, SensorReading &sr) {
+  static_assert(FARM_FIELD_SOIL == FIELD_SOIL && FARM_FIELD_TEMP == FIELD_TEMP &&
+                FARM_FIELD_HUM == FIELD_HUM && FARM_FIELD_LIGHT == FIELD_LIGHT,
+                "FarmProto field bits must match FIELD_*");
+  sr.sensorId     = sensorId;
+  sr.fields       = s.fields & ((1 << FIELD_COUNT) - 1);
+  sr.soilMoisture = s.values[FIELD_SOIL];
+  sr.temperature  = s.values[FIELD_TEMP];
+  sr.humidity     = s.values[FIELD_HUM];
+  sr.lightLevel   = s.values[FIELD_LIGHT];
+  sr.timestamp    = sanitizeTimestamp(s.ts, now);
+}
+
+// Společná část pro JSON i binární dávku: readings[i] je vzorek seq + i.
+// Vyřadí duplicity a prázdné vzorky, zbytek uloží jedním zápisem do logu.
+// Vrací číslo posledního zpracovaného vzorku (pro potvrzení).
+static inline uint32_t commitBatch(uint8_t sensorId, uint32_t boot, uint32_t seq,
+                                   SensorReading *readings, uint8_t taken) {
+  UplinkState *st = (sensorId < MAX_SENSOR_IDS) ? &g_uplink[sensorId] : nullptr;
+  bool known = st && st->valid && st->boot == boot;
+
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < taken; i++) {
+    if (known && (int32_t)(seq + i - st->lastSeq) <= 0) continue; // duplicita
+    if (readings[i].fields == 0) continue;
+    readings[count++] = readings[i];
+  }
+  storeSensorBatch(readings, count);
+
+  uint32_t last = seq + taken - 1;
+  if (st && taken > 0) {
+    st->valid   = true;
+    st->boot    = boot;
+    st->lastSeq = last;
+  }
+  Serial.printf("Batch from %s: %u samples, %u stored\n",
+                sensorIdName(sensorId), (unsigned)taken, (unsigned)count);
+  return last;
+}
+
+// Dávka v JSON
+static inline uint32_t ingestBatch(JsonDocument &doc, uint8_t sensorId) {
+  JsonArray batch = doc["batch"].as<JsonArray>();
+  uint32_t  now   = hubNow();
+
+  SensorReading readings[WS_MAX_BATCH];
+  uint8_t taken = 0;
+  for (JsonVariant v : batch) {
+    if (taken >= WS_MAX_BATCH) break;
+    readingFromJson(v, sensorId, now, readings[taken++]);
+  }
+  return commitBatch(sensorId, doc["boot"] | 0UL, doc["seq"] | 0UL, readings, taken);
+}
+
+// Binární rámec od uzlu
+static inline void handleBinaryFrame(AsyncWebSocketClient *client, const uint8_t *data, size_t len) {
+  FarmHeader hdr;
+  FarmReader r;
+  if (!farmParse(data, len, hdr, r)) {
+    Serial.printf("Client #%u: invalid binary frame (%u B)\n", client->id(), (unsigned)len);
+    return;
+  }
+
+  if (hdr.type == MSG_READINGS) {
+    uint8_t  sensorId = internSensorID(farmNodeName(hdr.node));
+    uint32_t boot     = farmGetU32(r);
+    uint8_t  n        = farmGetU8(r);
+    uint32_t now      = hubNow();
+
+    SensorReading readings[WS_MAX_BATCH];
+    uint8_t taken = 0;
+    FarmSample sample;
+    while (taken < n && taken < WS_MAX_BATCH && farmGetSample(r, sample)) {
+      readingFromSample(sample, sensorId, now, readings[taken++]);
+    }
+
+    uint8_t frame[FARM_HEADER_SIZE];
+    FarmWriter w;
+    farmBegin(w, frame, sizeof(frame), MSG_ACK, hdr.node,
+              commitBatch(sensorId, boot, hdr.seq, readings, taken));
+    wsSendBinary(client, frame, farmEnd(w));
+  } else if (hdr.type == MSG_PUMP_ACK) {
+    onPumpAck(hdr.seq);
+  } else if (hdr.type == MSG_PUMP_DONE) {
+    onPumpDone(hdr.seq, farmGetU32(r));
+  }
+}
+
+// Textová (JSON) zpráva. Parsuje se přímo v přijatém bufferu – řetězce
+// v dokumentu ukazují do `data`, které platí jen během volání.
+static inline void handleJsonMessage(AsyncWebSocketClient *client, char *data, size_t len) {
+  Serial.printf("Data from #%u: %u B JSON\n", client->id(), (unsigned)len);
+
+  JsonDocument &doc = g_wsDoc;
+  uint32_t parseStart = micros();
+  DeserializationError err = deserializeJson(doc, data, len);
+  latencyRecord(g_metrics.jsonParse, micros() - parseStart);
+  if (err) {
+    g_metrics.jsonErrors++;
+    wsSendText(client, "{\"status\":\"ERROR\",\"reason\":\"JSON parse\"}");
+    return;
+  }
+
+  const char *cmd = doc["cmd"] | "";
+  if (strcmp(cmd, "PUMP_ACK") == 0) {
+    onPumpAck(doc["seq"] | 0UL);
+  } else if (strcmp(cmd, "PUMP_DONE") == 0) {
+    onPumpDone(doc["seq"] | 0UL, doc["runtimeMs"] | 0UL);
+  } else if (doc.containsKey("batch")) {
+    uint8_t sensorId = internSensorID(doc["sensorID"] | "unknown");
+    char reply[48];
+    snprintf(reply, sizeof(reply), "{\"status\":\"OK\",\"ack\":%lu}",
+             (unsigned long)ingestBatch(doc, sensorId));
+    wsSendText(client, reply);
+  } else if (jsonReadingFields(doc.as<JsonVariant>()) == 0) {
+    // Bez hodnot = ohlášení uzlu (role, témata, protokol)
+    identifyPeer(client, doc);
+    if (!doc.containsKey("proto")) wsSendText(client, "{\"status\":\"OK\"}");
+  } else {
+    uint8_t sensorId = internSensorID(doc["sensorID"] | "unknown");
+    SensorReading sr;
+    readingFromJson(doc.as<JsonVariant>(), sensorId, hubNow(), sr);
+    storeSensorData(sr);
+    wsSendText(client, "{\"status\":\"OK\"}");
+  }
+}
+
+static inline void handleWsMessage(AsyncWebSocketClient *client, uint8_t opcode,
+                                   uint8_t *data, size_t len) {
+  WsPeer *peer = findPeer(client->id());
+  metricsWsIn(peer ? peer->node : NODE_HUB, len);
+  if (opcode == WS_BINARY) {
+    handleBinaryFrame(client, data, len);
+  } else if (opcode == WS_TEXT) {
+    handleJsonMessage(client, (char *)data, len);
+  }
+}
+
+// Část zprávy (fragment nebo kus rámce) – skládá se v bufferu klienta.
+// Zpráva delší než WS_RX_BUFFER se zahodí.
+static inline void handleWsFragment(AsyncWebSocketClient *client, const AwsFrameInfo *info,
+                                    uint8_t *data, size_t len) {
+  WsPeer *peer = findPeer(client->id());
+  if (!peer) return;
+
+  if (info->index == 0 && info->num == 0) {
+    // první kus první části zprávy
+    peer->rxOpcode   = info->message_opcode;
+    peer->rxLen      = 0;
+    peer->rxOverflow = false;
+  }
+  if (peer->rxLen + len > WS_RX_BUFFER) {
+    peer->rxOverflow = true;
+  } else {
+    memcpy(peer->rx + peer->rxLen, data, len);
+    peer->rxLen += len;
+  }
+
+  bool frameEnd = (info->index + len == info->len);
+  if (!frameEnd || !info->final) return;
+
+  if (peer->rxOverflow) {
+    Serial.printf("Client #%u: message over %u B dropped\n", client->id(), (unsigned)WS_RX_BUFFER);
+  } else {
+    handleWsMessage(client, peer->rxOpcode, peer->rx, peer->rxLen);
+  }
+  peer->rxLen = 0;
 }
 
 // Obsluha událostí na WebSocketu
@@ -66,31 +626,35 @@ static inline void onWsEvent(AsyncWebSocket *server,
   if (type == WS_EVT_CONNECT) {
     Serial.printf("Client #%u connected from %s\n", 
                   client->id(), client->remoteIP().toString().c_str());
-    client->text("{\"msg\":\"Welcome sensor!\"}");
+    if (!addPeer(client->id())) {
+      // Bez slotu by se klient neuměl ohlásit ani skládat zprávy – odmítne se
+      Serial.printf("Client #%u rejected: all %u peer slots in use\n",
+                    client->id(), (unsigned)WS_MAX_PEERS);
+      g_metrics.wsRejected++;
+      client->close();
+      return;
+    }
+    g_metrics.wsClients++;
+    wsSendText(client, "{\"msg\":\"Welcome sensor!\"}");
     sendInitTime(client);
   }
   else if (type == WS_EVT_DISCONNECT) {
     Serial.printf("Client #%u disconnected.\n", client->id());
+    if (findPeer(client->id())) {
+      removePeer(client->id());
+      if (g_metrics.wsClients > 0) g_metrics.wsClients--;
+    }
   }
   else if (type == WS_EVT_DATA) {
-    data[len] = 0;
-    String payload = (char*)data;
-    Serial.printf("Data from #%u: %s\n", client->id(), payload.c_str());
-
-    StaticJsonDocument<256> doc;
-    DeserializationError err = deserializeJson(doc, payload);
-    if (!err) {
-      SensorReading sr;
-      sr.sensorID     = doc["sensorID"]   | "unknown";
-      sr.soilMoisture = doc["soil"]       | 0.0;
-      sr.temperature  = doc["temp"]       | 0.0;
-      sr.humidity     = doc["hum"]        | 0.0;
-      sr.lightLevel   = doc["light"]      | 0.0;
-      sr.timestamp    = (unsigned long)time(nullptr);
-      storeSensorData(sr);
-      client->text("{\"status\":\"OK\"}");
+    AwsFrameInfo *info = (AwsFrameInfo *)arg;
+    if (info->final && info->index == 0 && info->len == len &&
+        info->num == 0 && info->opcode != WS_CONTINUATION) {
+      // Celá zpráva v jednom rámci – zpracuje se přímo v bufferu knihovny.
+      // Poslední rámec fragmentované zprávy (num > 0, opcode CONTINUATION)
+      // sem nepatří, jeho začátek už je v bufferu klienta.
+      handleWsMessage(client, info->opcode, data, len);
     } else {
-      client->text("{\"status\":\"ERROR\",\"reason\":\"JSON parse\"}");
+      handleWsFragment(client, info, data, len);
     }
   }
 }
@@ -0,0 +1,241 @@
+#ifndef FARM_HUB_WIFI_H
+#define FARM_HUB_WIFI_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <vector>
+#include <FarmWifiCache.h>
+#include "FarmHubScheduler.h"
+#include "FarmHubConfig.h"
+
+// Výchozí AP (Access Point) údaje
+static const char* AP_SSID = "FarmHub-AP";
+static const char* AP_PASS = "farmhub123";
+
+// Proměnné pro asynchronní skenování
+static bool g_isScanning    = false;
+static bool g_scanComplete  = false;
+static int  g_foundNetworks = 0;
+static std::vector<String> g_scannedSSIDs;
+static uint8_t g_scanTask   = SCHED_NONE;
+
+static const uint32_t SCAN_POLL_MS = 500;
+
+static inline void checkAsyncScan();
+
+// Jednorázová úloha plánovače, která se přeplánuje, dokud sken běží
+static inline void pollAsyncScan() {
+  checkAsyncScan();
+  if (g_isScanning) {
+    schedulerRunIn(g_scanTask, SCAN_POLL_MS);
+  } else {
+    g_scanTask = SCHED_NONE;
+  }
+}
+
+// Spuštění AP + STA módu
+static inline void setupWifiAP() {
+  WiFi.mode(WIFI_AP_STA);
+  WiFi.softAP(AP_SSID, AP_PASS);
+
+  Serial.println("=== AP MODE ===");
+  Serial.print("AP SSID: ");
+  Serial.println(AP_SSID);
+  Serial.print("AP PASS: ");
+  Serial.println(AP_PASS);
+  Serial.print("AP IP: ");
+  Serial.println(WiFi.softAPIP());
+}
+
+// ------------------------------------------------------------
+// Připojení k domácí Wi-Fi na pozadí
+//
+// homeWifiBegin() jen zavolá WiFi.begin(); stav pak sleduje úloha
+// plánovače, takže AP, webserver i WebSocket běží od startu. Když se
+// připojení nepovede do HOME_WIFI_JOIN_MS, STA se odpojí (jinak by
+// přeskakováním kanálů rušilo AP) a zkusí se znovu po HOME_WIFI_RETRY_MS.
+// S uloženým profilem (homeWifiProfile) se připojí bez skenu (adresa z DHCP);
+// když to do FARM_WIFI_FAST_JOIN_MS nevyjde, hned následuje úplné připojení.
+// Po výpadku navázaného spojení se SDK připojuje samo (RECONNECTING);
+// krátký limit rychlého připojení ani zneplatnění profilu se na to nevztahují.
+// ------------------------------------------------------------
+enum HomeWifiState : uint8_t {
+  HOME_WIFI_OFF,         // bez přihlašovacích údajů
+  HOME_WIFI_JOINING,
+  HOME_WIFI_CONNECTED,
+  HOME_WIFI_RECONNECTING, // výpadek, SDK se připojuje samo
+  HOME_WIFI_FAILED       // čeká na další pokus
+};
+
+static const uint32_t HOME_WIFI_POLL_MS  = 500;
+static const uint32_t HOME_WIFI_JOIN_MS  = 10000;
+static const uint32_t HOME_WIFI_RETRY_MS = 60000;
+
+static HomeWifiState g_homeWifi       = HOME_WIFI_OFF;
+static uint32_t      g_homeWifiSince  = 0;   // millis() vstupu do stavu
+static uint32_t      g_homeWifiJoins  = 0;   // úspěšná připojení
+static uint32_t      g_homeWifiJoinMs = 0;   // doba posledního připojení
+static FarmJoinMode  g_homeWifiMode   = FARM_JOIN_FULL;
+static uint8_t       g_homeWifiTask   = SCHED_NONE;
+static String        g_homeWifiSsid;
+static String        g_homeWifiPass;
+
+static inline const char *homeWifiStateName(HomeWifiState s) {
+  switch (s) {
+    case HOME_WIFI_JOINING:      return "připojuje se";
+    case HOME_WIFI_CONNECTED:    return "připojeno";
+    case HOME_WIFI_RECONNECTING: return "výpadek, připojuje se";
+    case HOME_WIFI_FAILED:       return "nepřipojeno, zkusí znovu";
+    default:                     return "nenastaveno";
+  }
+}
+
+static inline void homeWifiEnter(HomeWifiState s) {
+  g_homeWifi      = s;
+  g_homeWifiSince = millis();
+}
+
+static inline void homeWifiJoin() {
+  const FarmWifiProfile &p = homeWifiProfile;
+  g_homeWifiMode = farmWifiJoinMode(p, g_homeWifiSsid.c_str());
+  Serial.printf("Connecting to: %s (%s)\n", g_homeWifiSsid.c_str(),
+                g_homeWifiMode == FARM_JOIN_FAST ? "cached profile + DHCP" : "scan + DHCP");
+  WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));   // adresa vždy z DHCP
+  if (g_homeWifiMode == FARM_JOIN_FAST) {
+    WiFi.begin(g_homeWifiSsid.c_str(), g_homeWifiPass.c_str(), p.channel, p.bssid);
+  } else {
+    WiFi.begin(g_homeWifiSsid.c_str(), g_homeWifiPass.c_str());
+  }
+  homeWifiEnter(HOME_WIFI_JOINING);
+}
+
+static inline void homeWifiJoined() {
+  g_homeWifiJoins++;
+  g_homeWifiJoinMs = millis() - g_homeWifiSince;
+  if (g_homeWifiMode == FARM_JOIN_FULL) {
+    farmWifiProfileStore(homeWifiProfile, g_homeWifiSsid.c_str(), WiFi.BSSID(), WiFi.channel());
+    saveUserConfig();
+  }
+  homeWifiEnter(HOME_WIFI_CONNECTED);
+  Serial.printf("Connected to home WiFi in %lu ms, IP: %s\n",
+                (unsigned long)g_homeWifiJoinMs, WiFi.localIP().toString().c_str());
+}
+
+static inline void homeWifiPoll() {
+  bool     up      = (WiFi.status() == WL_CONNECTED);
+  uint32_t elapsed = millis() - g_homeWifiSince;
+
+  switch (g_homeWifi) {
+    case HOME_WIFI_JOINING:
+      if (up) {
+        homeWifiJoined();
+      } else if (g_homeWifiMode == FARM_JOIN_FAST && elapsed >= FARM_WIFI_FAST_JOIN_MS) {
+        Serial.println("Cached WiFi profile failed, full join");
+        farmWifiProfileInvalidate(homeWifiProfile);
+        saveUserConfig();
+        WiFi.disconnect();
+        homeWifiJoin();
+      } else if (elapsed >= HOME_WIFI_JOIN_MS) {
+        Serial.println("Failed to connect to home WiFi, retry later");
+        WiFi.disconnect();
+        homeWifiEnter(HOME_WIFI_FAILED);
+      }
+      break;
+
+    case HOME_WIFI_CONNECTED:
+      // Výpadek: SDK se znovu připojuje samo, hlídáme jen limit
+      if (!up) {
+        Serial.println("Home WiFi link lost, reconnecting");
+        homeWifiEnter(HOME_WIFI_RECONNECTING);
+      }
+      break;
+
+    case HOME_WIFI_RECONNECTING:
+      if (up) {
+        homeWifiEnter(HOME_WIFI_CONNECTED);
+      } else if (elapsed >= HOME_WIFI_JOIN_MS) {
+        Serial.println("Home WiFi did not come back, retry later");
+        WiFi.disconnect();
+        homeWifiEnter(HOME_WIFI_FAILED);
+      }
+      break;
+
+    case HOME_WIFI_FAILED:
+      if (elapsed >= HOME_WIFI_RETRY_MS && !g_isScanning) homeWifiJoin();
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Zahájí připojení k domácí síti (nečeká na něj). Volá se při
+ *        startu i po změně údajů; prázdné údaje připojování vypnou.
+ */
+static inline bool homeWifiBegin(const String &ssid, const String &pass) {
+  if (g_homeWifi != HOME_WIFI_OFF) WiFi.disconnect();
+  g_homeWifiSsid = ssid;
+  g_homeWifiPass = pass;
+  if (ssid.isEmpty() || pass.isEmpty()) {
+    Serial.println("Home WiFi credentials empty, skipping...");
+    homeWifiEnter(HOME_WIFI_OFF);
+    return false;
+  }
+  if (g_homeWifiTask == SCHED_NONE) {
+    g_homeWifiTask = schedulerEvery("homeWifi", homeWifiPoll, HOME_WIFI_POLL_MS);
+  }
+  homeWifiJoin();
+  return true;
+}
+
+// Získání lokální IP
+static inline IPAddress getLocalIP() {
+  return WiFi.localIP();
+}
+
+// Spuštění asynchronního skenu
+static inline void startAsyncScan() {
+  if (!g_isScanning) {
+    Serial.println("Starting async Wi-Fi scan...");
+    g_isScanning   = true;
+    g_scanComplete = false;
+    g_foundNetworks = -1;
+    WiFi.scanNetworks(true);
+    g_scanTask = schedulerOnce("wifiScan", pollAsyncScan, SCAN_POLL_MS);
+  }
+}
+
+// Kontrola, zda sken doběhl a uložení výsledků
+static inline void checkAsyncScan() {
+  if (!g_isScanning) return;
+
+  int result = WiFi.scanComplete();
+  if (result == WIFI_SCAN_RUNNING) {
+    return; // stále probíhá
+  }
+  else if (result == WIFI_SCAN_FAILED) {
+    Serial.println("Scan failed, retrying...");
+    WiFi.scanDelete();
+    WiFi.scanNetworks(true);
+  }
+  else {
+    g_isScanning    = false;
+    g_scanComplete  = true;
+    g_foundNetworks = result;
+
+    g_scannedSSIDs.clear();
+    for (int i = 0; i < result; i++) {
+      g_scannedSSIDs.push_back(WiFi.SSID(i));
+    }
+    WiFi.scanDelete();
+
+    // Obnovíme AP pro jistotu
+    WiFi.mode(WIFI_AP_STA);
+    WiFi.softAP(AP_SSID, AP_PASS);
+
+    Serial.printf("Scan complete, found %d networks.\n", result);
+  }
+}
+
+#endif // FARM_HUB_WIFI_H
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Zpracování výstupu benchmarků hubu (sestavení s FARMHUB_BENCH).
+
+Ze záznamu sériové linky vybere řádky "BENCH {json}" a uloží je jako
+JSON soubor. S --baseline porovná usPerOp s předchozím během a skončí
+s chybou, pokud se něco zhoršilo víc než o --threshold procent:
+
+    pio device monitor | tee bench.log     # nebo Serial Monitor -> soubor
+    python3 tools/bench_report.py bench.log --out bench.json --baseline bench-main.json
+
+Stejné benchmarky s logem o 1k/100k/1M záznamech a 1–100 uzly běží i na PC
+(test/bench_hub.cpp):
+
+    ./bench_hub | python3 ../FarmHub/tools/bench_report.py --out bench.json
+"""
+
+import argparse
+import json
+import sys
+
+
+def parse(lines):
+    results = []
+    for line in lines:
+        pos = line.find("BENCH {")
+        if pos < 0:
+            continue
+        try:
+            results.append(json.loads(line[pos + len("BENCH "):]))
+        except ValueError:
+            print("nečitelný řádek: %s" % line.strip(), file=sys.stderr)
+    return results
+
+
+def key(r):
+    return "%s/%s" % (r["name"], r["param"])
+
+
+def main():
+    p = argparse.ArgumentParser(description="Výsledky benchmarků FarmHubu")
+    p.add_argument("log", nargs="?", help="záznam ze Serialu (výchozí stdin)")
+    p.add_argument("--out", help="výsledky do JSON souboru")
+    p.add_argument("--baseline", help="JSON z předchozího běhu pro porovnání")
+    p.add_argument("--threshold", type=float, default=10.0, help="povolené zhoršení v %%")
+    args = p.parse_args()
+
+    if args.log:
+        with open(args.log, errors="replace") as f:
+            results = parse(f)
+    else:
+        results = parse(sys.stdin)
+    if not results:
+        sys.exit("žádné řádky BENCH")
+
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump({"results": results}, f, indent=2)
+
+    base = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            base = {key(r): r for r in json.load(f)["results"]}
+
+    regressions = 0
+    print("%-20s %8s %8s %12s %10s %10s" % ("benchmark", "param", "ops", "us/op", "baseline", "změna"))
+    for r in results:
+        old = base.get(key(r))
+        change = ""
+        if old and old["usPerOp"] > 0:
+            pct = (r["usPerOp"] - old["usPerOp"]) * 100.0 / old["usPerOp"]
+            change = "%+.1f %%" % pct
+            if pct > args.threshold:
+                change += " !"
+                regressions += 1
+        print("%-20s %8s %8s %12.2f %10s %10s" % (
+            r["name"], r["param"], r["ops"], r["usPerOp"],
+            "%.2f" % old["usPerOp"] if old else "-", change))
+
+    if regressions:
+        sys.exit("%d benchmarků horší o víc než %.0f %%" % (regressions, args.threshold))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Zabalí statické soubory z FarmHub/web do FarmHubAssets.h.
+
+Každý soubor se zkomprimuje gzipem (deterministicky, bez času v hlavičce)
+a uloží jako PROGMEM pole. ETag je zkrácený SHA-1 obsahu, takže se mění
+jen při změně souboru. Spouštět po každé úpravě web/*:
+
+    python3 tools/embed_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUT = os.path.join(ROOT, "FarmHubAssets.h")
+
+CONTENT_TYPES = {
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".html": "text/html",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+
+def symbol(name):
+    return "ASSET_" + re.sub(r"[^A-Za-z0-9]", "_", name).upper()
+
+
+def main():
+    assets = []
+    for name in sorted(os.listdir(WEB_DIR)):
+        ext = os.path.splitext(name)[1]
+        if ext not in CONTENT_TYPES:
+            continue
+        with open(os.path.join(WEB_DIR, name), "rb") as f:
+            raw = f.read()
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha1(raw).hexdigest()[:12]
+        assets.append((name, symbol(name), CONTENT_TYPES[ext], packed, etag, len(raw)))
+
+    out = []
+    out.append("#ifndef FARM_HUB_ASSETS_H")
+    out.append("#define FARM_HUB_ASSETS_H")
+    out.append("")
+    out.append("// VYGENEROVÁNO skriptem tools/embed_assets.py z adresáře web/ – neupravovat ručně.")
+    out.append("")
+    out.append("#include <Arduino.h>")
+    out.append("")
+    for name, sym, ctype, packed, etag, rawlen in assets:
+        out.append("// %s: %d B, gzip %d B" % (name, rawlen, len(packed)))
+        out.append('#define %s_ETAG "%s"' % (sym, etag))
+        out.append("static const uint8_t %s[] PROGMEM = {" % sym)
+        for i in range(0, len(packed), 16):
+            out.append("  " + ",".join("0x%02x" % b for b in packed[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+    out.append("struct StaticAsset {")
+    out.append("  const char    *path;         // URL bez query (?v=ETag)")
+    out.append("  const char    *contentType;")
+    out.append("  const uint8_t *data;         // gzip v PROGMEM")
+    out.append("  size_t         length;")
+    out.append("  const char    *etag;")
+    out.append("};")
+    out.append("")
+    out.append("static const StaticAsset STATIC_ASSETS[] = {")
+    for name, sym, ctype, packed, etag, rawlen in assets:
+        out.append('  { "/static/%s", "%s", %s, sizeof(%s), %s_ETAG },' % (name, ctype, sym, sym, sym))
+    out.append("};")
+    out.append("static const uint8_t STATIC_ASSET_COUNT = sizeof(STATIC_ASSETS) / sizeof(STATIC_ASSETS[0]);")
+    out.append("")
+    out.append("#endif // FARM_HUB_ASSETS_H")
+    out.append("")
+
+    with open(OUT, "w", newline="\n") as f:
+        f.write("\n".join(out))
+    for name, sym, ctype, packed, etag, rawlen in assets:
+        print("%-12s %6d -> %6d B  etag %s" % (name, rawlen, len(packed), etag))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,593 @@
+#!/usr/bin/env python3
+"""Simulace flotily uzlů proti běžícímu hubu (zátěžový test /ws).
+
+Spustí N virtuálních uzlů (půdní/DHT senzory, světelné senzory, čerpadla
+a světelné moduly). Uzly mluví se skutečným hubem stejným protokolem
+jako sketche: JSON ohlášení, binární FarmProto po MSG_WELCOME, dávky
+měření s potvrzením a PUMP_ACK/PUMP_DONE na příkazy RUN_PUMP.
+Po skončení vypíše propustnost a latenci potvrzení dávek. Před a po
+běhu stáhne /metrics?format=json, takže je vidět i halda, čas
+parsování a zápisu do logu na hubu.
+
+Jen standardní knihovna (asyncio + vlastní minimální WebSocket klient):
+
+    python3 tools/fleet_sim.py --host 192.168.4.1 --soil 10 --light 10 \\
+        --pump 2 --lightmodule 2 --interval 5 --duration 120 --out sim.json
+
+Bez hardwaru proti hubu přeloženému pro PC (test/farmhub_host.cpp,
+cíl farmhub_host v test/CMakeLists.txt); --check vrátí chybu, když
+senzory nic nedoručily:
+
+    ./farmhub_host --port 8080 --quiet &
+    python3 tools/fleet_sim.py --host 127.0.0.1 --port 8080 --soil 50 --light 50 --check
+
+Pozn.: hub drží registr jen pro WS_MAX_PEERS uzlů (ESP8266: 6, farmhub_host
+podle -DFARMHUB_HOST_WS_PEERS), uzly nad limit odmítne a zavře jim
+spojení (simulace je vypíše jako odpojené).
+
+S --reconnect se uzly po výpadku připojují znovu stejnou politikou jako
+FarmNode (libraries/FarmNet/src/FarmBackoff.h), --fixed-retry S místo
+toho simuluje staré pevné opakování. Restartujte hub během běhu a report
+ukáže dobu výpadku uzlů a špičku pokusů o připojení za sekundu:
+
+    python3 tools/fleet_sim.py --soil 25 --light 25 --pump 0 --lightmodule 0 \
+        --unique-ids --reconnect --duration 180
+"""
+
+import argparse
+import asyncio
+import base64
+import json
+import os
+import random
+import statistics
+import struct
+import time
+import urllib.request
+
+# --- FarmProto (libraries/FarmNet/src/FarmProto.h) ---
+FARM_MAGIC = 0xFA
+FARM_VERSION = 1
+HEADER = struct.Struct("<BBBBIH")
+
+MSG_WELCOME = 1
+MSG_TIME = 2
+MSG_READINGS = 3
+MSG_ACK = 4
+MSG_RUN_PUMP = 5
+MSG_LIGHT_SETTINGS = 6
+MSG_PUMP_ACK = 7
+MSG_PUMP_DONE = 8
+
+NODE_SOIL_DHT = 1
+NODE_LIGHT_SENSOR = 2
+NODE_LIGHT_MODULE = 3
+NODE_PUMP = 4
+
+FIELD_SOIL, FIELD_TEMP, FIELD_HUM, FIELD_LIGHT = range(4)
+
+# --- Čekání před opětovným připojením (FarmBackoff.h) ---
+BACKOFF_BASE_MS = 1000
+BACKOFF_MAX_MS = 60000
+
+
+def backoff_ms(attempt, rng):
+    wait = BACKOFF_BASE_MS
+    for _ in range(1, attempt):
+        if wait >= BACKOFF_MAX_MS:
+            break
+        wait <<= 1
+    half = min(wait, BACKOFF_MAX_MS) // 2
+    return half + rng.randint(0, half)
+
+
+def farm_frame(msg_type, node, seq, payload=b""):
+    return HEADER.pack(FARM_MAGIC, FARM_VERSION, msg_type, node, seq, len(payload)) + payload
+
+
+def farm_parse(data):
+    if len(data) < HEADER.size:
+        return None
+    magic, version, msg_type, node, seq, length = HEADER.unpack_from(data)
+    if magic != FARM_MAGIC or version != FARM_VERSION or HEADER.size + length != len(data):
+        return None
+    return msg_type, node, seq, data[HEADER.size:]
+
+
+def farm_sample(ts, values):
+    """values = {FIELD_*: float}"""
+    mask = 0
+    body = b""
+    for field in range(4):
+        if field in values:
+            mask |= 1 << field
+            body += struct.pack("<f", values[field])
+    return struct.pack("<IB", ts, mask) + body
+
+
+# --- Minimální WebSocket klient (RFC 6455, jen ws://) ---
+OP_CONT, OP_TEXT, OP_BINARY, OP_CLOSE, OP_PING, OP_PONG = 0x0, 0x1, 0x2, 0x8, 0x9, 0xA
+
+
+class WsClient:
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+
+    @classmethod
+    async def connect(cls, host, port, path):
+        reader, writer = await asyncio.open_connection(host, port)
+        key = base64.b64encode(os.urandom(16)).decode()
+        writer.write((
+            "GET %s HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+            "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n" % (path, host, port, key)
+        ).encode())
+        await writer.drain()
+        response = await reader.readuntil(b"\r\n\r\n")
+        if b" 101 " not in response.split(b"\r\n", 1)[0]:
+            writer.close()
+            raise ConnectionError("handshake: " + response.split(b"\r\n", 1)[0].decode(errors="replace"))
+        return cls(reader, writer)
+
+    async def send(self, opcode, payload):
+        if isinstance(payload, str):
+            payload = payload.encode()
+        header = bytes([0x80 | opcode])
+        n = len(payload)
+        if n < 126:
+            header += bytes([0x80 | n])
+        elif n < 65536:
+            header += bytes([0x80 | 126]) + struct.pack(">H", n)
+        else:
+            header += bytes([0x80 | 127]) + struct.pack(">Q", n)
+        mask = os.urandom(4)
+        masked = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+        self.writer.write(header + mask + masked)
+        await self.writer.drain()
+
+    async def recv(self):
+        """Vrací (opcode, payload) celé zprávy; ping vyřídí sám."""
+        message_op, parts = None, []
+        while True:
+            b0, b1 = await self.reader.readexactly(2)
+            opcode, n = b0 & 0x0F, b1 & 0x7F
+            if n == 126:
+                n = struct.unpack(">H", await self.reader.readexactly(2))[0]
+            elif n == 127:
+                n = struct.unpack(">Q", await self.reader.readexactly(8))[0]
+            mask = await self.reader.readexactly(4) if b1 & 0x80 else None
+            payload = await self.reader.readexactly(n)
+            if mask:
+                payload = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+            if opcode == OP_PING:
+                await self.send(OP_PONG, payload)
+                continue
+            if opcode == OP_CLOSE:
+                raise ConnectionError("closed by hub")
+            if opcode != OP_CONT:
+                message_op, parts = opcode, []
+            parts.append(payload)
+            if b0 & 0x80:
+                return message_op, b"".join(parts)
+
+    def close(self):
+        self.writer.close()
+
+
+# --- Statistiky ---
+def percentile(values, p):
+    """values musí být seřazené"""
+    return round(values[min(len(values) - 1, int(p * len(values)))], 1) if values else None
+
+
+def peak_per_second(times):
+    """Nejvíc událostí v libovolném okně 1 s"""
+    times = sorted(times)
+    peak, lo = 0, 0
+    for hi, t in enumerate(times):
+        while t - times[lo] >= 1.0:
+            lo += 1
+        peak = max(peak, hi - lo + 1)
+    return peak
+
+
+class Stats:
+    def __init__(self):
+        self.connected = 0
+        self.binary = 0
+        self.failed = 0
+        self.disconnects = 0
+        self.batches = 0
+        self.samples_sent = 0
+        self.samples_acked = 0
+        self.ack_latency_ms = []
+        self.pump_cmds = 0
+        self.pump_dupes = 0
+        self.light_settings = 0
+        self.attempts = []      # time.monotonic() každého pokusu o připojení
+        self.outage_ms = []     # od ztráty spojení po opětovné připojení
+        self.reconnected = []   # time.monotonic() opětovných připojení
+
+    def summary(self):
+        lat = sorted(self.ack_latency_ms)
+
+        def pct(p):
+            return percentile(lat, p)
+
+        return {
+            "connected": self.connected, "binary": self.binary, "failed": self.failed,
+            "disconnects": self.disconnects, "batches": self.batches,
+            "samplesSent": self.samples_sent, "samplesAcked": self.samples_acked,
+            "ackP50Ms": pct(0.50), "ackP95Ms": pct(0.95), "ackP99Ms": pct(0.99),
+            "ackMaxMs": round(lat[-1], 1) if lat else None,
+            "ackMeanMs": round(statistics.mean(lat), 1) if lat else None,
+            "pumpCmds": self.pump_cmds, "pumpDupes": self.pump_dupes,
+            "lightSettings": self.light_settings,
+            "reconnects": len(self.outage_ms),
+            "outageP50Ms": percentile(sorted(self.outage_ms), 0.50),
+            "outageMaxMs": round(max(self.outage_ms), 1) if self.outage_ms else None,
+        }
+
+
+# --- Virtuální uzly ---
+class Node:
+    def __init__(self, args, kind, node_id, name, stats):
+        self.args = args
+        self.kind = kind
+        self.node_id = node_id
+        self.name = name
+        self.stats = stats
+        self.binary = False
+        self.ws = None
+
+    def hello(self):
+        msg = {"sensorID": self.name, "node": self.node_id}
+        if not self.args.json:
+            msg["proto"] = FARM_VERSION
+        return msg
+
+    async def run(self, deadline):
+        rng = random.Random(self.name + str(id(self)))
+        attempt = 0
+        down_since = None
+        while True:
+            online = await self.run_once(deadline, down_since)
+            now = time.monotonic()
+            if not (self.args.reconnect or self.args.fixed_retry) or now >= deadline:
+                return
+            if online:
+                down_since, attempt = now, 0
+            attempt += 1
+            if self.args.fixed_retry:
+                wait = self.args.fixed_retry
+            else:
+                wait = backoff_ms(attempt, rng) / 1000.0
+            await asyncio.sleep(min(wait, max(0.0, deadline - now)))
+            if time.monotonic() >= deadline:
+                return
+
+    async def run_once(self, deadline, down_since):
+        """Jedno připojení; True = spojení bylo navázané (a spadlo nebo skončil čas)"""
+        self.stats.attempts.append(time.monotonic())
+        self.binary = False
+        try:
+            self.ws = await asyncio.wait_for(
+                WsClient.connect(self.args.host, self.args.port, self.args.path), 5.0)
+        except (OSError, ConnectionError, asyncio.IncompleteReadError, asyncio.TimeoutError) as e:
+            self.stats.failed += 1
+            if self.args.verbose:
+                print("%s: %s" % (self.name, e))
+            return False
+        self.stats.connected += 1
+        if down_since is not None:
+            self.stats.reconnected.append(time.monotonic())
+            self.stats.outage_ms.append((time.monotonic() - down_since) * 1000.0)
+        try:
+            await self.ws.send(OP_TEXT, json.dumps(self.hello()))
+            await asyncio.wait_for(self.session(deadline), max(0.0, deadline - time.monotonic()))
+        except asyncio.TimeoutError:
+            pass
+        except (OSError, ConnectionError, asyncio.IncompleteReadError):
+            self.stats.disconnects += 1
+        finally:
+            self.ws.close()
+        return True
+
+    async def session(self, deadline):
+        while True:
+            opcode, data = await self.ws.recv()
+            if opcode == OP_BINARY:
+                frame = farm_parse(data)
+                if frame:
+                    await self.on_frame(*frame)
+            elif opcode == OP_TEXT:
+                try:
+                    await self.on_json(json.loads(data))
+                except ValueError:
+                    pass
+
+    async def on_frame(self, msg_type, node, seq, payload):
+        if msg_type == MSG_WELCOME and not self.binary:
+            self.binary = True
+            self.stats.binary += 1
+
+    async def on_json(self, msg):
+        pass
+
+
+class SensorNode(Node):
+    """Posílá dávky měření každých --interval s a měří čas do potvrzení."""
+
+    def __init__(self, *a):
+        super().__init__(*a)
+        self.boot = random.getrandbits(32)
+        self.seq = 1
+        self.pending = {}   # poslední seq dávky -> (čas odeslání, počet vzorků)
+
+    def values(self):
+        if self.kind == "light":
+            return {FIELD_LIGHT: random.uniform(0, 2000)}
+        return {FIELD_SOIL: random.uniform(20, 60), FIELD_TEMP: random.uniform(15, 30),
+                FIELD_HUM: random.uniform(30, 80)}
+
+    async def session(self, deadline):
+        sender = asyncio.ensure_future(self.sender())
+        try:
+            await super().session(deadline)
+        finally:
+            sender.cancel()
+
+    async def sender(self):
+        await asyncio.sleep(random.uniform(0, self.args.interval))
+        while True:
+            await self.send_batch()
+            await asyncio.sleep(self.args.interval)
+
+    async def send_batch(self):
+        n = self.args.batch
+        now = int(time.time())
+        samples = [(now - (n - 1 - i), self.values()) for i in range(n)]
+        first, last = self.seq, self.seq + n - 1
+        if self.binary:
+            payload = struct.pack("<IB", self.boot, n) + b"".join(farm_sample(ts, v) for ts, v in samples)
+            await self.ws.send(OP_BINARY, farm_frame(MSG_READINGS, self.node_id, first, payload))
+        else:
+            names = {FIELD_SOIL: "soil", FIELD_TEMP: "temp", FIELD_HUM: "hum", FIELD_LIGHT: "light"}
+            batch = [dict({"ts": ts}, **{names[f]: round(x, 2) for f, x in v.items()}) for ts, v in samples]
+            await self.ws.send(OP_TEXT, json.dumps({"sensorID": self.name, "boot": self.boot,
+                                                    "seq": first, "batch": batch}))
+        self.pending[last] = (time.monotonic(), n)
+        self.seq = last + 1
+        self.stats.batches += 1
+        self.stats.samples_sent += n
+
+    def on_ack(self, upto):
+        now = time.monotonic()
+        for last in [s for s in self.pending if s <= upto]:
+            sent, n = self.pending.pop(last)
+            self.stats.ack_latency_ms.append((now - sent) * 1000.0)
+            self.stats.samples_acked += n
+
+    async def on_frame(self, msg_type, node, seq, payload):
+        await super().on_frame(msg_type, node, seq, payload)
+        if msg_type == MSG_ACK:
+            self.on_ack(seq)
+
+    async def on_json(self, msg):
+        if "ack" in msg:
+            self.on_ack(msg["ack"])
+
+
+class PumpNode(Node):
+    """Potvrdí RUN_PUMP hned, PUMP_DONE pošle po (zrychlené) době chodu."""
+
+    def __init__(self, *a):
+        super().__init__(*a)
+        self.last_seq = 0
+
+    def hello(self):
+        msg = super().hello()
+        msg["acks"] = True
+        return msg
+
+    async def run_pump(self, seq, duration, pump):
+        if pump != 0:
+            return
+        if seq:
+            if self.binary:
+                await self.ws.send(OP_BINARY, farm_frame(MSG_PUMP_ACK, NODE_PUMP, seq))
+            else:
+                await self.ws.send(OP_TEXT, json.dumps({"cmd": "PUMP_ACK", "seq": seq}))
+            if seq == self.last_seq:
+                self.stats.pump_dupes += 1
+                return
+            self.last_seq = seq
+        self.stats.pump_cmds += 1
+        asyncio.ensure_future(self.finish(seq, duration))
+
+    async def finish(self, seq, duration):
+        runtime = duration / self.args.pump_speedup
+        await asyncio.sleep(runtime)
+        if not seq:
+            return
+        ms = int(duration * 1000)
+        if self.binary:
+            await self.ws.send(OP_BINARY, farm_frame(MSG_PUMP_DONE, NODE_PUMP, seq, struct.pack("<I", ms)))
+        else:
+            await self.ws.send(OP_TEXT, json.dumps({"cmd": "PUMP_DONE", "seq": seq, "runtimeMs": ms}))
+
+    async def on_frame(self, msg_type, node, seq, payload):
+        await super().on_frame(msg_type, node, seq, payload)
+        if msg_type == MSG_RUN_PUMP and len(payload) >= 2:
+            duration = struct.unpack_from("<H", payload)[0]
+            pump = payload[2] if len(payload) > 2 else 0
+            await self.run_pump(seq, duration, pump)
+
+    async def on_json(self, msg):
+        if msg.get("cmd") == "RUN_PUMP":
+            await self.run_pump(msg.get("seq", 0), msg.get("duration", 0), msg.get("pump", 0))
+
+
+class LightModuleNode(Node):
+    async def on_frame(self, msg_type, node, seq, payload):
+        await super().on_frame(msg_type, node, seq, payload)
+        if msg_type == MSG_LIGHT_SETTINGS:
+            self.stats.light_settings += 1
+
+    async def on_json(self, msg):
+        if msg.get("cmd") == "LIGHT_SETTINGS":
+            self.stats.light_settings += 1
+
+
+KINDS = [
+    # (parametr, třída, FarmNodeId, sensorID prvního uzlu, prefix dalších)
+    ("soil", SensorNode, NODE_SOIL_DHT, "soilDHTsensor", "soil"),
+    ("light", SensorNode, NODE_LIGHT_SENSOR, "lightsensor", "light"),
+    ("pump", PumpNode, NODE_PUMP, "pumpClient", "pump"),
+    ("lightmodule", LightModuleNode, NODE_LIGHT_MODULE, "lightModule", "lightModule"),
+]
+
+
+def fetch_metrics(args):
+    url = "http://%s:%d/metrics?format=json" % (args.host, args.port)
+    try:
+        with urllib.request.urlopen(url, timeout=5) as r:
+            return json.loads(r.read())
+    except (OSError, ValueError):
+        return None
+
+
+def metrics_digest(m):
+    if not m:
+        return None
+
+    def avg(s):
+        return round(s["sumUs"] / s["count"], 1) if s.get("count") else None
+
+    return {
+        "heapFree": m["heap"]["free"], "heapMaxBlock": m["heap"]["maxBlock"],
+        "heapFragPct": m["heap"]["fragPct"], "wsClients": m["ws"]["clients"],
+        "jsonParseAvgUs": avg(m["jsonParse"]), "jsonParseMaxUs": m["jsonParse"]["maxUs"],
+        "logAppendAvgUs": avg(m["logAppend"]), "logAppendMaxUs": m["logAppend"]["maxUs"],
+        "loopMaxUs": m["loop"]["pass"]["maxUs"],
+    }
+
+
+async def simulate(args):
+    stats = {kind: Stats() for kind, *_ in KINDS}
+    nodes = []
+    for kind, cls, node_id, first_name, prefix in KINDS:
+        for i in range(getattr(args, kind)):
+            # Bez --unique-ids se všechny uzly druhu hlásí jako skutečný uzel
+            name = "%s%d" % (prefix, i + 1) if args.unique_ids and i > 0 else first_name
+            nodes.append(cls(args, kind, node_id, name, stats[kind]))
+    random.shuffle(nodes)
+
+    before = fetch_metrics(args)
+    start = time.monotonic()
+    deadline = start + args.ramp + args.duration
+    tasks = []
+    for i, node in enumerate(nodes):
+        # Rozložení připojování do --ramp sekund
+        delay = args.ramp * i / max(1, len(nodes))
+        tasks.append(asyncio.ensure_future(delayed(node, delay, deadline)))
+    await asyncio.gather(*tasks)
+    elapsed = time.monotonic() - start
+    after = fetch_metrics(args)
+
+    result = {
+        "host": args.host, "nodes": len(nodes), "durationS": round(elapsed, 1),
+        "protocol": "json" if args.json else "binary",
+        "kinds": {kind: s.summary() for kind, s in stats.items() if getattr(args, kind)},
+        "hubBefore": metrics_digest(before), "hubAfter": metrics_digest(after),
+    }
+    acked = sum(s.samples_acked for s in stats.values())
+    result["samplesAckedPerSec"] = round(acked / args.duration, 2) if args.duration else None
+    if args.reconnect or args.fixed_retry:
+        outages = sorted(o for s in stats.values() for o in s.outage_ms)
+        result["reconnect"] = {
+            "policy": "fixed %.1f s" % args.fixed_retry if args.fixed_retry else "backoff",
+            "reconnects": len(outages),
+            "outageP50Ms": percentile(outages, 0.50),
+            "outageP95Ms": percentile(outages, 0.95),
+            "outageMaxMs": round(outages[-1], 1) if outages else None,
+            "attempts": sum(len(s.attempts) for s in stats.values()),
+            "peakAttemptsPerSec": peak_per_second([t for s in stats.values() for t in s.attempts]),
+            "peakReconnectsPerSec": peak_per_second([t for s in stats.values() for t in s.reconnected]),
+        }
+    return result
+
+
+async def delayed(node, delay, deadline):
+    await asyncio.sleep(delay)
+    await node.run(deadline)
+
+
+def print_report(r):
+    print("Hub %s, %d uzlů, %s, %.1f s" % (r["host"], r["nodes"], r["protocol"], r["durationS"]))
+    print("%-12s %5s %5s %5s %7s %8s %8s %8s %8s %8s" % (
+        "druh", "conn", "bin", "fail", "dávky", "vzorky", "p50 ms", "p95 ms", "p99 ms", "max ms"))
+    for kind, s in r["kinds"].items():
+        print("%-12s %5d %5d %5d %7d %8d %8s %8s %8s %8s" % (
+            kind, s["connected"], s["binary"], s["failed"], s["batches"], s["samplesAcked"],
+            s["ackP50Ms"], s["ackP95Ms"], s["ackP99Ms"], s["ackMaxMs"]))
+    print("Potvrzených vzorků/s: %s" % r["samplesAckedPerSec"])
+    for kind in ("pump", "lightmodule"):
+        if kind in r["kinds"]:
+            s = r["kinds"][kind]
+            print("%-12s příkazů %d (duplicit %d), LIGHT_SETTINGS %d, odpojení %d" % (
+                kind, s["pumpCmds"], s["pumpDupes"], s["lightSettings"], s["disconnects"]))
+    if "reconnect" in r:
+        c = r["reconnect"]
+        print("Opětovné připojení (%s): %d, výpadek p50 %s ms, p95 %s ms, max %s ms" % (
+            c["policy"], c["reconnects"], c["outageP50Ms"], c["outageP95Ms"], c["outageMaxMs"]))
+        print("Pokusů o připojení %d, špička %d pokusů/s, %d připojení/s po restartu" % (
+            c["attempts"], c["peakAttemptsPerSec"], c["peakReconnectsPerSec"]))
+    for label in ("hubBefore", "hubAfter"):
+        if r[label]:
+            print("%-10s %s" % (label, " ".join("%s=%s" % kv for kv in r[label].items())))
+        else:
+            print("%-10s /metrics nedostupné" % label)
+
+
+def main():
+    p = argparse.ArgumentParser(description="Simulace uzlů FarmHubu proti skutečnému hubu")
+    p.add_argument("--host", default="192.168.4.1")
+    p.add_argument("--port", type=int, default=80)
+    p.add_argument("--path", default="/ws")
+    p.add_argument("--soil", type=int, default=1, help="počet půdních/DHT senzorů")
+    p.add_argument("--light", type=int, default=1, help="počet světelných senzorů")
+    p.add_argument("--pump", type=int, default=1, help="počet čerpadel")
+    p.add_argument("--lightmodule", type=int, default=1, help="počet světelných modulů")
+    p.add_argument("--interval", type=float, default=90.0, help="perioda dávek senzoru (s)")
+    p.add_argument("--batch", type=int, default=1, help="vzorků v dávce")
+    p.add_argument("--duration", type=float, default=60.0, help="délka měření (s)")
+    p.add_argument("--ramp", type=float, default=5.0, help="rozložení připojení (s)")
+    p.add_argument("--pump-speedup", type=float, default=10.0, help="zrychlení chodu čerpadla")
+    p.add_argument("--json", action="store_true", help="jen JSON (bez binárního protokolu)")
+    p.add_argument("--unique-ids", action="store_true", help="každý senzor s vlastním sensorID")
+    p.add_argument("--reconnect", action="store_true",
+                   help="po výpadku se připojovat znovu (backoff jako FarmNode)")
+    p.add_argument("--fixed-retry", type=float, default=0.0,
+                   help="místo backoffu opakovat po pevných S sekundách (staré chování)")
+    p.add_argument("--out", help="výsledek do JSON souboru")
+    p.add_argument("--check", action="store_true",
+                   help="návratový kód 1, když se senzor nepřipojil nebo nemá potvrzené vzorky")
+    p.add_argument("--verbose", action="store_true")
+    args = p.parse_args()
+
+    result = asyncio.run(simulate(args))
+    print_report(result)
+    if args.out:
+        with open(args.out, "w") as f:
+            json.dump(result, f, indent=2)
+    if args.check:
+        bad = [kind for kind in ("soil", "light") if kind in result["kinds"] and
+               (result["kinds"][kind]["connected"] == 0 or result["kinds"][kind]["samplesAcked"] == 0)]
+        if bad or not result["hubAfter"]:
+            print("CHECK FAILED: %s" % (", ".join(bad) or "/metrics"))
+            raise SystemExit(1)
+
+
+if __name__ == "__main__":
+    main()
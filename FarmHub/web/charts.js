@@ -0,0 +1,130 @@
+// Grafy pro stránku /charts – bez externích knihoven (funguje i v AP režimu).
+// Data se stahují z /api/series jako sloupce a při obnovení se dotahují
+// jen body novější než poslední zobrazený.
+
+function formatTimeFromSeconds(epochSec, withDate) {
+  const dt = new Date(epochSec * 1000); // epochSec je v sekundách, Date potřebuje ms
+  const pad = function(v) { return String(v).padStart(2, '0'); };
+  const hm = pad(dt.getHours()) + ':' + pad(dt.getMinutes());
+  return withDate ? dt.getDate() + '.' + (dt.getMonth() + 1) + '. ' + hm : hm;
+}
+
+// Jednoduchý čárový graf na canvasu: data = [{x: epoch s, y: hodnota}]
+function LineChart(canvas, opts) {
+  this.canvas = canvas;
+  this.opts = opts;
+  this.data = [];
+  const self = this;
+  window.addEventListener('resize', function() { self.update(); });
+}
+
+LineChart.prototype.update = function() {
+  const c = this.canvas, o = this.opts, data = this.data;
+  const dpr = window.devicePixelRatio || 1;
+  const w = c.clientWidth, h = c.clientHeight;
+  c.width = w * dpr;
+  c.height = h * dpr;
+  const g = c.getContext('2d');
+  g.setTransform(dpr, 0, 0, dpr, 0, 0);
+  g.clearRect(0, 0, w, h);
+  g.font = '11px sans-serif';
+  g.fillStyle = '#333';
+  g.fillText(o.label, 46, 12);
+
+  const L = 44, R = 8, T = 20, B = 22;
+  const pw = w - L - R, ph = h - T - B;
+  if (!data.length || pw <= 0 || ph <= 0) {
+    g.fillText('Žádná data', L + pw / 2 - 25, T + ph / 2);
+    return;
+  }
+
+  let x0 = data[0].x, x1 = data[data.length - 1].x;
+  let y0 = Infinity, y1 = -Infinity;
+  data.forEach(function(p) {
+    if (p.y === null) return;
+    if (p.y < y0) y0 = p.y;
+    if (p.y > y1) y1 = p.y;
+  });
+  if (o.pct) { y0 = Math.min(y0, 0); y1 = Math.max(y1, 100); }
+  if (!(y1 > y0)) { y0 -= 1; y1 += 1; }
+  if (x1 === x0) x1 = x0 + 1;
+  const sx = function(x) { return L + (x - x0) / (x1 - x0) * pw; };
+  const sy = function(y) { return T + (y1 - y) / (y1 - y0) * ph; };
+
+  // Osy a popisky (5 úrovní na ose Y, 4 časy na ose X)
+  g.strokeStyle = '#ddd';
+  g.lineWidth = 1;
+  g.textAlign = 'right';
+  for (let i = 0; i <= 4; i++) {
+    const v = y0 + (y1 - y0) * i / 4, y = sy(v);
+    g.beginPath(); g.moveTo(L, y); g.lineTo(L + pw, y); g.stroke();
+    g.fillText(v.toFixed(y1 - y0 < 10 ? 1 : 0), L - 4, y + 4);
+  }
+  g.textAlign = 'center';
+  const withDate = (x1 - x0) > 86400;
+  for (let i = 0; i <= 3; i++) {
+    const v = x0 + (x1 - x0) * i / 3;
+    g.fillText(formatTimeFromSeconds(v, withDate), Math.min(Math.max(sx(v), L + 20), L + pw - 20), h - 6);
+  }
+
+  // Křivka a výplň pod ní
+  g.beginPath();
+  let started = false;
+  data.forEach(function(p) {
+    if (p.y === null) return;
+    if (started) { g.lineTo(sx(p.x), sy(p.y)); } else { g.moveTo(sx(p.x), sy(p.y)); started = true; }
+  });
+  g.strokeStyle = 'rgba(' + o.color + ', 1)';
+  g.lineWidth = 2;
+  g.stroke();
+  g.lineTo(sx(data[data.length - 1].x), T + ph);
+  g.lineTo(sx(data[0].x), T + ph);
+  g.closePath();
+  g.fillStyle = 'rgba(' + o.color + ', 0.2)';
+  g.fill();
+};
+
+const SERIES = [
+  { id: 'chartSoil',  sensor: 'soilDHTsensor', channel: 'soil',  label: 'Soil Moisture (%)', color: '75, 192, 192', pct: true },
+  { id: 'chartTemp',  sensor: 'soilDHTsensor', channel: 'temp',  label: 'Temperature (°C)',  color: '255, 99, 132', pct: false },
+  { id: 'chartHum',   sensor: 'soilDHTsensor', channel: 'hum',   label: 'Humidity (%)',      color: '54, 162, 235', pct: true },
+  { id: 'chartLight', sensor: 'lightsensor',   channel: 'light', label: 'Light',             color: '255, 206, 86', pct: false }
+];
+
+function makeChart(s) {
+  s.lastT = 0;
+  s.chart = new LineChart(document.getElementById(s.id), s);
+  s.chart.update();
+}
+
+// Dotáhne body od posledního známého; ten se přepíše (bucket mohl ještě růst)
+function refreshSeries(s, step, points) {
+  fetch('/api/series?sensor=' + s.sensor + '&channel=' + s.channel +
+        '&step=' + step + '&from=' + s.lastT)
+    .then(function(r) { return r.json(); })
+    .then(function(d) {
+      const data = s.chart.data;
+      for (let i = 0; i < d.t.length; i++) {
+        const last = data.length ? data[data.length - 1].x : 0;
+        if (d.t[i] < last) continue;
+        if (d.t[i] === last) {
+          data[data.length - 1].y = d.avg[i];
+        } else {
+          data.push({ x: d.t[i], y: d.avg[i] });
+        }
+      }
+      while (data.length > points) data.shift();
+      if (data.length) s.lastT = data[data.length - 1].x;
+      s.chart.update();
+    })
+    .catch(function() {});
+}
+
+function startCharts(step, points) {
+  SERIES.forEach(makeChart);
+  const tick = function() {
+    SERIES.forEach(function(s) { refreshSeries(s, step, points); });
+  };
+  tick();
+  setInterval(tick, Math.min(step, 300) * 1000);
+}
@@ -1,42 +1,56 @@
 /*
    LightModule.ino – samostatný firmware pro ESP8266 na ovládání světla.
-   - Připojí se k WiFi (FarmHub síti), kde je dostupný internet.
-   - Zkusí synchronizovat čas přes NTP.
-   - WebSocketem přijímá nastavení: manuální/automatický režim, čas zapnutí/vypnutí,
-     možnost svítit jen když < 50 lux.
+   - Připojí se k WiFi (FarmHub síti) a WebSocketem k hubu (FarmNode,
+     neblokující připojování s backoffem), čas dostane od hubu.
+   - WebSocketem přijímá nastavení: manuální/automatický režim, okna svícení
+     (více oken, dny v týdnu), možnost svítit jen když < 50 lux.
    - Lokálně měří lux (analogRead(A0)) a řídí pin D1 (relé).
+   - Stav se přepočítá jen při změně nastavení/času a v okamžiku přepnutí,
+     mezi tím smyčka jen obsluhuje WebSocket a spí.
 */
 
 #include <ESP8266WiFi.h>
 #include <WebSocketsClient.h>
 #include <ArduinoJson.h>
-#include <time.h>            // Pro NTP synchronizaci
+#include <FarmProto.h>
+#include <FarmNode.h>
+#include <time.h>            // localtime() pro okna svícení
 
 // Piny
 static const int PIN_LIGHT = D1;  // D1 -> ovládání relé
 
 // Globální proměnné konfigurace (od Hubu)
 bool autoLight        = false;
-int  lightStartHour   = 8;
-int  lightStartMinute = 0;
-int  lightEndHour     = 20;
-int  lightEndMinute   = 0;
 bool lightOnlyIfDark  = false;
 bool manualLightOn    = false;
 
-// --- NTP: nastavení ---
-static const char* ntpServer = "195.113.144.201";
-static const long  gmtOffset_sec = 3600;     // Pro ČR: GMT+1 => 3600
-static const int   daylightOffset_sec = 0;   // Letní čas ručně, anebo 3600 pokud je letní;
-unsigned long g_hubEpochTime = 0;
-unsigned long g_hubEpochTimeMillis = 0; 
+// Okna svícení (výchozí 8:00-20:00 denně)
+FarmLightWindow lightWindows[FARM_LIGHT_MAX_WINDOWS] = {
+  { FARM_LIGHT_ALL_DAYS, 8, 0, 20, 0 }
+};
+uint8_t lightWindowCount = 1;
+
+// --- Plán svícení ---
+static const uint32_t      MINUTES_PER_WEEK = 7UL * 24 * 60;
+static const unsigned long LIGHT_IDLE_MS    = 20;      // spánek smyčky mezi obsluhou WebSocketu
+static const unsigned long DARK_CHECK_MS    = 30000;   // měření lux v okně s onlyIfDark
+static const int           DARK_THRESHOLD   = 50;
+
+bool          lightOn        = false;  // stav relé
+bool          inWindow       = false;  // jsme v některém okně (auto režim)
+bool          planDirty      = true;   // přepočítat při nejbližší smyčce
+unsigned long planAtMs       = 0;      // millis() posledního výpočtu
+unsigned long planInMs       = 0;      // za kolik ms je další přepnutí (0 = žádné)
+unsigned long lastDarkCheck  = 0;
 
 // Připojení k WiFi
 const char* ssid = "FarmHub-AP";  // nebo vaše domácí síť
 const char* pass = "farmhub123";  //
 
-// IP adresa hubu (pro WebSocket)
-IPAddress hubIP(192,168,4,1);     // pokud je v AP módu => 192.168.4.1, příp. jiná
+// Hub (v AP módu 192.168.4.1), port 80, path /ws
+const FarmNodeConfig NET_CONFIG = {
+  ssid, pass, "192.168.4.1", 80, "/ws", NODE_LIGHT_MODULE, "lightModule", nullptr
+};
 
 // WebSocket klient
 WebSocketsClient webSocket;
@@ -49,72 +63,117 @@ int toMinutesFromMidnight(int h, int m) {
   return h * 60 + m;
 }
 
-void setEpochTime(unsigned long hubTime) {
-  g_hubEpochTime = hubTime;
-  g_hubEpochTimeMillis = millis();
+// Jediné okno pro všechny dny (starý formát nastavení)
+void setSingleWindow(int startH, int startM, int endH, int endM) {
+  lightWindows[0] = { FARM_LIGHT_ALL_DAYS, (uint8_t)startH, (uint8_t)startM,
+                      (uint8_t)endH, (uint8_t)endM };
+  lightWindowCount = 1;
+}
+
+// Je minuta týdne `minute` (0 = neděle 0:00) uvnitř okna? Do `untilEdge`
+// uloží počet minut do nejbližšího začátku nebo konce okna.
+bool windowContains(const FarmLightWindow &lw, uint32_t minute, uint32_t &untilEdge) {
+  uint32_t startMin = toMinutesFromMidnight(lw.startHour, lw.startMinute);
+  uint32_t endMin   = toMinutesFromMidnight(lw.endHour,   lw.endMinute);
+  // konec <= začátek => přes půlnoc (shodné = celých 24 h)
+  uint32_t length   = (endMin > startMin) ? endMin - startMin : 1440 - startMin + endMin;
+  bool inside = false;
+  untilEdge = MINUTES_PER_WEEK;
+
+  for (uint8_t day = 0; day < 7; day++) {
+    if (!(lw.days & (1 << day))) continue;
+    uint32_t start  = day * 1440UL + startMin;
+    uint32_t offset = (minute + MINUTES_PER_WEEK - start) % MINUTES_PER_WEEK;
+    uint32_t edge;
+    if (offset < length) {
+      inside = true;
+      edge   = length - offset;                 // do konce okna
+    } else {
+      edge   = MINUTES_PER_WEEK - offset;       // do začátku okna
+    }
+    if (edge < untilEdge) untilEdge = edge;
+  }
+  return inside;
+}
+
+bool isDark() {
+  // Tady je třeba dle rozsahu čidla definovat podmínku < 50
+  // (Pokud je LDR zapojen jinak, může být 0=světlo atd., v praxi vyžaduje kalibraci.)
+  return analogRead(A0) < DARK_THRESHOLD;
 }
 
-unsigned long getCurrentEpochTime() {
-  // Kolik vteřin uběhlo od momentu, kdy jsme si čas uložili?
-  unsigned long secsSinceSync = (millis() - g_hubEpochTimeMillis) / 1000;
-  // Vrátíme původní hubTime + uplynulý čas
-  return g_hubEpochTime + secsSinceSync;
+// Relé se přepíná jen při skutečné změně stavu
+void setLight(bool on) {
+  if (on == lightOn) return;
+  lightOn = on;
+  pinMode(PIN_LIGHT, on ? OUTPUT : INPUT);
+  Serial.printf("[LIGHT] %s\n", on ? "zapnuto" : "vypnuto");
 }
 
-// Zjistí, zda je aktuální lokální čas (podle RTC) uvnitř intervalu start..end
-bool isInLightingWindow() {
-  // Získání lokálního času z RTC (synced z NTP)
-  unsigned long now = getCurrentEpochTime();
+// Spočítá požadovaný stav a čas dalšího přepnutí (jednou, ne v každé smyčce)
+void planLight() {
+  planDirty = false;
+  planAtMs  = millis();
+  planInMs  = 0;
+  inWindow  = false;
+
+  // (1) – Pokud je manuální zapnutí, to má přednost
+  if (manualLightOn) {
+    setLight(true);
+    return;
+  }
+  // (2) – Bez autoLight nebo bez skutečného času z hubu => vypnuto
+  if (!autoLight || !farmNodeClockValid()) {
+    setLight(false);
+    return;
+  }
+
+  unsigned long now = farmNodeEpoch();
   time_t rawTime = (time_t)now;
   struct tm* timeinfo = localtime(&rawTime);
-  
   if (!timeinfo) {
-    // Pokud se NTP nepovedlo, timeInfo může být nullptr,
-    // fallback: považujme to, jako by byl 0:0
-    return false;
+    setLight(false);
+    return;
+  }
+  uint32_t minute = timeinfo->tm_wday * 1440UL +
+                    toMinutesFromMidnight(timeinfo->tm_hour, timeinfo->tm_min);
+
+  uint32_t untilNext = MINUTES_PER_WEEK;
+  for (uint8_t i = 0; i < lightWindowCount; i++) {
+    uint32_t edge;
+    if (windowContains(lightWindows[i], minute, edge)) inWindow = true;
+    if (edge < untilNext) untilNext = edge;
   }
-  int currentHour   = timeinfo->tm_hour;
-  int currentMinute = timeinfo->tm_min;
-  
-  int nowMin   = toMinutesFromMidnight(currentHour, currentMinute);
-  int startMin = toMinutesFromMidnight(lightStartHour, lightStartMinute);
-  int endMin   = toMinutesFromMidnight(lightEndHour,   lightEndMinute);
-
-  if (startMin < endMin) {
-    return (nowMin >= startMin && nowMin < endMin);
+  planInMs = (untilNext * 60UL - timeinfo->tm_sec) * 1000UL;
+
+  if (inWindow && lightOnlyIfDark) {
+    lastDarkCheck = millis();
+    setLight(isDark());
   } else {
-    // rozmezí přes půlnoc (např. 20:00 -> 06:00)
-    if (nowMin >= startMin || nowMin < endMin) {
-      return true;
-    } else {
-      return false;
-    }
+    setLight(inWindow);
+  }
+  Serial.printf("[LIGHT] %s okno, další přepnutí za %lu min\n",
+                inWindow ? "v" : "mimo", (unsigned long)untilNext);
+}
+
+void printLightSettings() {
+  Serial.println("[WS] Přijal LIGHT_SETTINGS z Hubu:");
+  Serial.printf("  manualOn=%d, autoLight=%d, onlyDark=%d, oken=%u\n",
+      manualLightOn, autoLight, lightOnlyIfDark, lightWindowCount);
+  for (uint8_t i = 0; i < lightWindowCount; i++) {
+    const FarmLightWindow &lw = lightWindows[i];
+    Serial.printf("  dny=0x%02X %02u:%02u->%02u:%02u\n", lw.days,
+        lw.startHour, lw.startMinute, lw.endHour, lw.endMinute);
   }
 }
 
 // -------------------------------------------------------------------------------------
 // WebSocket callback – příjem příkazů z FarmHubu
 
+// Ohlášení a opětovné připojení řeší FarmNode; LIGHT_SETTINGS pošle
+// hub sám po ohlášení. Bez spojení relé drží poslední plán.
 void webSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
   switch(type) {
-    case WStype_CONNECTED:
-      Serial.println("[WS] Připojeno k Hubu!");
-      // Můžeme si vyžádat nastavení LIGHT_SETTINGS, ale obvykle ho Hub pošle automaticky.
-      break;
-
-    case WStype_DISCONNECTED:
-      Serial.println("[WS] Odpojeno!");
-      {  WiFi.mode(WIFI_STA);
-        WiFi.begin(ssid, pass);
-        Serial.print("Connecting to WiFi");
-        unsigned long startAttempt = millis();
-        while (WiFi.status() != WL_CONNECTED && (millis() - startAttempt < 20000)) {
-          delay(500);
-          Serial.print(".");
-        }
-      }
-      break;
-
     case WStype_TEXT:
       payload[length] = 0; // ukončit řetězec
       Serial.printf("[WS] Message: %s\n", (char*)payload);
@@ -129,27 +188,53 @@ void webSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
             // Načteme si novou konfiguraci
             manualLightOn    = doc["manualOn"]       | false;
             autoLight        = doc["autoLight"]      | false;
-            lightStartHour   = doc["startHour"]      | 8;
-            lightStartMinute = doc["startMinute"]    | 0;
-            lightEndHour     = doc["endHour"]        | 20;
-            lightEndMinute   = doc["endMinute"]      | 0;
             lightOnlyIfDark  = doc["onlyIfDark"]     | false;
-
-            Serial.println("[WS] Přijal LIGHT_SETTINGS z Hubu:");
-            Serial.printf("  manualOn=%d, autoLight=%d, %02d:%02d->%02d:%02d, onlyDark=%d\n",
-                manualLightOn, autoLight,
-                lightStartHour, lightStartMinute,
-                lightEndHour,   lightEndMinute,
-                lightOnlyIfDark
-            );
+            setSingleWindow(doc["startHour"]   | 8,
+                            doc["startMinute"] | 0,
+                            doc["endHour"]     | 20,
+                            doc["endMinute"]   | 0);
+            printLightSettings();
+            planDirty = true;
           } else if (cmd == "INIT_TIME") {
-            // Přijímáme epochTime z hubu
-            unsigned long epoch = doc["epochTime"] | 0UL;
-            setEpochTime(epoch); 
-            
-            Serial.print("[WS] Přijal INIT_TIME, epoch = ");
-            Serial.println(epoch);
+            // epochTime už převzal FarmNode
+            Serial.printf("[WS] Přijal INIT_TIME, epoch = %lu\n", (unsigned long)farmNodeEpoch());
+            planDirty = true;
+          }
+        }
+      }
+      break;
+
+    case WStype_BIN:
+      {
+        FarmHeader hdr;
+        FarmReader r;
+        if (!farmParse(payload, length, hdr, r)) break;
+        if (hdr.type == MSG_LIGHT_SETTINGS) {
+          uint8_t flags    = farmGetU8(r);
+          manualLightOn    = flags & FARM_LIGHT_MANUAL_ON;
+          autoLight        = flags & FARM_LIGHT_AUTO;
+          lightOnlyIfDark  = flags & FARM_LIGHT_ONLY_DARK;
+          uint8_t startH   = farmGetU8(r);
+          uint8_t startM   = farmGetU8(r);
+          uint8_t endH     = farmGetU8(r);
+          uint8_t endM     = farmGetU8(r);
+          setSingleWindow(startH, startM, endH, endM);
+
+          // Volitelně všechna okna (hub, který je zná)
+          uint8_t count = (r.pos < r.len) ? farmGetU8(r) : 0;
+          if (count > 0 && count <= FARM_LIGHT_MAX_WINDOWS) {
+            FarmLightWindow windows[FARM_LIGHT_MAX_WINDOWS];
+            uint8_t n = 0;
+            while (n < count && farmGetLightWindow(r, windows[n])) n++;
+            if (n == count) {
+              memcpy(lightWindows, windows, n * sizeof(FarmLightWindow));
+              lightWindowCount = n;
+            }
           }
+          printLightSettings();
+          planDirty = true;
+        } else if (hdr.type == MSG_TIME) {
+          planDirty = true;
         }
       }
       break;
@@ -166,78 +251,26 @@ void setup() {
   Serial.begin(115200);
   pinMode(PIN_LIGHT, INPUT);
 
-  // Připojení k WiFi
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(ssid, pass);
-  Serial.print("Connecting to WiFi");
-  unsigned long startAttempt = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - startAttempt < 20000)) {
-    delay(500);
-    Serial.print(".");
-  }
-
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\n[WiFi] Připojeno!");
-    Serial.print("[WiFi] IP adresa: ");
-    Serial.println(WiFi.localIP());
-    Serial.print("[WiFi] Gateway:    ");
-    Serial.println(WiFi.gatewayIP());
-    Serial.print("[WiFi] DNS:        ");
-    Serial.println(WiFi.dnsIP());
-
-    unsigned long now = getCurrentEpochTime();
-    Serial.print("Aktuální čas: ");
-    Serial.println(now);
-
-  } else {
-    Serial.println("\n[WiFi] Nepodařilo se připojit k WiFi (timeout).");
-  }
-
-  // Nastavení WebSocket klienta (předpoklad: Hub běží na IP hubIP, port 80, path /ws)
-  webSocket.begin(hubIP.toString(), 80, "/ws");
-  webSocket.onEvent(webSocketEvent);
-  webSocket.setReconnectInterval(3000); // Reconnect každý 3 s
+  // Připojení k WiFi a hubu běží na pozadí ve farmNodeLoop()
+  farmNodeBegin(webSocket, NET_CONFIG, webSocketEvent);
 }
 
 void loop() {
-  // WebSocket zpracování
-  webSocket.loop();
+  // Wi-Fi a WebSocket zpracování
+  farmNodeLoop();
 
-  // (1) – Pokud je manuální zapnutí, to má přednost
-  if (manualLightOn) {
-    pinMode(PIN_LIGHT, OUTPUT);
-  }
-  else {
-    // (2) – Pokud není manuál, koukneme na autoLight
-    if (autoLight) {
-      bool inWindow = isInLightingWindow();
-      if (inWindow) {
-        if (lightOnlyIfDark) {
-          // Přečteme lokální senzor (analogRead(A0)) – příklad
-          int sensorVal = analogRead(A0); 
-          // Tady je třeba dle rozsahu čidla definovat podmínku < 50
-          // (Pokud je LDR zapojen jinak, může být 0=světlo atd., v praxi vyžaduje kalibraci.)
-          if (sensorVal < 50) {
-            pinMode(PIN_LIGHT, OUTPUT);
-          } else {
-            pinMode(PIN_LIGHT, INPUT);
-          }
-        } else {
-          // Svítit bez ohledu na okolní světlo
-          pinMode(PIN_LIGHT, OUTPUT);
-        }
-      }
-      else {
-        // Mimo nastavený interval
-        pinMode(PIN_LIGHT, INPUT);
-      }
-    }
-    else {
-      // (3) – Ani manuál, ani auto => vypnuto
-      pinMode(PIN_LIGHT, INPUT);
-    }
+  if (planDirty || (planInMs != 0 && millis() - planAtMs >= planInMs)) {
+    // Změna nastavení/času nebo hranice okna
+    planLight();
+  } else if (inWindow && lightOnlyIfDark && !manualLightOn &&
+             millis() - lastDarkCheck >= DARK_CHECK_MS) {
+    // V okně s podmínkou tmy stačí občasné měření
+    lastDarkCheck = millis();
+    setLight(isDark());
   }
 
   // Lze doplnit periodické odeslání stavu (lux, zapnuto/vypnuto) na Hub
   // ...
+
+  delay(LIGHT_IDLE_MS);
 }
@@ -2,6 +2,8 @@
 #include <ESP8266WiFi.h>
 #include <WebSocketsClient.h>
 #include <ArduinoJson.h>
+#include <FarmProto.h>
+#include <FarmNode.h>
 
 // Wi-Fi údaje
 const char* WIFI_SSID = "FarmHub-AP";
@@ -12,11 +14,25 @@ const char* WS_HOST = "192.168.4.1";
 const int   WS_PORT = 80;
 const char* WS_PATH = "/ws";
 
+// Spojení s hubem (FarmNode: neblokující připojování s backoffem)
+const FarmNodeConfig NET_CONFIG = {
+  WIFI_SSID, WIFI_PASS, WS_HOST, WS_PORT, WS_PATH, NODE_PUMP, "pumpClient", ",\"acks\":true"
+};
+
 #define PUMP_PIN 4
+#define PUMP_ID  0   // číslo čerpadla (zóny) na hubu; příkazy pro jiná se ignorují
 
 WebSocketsClient webSocket;
 bool pumpRunning    = false;
-unsigned long pumpEndTime = 0;
+unsigned long pumpStartTime = 0;
+unsigned long pumpDuration  = 0;   // ms
+
+// Potvrzování příkazů: seq posledního provedeného příkazu (duplicity se
+// jen znovu potvrdí) a hlášení o dokončení, které čeká na spojení
+uint32_t lastCmdSeq   = 0;
+bool     donePending  = false;
+uint32_t doneSeq      = 0;
+uint32_t doneRuntime  = 0;    // ms
 
 void pumpOn() {
   pinMode(PUMP_PIN, OUTPUT);
@@ -27,20 +43,72 @@ void pumpOff() {
   pinMode(PUMP_PIN, INPUT);
 }
 
-// Připojení k Wi-Fi
-void connectToWifi() {
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
-  unsigned long start = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - start) < 10000) {
-    delay(200);
+// Potvrzení příkazu hubu (PUMP_ACK) v protokolu, kterým hub mluví
+void sendPumpAck(uint32_t seq) {
+  if (farmNodeBinary()) {
+    uint8_t frame[FARM_HEADER_SIZE];
+    FarmWriter w;
+    farmBegin(w, frame, sizeof(frame), MSG_PUMP_ACK, NODE_PUMP, seq);
+    webSocket.sendBIN(frame, farmEnd(w));
+  } else {
+    char msg[48];
+    snprintf(msg, sizeof(msg), "{\"cmd\":\"PUMP_ACK\",\"seq\":%lu}", (unsigned long)seq);
+    webSocket.sendTXT(msg);
+  }
+}
+
+// Hlášení o doběhnutí (PUMP_DONE), při výpadku spojení se pošle po připojení
+void sendPumpDone() {
+  if (!donePending || !farmNodeOnline()) return;
+  if (farmNodeBinary()) {
+    uint8_t frame[FARM_HEADER_SIZE + 4];
+    FarmWriter w;
+    farmBegin(w, frame, sizeof(frame), MSG_PUMP_DONE, NODE_PUMP, doneSeq);
+    farmPutU32(w, doneRuntime);
+    webSocket.sendBIN(frame, farmEnd(w));
+  } else {
+    char msg[80];
+    snprintf(msg, sizeof(msg), "{\"cmd\":\"PUMP_DONE\",\"seq\":%lu,\"runtimeMs\":%lu}",
+             (unsigned long)doneSeq, (unsigned long)doneRuntime);
+    webSocket.sendTXT(msg);
+  }
+  donePending = false;
+}
+
+// Konec běhu čerpadla (doběhl nebo ho přerušil nový příkaz) – hub
+// dostane PUMP_DONE se skutečnou dobou běhu
+void finishPump() {
+  pumpOff();
+  pumpRunning = false;
+  if (doneSeq != 0) {
+    doneRuntime = millis() - pumpStartTime;
+    donePending = true;
+    sendPumpDone();
   }
 }
 
-// WebSocket události
+// Příkaz RUN_PUMP (z JSON i binárního rámce); seq 0 = starý hub bez potvrzování
+void runPump(int durationSec, uint32_t seq) {
+  if (seq != 0) {
+    sendPumpAck(seq);
+    if (seq == lastCmdSeq) return;  // opakované odeslání, už běží / proběhlo
+    lastCmdSeq = seq;
+  }
+  // Nový příkaz za běhu: předchozí se ukončí a nahlásí, jinak by hub
+  // na jeho PUMP_DONE čekal marně (doneSeq se přepíše)
+  if (pumpRunning) finishPump();
+  if (durationSec > 60) durationSec = 60;  // omezení
+  pumpOn();
+  pumpRunning   = true;
+  pumpStartTime = millis();
+  pumpDuration  = (unsigned long)durationSec * 1000UL;
+  doneSeq       = seq;
+}
+
+// WebSocket události (ohlášení a WELCOME zpracuje FarmNode)
 void webSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
   if (type == WStype_CONNECTED) {
-    webSocket.sendTXT("{\"sensorID\":\"pumpClient\"}");
+    sendPumpDone();
   }
   else if (type == WStype_TEXT) {
     payload[length] = 0;
@@ -51,33 +119,38 @@ void webSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
       String cmd = doc["cmd"]      | "";
       int durationSec = doc["duration"] | 0;
 
-      if (cmd.equals("RUN_PUMP")) {
-        if (durationSec > 60) durationSec = 60;  // omezení
-        pumpOn();
-        pumpRunning = true;
-        pumpEndTime = millis() + (unsigned long)durationSec * 1000UL;
+      if (cmd.equals("RUN_PUMP") && (doc["pump"] | 0) == PUMP_ID) {
+        runPump(durationSec, doc["seq"] | 0UL);
       }
     }
   }
+  else if (type == WStype_BIN) {
+    FarmHeader hdr;
+    FarmReader r;
+    if (!farmParse(payload, length, hdr, r)) return;
+    if (hdr.type == MSG_RUN_PUMP) {
+      uint16_t durationSec = farmGetU16(r);
+      uint8_t  pump        = farmGetU8(r);   // starší hub ho neposílá => 0
+      if (pump == PUMP_ID) runPump(durationSec, hdr.seq);
+    }
+  }
 }
 
 // setup()
 void setup() {
   Serial.begin(115200);
   pumpOff();
-  connectToWifi();
-  webSocket.begin(WS_HOST, WS_PORT, WS_PATH);
-  webSocket.onEvent(webSocketEvent);
+  farmNodeBegin(webSocket, NET_CONFIG, webSocketEvent);
 }
 
 // loop()
 void loop() {
-  webSocket.loop();
+  farmNodeLoop();
 
-  if (pumpRunning && millis() >= pumpEndTime) {
-    pumpOff();
-    pumpRunning = false;
+  if (pumpRunning && millis() - pumpStartTime >= pumpDuration) {
+    finishPump();
   }
+  sendPumpDone();
 
   delay(20);
 }
@@ -2,6 +2,9 @@
 #include <ESP8266WiFi.h>
 #include <WebSocketsClient.h>
 #include <ArduinoJson.h>
+#include <FarmProto.h>
+#include <FarmNode.h>
+#include <FarmReport.h>
 #include <DHT.h>
 
 // Wi-Fi údaje
@@ -13,6 +16,11 @@ const char* WS_HOST = "192.168.4.1";
 const int   WS_PORT = 80;
 const char* WS_PATH = "/ws";
 
+// Spojení s hubem (FarmNode: neblokující připojování s backoffem)
+const FarmNodeConfig NET_CONFIG = {
+  WIFI_SSID, WIFI_PASS, WS_HOST, WS_PORT, WS_PATH, NODE_SOIL_DHT, "soilDHTsensor", nullptr
+};
+
 // Pin DHT11 a definice typu
 #define DHT_PIN  D2
 #define DHTTYPE  DHT11
@@ -20,49 +28,171 @@ const char* WS_PATH = "/ws";
 DHT dht(DHT_PIN, DHTTYPE);
 WebSocketsClient webSocket;
 
-// Interval pro odeslání dat (ms)
-unsigned long lastSendTime = 0;
-const unsigned long SEND_INTERVAL = 90000; // 90 s
-
-// Připojení k Wi-Fi
-void connectToWifi() {
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
+// Měření po policy.sampleSec, hlásí se jen změny (FarmReport)
+unsigned long lastSampleTime = 0;
+const uint8_t SOIL_OVERSAMPLE = 8;   // čtení A0 na jedno měření
+FarmReporter  reporter;
+
+// ------------------------------------------------------------
+// Lokální fronta měření (store-and-forward)
+//
+// Do fronty jde jen nahlášené měření (změna, skok nebo heartbeat) s pořadovým
+// číslem a časem pořízení (millis) a odesílá se hned. Vzorky se mažou až po
+// potvrzení hubem ("ack"), takže se při výpadku spojení nic neztratí; po
+// připojení se fronta doplní v dávkách.
+// Skutečný čas (epoch) se dopočítá z INIT_TIME, který hub pošle po připojení.
+// ------------------------------------------------------------
+struct Sample {
+  uint32_t seq;
+  uint32_t takenMs;
+  float    soil;
+  float    temp;
+  float    hum;
+};
+
+const uint16_t      QUEUE_SIZE      = 240;    // hlášení (min. 40 min i při změně každých 10 s)
+const uint8_t       BATCH_MAX       = 12;     // max. vzorků v jedné zprávě (doplňování)
+const unsigned long ACK_TIMEOUT     = 10000;  // bez potvrzení => poslat znovu
+
+Sample   queue[QUEUE_SIZE];
+uint16_t queueHead  = 0;   // nejstarší vzorek
+uint16_t queueCount = 0;
+uint32_t nextSeq    = 1;
+uint32_t bootId     = 0;   // náhodné ID běhu, hub podle něj pozná restart
+
+bool          batchInFlight = false;
+unsigned long batchSentAt   = 0;
+
+float readSoilRaw() {
+  return analogRead(A0);
+}
 
-  Serial.print("Connecting to WiFi ");
-  Serial.print(WIFI_SSID);
+// Vloží měření do fronty, při plné frontě zahodí nejstarší
+void queueSample(float soil, float temp, float hum) {
+  if (queueCount == QUEUE_SIZE) {
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    queueCount--;
+  }
+  Sample &s = queue[(queueHead + queueCount) % QUEUE_SIZE];
+  s.seq     = nextSeq++;
+  s.takenMs = millis();
+  s.soil    = soil;
+  s.temp    = temp;
+  s.hum     = hum;
+  queueCount++;
+}
 
-  unsigned long start = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - start) < 10000) {
-    delay(200);
-    Serial.print(".");
+// Smaže vzorky potvrzené hubem (seq <= ack)
+void dropAcked(uint32_t ack) {
+  while (queueCount > 0 && (int32_t)(queue[queueHead].seq - ack) <= 0) {
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    queueCount--;
   }
-  Serial.println();
+  batchInFlight = false;
+}
+
+// Čas pořízení vzorku v epoch s (platí i pro vzorky změřené před INIT_TIME)
+uint32_t sampleEpoch(const Sample &s) {
+  return farmNodeEpochAt(s.takenMs);
+}
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("WiFi connected!");
-    Serial.print("IP address: ");
-    Serial.println(WiFi.localIP());
+// Odešle nejstarší vzorky z fronty jako jednu dávku
+void sendBatch() {
+  uint8_t n = (queueCount < BATCH_MAX) ? queueCount : BATCH_MAX;
+
+  if (farmNodeBinary()) {
+    uint8_t frame[FARM_MAX_FRAME];
+    FarmWriter w;
+    farmBegin(w, frame, sizeof(frame), MSG_READINGS, NODE_SOIL_DHT, queue[queueHead].seq);
+    farmPutU32(w, bootId);
+    farmPutU8(w, n);
+    for (uint8_t i = 0; i < n; i++) {
+      const Sample &q = queue[(queueHead + i) % QUEUE_SIZE];
+      FarmSample s;
+      s.ts     = sampleEpoch(q);
+      // Veličina, která ještě nebyla změřena (NAN, např. chyba DHT), se neposílá
+      s.fields = (isnan(q.soil) ? 0 : (1 << FARM_FIELD_SOIL)) |
+                 (isnan(q.temp) ? 0 : (1 << FARM_FIELD_TEMP)) |
+                 (isnan(q.hum)  ? 0 : (1 << FARM_FIELD_HUM));
+      s.values[FARM_FIELD_SOIL] = q.soil;
+      s.values[FARM_FIELD_TEMP] = q.temp;
+      s.values[FARM_FIELD_HUM]  = q.hum;
+      farmPutSample(w, s);
+    }
+    webSocket.sendBIN(frame, farmEnd(w));
   } else {
-    Serial.println("WiFi NOT connected (timeout).");
+    DynamicJsonDocument doc(1536);
+    doc["sensorID"] = "soilDHTsensor";
+    doc["boot"]     = bootId;
+    doc["seq"]      = queue[queueHead].seq;
+    JsonArray batch = doc.createNestedArray("batch");
+    for (uint8_t i = 0; i < n; i++) {
+      const Sample &s = queue[(queueHead + i) % QUEUE_SIZE];
+      JsonObject o = batch.createNestedObject();
+      o["ts"]   = sampleEpoch(s);
+      if (!isnan(s.soil)) o["soil"] = s.soil;
+      if (!isnan(s.temp)) o["temp"] = s.temp;
+      if (!isnan(s.hum))  o["hum"]  = s.hum;
+    }
+
+    String out;
+    serializeJson(doc, out);
+    webSocket.sendTXT(out);
   }
+  batchInFlight = true;
+  batchSentAt   = millis();
+
+  Serial.printf("Odesílám dávku %u vzorků (seq %lu)\n", n, (unsigned long)queue[queueHead].seq);
 }
 
-// WebSocket události
+// Rozhodne, zda je čas odeslat dávku
+void uplinkLoop() {
+  if (!farmNodeOnline() || !farmNodeTimeSynced() || queueCount == 0) return;
+
+  if (batchInFlight) {
+    if (millis() - batchSentAt < ACK_TIMEOUT) return;
+    batchInFlight = false; // potvrzení nepřišlo, pošleme znovu
+  }
+  // Fronta obsahuje jen nahlášená měření => posílá se hned
+  sendBatch();
+}
+
+// Nová pravidla hlášení od hubu
+void applyPolicy(const FarmReportPolicy &policy) {
+  farmReporterSetPolicy(reporter, policy);
+  Serial.printf("Hlášení: měření %u s, heartbeat %u s\n", policy.sampleSec, policy.heartbeatSec);
+}
+
+// WebSocket události (ohlášení, WELCOME a čas zpracuje FarmNode)
 void webSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
   switch (type) {
     case WStype_DISCONNECTED:
-      Serial.println("WebSocket disconnected!");
-      break;
-    case WStype_CONNECTED:
-      Serial.println("WebSocket connected!");
-      webSocket.sendTXT("{\"sensorID\":\"soilDHTsensor\"}");
+      batchInFlight = false;
       break;
     case WStype_TEXT: {
       payload[length] = 0;
-      String msg = (char*)payload;
       Serial.print("WS message: ");
-      Serial.println(msg);
+      Serial.println((char*)payload);
+
+      StaticJsonDocument<384> doc;
+      if (deserializeJson(doc, (char*)payload)) break;
+      if (doc.containsKey("ack")) {
+        dropAcked(doc["ack"] | 0UL);
+      } else if (strcmp(doc["cmd"] | "", "REPORT_POLICY") == 0) {
+        FarmReportPolicy policy;
+        if (farmReportPolicyFromJson(doc, policy)) applyPolicy(policy);
+      }
+    } break;
+    case WStype_BIN: {
+      FarmHeader hdr;
+      FarmReader r;
+      if (!farmParse(payload, length, hdr, r)) break;
+      if (hdr.type == MSG_ACK) {
+        dropAcked(hdr.seq);
+      } else if (hdr.type == MSG_REPORT_POLICY) {
+        FarmReportPolicy policy;
+        if (farmGetReportPolicy(r, policy)) applyPolicy(policy);
+      }
     } break;
     default:
       break;
@@ -73,42 +203,40 @@ void webSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
 void setup() {
   Serial.begin(115200);
   dht.begin();
-  connectToWifi();
-  webSocket.begin(WS_HOST, WS_PORT, WS_PATH);
-  webSocket.onEvent(webSocketEvent);
+  bootId = ESP.random();
+  farmReporterInit(reporter, (1 << FARM_FIELD_SOIL) | (1 << FARM_FIELD_TEMP) | (1 << FARM_FIELD_HUM));
+  lastSampleTime = millis() - farmReporterSampleMs(reporter);  // první měření hned, ne až po periodě
+  farmNodeBegin(webSocket, NET_CONFIG, webSocketEvent);
 }
 
 // loop()
 void loop() {
-  webSocket.loop();
-
-  // Odesílání dat v intervalu
-  if (millis() - lastSendTime >= SEND_INTERVAL) {
-    lastSendTime = millis();
+  farmNodeLoop();
 
-    float soilVal = analogRead(A0);  
-    float temperature = dht.readTemperature();
-    float humidity    = dht.readHumidity();
+  // Měření v intervalu; do fronty (a hned na hub) jde jen při změně
+  if (millis() - lastSampleTime >= farmReporterSampleMs(reporter)) {
+    lastSampleTime = millis();
 
-    if (isnan(temperature) || isnan(humidity)) {
+    float raw[FARM_FIELD_COUNT] = { NAN, NAN, NAN, NAN };
+    float soilVal = farmTrimmedMean(readSoilRaw, SOIL_OVERSAMPLE);
+    // Přepočet 0..1023 -> odhad vlhkosti v %
+    raw[FARM_FIELD_SOIL] = 100.0f - (soilVal / 10.23f);
+    raw[FARM_FIELD_TEMP] = dht.readTemperature();
+    raw[FARM_FIELD_HUM]  = dht.readHumidity();
+    if (isnan(raw[FARM_FIELD_TEMP]) || isnan(raw[FARM_FIELD_HUM])) {
       Serial.println("Chyba čtení z DHT senzoru!");
-      return;
     }
 
-    // Přepočet 0..1023 -> odhad vlhkosti v %
-    StaticJsonDocument<256> doc;
-    doc["sensorID"] = "soilDHTsensor";
-    doc["soil"]     = (100.0f - (soilVal / 10.23f)); 
-    doc["temp"]     = temperature;
-    doc["hum"]      = humidity;
-
-    String out;
-    serializeJson(doc, out);
-    webSocket.sendTXT(out);
-
-    Serial.print("Odesílám: ");
-    Serial.println(out);
+    FarmReportReason reason = farmReporterUpdate(reporter, raw, lastSampleTime);
+    if (reason != FARM_REPORT_NONE) {
+      queueSample(reporter.filtered[FARM_FIELD_SOIL], reporter.filtered[FARM_FIELD_TEMP],
+                  reporter.filtered[FARM_FIELD_HUM]);
+      Serial.printf("Hlášení (%s), %lu/%lu měření\n", farmReportReasonName(reason),
+                    (unsigned long)reporter.reports, (unsigned long)reporter.samples);
+    }
   }
 
+  uplinkLoop();
+
   delay(20);
 }
@@ -0,0 +1,36 @@
+#ifndef FARM_BACKOFF_H
+#define FARM_BACKOFF_H
+
+#include <stdint.h>
+
+// ------------------------------------------------------------
+// Čekání mezi pokusy o připojení (exponenciální, s náhodnou složkou)
+//
+// Pokus n čeká base * 2^(n-1), nejvýš FARM_BACKOFF_MAX_MS. Polovina
+// čekání je pevná a polovina náhodná, takže se uzly, které spojení
+// ztratily současně (restart hubu), nepřipojují ve stejný okamžik.
+// Generátor je xorshift32 se semínkem podle uzlu; bez závislosti na
+// Arduinu, aby šla politika ověřit i na PC (tools/fleet_sim.py).
+// ------------------------------------------------------------
+
+static const uint32_t FARM_BACKOFF_BASE_MS = 1000;
+static const uint32_t FARM_BACKOFF_MAX_MS  = 60000;
+
+static inline uint32_t farmRandom(uint32_t &state) {
+  if (state == 0) state = 0x9E3779B9;   // xorshift neumí stav 0
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// attempt = počet neúspěchů za sebou (1 = první opakování)
+static inline uint32_t farmBackoffMs(uint8_t attempt, uint32_t &rng) {
+  uint32_t wait = FARM_BACKOFF_BASE_MS;
+  for (uint8_t i = 1; i < attempt && wait < FARM_BACKOFF_MAX_MS; i++) wait <<= 1;
+  if (wait > FARM_BACKOFF_MAX_MS) wait = FARM_BACKOFF_MAX_MS;
+  uint32_t half = wait / 2;
+  return half + farmRandom(rng) % (half + 1);
+}
+
+#endif // FARM_BACKOFF_H
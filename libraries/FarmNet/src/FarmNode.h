@@ -0,0 +1,321 @@
+#ifndef FARM_NODE_H
+#define FARM_NODE_H
+
+#include <ESP8266WiFi.h>
+#include <WebSocketsClient.h>
+#include <ArduinoJson.h>
+#include "FarmProto.h"
+#include "FarmBackoff.h"
+#include "FarmWifiCache.h"
+
+// ------------------------------------------------------------
+// Společné připojení uzlu k hubu: Wi-Fi, WebSocket, ohlášení, čas
+//
+// Neblokující stavový automat, farmNodeLoop() se volá z loop():
+//   JOINING     WiFi.begin(), čeká na připojení (max. FARM_NODE_JOIN_MS,
+//               rychlé připojení z profilu v RTC FARM_WIFI_FAST_JOIN_MS)
+//   CONNECTING  WebSocket k hubu (max. FARM_NODE_CONNECT_MS); po výpadku
+//               první pokus až po náhodné části FARM_NODE_CONNECT_JITTER_MS
+//   ONLINE      spojeno; po ohlášení hub pošle WELCOME a čas
+//   BACKOFF     po neúspěchu/výpadku čeká farmBackoffMs() a zkusí znovu
+// Nikde se nečeká v delay(), takže měření v loop() běží i bez spojení.
+// Neúspěšné rychlé připojení nečeká na backoff, hned následuje úplné.
+// Po restartu hubu se uzly připojí k AP téměř současně (jakmile se AP
+// objeví), samotný backoff je tedy nerozloží – proto i náhodný odklad
+// WebSocketu. První připojení po startu uzlu se neodkládá.
+//
+// Knihovna sama pošle ohlášení, zpracuje MSG_WELCOME, MSG_TIME
+// i JSON INIT_TIME; všechny události pak předá handleru sketche.
+// ------------------------------------------------------------
+
+static const unsigned long FARM_NODE_JOIN_MS    = 15000;
+static const unsigned long FARM_NODE_CONNECT_MS = 5000;
+static const uint32_t      FARM_NODE_PING_MS    = 15000;  // heartbeat, odhalí mrtvý hub
+static const unsigned long FARM_NODE_WS_RETRY_MS = 500;   // opakování TCP spojení uvnitř CONNECTING
+static const unsigned long FARM_NODE_CONNECT_JITTER_MS = 1000;  // max. odklad WebSocketu po výpadku
+static const uint32_t      FARM_NODE_RTC_OFFSET = 0;      // profil Wi-Fi v RTC paměti (bloky po 4 B)
+
+enum FarmNodeState : uint8_t {
+  FARM_NODE_JOINING,
+  FARM_NODE_CONNECTING,
+  FARM_NODE_ONLINE,
+  FARM_NODE_BACKOFF
+};
+
+struct FarmNodeConfig {
+  const char *ssid;
+  const char *pass;
+  const char *host;
+  uint16_t    port;
+  const char *path;
+  uint8_t     node;        // FarmNodeId
+  const char *sensorId;    // jméno v JSON ohlášení
+  const char *helloExtra;  // další klíče ohlášení (",\"acks\":true"), může být nullptr
+};
+
+struct FarmNodeStats {
+  uint32_t      joins;        // úspěšná připojení k Wi-Fi
+  uint32_t      fastJoins;    // z toho rychlých (z profilu)
+  uint32_t      fastFallbacks;// rychlé připojení selhalo => úplné
+  unsigned long lastJoinMs;   // doba posledního připojení k Wi-Fi
+  uint32_t      connects;     // úspěšná připojení WebSocketu
+  uint32_t      failures;     // neúspěšné pokusy (Wi-Fi i WebSocket)
+  uint32_t      drops;        // ztráta navázaného spojení
+  unsigned long lastOutageMs; // délka posledního výpadku
+};
+
+typedef void (*FarmNodeHandler)(WStype_t type, uint8_t *payload, size_t length);
+
+struct FarmNodeLink {
+  FarmNodeConfig    cfg;
+  WebSocketsClient *ws;
+  FarmNodeHandler   handler;
+  FarmNodeState     state;
+  FarmJoinMode      joinMode;    // jak se právě připojuje / připojil
+  FarmWifiProfile   profile;     // kopie profilu z RTC paměti
+  unsigned long     since;       // millis() vstupu do stavu
+  unsigned long     waitMs;      // délka BACKOFF
+  unsigned long     connectDelayMs; // odklad prvního pokusu v CONNECTING
+  unsigned long     downSince;   // millis() ztráty spojení
+  uint8_t           attempts;    // neúspěchy za sebou
+  uint32_t          rng;
+  bool              binary;      // hub potvrdil binární protokol
+  bool              timeSynced;
+  uint32_t          syncEpoch;   // epoch z hubu
+  unsigned long     syncMillis;  // millis() v okamžiku synchronizace
+  FarmNodeStats     stats;
+};
+
+static FarmNodeLink g_farmNode;
+
+static inline const char *farmNodeStateName(FarmNodeState s) {
+  switch (s) {
+    case FARM_NODE_JOINING:    return "joining";
+    case FARM_NODE_CONNECTING: return "connecting";
+    case FARM_NODE_ONLINE:     return "online";
+    default:                   return "backoff";
+  }
+}
+
+static inline void farmNodeEnter(FarmNodeState s) {
+  g_farmNode.state = s;
+  g_farmNode.since = millis();
+}
+
+static inline void farmNodeSaveProfile() {
+  ESP.rtcUserMemoryWrite(FARM_NODE_RTC_OFFSET, (uint32_t *)&g_farmNode.profile,
+                         sizeof(FarmWifiProfile));
+}
+
+static inline void farmNodeJoin() {
+  FarmNodeLink &n = g_farmNode;
+  n.joinMode = farmWifiJoinMode(n.profile, n.cfg.ssid);
+  WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));   // adresa vždy z DHCP
+  if (n.joinMode == FARM_JOIN_FAST) {
+    WiFi.begin(n.cfg.ssid, n.cfg.pass, n.profile.channel, n.profile.bssid);
+  } else {
+    WiFi.begin(n.cfg.ssid, n.cfg.pass);
+  }
+  farmNodeEnter(FARM_NODE_JOINING);
+}
+
+// Rychlé připojení selhalo: profil pryč a hned úplné připojení
+static inline void farmNodeFastFailed() {
+  FarmNodeLink &n = g_farmNode;
+  Serial.println("[NET] profil Wi-Fi neplatí, úplné připojení");
+  n.stats.fastFallbacks++;
+  farmWifiProfileInvalidate(n.profile);
+  farmNodeSaveProfile();
+  WiFi.disconnect();
+  farmNodeJoin();
+}
+
+static inline void farmNodeJoined() {
+  FarmNodeLink &n = g_farmNode;
+  n.stats.joins++;
+  n.stats.lastJoinMs = millis() - n.since;
+  if (n.joinMode == FARM_JOIN_FAST) {
+    n.stats.fastJoins++;
+  } else {
+    farmWifiProfileStore(n.profile, n.cfg.ssid, WiFi.BSSID(), WiFi.channel());
+    farmNodeSaveProfile();
+  }
+  Serial.printf("[NET] WiFi %s za %lu ms (%s)\n", WiFi.localIP().toString().c_str(),
+                n.stats.lastJoinMs, n.joinMode == FARM_JOIN_FAST ? "profil+DHCP" : "sken+DHCP");
+}
+
+static inline void farmNodeConnect() {
+  // Knihovna před prvním pokusem čeká i interval opakování (počítaný
+  // od nuly), proto jen krátký. Mimo CONNECTING a ONLINE se ws->loop()
+  // nevolá, takže další pokusy stejně řídí BACKOFF.
+  FarmNodeLink &n = g_farmNode;
+  n.ws->begin(n.cfg.host, n.cfg.port, n.cfg.path);
+  n.ws->setReconnectInterval(FARM_NODE_WS_RETRY_MS);
+  n.connectDelayMs = n.attempts ? farmRandom(n.rng) % FARM_NODE_CONNECT_JITTER_MS : 0;
+  farmNodeEnter(FARM_NODE_CONNECTING);
+}
+
+static inline void farmNodeFail() {
+  FarmNodeLink &n = g_farmNode;
+  if (n.state == FARM_NODE_ONLINE) {
+    n.stats.drops++;
+    n.downSince = millis();
+  } else {
+    n.stats.failures++;
+  }
+  if (n.attempts < 255) n.attempts++;
+  n.binary = false;
+  n.waitMs = farmBackoffMs(n.attempts, n.rng);
+  farmNodeEnter(FARM_NODE_BACKOFF);   // před disconnect(), ten může vyvolat událost
+  n.ws->disconnect();
+  Serial.printf("[NET] %s, pokus %u za %lu ms\n",
+                WiFi.status() == WL_CONNECTED ? "WebSocket down" : "WiFi down",
+                n.attempts, n.waitMs);
+}
+
+static inline void farmNodeSetTime(uint32_t epoch) {
+  g_farmNode.syncEpoch  = epoch;
+  g_farmNode.syncMillis = millis();
+  g_farmNode.timeSynced = true;
+}
+
+static inline void farmNodeSendHello() {
+  const FarmNodeConfig &c = g_farmNode.cfg;
+  char hello[128];
+  snprintf(hello, sizeof(hello), "{\"sensorID\":\"%s\",\"proto\":%u,\"node\":%u%s}",
+           c.sensorId, FARM_PROTO_VERSION, c.node, c.helloExtra ? c.helloExtra : "");
+  g_farmNode.ws->sendTXT(hello);
+}
+
+static inline void farmNodeEvent(WStype_t type, uint8_t *payload, size_t length) {
+  FarmNodeLink &n = g_farmNode;
+  switch (type) {
+    case WStype_CONNECTED:
+      n.stats.connects++;
+      if (n.downSince != 0) {
+        n.stats.lastOutageMs = millis() - n.downSince;
+        n.downSince = 0;
+      }
+      n.attempts = 0;
+      n.binary   = false;
+      farmNodeEnter(FARM_NODE_ONLINE);
+      Serial.printf("[NET] online (výpadek %lu ms)\n", n.stats.lastOutageMs);
+      farmNodeSendHello();
+      break;
+
+    case WStype_DISCONNECTED:
+      if (n.state == FARM_NODE_ONLINE || n.state == FARM_NODE_CONNECTING) farmNodeFail();
+      break;
+
+    case WStype_TEXT:
+      // Čas od hubu, který mluví jen JSON
+      if (strstr((const char *)payload, "INIT_TIME")) {
+        StaticJsonDocument<128> doc;
+        if (!deserializeJson(doc, (const char *)payload, length)) {
+          farmNodeSetTime(doc["epochTime"] | 0UL);
+        }
+      }
+      break;
+
+    case WStype_BIN: {
+      FarmHeader hdr;
+      FarmReader r;
+      if (!farmParse(payload, length, hdr, r)) break;
+      if (hdr.type == MSG_WELCOME) {
+        n.binary = true;
+      } else if (hdr.type == MSG_TIME) {
+        farmNodeSetTime(farmGetU32(r));
+      }
+    } break;
+
+    default:
+      break;
+  }
+  if (n.handler) n.handler(type, payload, length);
+}
+
+/**
+ * @brief Spustí připojování (nečeká na něj). Semínko náhodného čekání
+ *        je z hardwarového RNG a MAC, takže se uzly rozejdou.
+ */
+static inline void farmNodeBegin(WebSocketsClient &ws, const FarmNodeConfig &cfg,
+                                 FarmNodeHandler handler) {
+  FarmNodeLink &n = g_farmNode;
+  memset(&n, 0, sizeof(n));
+  n.cfg     = cfg;
+  n.ws      = &ws;
+  n.handler = handler;
+  n.rng     = ESP.random() ^ ESP.getChipId();
+
+  WiFi.persistent(false);
+  WiFi.setAutoReconnect(false);   // opakování řídí backoff
+  WiFi.mode(WIFI_STA);
+  ws.onEvent(farmNodeEvent);
+  ws.enableHeartbeat(FARM_NODE_PING_MS, 3000, 2);
+  if (!ESP.rtcUserMemoryRead(FARM_NODE_RTC_OFFSET, (uint32_t *)&n.profile, sizeof(n.profile))) {
+    farmWifiProfileInvalidate(n.profile);
+  }
+  farmNodeJoin();
+}
+
+static inline void farmNodeLoop() {
+  FarmNodeLink &n = g_farmNode;
+  unsigned long elapsed = millis() - n.since;
+
+  switch (n.state) {
+    case FARM_NODE_JOINING:
+      if (WiFi.status() == WL_CONNECTED) {
+        farmNodeJoined();
+        farmNodeConnect();
+      } else if (n.joinMode == FARM_JOIN_FAST && elapsed >= FARM_WIFI_FAST_JOIN_MS) {
+        farmNodeFastFailed();
+      } else if (elapsed >= FARM_NODE_JOIN_MS) {
+        farmNodeFail();
+      }
+      break;
+
+    case FARM_NODE_CONNECTING:
+      if (WiFi.status() != WL_CONNECTED || elapsed >= FARM_NODE_CONNECT_MS) {
+        farmNodeFail();
+      } else if (elapsed >= n.connectDelayMs) {
+        n.ws->loop();
+      }
+      break;
+
+    case FARM_NODE_ONLINE:
+      if (WiFi.status() != WL_CONNECTED) {
+        farmNodeFail();
+      } else {
+        n.ws->loop();
+      }
+      break;
+
+    case FARM_NODE_BACKOFF:
+      if (elapsed < n.waitMs) break;
+      if (WiFi.status() == WL_CONNECTED) {
+        farmNodeConnect();
+      } else {
+        farmNodeJoin();
+      }
+      break;
+  }
+}
+
+static inline bool farmNodeOnline()     { return g_farmNode.state == FARM_NODE_ONLINE; }
+static inline bool farmNodeBinary()     { return farmNodeOnline() && g_farmNode.binary; }
+static inline bool farmNodeTimeSynced() { return g_farmNode.timeSynced; }
+// Skutečný čas (ne prozatímní čas hubu před NTP) – pro plánování podle hodin
+static inline bool farmNodeClockValid() {
+  return g_farmNode.timeSynced && g_farmNode.syncEpoch >= FARM_MIN_EPOCH;
+}
+
+// Epoch okamžiku millis() `ms` (platí i pro vzorky změřené před synchronizací)
+static inline uint32_t farmNodeEpochAt(unsigned long ms) {
+  return g_farmNode.syncEpoch + (int32_t)(ms - g_farmNode.syncMillis) / 1000;
+}
+
+static inline uint32_t farmNodeEpoch() {
+  return farmNodeEpochAt(millis());
+}
+
+#endif // FARM_NODE_H
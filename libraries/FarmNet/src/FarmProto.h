@@ -0,0 +1,308 @@
+#ifndef FARM_PROTO_H
+#define FARM_PROTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ------------------------------------------------------------
+// Binární protokol mezi hubem a uzly (WebSocket, binární zprávy)
+//
+// Rámec = pevná hlavička (10 B) + data:
+//   magic   u8   0xFA
+//   version u8   FARM_PROTO_VERSION
+//   type    u8   FarmMsgType
+//   node    u8   FarmNodeId odesílatele / adresáta
+//   seq     u32  pořadové číslo (u měření číslo prvního vzorku)
+//   length  u16  délka dat za hlavičkou
+// Čísla jsou little-endian (ESP8266 i PC), float je IEEE 754.
+//
+// Vyjednání: uzel po připojení pošle JSON ohlášení s "proto":<verze>
+// a "node":<id>. Hub, který protokol zná, odpoví binárním MSG_WELCOME
+// a od té chvíle spolu mluví binárně. Starý hub klíč ignoruje a uzel
+// bez WELCOME zůstane u JSON; stejně tak hub mluví JSON se starými uzly.
+// ------------------------------------------------------------
+
+static const uint8_t FARM_PROTO_MAGIC   = 0xFA;
+static const uint8_t FARM_PROTO_VERSION = 1;
+static const size_t  FARM_HEADER_SIZE   = 10;
+static const size_t  FARM_MAX_FRAME     = 512;
+
+// MSG_TIME s menší hodnotou není skutečný čas: hub bez NTP posílá
+// prozatímní čas (sekundy od svého startu), viz FarmHubTime.h
+static const uint32_t FARM_MIN_EPOCH = 1600000000;
+
+enum FarmMsgType : uint8_t {
+  MSG_WELCOME        = 1,  // hub -> uzel: binární protokol přijat (u8 verze)
+  MSG_TIME           = 2,  // hub -> uzel: u32 epoch
+  MSG_READINGS       = 3,  // uzel -> hub: u32 boot, u8 počet, vzorky
+  MSG_ACK            = 4,  // hub -> uzel: potvrzeno do seq (včetně)
+  MSG_RUN_PUMP       = 5,  // hub -> uzel: u16 sekund, u8 čerpadlo (chybí = 0)
+  MSG_LIGHT_SETTINGS = 6,  // hub -> uzel: u8 příznaky, u8 start h/m, u8 konec h/m,
+                           //   pak volitelně u8 počet oken a okna (FarmLightWindow)
+  MSG_PUMP_ACK       = 7,  // uzel -> hub: příkaz seq přijat (čerpadlo běží)
+  MSG_PUMP_DONE      = 8,  // uzel -> hub: příkaz seq dokončen, u32 skutečná doba v ms
+  MSG_REPORT_POLICY  = 9   // hub -> uzel: FarmReportPolicy (kdy hlásit měření)
+};
+
+enum FarmNodeId : uint8_t {
+  NODE_HUB          = 0,
+  NODE_SOIL_DHT     = 1,
+  NODE_LIGHT_SENSOR = 2,
+  NODE_LIGHT_MODULE = 3,
+  NODE_PUMP         = 4,
+  NODE_COUNT        = 5
+};
+
+// Názvy uzlů = sensorID používané v JSON (a v logu hubu)
+static inline const char *farmNodeName(uint8_t node) {
+  switch (node) {
+    case NODE_SOIL_DHT:     return "soilDHTsensor";
+    case NODE_LIGHT_SENSOR: return "lightsensor";
+    case NODE_LIGHT_MODULE: return "lightModule";
+    case NODE_PUMP:         return "pumpClient";
+    default:                return "unknown";
+  }
+}
+
+// Uzel podle sensorID z ohlášení (i starší názvy), NODE_HUB = neznámý
+static inline uint8_t farmNodeFromName(const char *name) {
+  for (uint8_t n = 1; n < NODE_COUNT; n++) {
+    if (strcmp(name, farmNodeName(n)) == 0) return n;
+  }
+  if (strcmp(name, "bh1750Sensor") == 0) return NODE_LIGHT_SENSOR;
+  return NODE_HUB;
+}
+
+// ------------------------------------------------------------
+// Témata příkazů od hubu. Uzel dostává jen zprávy odebíraných témat;
+// výchozí odběr plyne z role uzlu, v ohlášení ho lze přepsat polem
+// "topics":["pump",...]. Neohlášený klient odebírá vše (starý firmware).
+// ------------------------------------------------------------
+static const uint8_t FARM_TOPIC_PUMP  = 0x01;  // RUN_PUMP
+static const uint8_t FARM_TOPIC_LIGHT = 0x02;  // LIGHT_SETTINGS
+static const uint8_t FARM_TOPIC_REPORT = 0x04; // REPORT_POLICY
+static const uint8_t FARM_TOPIC_ALL   = 0xFF;
+
+static inline uint8_t farmTopicFromName(const char *name) {
+  if (strcmp(name, "pump") == 0)  return FARM_TOPIC_PUMP;
+  if (strcmp(name, "light") == 0) return FARM_TOPIC_LIGHT;
+  if (strcmp(name, "report") == 0) return FARM_TOPIC_REPORT;
+  return 0;
+}
+
+static inline uint8_t farmNodeTopics(uint8_t node) {
+  switch (node) {
+    case NODE_PUMP:         return FARM_TOPIC_PUMP;
+    case NODE_LIGHT_MODULE: return FARM_TOPIC_LIGHT;
+    case NODE_SOIL_DHT:
+    case NODE_LIGHT_SENSOR: return FARM_TOPIC_REPORT;
+    default:                return FARM_TOPIC_ALL;
+  }
+}
+
+// Veličiny ve vzorku (bit v masce; pořadí shodné s FIELD_* v hubu)
+static const uint8_t FARM_FIELD_SOIL  = 0;
+static const uint8_t FARM_FIELD_TEMP  = 1;
+static const uint8_t FARM_FIELD_HUM   = 2;
+static const uint8_t FARM_FIELD_LIGHT = 3;
+static const uint8_t FARM_FIELD_COUNT = 4;
+
+// Počet čerpadel (zón), která hub umí adresovat
+static const uint8_t FARM_MAX_PUMPS = 4;
+
+// Příznaky v MSG_LIGHT_SETTINGS
+static const uint8_t FARM_LIGHT_MANUAL_ON  = 0x01;
+static const uint8_t FARM_LIGHT_AUTO       = 0x02;
+static const uint8_t FARM_LIGHT_ONLY_DARK  = 0x04;
+
+// Okna svícení v MSG_LIGHT_SETTINGS: u8 dny, u8 start h/m, u8 konec h/m.
+// Dny jsou maska podle tm_wday (bit 0 = neděle ... bit 6 = sobota).
+// Konec <= start znamená přes půlnoc (konec == start = celých 24 h).
+// Starý uzel okna nečte a použije jen start/konec z pevné části.
+static const uint8_t FARM_LIGHT_MAX_WINDOWS = 8;
+static const uint8_t FARM_LIGHT_ALL_DAYS    = 0x7F;
+
+struct FarmLightWindow {
+  uint8_t days;
+  uint8_t startHour;
+  uint8_t startMinute;
+  uint8_t endHour;
+  uint8_t endMinute;
+};
+
+// Pravidla hlášení měření (MSG_REPORT_POLICY): u16 perioda měření s,
+// u16 max. ticho s, pak pro každou veličinu FARM_FIELD_* float pásmo
+// necitlivosti a float skok pro okamžité hlášení (0 = vypnuto)
+struct FarmReportPolicy {
+  uint16_t sampleSec;
+  uint16_t heartbeatSec;
+  float    deadband[FARM_FIELD_COUNT];
+  float    urgent[FARM_FIELD_COUNT];
+};
+
+// Výchozí pravidla (hub i uzel bez nastavení): měření po 10 s, hlášení
+// nejpozději po 15 min; půda %, teplota °C, vlhkost %, světlo lux
+static const FarmReportPolicy FARM_REPORT_DEFAULT = {
+  10, 900,
+  { 2.0f, 0.5f, 3.0f, 20.0f },
+  { 10.0f, 3.0f, 15.0f, 300.0f }
+};
+
+struct FarmHeader {
+  uint8_t  type;
+  uint8_t  node;
+  uint32_t seq;
+  uint16_t length;
+};
+
+// Jeden vzorek v MSG_READINGS: u32 ts, u8 maska, pak float pro každý bit masky
+struct FarmSample {
+  uint32_t ts;
+  uint8_t  fields;
+  float    values[FARM_FIELD_COUNT];
+};
+
+// ------------------------------------------------------------
+// Zápis rámce do bufferu volajícího (bez alokací)
+// ------------------------------------------------------------
+struct FarmWriter {
+  uint8_t *buf;
+  size_t   cap;
+  size_t   len;
+  bool     ok;   // false = buffer přetekl
+};
+
+static inline void farmPutBytes(FarmWriter &w, const void *data, size_t n) {
+  if (!w.ok || w.len + n > w.cap) {
+    w.ok = false;
+    return;
+  }
+  memcpy(w.buf + w.len, data, n);
+  w.len += n;
+}
+
+static inline void farmPutU8(FarmWriter &w, uint8_t v)   { farmPutBytes(w, &v, 1); }
+static inline void farmPutU16(FarmWriter &w, uint16_t v) { farmPutBytes(w, &v, 2); }
+static inline void farmPutU32(FarmWriter &w, uint32_t v) { farmPutBytes(w, &v, 4); }
+static inline void farmPutFloat(FarmWriter &w, float v)  { farmPutBytes(w, &v, 4); }
+
+static inline void farmBegin(FarmWriter &w, uint8_t *buf, size_t cap,
+                             uint8_t type, uint8_t node, uint32_t seq) {
+  w.buf = buf;
+  w.cap = cap;
+  w.len = 0;
+  w.ok  = true;
+  farmPutU8(w, FARM_PROTO_MAGIC);
+  farmPutU8(w, FARM_PROTO_VERSION);
+  farmPutU8(w, type);
+  farmPutU8(w, node);
+  farmPutU32(w, seq);
+  farmPutU16(w, 0);  // délka se doplní ve farmEnd()
+}
+
+// Doplní délku dat, vrací velikost rámce (0 = nevešel se)
+static inline size_t farmEnd(FarmWriter &w) {
+  if (!w.ok) return 0;
+  uint16_t payload = (uint16_t)(w.len - FARM_HEADER_SIZE);
+  memcpy(w.buf + 8, &payload, 2);
+  return w.len;
+}
+
+static inline void farmPutLightWindow(FarmWriter &w, const FarmLightWindow &lw) {
+  farmPutU8(w, lw.days);
+  farmPutU8(w, lw.startHour);
+  farmPutU8(w, lw.startMinute);
+  farmPutU8(w, lw.endHour);
+  farmPutU8(w, lw.endMinute);
+}
+
+static inline void farmPutReportPolicy(FarmWriter &w, const FarmReportPolicy &p) {
+  farmPutU16(w, p.sampleSec);
+  farmPutU16(w, p.heartbeatSec);
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    farmPutFloat(w, p.deadband[f]);
+    farmPutFloat(w, p.urgent[f]);
+  }
+}
+
+static inline void farmPutSample(FarmWriter &w, const FarmSample &s) {
+  farmPutU32(w, s.ts);
+  farmPutU8(w, s.fields);
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    if (s.fields & (1 << f)) farmPutFloat(w, s.values[f]);
+  }
+}
+
+// ------------------------------------------------------------
+// Čtení rámce přímo z přijatého bufferu
+// ------------------------------------------------------------
+struct FarmReader {
+  const uint8_t *p;
+  size_t         len;
+  size_t         pos;
+  bool           ok;   // false = čtení za konec dat
+};
+
+static inline void farmGetBytes(FarmReader &r, void *out, size_t n) {
+  if (!r.ok || r.pos + n > r.len) {
+    r.ok = false;
+    memset(out, 0, n);
+    return;
+  }
+  memcpy(out, r.p + r.pos, n);
+  r.pos += n;
+}
+
+static inline uint8_t  farmGetU8(FarmReader &r)    { uint8_t v;  farmGetBytes(r, &v, 1); return v; }
+static inline uint16_t farmGetU16(FarmReader &r)   { uint16_t v; farmGetBytes(r, &v, 2); return v; }
+static inline uint32_t farmGetU32(FarmReader &r)   { uint32_t v; farmGetBytes(r, &v, 4); return v; }
+static inline float    farmGetFloat(FarmReader &r) { float v;    farmGetBytes(r, &v, 4); return v; }
+
+// Ověří hlavičku; reader pak ukazuje na data rámce
+static inline bool farmParse(const uint8_t *data, size_t len, FarmHeader &hdr, FarmReader &r) {
+  if (len < FARM_HEADER_SIZE || data[0] != FARM_PROTO_MAGIC || data[1] != FARM_PROTO_VERSION) {
+    return false;
+  }
+  hdr.type = data[2];
+  hdr.node = data[3];
+  memcpy(&hdr.seq, data + 4, 4);
+  memcpy(&hdr.length, data + 8, 2);
+  if (FARM_HEADER_SIZE + hdr.length != len) return false;
+  r.p   = data + FARM_HEADER_SIZE;
+  r.len = hdr.length;
+  r.pos = 0;
+  r.ok  = true;
+  return true;
+}
+
+static inline bool farmGetLightWindow(FarmReader &r, FarmLightWindow &lw) {
+  lw.days        = farmGetU8(r);
+  lw.startHour   = farmGetU8(r);
+  lw.startMinute = farmGetU8(r);
+  lw.endHour     = farmGetU8(r);
+  lw.endMinute   = farmGetU8(r);
+  return r.ok && lw.startHour < 24 && lw.endHour < 24 &&
+         lw.startMinute < 60 && lw.endMinute < 60;
+}
+
+static inline bool farmGetReportPolicy(FarmReader &r, FarmReportPolicy &p) {
+  p.sampleSec    = farmGetU16(r);
+  p.heartbeatSec = farmGetU16(r);
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    p.deadband[f] = farmGetFloat(r);
+    p.urgent[f]   = farmGetFloat(r);
+  }
+  return r.ok && p.sampleSec > 0;
+}
+
+static inline bool farmGetSample(FarmReader &r, FarmSample &s) {
+  s.ts     = farmGetU32(r);
+  s.fields = farmGetU8(r);
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    s.values[f] = (s.fields & (1 << f)) ? farmGetFloat(r) : 0.0f;
+  }
+  return r.ok;
+}
+
+#endif // FARM_PROTO_H
@@ -0,0 +1,141 @@
+#ifndef FARM_REPORT_H
+#define FARM_REPORT_H
+
+#include <math.h>
+#include <ArduinoJson.h>
+#include "FarmProto.h"
+
+// ------------------------------------------------------------
+// Hlášení měření podle změny (uzel)
+//
+// Uzel měří každých sampleSec. Hodnota se vyhladí exponenciálním
+// průměrem a hlásí se, jen když se vyhlazená hodnota od posledního
+// hlášení změní aspoň o deadband, nebo když uzel mlčí heartbeatSec.
+// Skok surové hodnoty aspoň o urgent se hlásí hned a filtr se na ni
+// nastaví, aby zalití nebo rozsvícení nečekalo na dobíhající průměr.
+// Pravidla posílá hub (MSG_REPORT_POLICY), do té doby platí výchozí.
+// ------------------------------------------------------------
+
+static const float   FARM_REPORT_ALPHA   = 0.3f;  // váha nového měření ve filtru
+static const uint8_t FARM_OVERSAMPLE_MAX = 16;
+
+enum FarmReportReason : uint8_t {
+  FARM_REPORT_NONE,
+  FARM_REPORT_FIRST,      // první měření po startu
+  FARM_REPORT_CHANGE,     // vyhlazená hodnota mimo pásmo necitlivosti
+  FARM_REPORT_URGENT,     // velký skok surové hodnoty
+  FARM_REPORT_HEARTBEAT   // dlouho bez hlášení
+};
+
+struct FarmReporter {
+  FarmReportPolicy policy;
+  uint8_t          fields;                      // veličiny uzlu (maska FARM_FIELD_*)
+  float            filtered[FARM_FIELD_COUNT];  // NAN = zatím neměřeno
+  float            reported[FARM_FIELD_COUNT];  // naposledy nahlášené hodnoty
+  unsigned long    lastReportMs;
+  uint32_t         samples;                     // měření celkem
+  uint32_t         reports;                     // z toho nahlášeno
+};
+
+static inline void farmReporterInit(FarmReporter &r, uint8_t fields) {
+  memset(&r, 0, sizeof(r));
+  r.policy = FARM_REPORT_DEFAULT;
+  r.fields = fields;
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    r.filtered[f] = NAN;
+    r.reported[f] = NAN;
+  }
+}
+
+static inline unsigned long farmReporterSampleMs(const FarmReporter &r) {
+  return r.policy.sampleSec * 1000UL;
+}
+
+static inline const char *farmReportReasonName(FarmReportReason reason) {
+  switch (reason) {
+    case FARM_REPORT_FIRST:     return "start";
+    case FARM_REPORT_CHANGE:    return "změna";
+    case FARM_REPORT_URGENT:    return "skok";
+    case FARM_REPORT_HEARTBEAT: return "heartbeat";
+    default:                    return "-";
+  }
+}
+
+/**
+ * @brief Zpracuje jedno měření (raw[FARM_FIELD_*], NAN = veličina se
+ *        tentokrát nezměřila). Vrací důvod hlášení; hodnoty k odeslání
+ *        jsou pak v r.filtered (NAN = veličina ještě nebyla změřena).
+ */
+static inline FarmReportReason farmReporterUpdate(FarmReporter &r, const float *raw,
+                                                  unsigned long nowMs) {
+  FarmReportReason reason = FARM_REPORT_NONE;
+  r.samples++;
+
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    if (!(r.fields & (1 << f)) || isnan(raw[f])) continue;
+    float urgent = r.policy.urgent[f];
+
+    if (isnan(r.filtered[f]) || isnan(r.reported[f])) {
+      // první platné měření veličiny
+      r.filtered[f] = raw[f];
+      reason = FARM_REPORT_FIRST;
+      continue;
+    }
+    if (urgent > 0 && fabsf(raw[f] - r.reported[f]) >= urgent) {
+      r.filtered[f] = raw[f];
+      if (reason != FARM_REPORT_FIRST) reason = FARM_REPORT_URGENT;
+    } else {
+      r.filtered[f] += FARM_REPORT_ALPHA * (raw[f] - r.filtered[f]);
+    }
+    if (reason == FARM_REPORT_NONE &&
+        fabsf(r.filtered[f] - r.reported[f]) >= r.policy.deadband[f]) {
+      reason = FARM_REPORT_CHANGE;
+    }
+  }
+
+  if (reason == FARM_REPORT_NONE && nowMs - r.lastReportMs >= r.policy.heartbeatSec * 1000UL) {
+    reason = FARM_REPORT_HEARTBEAT;
+  }
+
+  if (reason != FARM_REPORT_NONE) {
+    memcpy(r.reported, r.filtered, sizeof(r.reported));
+    r.lastReportMs = nowMs;
+    r.reports++;
+  }
+  return reason;
+}
+
+// Pravidla z hubu (binárně MSG_REPORT_POLICY, v JSON "cmd":"REPORT_POLICY")
+static inline void farmReporterSetPolicy(FarmReporter &r, const FarmReportPolicy &p) {
+  r.policy = p;
+  if (r.policy.sampleSec == 0) r.policy.sampleSec = FARM_REPORT_DEFAULT.sampleSec;
+}
+
+static inline bool farmReportPolicyFromJson(JsonDocument &doc, FarmReportPolicy &p) {
+  p.sampleSec    = doc["sampleSec"]    | FARM_REPORT_DEFAULT.sampleSec;
+  p.heartbeatSec = doc["heartbeatSec"] | FARM_REPORT_DEFAULT.heartbeatSec;
+  for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+    p.deadband[f] = doc["deadband"][f] | FARM_REPORT_DEFAULT.deadband[f];
+    p.urgent[f]   = doc["urgent"][f]   | FARM_REPORT_DEFAULT.urgent[f];
+  }
+  return p.sampleSec > 0;
+}
+
+/**
+ * @brief Průměr n čtení bez nejmenšího a největšího (potlačí špičky
+ *        šumu, např. A0 při vysílání Wi-Fi).
+ */
+static inline float farmTrimmedMean(float (*read)(), uint8_t n) {
+  if (n > FARM_OVERSAMPLE_MAX) n = FARM_OVERSAMPLE_MAX;
+  if (n < 3) return read();
+  float sum = 0, lo = INFINITY, hi = -INFINITY;
+  for (uint8_t i = 0; i < n; i++) {
+    float v = read();
+    sum += v;
+    if (v < lo) lo = v;
+    if (v > hi) hi = v;
+  }
+  return (sum - lo - hi) / (n - 2);
+}
+
+#endif // FARM_REPORT_H
@@ -0,0 +1,81 @@
+#ifndef FARM_WIFI_CACHE_H
+#define FARM_WIFI_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ------------------------------------------------------------
+// Profil posledního úspěšného připojení k Wi-Fi (rychlé připojení)
+//
+// Po úplném připojení (sken všech kanálů + DHCP) se uloží BSSID a kanál.
+// Další připojení je pak WiFi.begin() s kanálem a BSSID, tj. bez skenu.
+// Adresa se bere vždy z DHCP: lease z minula mohl vypršet a router ji
+// mezitím přidělit jinému zařízení (nebo změnit podsíť), a bez hodin
+// platných po startu se to poznat nedá. Když rychlé připojení selže
+// (AP jinde, jiný kanál), profil se zneplatní a hned následuje úplné
+// připojení, které uloží nový profil.
+//
+// Uzly profil drží v RTC paměti (přežije reset i deep sleep), hub
+// v /config.json. Bez závislosti na Arduinu, aby šla logika ověřit i na PC.
+// ------------------------------------------------------------
+
+static const uint32_t FARM_WIFI_MAGIC        = 0x46574332; // "FWC2" (bez adres z DHCP)
+static const uint32_t FARM_WIFI_FAST_JOIN_MS = 5000;       // asociace + DHCP bez skenu
+
+struct __attribute__((aligned(4))) FarmWifiProfile {
+  uint32_t magic;
+  uint32_t check;      // FNV-1a zbytku struktury
+  uint32_t ssidHash;   // profil patří k této síti
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint8_t  reserved;
+};
+
+enum FarmJoinMode : uint8_t {
+  FARM_JOIN_FULL,   // sken + DHCP
+  FARM_JOIN_FAST    // kanál + BSSID z profilu, DHCP
+};
+
+static inline uint32_t farmFnv1a(const uint8_t *data, size_t len, uint32_t h = 2166136261UL) {
+  for (size_t i = 0; i < len; i++) {
+    h ^= data[i];
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+static inline uint32_t farmWifiSsidHash(const char *ssid) {
+  return farmFnv1a((const uint8_t *)ssid, strlen(ssid));
+}
+
+static inline uint32_t farmWifiProfileCheck(const FarmWifiProfile &p) {
+  const uint8_t *rest = (const uint8_t *)&p.ssidHash;
+  return farmFnv1a(rest, sizeof(FarmWifiProfile) - offsetof(FarmWifiProfile, ssidHash));
+}
+
+static inline bool farmWifiProfileValid(const FarmWifiProfile &p, const char *ssid) {
+  return p.magic == FARM_WIFI_MAGIC && p.check == farmWifiProfileCheck(p) &&
+         p.ssidHash == farmWifiSsidHash(ssid) && p.channel >= 1 && p.channel <= 14;
+}
+
+static inline FarmJoinMode farmWifiJoinMode(const FarmWifiProfile &p, const char *ssid) {
+  return farmWifiProfileValid(p, ssid) ? FARM_JOIN_FAST : FARM_JOIN_FULL;
+}
+
+// Profil po úplném připojení
+static inline void farmWifiProfileStore(FarmWifiProfile &p, const char *ssid, const uint8_t *bssid,
+                                        uint8_t channel) {
+  memset(&p, 0, sizeof(p));
+  p.ssidHash = farmWifiSsidHash(ssid);
+  memcpy(p.bssid, bssid, sizeof(p.bssid));
+  p.channel  = channel;
+  p.magic    = FARM_WIFI_MAGIC;
+  p.check    = farmWifiProfileCheck(p);
+}
+
+static inline void farmWifiProfileInvalidate(FarmWifiProfile &p) {
+  p.magic = 0;
+}
+
+#endif // FARM_WIFI_CACHE_H
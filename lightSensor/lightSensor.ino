@@ -2,6 +2,9 @@
 #include <ESP8266WiFi.h>
 #include <WebSocketsClient.h>
 #include <ArduinoJson.h>
+#include <FarmProto.h>
+#include <FarmNode.h>
+#include <FarmReport.h>
 #include <Wire.h>
 #include <BH1750.h>
 
@@ -14,52 +17,163 @@ const char* WS_HOST = "192.168.4.1";
 const int   WS_PORT = 80;
 const char* WS_PATH = "/ws";
 
+// Spojení s hubem (FarmNode: neblokující připojování s backoffem)
+const FarmNodeConfig NET_CONFIG = {
+  WIFI_SSID, WIFI_PASS, WS_HOST, WS_PORT, WS_PATH, NODE_LIGHT_SENSOR, "lightsensor", nullptr
+};
+
 BH1750 lightMeter;
 WebSocketsClient webSocket;
 
-// Interval pro odeslání dat
-unsigned long lastSendTime = 0;
-const unsigned long SEND_INTERVAL = 90000; // 90 s
+// Měření po policy.sampleSec, hlásí se jen změny (FarmReport)
+unsigned long lastSampleTime = 0;
+FarmReporter  reporter;
+
+// ------------------------------------------------------------
+// Lokální fronta měření (store-and-forward)
+//
+// Nahlášená měření (změna, skok nebo heartbeat) se ukládají s pořadovým
+// číslem a časem pořízení a odesílají se hned. Smažou se až po potvrzení
+// hubem ("ack"), po výpadku spojení se fronta doplní v dávkách. Epoch čas
+// se dopočítá z INIT_TIME od hubu.
+// ------------------------------------------------------------
+struct Sample {
+  uint32_t seq;
+  uint32_t takenMs;
+  float    light;
+};
+
+const uint16_t      QUEUE_SIZE      = 240;    // hlášení (min. 40 min i při změně každých 10 s)
+const uint8_t       BATCH_MAX       = 16;     // max. vzorků v jedné zprávě (doplňování)
+const unsigned long ACK_TIMEOUT     = 10000;  // bez potvrzení => poslat znovu
+
+Sample   queue[QUEUE_SIZE];
+uint16_t queueHead  = 0;   // nejstarší vzorek
+uint16_t queueCount = 0;
+uint32_t nextSeq    = 1;
+uint32_t bootId     = 0;   // náhodné ID běhu, hub podle něj pozná restart
+
+bool          batchInFlight = false;
+unsigned long batchSentAt   = 0;
+
+// Vloží měření do fronty, při plné frontě zahodí nejstarší
+void queueSample(float light) {
+  if (queueCount == QUEUE_SIZE) {
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    queueCount--;
+  }
+  Sample &s = queue[(queueHead + queueCount) % QUEUE_SIZE];
+  s.seq     = nextSeq++;
+  s.takenMs = millis();
+  s.light   = light;
+  queueCount++;
+}
+
+// Smaže vzorky potvrzené hubem (seq <= ack)
+void dropAcked(uint32_t ack) {
+  while (queueCount > 0 && (int32_t)(queue[queueHead].seq - ack) <= 0) {
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    queueCount--;
+  }
+  batchInFlight = false;
+}
 
-// Připojení k Wi-Fi
-void connectToWifi() {
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
+// Čas pořízení vzorku v epoch s (platí i pro vzorky změřené před INIT_TIME)
+uint32_t sampleEpoch(const Sample &s) {
+  return farmNodeEpochAt(s.takenMs);
+}
 
-  Serial.print("Connecting to WiFi ");
-  Serial.print(WIFI_SSID);
+// Odešle nejstarší vzorky z fronty jako jednu dávku
+void sendBatch() {
+  uint8_t n = (queueCount < BATCH_MAX) ? queueCount : BATCH_MAX;
+
+  if (farmNodeBinary()) {
+    uint8_t frame[FARM_MAX_FRAME];
+    FarmWriter w;
+    farmBegin(w, frame, sizeof(frame), MSG_READINGS, NODE_LIGHT_SENSOR, queue[queueHead].seq);
+    farmPutU32(w, bootId);
+    farmPutU8(w, n);
+    for (uint8_t i = 0; i < n; i++) {
+      const Sample &q = queue[(queueHead + i) % QUEUE_SIZE];
+      FarmSample s;
+      s.ts     = sampleEpoch(q);
+      s.fields = (1 << FARM_FIELD_LIGHT);
+      s.values[FARM_FIELD_LIGHT] = q.light;
+      farmPutSample(w, s);
+    }
+    webSocket.sendBIN(frame, farmEnd(w));
+  } else {
+    DynamicJsonDocument doc(1024);
+    doc["sensorID"] = "lightsensor";
+    doc["boot"]     = bootId;
+    doc["seq"]      = queue[queueHead].seq;
+    JsonArray batch = doc.createNestedArray("batch");
+    for (uint8_t i = 0; i < n; i++) {
+      const Sample &s = queue[(queueHead + i) % QUEUE_SIZE];
+      JsonObject o = batch.createNestedObject();
+      o["ts"]    = sampleEpoch(s);
+      o["light"] = s.light;
+    }
 
-  unsigned long start = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - start) < 10000) {
-    delay(200);
-    Serial.print(".");
+    String out;
+    serializeJson(doc, out);
+    webSocket.sendTXT(out);
   }
-  Serial.println();
+  batchInFlight = true;
+  batchSentAt   = millis();
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("WiFi connected!");
-    Serial.print("IP address: ");
-    Serial.println(WiFi.localIP());
-  } else {
-    Serial.println("WiFi NOT connected (timeout).");
+  Serial.printf("Odesílám dávku %u vzorků (seq %lu)\n", n, (unsigned long)queue[queueHead].seq);
+}
+
+// Rozhodne, zda je čas odeslat dávku
+void uplinkLoop() {
+  if (!farmNodeOnline() || !farmNodeTimeSynced() || queueCount == 0) return;
+
+  if (batchInFlight) {
+    if (millis() - batchSentAt < ACK_TIMEOUT) return;
+    batchInFlight = false; // potvrzení nepřišlo, pošleme znovu
   }
+  // Fronta obsahuje jen nahlášená měření => posílá se hned
+  sendBatch();
 }
 
-// WebSocket události
+// Nová pravidla hlášení od hubu
+void applyPolicy(const FarmReportPolicy &policy) {
+  farmReporterSetPolicy(reporter, policy);
+  Serial.printf("Hlášení: měření %u s, heartbeat %u s\n", policy.sampleSec, policy.heartbeatSec);
+}
+
+// WebSocket události (ohlášení, WELCOME a čas zpracuje FarmNode)
 void webSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
   switch (type) {
     case WStype_DISCONNECTED:
-      Serial.println("WebSocket disconnected!");
+      batchInFlight = false;
       break;
-    case WStype_CONNECTED:
-      Serial.println("WebSocket connected!");
-      webSocket.sendTXT("{\"sensorID\":\"bh1750Sensor\"}");
-      break;
-    case WStype_TEXT:
+    case WStype_TEXT: {
       payload[length] = 0;
       Serial.print("WS message: ");
       Serial.println((char*)payload);
-      break;
+
+      StaticJsonDocument<384> doc;
+      if (deserializeJson(doc, (char*)payload)) break;
+      if (doc.containsKey("ack")) {
+        dropAcked(doc["ack"] | 0UL);
+      } else if (strcmp(doc["cmd"] | "", "REPORT_POLICY") == 0) {
+        FarmReportPolicy policy;
+        if (farmReportPolicyFromJson(doc, policy)) applyPolicy(policy);
+      }
+    } break;
+    case WStype_BIN: {
+      FarmHeader hdr;
+      FarmReader r;
+      if (!farmParse(payload, length, hdr, r)) break;
+      if (hdr.type == MSG_ACK) {
+        dropAcked(hdr.seq);
+      } else if (hdr.type == MSG_REPORT_POLICY) {
+        FarmReportPolicy policy;
+        if (farmGetReportPolicy(r, policy)) applyPolicy(policy);
+      }
+    } break;
     default:
       break;
   }
@@ -76,31 +190,34 @@ void setup() {
   }
   Serial.println("BH1750 ready.");
 
-  connectToWifi();
-  webSocket.begin(WS_HOST, WS_PORT, WS_PATH);
-  webSocket.onEvent(webSocketEvent);
+  bootId = ESP.random();
+  farmReporterInit(reporter, 1 << FARM_FIELD_LIGHT);
+  lastSampleTime = millis() - farmReporterSampleMs(reporter);  // první měření hned, ne až po periodě
+  farmNodeBegin(webSocket, NET_CONFIG, webSocketEvent);
 }
 
 // loop()
 void loop() {
-  webSocket.loop();
-
-  if (millis() - lastSendTime >= SEND_INTERVAL) {
-    lastSendTime = millis();
-
-    float luxValue = lightMeter.readLightLevel();
-
-    StaticJsonDocument<256> doc;
-    doc["sensorID"] = "lightsensor";
-    doc["light"]    = luxValue;
-
-    String out;
-    serializeJson(doc, out);
-    webSocket.sendTXT(out);
-
-    Serial.print("Odesílám: ");
-    Serial.println(out);
+  farmNodeLoop();
+
+  // Měření v intervalu; do fronty (a hned na hub) jde jen při změně.
+  // BH1750 sám průměruje 120 ms, stačí vyhlazení ve FarmReporteru.
+  if (millis() - lastSampleTime >= farmReporterSampleMs(reporter)) {
+    lastSampleTime = millis();
+
+    float raw[FARM_FIELD_COUNT] = { NAN, NAN, NAN, NAN };
+    float lux = lightMeter.readLightLevel();
+    if (lux >= 0) raw[FARM_FIELD_LIGHT] = lux;   // < 0 = chyba čtení
+
+    FarmReportReason reason = farmReporterUpdate(reporter, raw, lastSampleTime);
+    if (reason != FARM_REPORT_NONE && !isnan(reporter.filtered[FARM_FIELD_LIGHT])) {
+      queueSample(reporter.filtered[FARM_FIELD_LIGHT]);
+      Serial.printf("Hlášení (%s), %lu/%lu měření\n", farmReportReasonName(reason),
+                    (unsigned long)reporter.reports, (unsigned long)reporter.samples);
+    }
   }
 
+  uplinkLoop();
+
   delay(10);
 }
@@ -0,0 +1,76 @@
+// Mikrobenchmarky hubu z FarmHubBench.h na PC, s velikostmi, na které
+// flash desky nestačí: log s 1k, 100k a 1M záznamy a 1–100 uzlů
+//
+//   ./bench_hub [--records 1000,100000,1000000] [--nodes 1,10,100]
+//       | python3 ../FarmHub/tools/bench_report.py --out bench.json [--baseline main.json]
+//
+// Každá velikost logu začíná s prázdnou flash. Víc uzlů než MAX_SENSOR_IDS
+// se dělí o ID (tabulka hubu), počet zpráv odpovídá počtu uzlů.
+
+#include <Arduino.h>
+#include <FS.h>
+#include "FarmHub.ino"
+#include "FarmHubBench.h"
+
+static size_t parseList(const char *arg, uint32_t *out, size_t cap) {
+  size_t n = 0;
+  while (*arg && n < cap) {
+    out[n++] = strtoul(arg, (char **)&arg, 10);
+    if (*arg == ',') arg++;
+  }
+  return n;
+}
+
+int main(int argc, char **argv) {
+  uint32_t records[8] = { 1000, 100000, 1000000 };
+  uint32_t nodes[8]   = { 1, 10, 100 };
+  size_t   recordSizes = 3;
+  size_t   nodeSizes   = 3;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--records") == 0 && i + 1 < argc) {
+      recordSizes = parseList(argv[++i], records, 8);
+    } else if (strcmp(argv[i], "--nodes") == 0 && i + 1 < argc) {
+      nodeSizes = parseList(argv[++i], nodes, 8);
+    } else {
+      fprintf(stderr, "usage: %s [--records N,N..] [--nodes N,N..]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+  hostUseRealClock(true);
+  hostSerialEcho(true);
+  hostSetHeapSize(64UL * 1024 * 1024);
+  initFileSystem();
+  loadUserConfig();
+  initDataStore();
+  Serial.println("BENCH_START");
+
+  for (size_t i = 0; i < recordSizes; i++) {
+    if ((uint64_t)records[i] > (uint64_t)(LOG_MAX_SEGMENTS - 1) * LOG_SEGMENT_RECORDS) {
+      fprintf(stderr, "bench_hub: %lu records exceed the log (LOG_MAX_SEGMENTS %u)\n",
+              (unsigned long)records[i], (unsigned)LOG_MAX_SEGMENTS);
+      return 1;
+    }
+    size_t segments = records[i] / LOG_SEGMENT_RECORDS + 2;
+    SPIFFS.format();
+    hostFsSetCapacity(segments * LOG_SEGMENT_BYTES + 1024 * 1024);
+    logBudgetKB = (uint32_t)(segments * LOG_SEGMENT_BYTES / 1024 + 1);
+    saveUserConfig();
+    saveSensorIDs();
+    logInit(logBudgetKB * 1024UL);
+    benchDataStore(records[i]);
+  }
+
+  static const uint8_t SAMPLES[] = { 1, 4, 16 };
+  for (size_t i = 0; i < nodeSizes; i++) {
+    for (uint8_t s : SAMPLES) benchIngest((uint8_t)nodes[i], s, 50);
+  }
+
+  benchConfig(10);
+  benchPages(5);
+  benchScheduler(500);
+
+  Serial.println("BENCH_DONE");
+  return 0;
+}
@@ -0,0 +1,166 @@
+// Dotaz na interval: původní průchod celým /datalog.csv proti
+// segmentovanému logu s časovým indexem (FarmHubLog.h)
+//
+// Obojí nad stejnými záznamy – tolik, kolik log nejvýš drží (všech
+// LOG_MAX_SEGMENTS segmentů, poslední rozepsaný; CSV má přes 1,5 MB). Počty vrácených
+// záznamů se musí shodovat; dotaz na poslední hodinu musí být přes index
+// řádově rychlejší, protože nečte celý soubor.
+
+#include "farm_test.h"
+#include "farm_bench.h"
+#include <FS.h>
+#include "FarmHubLog.h"
+
+static const uint32_t TS0     = 1700000000;
+static const uint32_t RECORDS = (uint32_t)(LOG_MAX_SEGMENTS - 1) * LOG_SEGMENT_RECORDS +
+                                LOG_SEGMENT_RECORDS / 2;
+static const uint32_t BUDGET  = LOG_MAX_SEGMENTS * LOG_SEGMENT_BYTES;
+static const char     CSV_PATH[] = "/datalog.csv";
+static const char    *SENSORS[]  = { "soilDHTsensor", "lightSensor", "airSensor" };
+
+static LogRecord makeRecord(uint32_t i) {
+  LogRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.timestamp    = TS0 + i * 60;
+  rec.sensorId     = i % 3;
+  rec.fields       = 0x0F;
+  rec.soilMoisture = 30.0f + (i % 200) * 0.1f;
+  rec.temperature  = 18.0f + (i % 70) * 0.1f;
+  rec.humidity     = 40.0f + (i % 300) * 0.1f;
+  rec.lightLevel   = (float)(i % 1000);
+  return rec;
+}
+
+static uint64_t g_csvBytes = 0;
+
+// Stejné soubory jako po RECORDS voláních staré storeSensorData()
+static void buildLogs() {
+  SPIFFS.format();
+  hostFsSetCapacity(8 * 1024 * 1024);
+  CHECK(logInit(BUDGET));
+
+  File csv = SPIFFS.open(CSV_PATH, "w");
+  LogRecord batch[8];
+  for (uint32_t i = 0; i < RECORDS; i += 8) {
+    for (uint32_t k = 0; k < 8; k++) {
+      batch[k] = makeRecord(i + k);
+      const LogRecord &r = batch[k];
+      csv.printf("%s,%lu,%.2f,%.2f,%.2f,%.2f\n", SENSORS[r.sensorId], (unsigned long)r.timestamp,
+                 r.soilMoisture, r.temperature, r.humidity, r.lightLevel);
+    }
+    CHECK_EQ(logAppendBatch(batch, 8, BUDGET), 8);
+  }
+  g_csvBytes = csv.size();
+  csv.close();
+}
+
+// Původní getDataForPeriod() bez skládání JSON odpovědi – čistě čtení
+// a parsování řádků, tedy spodní odhad jeho ceny
+static uint32_t csvQuery(uint32_t fromTs, uint32_t toTs) {
+  uint32_t matched = 0;
+  File file = SPIFFS.open(CSV_PATH, "r");
+  while (file.available()) {
+    String line = file.readStringUntil('\n');
+    if (line.length() < 5) continue;
+
+    int idx1 = line.indexOf(',');
+    int idx2 = line.indexOf(',', idx1 + 1);
+    int idx3 = line.indexOf(',', idx2 + 1);
+    int idx4 = line.indexOf(',', idx3 + 1);
+    int idx5 = line.indexOf(',', idx4 + 1);
+    if (idx5 < 0) continue;
+
+    String sID = line.substring(0, idx1);
+    unsigned long ts = line.substring(idx1 + 1, idx2).toInt();
+    float sm = line.substring(idx2 + 1, idx3).toFloat();
+    float te = line.substring(idx3 + 1, idx4).toFloat();
+    float hu = line.substring(idx4 + 1, idx5).toFloat();
+    float li = line.substring(idx5 + 1).toFloat();
+    (void)sm; (void)te; (void)hu; (void)li;
+
+    if (ts >= fromTs && ts <= toTs) matched++;
+  }
+  file.close();
+  return matched;
+}
+
+static uint32_t logQuery(uint32_t fromTs, uint32_t toTs) {
+  LogCursor cur;
+  LogRecord rec;
+  uint32_t  matched = 0;
+  logCursorBegin(cur, fromTs, toTs);
+  while (logCursorNext(cur, rec)) matched++;
+  logCursorEnd(cur);
+  return matched;
+}
+
+struct Range {
+  const char *csvName;
+  const char *logName;
+  uint32_t    first;   // index prvního záznamu v intervalu
+  uint32_t    count;
+  uint16_t    csvRounds;
+  uint16_t    logRounds;
+};
+
+static const Range RANGES[] = {
+  { "csvQueryHour", "logQueryHour", RECORDS - 60,   60,       3, 2000 },
+  { "csvQueryDay",  "logQueryDay",  RECORDS / 2,    24 * 60,  3, 200 },
+  { "csvQueryAll",  "logQueryAll",  0,              RECORDS,  3, 10 },
+};
+
+TEST(queriesMatchCsvScan) {
+  buildLogs();
+  printf("  %u records: CSV %llu B, log %u B in %u segments\n", RECORDS,
+         (unsigned long long)g_csvBytes, logUsedBytes(), logStoredSegments());
+  CHECK(g_csvBytes > 1500 * 1024);
+
+  for (const Range &r : RANGES) {
+    uint32_t fromTs = TS0 + r.first * 60;
+    uint32_t toTs   = TS0 + (r.first + r.count - 1) * 60;
+    CHECK_EQ(csvQuery(fromTs, toTs), r.count);
+    CHECK_EQ(logQuery(fromTs, toTs), r.count);
+
+    HostBench b;
+    hostBenchBegin(b, r.csvName, RECORDS);
+    for (uint16_t i = 0; i < r.csvRounds; i++) csvQuery(fromTs, toTs);
+    double csvUs = hostBenchEnd(b, r.csvRounds, g_csvBytes * r.csvRounds);
+
+    hostBenchBegin(b, r.logName, RECORDS);
+    for (uint16_t i = 0; i < r.logRounds; i++) logQuery(fromTs, toTs);
+    double logUs = hostBenchEnd(b, r.logRounds, (uint64_t)r.count * sizeof(LogRecord) * r.logRounds);
+
+    // Krátký interval: index čte jen pár bloků místo celého souboru
+    if (r.count <= 60) CHECK(logUs * 20 < csvUs);
+  }
+}
+
+// Cena dotazu na poslední hodinu nesmí růst se stářím logu
+TEST(hourQueryIndependentOfLogAge) {
+  SPIFFS.format();
+  hostFsSetCapacity(8 * 1024 * 1024);
+  CHECK(logInit(BUDGET));
+
+  static const uint32_t STEPS[] = { RECORDS / 8, RECORDS / 2, RECORDS };
+  uint32_t stored = 0;
+  double   firstUs = 0;
+  LogRecord batch[8];
+  for (uint32_t step : STEPS) {
+    for (; stored < step; stored += 8) {
+      for (uint32_t k = 0; k < 8; k++) batch[k] = makeRecord(stored + k);
+      logAppendBatch(batch, 8, BUDGET);
+    }
+    uint32_t fromTs = TS0 + (stored - 60) * 60;
+    HostBench b;
+    hostBenchBegin(b, "logQueryHourByAge", stored);
+    uint32_t matched = 0;
+    for (int i = 0; i < 2000; i++) matched += logQuery(fromTs, 0xFFFFFFFF);
+    double us = hostBenchEnd(b, 2000);
+    CHECK_EQ(matched, 2000 * 60);
+    if (firstUs == 0) firstUs = us;
+    // Velkorysá mez kvůli šumu měření; CSV by tu rostlo 8x
+    CHECK(us < firstUs * 3 + 5);
+  }
+}
+
+FARM_TEST_MAIN()
@@ -0,0 +1,281 @@
+// Kódování zpráv hub <-> uzly: JSON (ArduinoJson, jako staré uzly)
+// proti binárnímu rámci FarmProto
+//
+// Dávka měření od senzoru s 1, 4 a 16 vzorky: velikost zprávy, sestavení
+// na uzlu a příjem na hubu (parse + převod polí, jako readingFromJson /
+// readingFromSample). Příkazy hubu RUN_PUMP, LIGHT_SETTINGS a INIT_TIME:
+// velikost a příjem na uzlu. Obě cesty musí dát stejné hodnoty.
+
+#include "farm_test.h"
+#include "farm_bench.h"
+#include <ArduinoJson.h>
+#include <FarmProto.h>
+
+static const uint32_t NOW = 1700000000;
+
+// Vstup a výsledky měřených smyček přes volatile, aby je překladač
+// nevytkl ze smyčky ani nevynechal
+static volatile uint32_t g_sink;
+static const uint8_t *volatile g_frameIn;
+
+struct Reading {
+  uint32_t ts;
+  uint8_t  fields;
+  float    values[FARM_FIELD_COUNT];
+};
+
+static FarmSample makeSample(uint8_t i) {
+  FarmSample s;
+  s.ts     = NOW - (16 - i) * 60;
+  s.fields = (1 << FARM_FIELD_SOIL) | (1 << FARM_FIELD_TEMP) | (1 << FARM_FIELD_HUM);
+  s.values[FARM_FIELD_SOIL]  = 30.0f + i * 1.3f;
+  s.values[FARM_FIELD_TEMP]  = 18.5f + i * 0.2f;
+  s.values[FARM_FIELD_HUM]   = 55.0f - i * 0.7f;
+  s.values[FARM_FIELD_LIGHT] = 0.0f;
+  return s;
+}
+
+// Uzel: stejně jako sendBatch() v air-soil_Humiditi.ino
+static size_t jsonEncodeBatch(uint8_t samples, String &out) {
+  DynamicJsonDocument doc(1536);
+  doc["sensorID"] = "soilDHTsensor";
+  doc["boot"]     = 0x1234u;
+  doc["seq"]      = 100u;
+  JsonArray batch = doc.createNestedArray("batch");
+  for (uint8_t i = 0; i < samples; i++) {
+    FarmSample s = makeSample(i);
+    JsonObject o = batch.createNestedObject();
+    o["ts"]   = s.ts;
+    o["soil"] = s.values[FARM_FIELD_SOIL];
+    o["temp"] = s.values[FARM_FIELD_TEMP];
+    o["hum"]  = s.values[FARM_FIELD_HUM];
+  }
+  return serializeJson(doc, out);
+}
+
+static size_t binaryEncodeBatch(uint8_t samples, uint8_t *frame, size_t cap) {
+  FarmWriter w;
+  farmBegin(w, frame, cap, MSG_READINGS, NODE_SOIL_DHT, 100);
+  farmPutU32(w, 0x1234u);
+  farmPutU8(w, samples);
+  for (uint8_t i = 0; i < samples; i++) farmPutSample(w, makeSample(i));
+  return farmEnd(w);
+}
+
+// Hub: parse v místě do sdíleného dokumentu (g_wsDoc) a převod polí
+static StaticJsonDocument<2048> g_doc;
+
+static uint8_t jsonDecodeBatch(char *msg, size_t len, Reading *out) {
+  if (deserializeJson(g_doc, msg, len)) return 0;
+  uint8_t n = 0;
+  for (JsonVariant v : g_doc["batch"].as<JsonArray>()) {
+    if (n >= 16) break;
+    Reading &r = out[n++];
+    r.values[FARM_FIELD_SOIL]  = v["soil"]  | 0.0;
+    r.values[FARM_FIELD_TEMP]  = v["temp"]  | 0.0;
+    r.values[FARM_FIELD_HUM]   = v["hum"]   | 0.0;
+    r.values[FARM_FIELD_LIGHT] = v["light"] | 0.0;
+    r.fields = (v.containsKey("soil")  ? (1 << FARM_FIELD_SOIL)  : 0) |
+               (v.containsKey("temp")  ? (1 << FARM_FIELD_TEMP)  : 0) |
+               (v.containsKey("hum")   ? (1 << FARM_FIELD_HUM)   : 0) |
+               (v.containsKey("light") ? (1 << FARM_FIELD_LIGHT) : 0);
+    r.ts = v["ts"] | 0UL;
+  }
+  return n;
+}
+
+static uint8_t binaryDecodeBatch(const uint8_t *frame, size_t len, Reading *out) {
+  FarmHeader hdr;
+  FarmReader r;
+  if (!farmParse(frame, len, hdr, r) || hdr.type != MSG_READINGS) return 0;
+  farmGetU32(r);
+  uint8_t count = farmGetU8(r);
+  uint8_t n = 0;
+  FarmSample s;
+  while (n < count && n < 16 && farmGetSample(r, s)) {
+    out[n].ts     = s.ts;
+    out[n].fields = s.fields;
+    memcpy(out[n].values, s.values, sizeof(s.values));
+    n++;
+  }
+  return n;
+}
+
+TEST(readingsBatch) {
+  static const uint8_t SAMPLES[] = { 1, 4, 16 };
+  static char scratch[2048];
+  uint8_t frame[FARM_MAX_FRAME];
+  Reading fromJson[16], fromBinary[16];
+
+  for (uint8_t samples : SAMPLES) {
+    String json;
+    size_t jsonLen  = jsonEncodeBatch(samples, json);
+    size_t frameLen = binaryEncodeBatch(samples, frame, sizeof(frame));
+    printf("  %2u samples: JSON %u B, binary %u B\n", samples, (unsigned)jsonLen, (unsigned)frameLen);
+    CHECK(frameLen > 0);
+    CHECK(frameLen * 2 < jsonLen);
+
+    // Stejné hodnoty z obou cest (JSON nese float v textu)
+    memcpy(scratch, json.c_str(), jsonLen);
+    CHECK_EQ(jsonDecodeBatch(scratch, jsonLen, fromJson), samples);
+    CHECK_EQ(binaryDecodeBatch(frame, frameLen, fromBinary), samples);
+    for (uint8_t i = 0; i < samples; i++) {
+      CHECK_EQ(fromJson[i].ts, fromBinary[i].ts);
+      CHECK_EQ(fromJson[i].fields, fromBinary[i].fields);
+      for (uint8_t f = 0; f < FARM_FIELD_COUNT; f++) {
+        CHECK_NEAR(fromJson[i].values[f], fromBinary[i].values[f], 1e-4);
+      }
+    }
+
+    uint32_t rounds = 64000 / samples;
+    HostBench b;
+    hostBenchBegin(b, "jsonEncodeBatch", samples);
+    for (uint32_t m = 0; m < rounds; m++) g_sink = jsonEncodeBatch(samples, json);
+    hostBenchEnd(b, rounds, (uint64_t)rounds * jsonLen);
+
+    hostBenchBegin(b, "binaryEncodeBatch", samples);
+    for (uint32_t m = 0; m < rounds; m++) g_sink = binaryEncodeBatch(samples, frame, sizeof(frame));
+    hostBenchEnd(b, rounds, (uint64_t)rounds * frameLen);
+
+    String source = json;
+    hostBenchBegin(b, "jsonDecodeBatch", samples);
+    for (uint32_t m = 0; m < rounds; m++) {
+      memcpy(scratch, source.c_str(), jsonLen);   // parse přepisuje vstup
+      g_sink = jsonDecodeBatch(scratch, jsonLen, fromJson) + fromJson[0].ts;
+    }
+    double jsonUs = hostBenchEnd(b, rounds, (uint64_t)rounds * jsonLen);
+
+    hostBenchBegin(b, "binaryDecodeBatch", samples);
+    for (uint32_t m = 0; m < rounds; m++) {
+      g_frameIn = frame;
+      g_sink = binaryDecodeBatch(g_frameIn, frameLen, fromBinary) + fromBinary[0].ts;
+    }
+    double binUs = hostBenchEnd(b, rounds, (uint64_t)rounds * frameLen);
+
+    // Velkorysá mez; na ESP8266 je rozdíl větší (float v textu je drahý)
+    CHECK(binUs * 3 < jsonUs);
+  }
+}
+
+// ------------------------------------------------------------
+// Příkazy hubu: zprávy jako v FarmHubWebSocket.h, příjem na uzlu
+// ------------------------------------------------------------
+struct Command;
+static const Command *volatile g_cmdIn;
+
+struct Command {
+  const char *name;
+  uint8_t     type;
+  char        json[160];
+  size_t      jsonLen;
+  uint8_t     frame[64];
+  size_t      frameLen;
+};
+
+static void buildCommands(Command *cmds) {
+  FarmWriter w;
+
+  Command &pump = cmds[0];
+  pump.name = "RUN_PUMP";
+  pump.type = MSG_RUN_PUMP;
+  pump.jsonLen = snprintf(pump.json, sizeof(pump.json),
+                          "{\"cmd\":\"RUN_PUMP\",\"duration\":%u,\"seq\":%lu,\"pump\":%u}", 30u, 17ul, 1u);
+  farmBegin(w, pump.frame, sizeof(pump.frame), MSG_RUN_PUMP, NODE_PUMP, 17);
+  farmPutU16(w, 30);
+  farmPutU8(w, 1);
+  pump.frameLen = farmEnd(w);
+
+  Command &light = cmds[1];
+  light.name = "LIGHT_SETTINGS";
+  light.type = MSG_LIGHT_SETTINGS;
+  StaticJsonDocument<256> doc;
+  doc["cmd"]         = "LIGHT_SETTINGS";
+  doc["manualOn"]    = false;
+  doc["autoLight"]   = true;
+  doc["startHour"]   = 7;
+  doc["startMinute"] = 30;
+  doc["endHour"]     = 21;
+  doc["endMinute"]   = 0;
+  doc["onlyIfDark"]  = true;
+  light.jsonLen = serializeJson(doc, light.json, sizeof(light.json));
+  farmBegin(w, light.frame, sizeof(light.frame), MSG_LIGHT_SETTINGS, NODE_LIGHT_MODULE, 0);
+  farmPutU8(w, FARM_LIGHT_AUTO | FARM_LIGHT_ONLY_DARK);
+  farmPutU8(w, 7);
+  farmPutU8(w, 30);
+  farmPutU8(w, 21);
+  farmPutU8(w, 0);
+  farmPutU8(w, 1);
+  FarmLightWindow lw = { FARM_LIGHT_ALL_DAYS, 7, 30, 21, 0 };
+  farmPutLightWindow(w, lw);
+  light.frameLen = farmEnd(w);
+
+  Command &init = cmds[2];
+  init.name = "INIT_TIME";
+  init.type = MSG_TIME;
+  doc.clear();
+  doc["cmd"]       = "INIT_TIME";
+  doc["epochTime"] = (unsigned long)NOW;
+  init.jsonLen = serializeJson(doc, init.json, sizeof(init.json));
+  farmBegin(w, init.frame, sizeof(init.frame), MSG_TIME, NODE_HUB, 0);
+  farmPutU32(w, NOW);
+  init.frameLen = farmEnd(w);
+}
+
+// Uzel: dokument na zásobníku, zpráva z knihovny WebSockets je const
+static uint32_t jsonDecodeCommand(const Command &c) {
+  StaticJsonDocument<256> doc;
+  if (deserializeJson(doc, c.json, c.jsonLen)) return 0;
+  const char *cmd = doc["cmd"] | "";
+  if (strcmp(cmd, "RUN_PUMP") == 0)       return (doc["duration"] | 0) + (doc["pump"] | 0);
+  if (strcmp(cmd, "LIGHT_SETTINGS") == 0) return (doc["startHour"] | 8) * 60 + (doc["startMinute"] | 0) +
+                                                 (doc["autoLight"] | false);
+  if (strcmp(cmd, "INIT_TIME") == 0)      return doc["epochTime"] | 0UL;
+  return 0;
+}
+
+static uint32_t binaryDecodeCommand(const Command &c) {
+  FarmHeader hdr;
+  FarmReader r;
+  if (!farmParse(c.frame, c.frameLen, hdr, r)) return 0;
+  switch (hdr.type) {
+    case MSG_RUN_PUMP: {
+      uint16_t sec = farmGetU16(r);
+      return sec + farmGetU8(r);
+    }
+    case MSG_LIGHT_SETTINGS: {
+      uint8_t flags = farmGetU8(r);
+      uint8_t h = farmGetU8(r), m = farmGetU8(r);
+      return h * 60 + m + ((flags & FARM_LIGHT_AUTO) ? 1 : 0);
+    }
+    case MSG_TIME:
+      return farmGetU32(r);
+    default:
+      return 0;
+  }
+}
+
+TEST(hubCommands) {
+  static Command cmds[3];
+  buildCommands(cmds);
+  for (const Command &c : cmds) {
+    printf("  %-14s JSON %u B, binary %u B\n", c.name, (unsigned)c.jsonLen, (unsigned)c.frameLen);
+    CHECK(c.frameLen > 0 && c.frameLen < c.jsonLen);
+    CHECK(jsonDecodeCommand(c) != 0);
+    CHECK_EQ(jsonDecodeCommand(c), binaryDecodeCommand(c));
+
+    uint32_t rounds = 50000;
+    HostBench b;
+    hostBenchBegin(b, "jsonDecodeCmd", c.type);
+    for (uint32_t m = 0; m < rounds; m++) g_sink = jsonDecodeCommand(c);
+    hostBenchEnd(b, rounds, (uint64_t)rounds * c.jsonLen);
+
+    hostBenchBegin(b, "binaryDecodeCmd", c.type);
+    for (uint32_t m = 0; m < rounds; m++) {
+      g_cmdIn = &c;
+      g_sink  = binaryDecodeCommand(*g_cmdIn);
+    }
+    hostBenchEnd(b, rounds, (uint64_t)rounds * c.frameLen);
+  }
+}
+
+FARM_TEST_MAIN()
@@ -0,0 +1,47 @@
+#ifndef FARM_BENCH_H
+#define FARM_BENCH_H
+
+#include <Arduino.h>
+#include "FarmHost.h"
+
+// ------------------------------------------------------------
+// Měření hostitelských benchmarků
+//
+// Vypisuje stejné řádky "BENCH {json}" jako FarmHubBench.h na desce,
+// takže je zpracuje i tools/bench_report.py:
+//
+//   ./bench_log_query | python3 ../FarmHub/tools/bench_report.py --out bench.json
+//
+// Místo heapDelta (na PC nemá smysl) se hlásí počet alokací přes new.
+// ------------------------------------------------------------
+
+struct HostBench {
+  const char *name;
+  uint32_t    param;
+  uint64_t    startUs;
+  uint64_t    startAllocs;
+};
+
+static inline void hostBenchBegin(HostBench &b, const char *name, uint32_t param) {
+  hostUseRealClock(true);
+  b.name        = name;
+  b.param       = param;
+  b.startAllocs = hostHeap().allocs;
+  b.startUs     = micros();
+}
+
+// ops = počet operací (dotazů, zpráv, ...), bytes = volitelně objem dat;
+// vrací naměřené us na operaci
+static inline double hostBenchEnd(HostBench &b, uint32_t ops, uint64_t bytes = 0) {
+  uint64_t us     = micros() - b.startUs;
+  uint64_t allocs = hostHeap().allocs - b.startAllocs;
+  double   perOp  = ops ? (double)us / ops : 0.0;
+  printf("BENCH {\"name\":\"%s\",\"param\":%lu,\"ops\":%lu,\"us\":%llu,\"usPerOp\":%.2f,"
+         "\"bytes\":%llu,\"allocs\":%llu}\n",
+         b.name, (unsigned long)b.param, (unsigned long)ops, (unsigned long long)us, perOp,
+         (unsigned long long)bytes, (unsigned long long)allocs);
+  fflush(stdout);
+  return perOp;
+}
+
+#endif // FARM_BENCH_H
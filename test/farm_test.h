@@ -0,0 +1,99 @@
+#ifndef FARM_TEST_H
+#define FARM_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// ------------------------------------------------------------
+// Minimální rámec hostitelských testů (bez závislostí)
+//
+// Každý test je funkce TEST(jmeno) { ... }, která se sama zaregistruje;
+// main() z FARM_TEST_MAIN je spustí v pořadí definice. CHECK* při
+// neúspěchu vypíše místo a hodnoty a pokračuje dál, návratový kód
+// programu je počet selhaných kontrol (ctest pak hlásí chybu).
+// ------------------------------------------------------------
+
+typedef void (*FarmTestFn)();
+
+struct FarmTestCase {
+  const char *name;
+  FarmTestFn  fn;
+};
+
+static const int FARM_TEST_MAX = 64;
+
+static FarmTestCase g_farmTests[FARM_TEST_MAX];
+static int          g_farmTestCount    = 0;
+static int          g_farmTestFailures = 0;
+static int          g_farmTestChecks   = 0;
+
+struct FarmTestReg {
+  FarmTestReg(const char *name, FarmTestFn fn) {
+    if (g_farmTestCount < FARM_TEST_MAX) g_farmTests[g_farmTestCount++] = { name, fn };
+  }
+};
+
+#define TEST(name)                                         \
+  static void name();                                      \
+  static FarmTestReg farmTestReg_##name(#name, name);      \
+  static void name()
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    g_farmTestChecks++;                                                    \
+    if (!(cond)) {                                                         \
+      g_farmTestFailures++;                                                \
+      printf("  FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);            \
+    }                                                                      \
+  } while (0)
+
+// Celočíselné porovnání s výpisem obou hodnot
+#define CHECK_EQ(a, b)                                                     \
+  do {                                                                     \
+    g_farmTestChecks++;                                                    \
+    long long va_ = (long long)(a), vb_ = (long long)(b);                  \
+    if (va_ != vb_) {                                                      \
+      g_farmTestFailures++;                                                \
+      printf("  FAIL %s:%d: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, \
+             #a, #b, va_, vb_);                                            \
+    }                                                                      \
+  } while (0)
+
+#define CHECK_NEAR(a, b, eps)                                              \
+  do {                                                                     \
+    g_farmTestChecks++;                                                    \
+    double va_ = (double)(a), vb_ = (double)(b);                           \
+    if (!(va_ - vb_ <= (eps) && vb_ - va_ <= (eps))) {                     \
+      g_farmTestFailures++;                                                \
+      printf("  FAIL %s:%d: %s ~ %s (%g != %g)\n", __FILE__, __LINE__,     \
+             #a, #b, va_, vb_);                                            \
+    }                                                                      \
+  } while (0)
+
+#define CHECK_STR(a, b)                                                    \
+  do {                                                                     \
+    g_farmTestChecks++;                                                    \
+    const char *va_ = (a), *vb_ = (b);                                     \
+    if (strcmp(va_, vb_) != 0) {                                           \
+      g_farmTestFailures++;                                                \
+      printf("  FAIL %s:%d: %s == %s (\"%s\" != \"%s\")\n", __FILE__,      \
+             __LINE__, #a, #b, va_, vb_);                                  \
+    }                                                                      \
+  } while (0)
+
+static inline int farmTestRun() {
+  for (int i = 0; i < g_farmTestCount; i++) {
+    int before = g_farmTestFailures;
+    printf("[ RUN  ] %s\n", g_farmTests[i].name);
+    g_farmTests[i].fn();
+    printf("[ %s ] %s\n", g_farmTestFailures == before ? " OK " : "FAIL", g_farmTests[i].name);
+  }
+  printf("%d checks, %d failed\n", g_farmTestChecks, g_farmTestFailures);
+  return g_farmTestFailures > 0 ? 1 : 0;
+}
+
+#define FARM_TEST_MAIN() \
+  int main() { return farmTestRun(); }
+
+#endif // FARM_TEST_H
@@ -0,0 +1,57 @@
+// FarmHub na PC: firmware hubu (FarmHub.ino) beze změn nad shimy z host/
+//
+//   ./farmhub_host [--port 8080] [--fs flash.img] [--quiet]
+//
+// Webové stránky a /ws poslouchají na 127.0.0.1:port, hodiny jsou
+// skutečné. Obsah flash se s --fs při startu načte z obrazu a po Ctrl+C
+// do něj uloží. Zátěž simulovanou flotilou uzlů:
+//
+//   python3 FarmHub/tools/fleet_sim.py --host 127.0.0.1 --port 8080
+//       --soil 50 --light 50 --pump 5 --lightmodule 5 --interval 1 --duration 60
+//
+// Hub drží WS_MAX_PEERS uzlů (na ESP8266 6); pro test s více uzly se
+// překládá s -DFARMHUB_HOST_WS_PEERS=N (viz CMakeLists.txt).
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include <signal.h>
+#include "FarmHub.ino"
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void onSignal(int) { g_stop = 1; }
+
+int main(int argc, char **argv) {
+  uint16_t    port  = 8080;
+  const char *image = nullptr;
+  bool        quiet = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+      port = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--fs") == 0 && i + 1 < argc) {
+      image = argv[++i];
+    } else if (strcmp(argv[i], "--quiet") == 0) {
+      quiet = true;
+    } else {
+      fprintf(stderr, "usage: %s [--port N] [--fs flash.img] [--quiet]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+  hostUseRealClock(true);
+  hostSerialEcho(!quiet);
+  if (image && !hostFsLoadImage(image)) fprintf(stderr, "farmhub_host: %s not loaded, empty flash\n", image);
+  if (!hostHttpListen(port)) return 1;
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  setup();
+  fprintf(stderr, "farmhub_host: http://127.0.0.1:%u/ (WebSocket /ws, %u peer slots)\n",
+          port, (unsigned)WS_MAX_PEERS);
+  while (!g_stop) loop();
+
+  if (image && !hostFsSaveImage(image)) fprintf(stderr, "farmhub_host: %s not saved\n", image);
+  return 0;
+}
@@ -0,0 +1,13 @@
+#!/bin/sh
+# Kouřový test: farmhub_host a krátký běh tools/fleet_sim.py proti němu
+#   fleet_smoke.sh <farmhub_host> <fleet_sim.py> [port]
+HUB=$1
+SIM=$2
+PORT=${3:-18080}
+
+"$HUB" --port "$PORT" --quiet 2>/dev/null &
+PID=$!
+trap 'kill $PID 2>/dev/null; wait $PID 2>/dev/null' EXIT
+sleep 1
+python3 "$SIM" --host 127.0.0.1 --port "$PORT" --soil 2 --light 1 --pump 1 --lightmodule 1 \
+  --interval 1 --duration 5 --ramp 1 --check
@@ -0,0 +1,37 @@
+#ifndef FARM_HOST_ADAFRUIT_GFX_H
+#define FARM_HOST_ADAFRUIT_GFX_H
+
+// Adafruit GFX (shim): nic nekreslí, text jen posouvá kurzor
+#include "Arduino.h"
+
+#define BLACK 0
+#define WHITE 1
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+
+  int16_t width() const  { return _width; }
+  int16_t height() const { return _height; }
+  void setTextSize(uint8_t s) { _textSize = s; }
+  void setTextColor(uint16_t c) {}
+  void setTextColor(uint16_t c, uint16_t bg) {}
+  void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) {}
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {}
+  void fillScreen(uint16_t color) {}
+
+  size_t write(uint8_t c) override {
+    if (c == '\n') { _cursorX = 0; _cursorY += 8 * _textSize; }
+    else if (c != '\r') _cursorX += 6 * _textSize;
+    return 1;
+  }
+  using Print::write;
+
+protected:
+  int16_t _width, _height;
+  int16_t _cursorX = 0, _cursorY = 0;
+  uint8_t _textSize = 1;
+};
+
+#endif // FARM_HOST_ADAFRUIT_GFX_H
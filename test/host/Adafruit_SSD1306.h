@@ -0,0 +1,40 @@
+#ifndef FARM_HOST_ADAFRUIT_SSD1306_H
+#define FARM_HOST_ADAFRUIT_SSD1306_H
+
+// SSD1306 (shim): framebuffer v RAM, příkazy a display() jdou na Wire
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_COLUMNADDR   0x21
+#define SSD1306_PAGEADDR     0x22
+#define SSD1306_WHITE        WHITE
+#define SSD1306_BLACK        BLACK
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(int16_t w, int16_t h, TwoWire *wire, int8_t rstPin = -1)
+    : Adafruit_GFX(w, h), _wire(wire) {}
+
+  bool     begin(uint8_t vcs = SSD1306_SWITCHCAPVCC, uint8_t addr = 0x3C) { _addr = addr; return true; }
+  void     clearDisplay() { memset(_buffer, 0, sizeof(_buffer)); }
+  void     display() {
+    _wire->beginTransmission(_addr);
+    _wire->write(_buffer, sizeof(_buffer));
+    _wire->endTransmission();
+  }
+  uint8_t *getBuffer() { return _buffer; }
+  void     ssd1306_command(uint8_t c) {
+    _wire->beginTransmission(_addr);
+    _wire->write((uint8_t)0x00);
+    _wire->write(c);
+    _wire->endTransmission();
+  }
+
+private:
+  TwoWire *_wire;
+  uint8_t  _addr = 0x3C;
+  uint8_t  _buffer[128 * 64 / 8];
+};
+
+#endif // FARM_HOST_ADAFRUIT_SSD1306_H
@@ -0,0 +1,356 @@
+// Arduino/ESP8266 core pro hostitelské sestavení (viz Arduino.h, FarmHost.h)
+
+#include "Arduino.h"
+#include <ctype.h>
+#include <new>
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass       ESP;
+
+// ------------------------------------------------------------
+// Halda – počítání globálních new/delete
+//
+// Před každý blok se uloží jeho velikost (16 B kvůli zarovnání),
+// delete ji odečte. malloc() se nepočítá; simulace flash (FS.cpp)
+// proto alokuje přes malloc a do měření firmwaru se nepromítá.
+// ------------------------------------------------------------
+static HostHeapStats g_hostHeap;
+static uint32_t      g_hostHeapSize = 48 * 1024;   // volná halda hubu po startu (ESP8266)
+static const size_t  HOST_ALLOC_HEADER = 16;
+
+static void *hostAlloc(size_t size) {
+  uint8_t *p = (uint8_t *)malloc(size + HOST_ALLOC_HEADER);
+  if (!p) throw std::bad_alloc();
+  *(size_t *)p = size;
+  g_hostHeap.allocs++;
+  g_hostHeap.bytes += size;
+  if (g_hostHeap.bytes > g_hostHeap.peak) g_hostHeap.peak = g_hostHeap.bytes;
+  return p + HOST_ALLOC_HEADER;
+}
+
+static void hostFree(void *ptr) {
+  if (!ptr) return;
+  uint8_t *p = (uint8_t *)ptr - HOST_ALLOC_HEADER;
+  g_hostHeap.frees++;
+  g_hostHeap.bytes -= *(size_t *)p;
+  free(p);
+}
+
+void *operator new(size_t size)   { return hostAlloc(size); }
+void *operator new[](size_t size) { return hostAlloc(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  try { return hostAlloc(size); } catch (...) { return nullptr; }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  try { return hostAlloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void *p) noexcept           { hostFree(p); }
+void operator delete[](void *p) noexcept         { hostFree(p); }
+void operator delete(void *p, size_t) noexcept   { hostFree(p); }
+void operator delete[](void *p, size_t) noexcept { hostFree(p); }
+
+const HostHeapStats &hostHeap() { return g_hostHeap; }
+void hostHeapResetPeak()        { g_hostHeap.peak = g_hostHeap.bytes; }
+void hostSetHeapSize(uint32_t bytes) { g_hostHeapSize = bytes; }
+
+uint32_t EspClass::getFreeHeap() {
+  return g_hostHeap.bytes < g_hostHeapSize ? g_hostHeapSize - (uint32_t)g_hostHeap.bytes : 0;
+}
+
+uint32_t EspClass::getMaxFreeBlockSize() { return getFreeHeap(); }
+
+// ------------------------------------------------------------
+// Hodiny
+// ------------------------------------------------------------
+static bool     g_realClock = false;
+static uint64_t g_simUs     = 0;
+
+static const int  HOST_MAX_IDLE = 4;
+static HostIdleFn g_idle[HOST_MAX_IDLE];
+static int        g_idleCount = 0;
+
+static uint64_t realUs() {
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - start).count();
+}
+
+void hostUseRealClock(bool real) { g_realClock = real; }
+void hostSetMillis(uint64_t ms)  { g_simUs = ms * 1000; }
+void hostAdvanceMs(uint32_t ms)  { g_simUs += (uint64_t)ms * 1000; }
+void hostAdvanceUs(uint32_t us)  { g_simUs += us; }
+
+void hostAddIdleHandler(HostIdleFn fn) {
+  if (g_idleCount < HOST_MAX_IDLE) g_idle[g_idleCount++] = fn;
+}
+
+static void runIdle(uint32_t waitMs) {
+  for (int i = 0; i < g_idleCount; i++) g_idle[i](i == 0 ? waitMs : 0);
+}
+
+unsigned long micros() { return g_realClock ? realUs() : g_simUs; }
+unsigned long millis() { return micros() / 1000; }
+
+void delay(unsigned long ms) {
+  if (!g_realClock) {
+    g_simUs += (uint64_t)ms * 1000;
+    runIdle(0);
+    return;
+  }
+  uint64_t end = realUs() + (uint64_t)ms * 1000;
+  for (;;) {
+    uint64_t now = realUs();
+    if (now >= end && ms > 0) break;
+    uint32_t left = (uint32_t)((end > now ? end - now : 0) / 1000);
+    if (g_idleCount > 0) {
+      runIdle(left);
+    } else if (left > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(left));
+    }
+    if (ms == 0) break;
+  }
+}
+
+void delayMicroseconds(unsigned int us) {
+  if (g_realClock) std::this_thread::sleep_for(std::chrono::microseconds(us));
+  else g_simUs += us;
+}
+
+void yield() { runIdle(0); }
+
+// ------------------------------------------------------------
+// Piny a náhoda
+// ------------------------------------------------------------
+static int g_pins[32];
+static int g_analog = 0;
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t val) { if (pin < 32) g_pins[pin] = val; }
+int  digitalRead(uint8_t pin) { return pin < 32 ? g_pins[pin] : LOW; }
+int  analogRead(uint8_t pin) { return g_analog; }
+void hostSetAnalog(uint8_t pin, int value) { g_analog = value; }
+
+static uint32_t g_rng = 0x12345678;
+
+static uint32_t hostRandom() {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+}
+
+long random(long howbig) { return howbig > 0 ? (long)(hostRandom() % (uint32_t)howbig) : 0; }
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+void randomSeed(unsigned long seed) { if (seed) g_rng = (uint32_t)seed; }
+
+uint32_t EspClass::random()    { return hostRandom(); }
+uint32_t EspClass::getChipId() { return 0x00C0FFEE; }
+
+// RTC user memory: 512 B po 4B blocích, přežije restart (na PC běh programu)
+static uint32_t g_rtcMemory[128];
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size) {
+  if (offset * 4 + size > sizeof(g_rtcMemory)) return false;
+  memcpy(data, (uint8_t *)g_rtcMemory + offset * 4, size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size) {
+  if (offset * 4 + size > sizeof(g_rtcMemory)) return false;
+  memcpy((uint8_t *)g_rtcMemory + offset * 4, data, size);
+  return true;
+}
+
+void EspClass::restart() {
+  Serial.println("ESP.restart()");
+  fflush(stdout);
+  exit(0);
+}
+
+void EspClass::deepSleep(uint64_t us) { restart(); }
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char *server1,
+                const char *server2, const char *server3) {}
+
+// ------------------------------------------------------------
+// String
+// ------------------------------------------------------------
+void String::fromLong(long v, unsigned char base) {
+  if (base == 10) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", v);
+    _s = buf;
+  } else if (v < 0) {
+    fromULong((unsigned long)-v, base);
+    _s.insert(0, 1, '-');
+  } else {
+    fromULong((unsigned long)v, base);
+  }
+}
+
+void String::fromULong(unsigned long v, unsigned char base) {
+  char buf[72];
+  char *p = buf + sizeof(buf) - 1;
+  *p = 0;
+  if (base < 2) base = 10;
+  do {
+    unsigned d = v % base;
+    *--p = d < 10 ? '0' + d : 'a' + d - 10;
+    v /= base;
+  } while (v);
+  _s = p;
+}
+
+void String::fromDouble(double v, unsigned char decimals) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+  _s = buf;
+}
+
+bool String::equalsIgnoreCase(const String &o) const {
+  if (_s.size() != o._s.size()) return false;
+  for (size_t i = 0; i < _s.size(); i++) {
+    if (tolower((unsigned char)_s[i]) != tolower((unsigned char)o._s[i])) return false;
+  }
+  return true;
+}
+
+void String::replace(const String &find, const String &repl) {
+  if (find._s.empty()) return;
+  size_t p = 0;
+  while ((p = _s.find(find._s, p)) != std::string::npos) {
+    _s.replace(p, find._s.size(), repl._s);
+    p += repl._s.size();
+  }
+}
+
+void String::toLowerCase() { for (char &c : _s) c = tolower((unsigned char)c); }
+void String::toUpperCase() { for (char &c : _s) c = toupper((unsigned char)c); }
+
+void String::trim() {
+  size_t b = 0, e = _s.size();
+  while (b < e && isspace((unsigned char)_s[b])) b++;
+  while (e > b && isspace((unsigned char)_s[e - 1])) e--;
+  _s = _s.substr(b, e - b);
+}
+
+String operator+(const String &a, const String &b) { String r(a); r.concat(b); return r; }
+String operator+(const String &a, const char *b)   { String r(a); r.concat(b); return r; }
+String operator+(const char *a, const String &b)   { String r(a); r.concat(b); return r; }
+String operator+(const String &a, char b)          { String r(a); r.concat(b); return r; }
+
+// ------------------------------------------------------------
+// IPAddress
+// ------------------------------------------------------------
+bool IPAddress::fromString(const char *s) {
+  unsigned a, b, c, d;
+  char extra;
+  if (sscanf(s, "%u.%u.%u.%u%c", &a, &b, &c, &d, &extra) != 4 ||
+      a > 255 || b > 255 || c > 255 || d > 255) {
+    return false;
+  }
+  *this = IPAddress(a, b, c, d);
+  return true;
+}
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+  return String(buf);
+}
+
+// ------------------------------------------------------------
+// Print
+// ------------------------------------------------------------
+size_t Print::write(const uint8_t *buf, size_t len) {
+  size_t n = 0;
+  while (len--) n += write(*buf++);
+  return n;
+}
+
+size_t Print::print(long v, int base) {
+  return print(String(v, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long v, int base) {
+  return print(String(v, (unsigned char)base));
+}
+
+size_t Print::print(double v, int digits) {
+  char buf[48];
+  return write(buf, snprintf(buf, sizeof(buf), "%.*f", digits, v));
+}
+
+// Jako na ESP8266: krátký text ze zásobníku, delší přes malloc
+static size_t vprintTo(Print &out, const char *fmt, va_list args) {
+  char    stack[128];
+  va_list copy;
+  va_copy(copy, args);
+  int len = vsnprintf(stack, sizeof(stack), fmt, copy);
+  va_end(copy);
+  if (len < 0) return 0;
+  if ((size_t)len < sizeof(stack)) return out.write((const uint8_t *)stack, len);
+  char *buf = (char *)malloc(len + 1);
+  if (!buf) return 0;
+  vsnprintf(buf, len + 1, fmt, args);
+  size_t n = out.write((const uint8_t *)buf, len);
+  free(buf);
+  return n;
+}
+
+size_t Print::printf(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  size_t n = vprintTo(*this, fmt, args);
+  va_end(args);
+  return n;
+}
+
+size_t Print::printf_P(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  size_t n = vprintTo(*this, fmt, args);
+  va_end(args);
+  return n;
+}
+
+// ------------------------------------------------------------
+// Serial – kruhový buffer posledních 64 kB (bez haldy) + volitelné echo
+// ------------------------------------------------------------
+static char   g_serialBuf[64 * 1024];
+static size_t g_serialLen  = 0;
+static bool   g_serialEcho = false;
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t len) {
+  if (g_serialEcho) fwrite(buf, 1, len, stdout);
+  const size_t cap = sizeof(g_serialBuf) - 1;
+  if (len > cap) {
+    buf += len - cap;
+    len  = cap;
+  }
+  if (g_serialLen + len > cap) {
+    // Zahodí starší polovinu (aspoň tolik, kolik je potřeba)
+    size_t drop = std::max(g_serialLen / 2, g_serialLen + len - cap);
+    memmove(g_serialBuf, g_serialBuf + drop, g_serialLen - drop);
+    g_serialLen -= drop;
+  }
+  memcpy(g_serialBuf + g_serialLen, buf, len);
+  g_serialLen += len;
+  g_serialBuf[g_serialLen] = 0;
+  return len;
+}
+
+void hostSerialEcho(bool on) { g_serialEcho = on; }
+void hostSerialClear()       { g_serialLen = 0; g_serialBuf[0] = 0; }
+
+bool hostSerialContains(const char *text) {
+  return memmem(g_serialBuf, g_serialLen, text, strlen(text)) != nullptr;
+}
@@ -0,0 +1,301 @@
+#ifndef FARM_HOST_ARDUINO_H
+#define FARM_HOST_ARDUINO_H
+
+// ------------------------------------------------------------
+// Arduino/ESP8266 core pro hostitelské sestavení (shim)
+//
+// Jen to, co používá hub a knihovna FarmNet: čas, String, Print/Serial,
+// IPAddress, ESP a pár funkcí pro piny. Řízení simulace (hodiny,
+// měření haldy, výstup Serialu) je v FarmHost.h.
+// ------------------------------------------------------------
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "FarmHost.h"
+
+// PROGMEM je na PC obyčejná paměť
+#define PROGMEM
+#define ICACHE_RAM_ATTR
+#define IRAM_ATTR
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define pgm_read_byte(p)  (*(const uint8_t *)(p))
+#define pgm_read_word(p)  (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define memcpy_P   memcpy
+#define strlen_P   strlen
+#define strcmp_P   strcmp
+#define strncpy_P  strncpy
+#define snprintf_P snprintf
+
+class __FlashStringHelper;
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define F(s)     FPSTR(s)
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x00
+#define OUTPUT       0x01
+#define INPUT_PULLUP 0x02
+
+// Piny NodeMCU
+#define A0 17
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define LED_BUILTIN 2
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+int  analogRead(uint8_t pin);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// ------------------------------------------------------------
+// String (nad std::string, API jako Arduino String)
+// ------------------------------------------------------------
+class String {
+public:
+  String() {}
+  String(const char *s) : _s(s ? s : "") {}
+  String(const String &o) = default;
+  String(String &&o) = default;
+  String(const __FlashStringHelper *s) : _s(reinterpret_cast<const char *>(s)) {}
+  explicit String(char c) : _s(1, c) {}
+  explicit String(unsigned char v, unsigned char base = 10) { fromULong(v, base); }
+  explicit String(int v, unsigned char base = 10) { fromLong(v, base); }
+  explicit String(unsigned int v, unsigned char base = 10) { fromULong(v, base); }
+  explicit String(long v, unsigned char base = 10) { fromLong(v, base); }
+  explicit String(unsigned long v, unsigned char base = 10) { fromULong(v, base); }
+  explicit String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+  explicit String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+
+  String &operator=(const String &o) = default;
+  String &operator=(String &&o) = default;
+  String &operator=(const char *s) { _s = s ? s : ""; return *this; }
+  String &operator=(const __FlashStringHelper *s) { _s = reinterpret_cast<const char *>(s); return *this; }
+
+  const char  *c_str() const   { return _s.c_str(); }
+  unsigned int length() const  { return (unsigned int)_s.size(); }
+  bool         isEmpty() const { return _s.empty(); }
+  bool         reserve(unsigned int size) { _s.reserve(size); return true; }
+  char         charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  char         operator[](unsigned int i) const { return charAt(i); }
+  char        &operator[](unsigned int i) { return _s[i]; }
+
+  bool concat(const String &o)              { _s += o._s; return true; }
+  bool concat(const char *s)                { if (s) _s += s; return true; }
+  bool concat(const char *s, unsigned int n) { _s.append(s, n); return true; }
+  bool concat(char c)                       { _s += c; return true; }
+  bool concat(const __FlashStringHelper *s) { _s += reinterpret_cast<const char *>(s); return true; }
+  bool concat(int v)           { return concat(String(v)); }
+  bool concat(unsigned int v)  { return concat(String(v)); }
+  bool concat(long v)          { return concat(String(v)); }
+  bool concat(unsigned long v) { return concat(String(v)); }
+  bool concat(float v)         { return concat(String(v)); }
+  bool concat(double v)        { return concat(String(v)); }
+
+  template <typename T>
+  String &operator+=(const T &v) { concat(v); return *this; }
+
+  int  compareTo(const String &o) const { return _s.compare(o._s); }
+  bool equals(const String &o) const    { return _s == o._s; }
+  bool equals(const char *s) const      { return _s == (s ? s : ""); }
+  bool equalsIgnoreCase(const String &o) const;
+  bool operator==(const String &o) const { return equals(o); }
+  bool operator==(const char *s) const   { return equals(s); }
+  bool operator!=(const String &o) const { return !equals(o); }
+  bool operator!=(const char *s) const   { return !equals(s); }
+  bool operator<(const String &o) const  { return _s < o._s; }
+  bool startsWith(const String &p) const { return _s.compare(0, p._s.size(), p._s) == 0; }
+  bool endsWith(const String &p) const {
+    return _s.size() >= p._s.size() && _s.compare(_s.size() - p._s.size(), p._s.size(), p._s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const           { return pos(_s.find(c, from)); }
+  int indexOf(const String &s, unsigned int from = 0) const  { return pos(_s.find(s._s, from)); }
+  int lastIndexOf(char c) const                              { return pos(_s.rfind(c)); }
+  int lastIndexOf(const String &s) const                     { return pos(_s.rfind(s._s)); }
+
+  String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    if (from >= _s.size()) return String();
+    return String(_s.substr(from, to - from));
+  }
+
+  void replace(char find, char repl) { std::replace(_s.begin(), _s.end(), find, repl); }
+  void replace(const String &find, const String &repl);
+  void remove(unsigned int index) { if (index < _s.size()) _s.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < _s.size()) _s.erase(index, count); }
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long   toInt() const    { return strtol(_s.c_str(), nullptr, 10); }
+  float  toFloat() const  { return strtof(_s.c_str(), nullptr); }
+  double toDouble() const { return strtod(_s.c_str(), nullptr); }
+
+private:
+  explicit String(const std::string &s) : _s(s) {}
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  void fromLong(long v, unsigned char base);
+  void fromULong(unsigned long v, unsigned char base);
+  void fromDouble(double v, unsigned char decimals);
+
+  std::string _s;
+};
+
+String operator+(const String &a, const String &b);
+String operator+(const String &a, const char *b);
+String operator+(const char *a, const String &b);
+String operator+(const String &a, char b);
+
+// ------------------------------------------------------------
+// IPAddress (adresa uložená jako na ESP8266: první oktet v nejnižším bajtu)
+// ------------------------------------------------------------
+class IPAddress {
+public:
+  IPAddress() : _addr(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    : _addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+  IPAddress(uint32_t addr) : _addr(addr) {}
+  IPAddress(int addr) : _addr((uint32_t)addr) {}
+
+  operator uint32_t() const { return _addr; }
+  uint8_t operator[](int i) const { return (_addr >> (8 * i)) & 0xFF; }
+  bool operator==(const IPAddress &o) const { return _addr == o._addr; }
+  bool operator!=(const IPAddress &o) const { return _addr != o._addr; }
+  bool isSet() const { return _addr != 0; }
+  bool fromString(const char *s);
+  String toString() const;
+
+private:
+  uint32_t _addr;
+};
+
+// ------------------------------------------------------------
+// Print a Serial
+// ------------------------------------------------------------
+#define DEC 10
+#define HEX 16
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t len);
+  size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+  size_t write(const char *buf, size_t len) { return write((const uint8_t *)buf, len); }
+
+  size_t print(const __FlashStringHelper *s) { return write(reinterpret_cast<const char *>(s)); }
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(const char *s)   { return write(s); }
+  size_t print(char c)          { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC)           { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC)  { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+  size_t print(const IPAddress &ip) { return print(ip.toString()); }
+
+  size_t println() { return write((const uint8_t *)"\r\n", 2); }
+  template <typename T>
+  size_t println(const T &v) { size_t n = print(v); return n + println(); }
+  template <typename T>
+  size_t println(const T &v, int arg) { size_t n = print(v, arg); return n + println(); }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t printf_P(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  virtual void flush() {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+
+  // Oddělovač se přečte, ale do bufferu nepřidá
+  size_t readBytesUntil(char terminator, char *buffer, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+      int c = read();
+      if (c < 0 || c == terminator) break;
+      buffer[n++] = (char)c;
+    }
+    return n;
+  }
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t len) override;
+  using Print::write;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// ------------------------------------------------------------
+// ESP (halda podle měření new/delete, RTC paměť, RNG)
+// ------------------------------------------------------------
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMaxFreeBlockSize();
+  uint8_t  getHeapFragmentation() { return 0; }
+  uint32_t getChipId();
+  uint32_t getCycleCount() { return micros() * 80; }
+  uint32_t random();
+  bool     rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+  bool     rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+  void     restart();
+  void     deepSleep(uint64_t us);
+};
+
+extern EspClass ESP;
+
+// NTP v SDK; na PC je systémový čas už nastavený
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char *server1,
+                const char *server2 = nullptr, const char *server3 = nullptr);
+
+#endif // FARM_HOST_ARDUINO_H
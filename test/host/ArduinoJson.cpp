@@ -0,0 +1,784 @@
+// ArduinoJson 6 pro hostitelské sestavení (viz ArduinoJson.h)
+
+#include "ArduinoJson.h"
+#include <ctype.h>
+#include <errno.h>
+
+using namespace farmjson;
+
+// ------------------------------------------------------------
+// Pool
+// ------------------------------------------------------------
+Slot *Pool::allocSlot() {
+  if (slotsUsed >= slotCount || used() + SLOT_BYTES > capacity) {
+    overflowed = true;
+    return nullptr;
+  }
+  Slot *s = &slots[slotsUsed++];
+  s->next    = nullptr;
+  s->key     = nullptr;
+  s->type    = TYPE_NULL;
+  s->float32 = false;
+  s->i       = 0;
+  return s;
+}
+
+char *Pool::copyString(const char *s, size_t len) {
+  if (used() + len + 1 > capacity) {
+    overflowed = true;
+    return nullptr;
+  }
+  char *p = strings + stringsUsed;
+  memcpy(p, s, len);
+  p[len] = 0;
+  stringsUsed += len + 1;
+  return p;
+}
+
+namespace farmjson {
+
+void slotSetNull(Slot *s) {
+  s->type    = TYPE_NULL;
+  s->float32 = false;
+  s->i       = 0;
+}
+
+static void slotSetCollection(Slot *s, Type type) {
+  s->type       = type;
+  s->coll.head  = nullptr;
+  s->coll.tail  = nullptr;
+  s->coll.count = 0;
+}
+
+Slot *collectionAdd(Pool *pool, Slot *coll) {
+  Slot *s = pool->allocSlot();
+  if (!s) return nullptr;
+  if (coll->coll.tail) coll->coll.tail->next = s;
+  else                 coll->coll.head = s;
+  coll->coll.tail = s;
+  coll->coll.count++;
+  return s;
+}
+
+Slot *objectFind(const Slot *obj, const char *key) {
+  if (!obj || obj->type != TYPE_OBJECT || !key) return nullptr;
+  for (Slot *s = obj->coll.head; s; s = s->next) {
+    if (s->key && strcmp(s->key, key) == 0) return s;
+  }
+  return nullptr;
+}
+
+Slot *arrayAt(const Slot *arr, size_t index) {
+  if (!arr || arr->type != TYPE_ARRAY) return nullptr;
+  Slot *s = arr->coll.head;
+  while (s && index > 0) { s = s->next; index--; }
+  return s;
+}
+
+static void collectionUnlink(Slot *coll, Slot *victim) {
+  Slot *prev = nullptr;
+  for (Slot *s = coll->coll.head; s; prev = s, s = s->next) {
+    if (s != victim) continue;
+    if (prev) prev->next = s->next;
+    else      coll->coll.head = s->next;
+    if (coll->coll.tail == s) coll->coll.tail = prev;
+    coll->coll.count--;
+    return;   // slot zůstane v poolu nevyužitý (jako v6)
+  }
+}
+
+} // namespace farmjson
+
+// ------------------------------------------------------------
+// JsonVariant – zápis
+// ------------------------------------------------------------
+Slot *JsonVariant::resolve() {
+  if (_slot || !_parent || !_pool) return _slot;
+  if (_key) {
+    if (_parent->type == TYPE_NULL) slotSetCollection(_parent, TYPE_OBJECT);
+    if (_parent->type != TYPE_OBJECT) return nullptr;
+    Slot *s = objectFind(_parent, _key);
+    if (!s) {
+      const char *key = _key;
+      if (_copyKey) {
+        key = _pool->copyString(_key, strlen(_key));
+        if (!key) return nullptr;
+      }
+      s = collectionAdd(_pool, _parent);
+      if (!s) return nullptr;
+      s->key = key;
+    }
+    _slot = s;
+  } else if (_index >= 0) {
+    if (_parent->type == TYPE_NULL) slotSetCollection(_parent, TYPE_ARRAY);
+    if (_parent->type != TYPE_ARRAY) return nullptr;
+    while (_parent->coll.count <= (size_t)_index) {
+      if (!collectionAdd(_pool, _parent)) return nullptr;
+    }
+    _slot = arrayAt(_parent, _index);
+  }
+  if (_slot) _parent = nullptr;
+  return _slot;
+}
+
+Slot *JsonVariant::ensureType(Type type) {
+  Slot *s = resolve();
+  if (!s) return nullptr;
+  if (s->type == TYPE_NULL) slotSetCollection(s, type);
+  return s->type == type ? s : nullptr;
+}
+
+bool JsonVariant::set(bool v) {
+  Slot *s = resolve();
+  if (!s) return false;
+  slotSetNull(s);
+  s->type = TYPE_BOOL;
+  s->b    = v;
+  return true;
+}
+
+bool JsonVariant::setInt(int64_t v) {
+  Slot *s = resolve();
+  if (!s) return false;
+  slotSetNull(s);
+  s->type = TYPE_INT;
+  s->i    = v;
+  return true;
+}
+
+bool JsonVariant::setFloat(double v, bool float32) {
+  Slot *s = resolve();
+  if (!s) return false;
+  slotSetNull(s);
+  s->type    = TYPE_FLOAT;
+  s->f       = v;
+  s->float32 = float32;
+  return true;
+}
+
+bool JsonVariant::setString(const char *v, bool copy) {
+  Slot *s = resolve();
+  if (!s) return false;
+  slotSetNull(s);
+  if (!v) return true;   // null ukazatel = null
+  if (copy) {
+    v = _pool->copyString(v, strlen(v));
+    if (!v) return false;
+  }
+  s->type = TYPE_STRING;
+  s->s    = v;
+  return true;
+}
+
+bool JsonVariant::set(const char *v)    { return setString(v, false); }
+bool JsonVariant::set(char *v)          { return setString(v, true); }
+bool JsonVariant::set(const String &v)  { return setString(v.c_str(), true); }
+
+// ------------------------------------------------------------
+// JsonVariant – čtení
+// ------------------------------------------------------------
+bool JsonVariant::asImpl(bool *) const {
+  if (!_slot) return false;
+  switch (_slot->type) {
+    case TYPE_BOOL:  return _slot->b;
+    case TYPE_INT:   return _slot->i != 0;
+    case TYPE_FLOAT: return _slot->f != 0;
+    default:         return false;
+  }
+}
+
+const char *JsonVariant::asImpl(const char **) const {
+  return (_slot && _slot->type == TYPE_STRING) ? _slot->s : nullptr;
+}
+
+String JsonVariant::asImpl(String *) const {
+  if (_slot && _slot->type == TYPE_STRING) return String(_slot->s);
+  String out;
+  serializeJson(*this, out);
+  return out;
+}
+
+JsonArray  JsonVariant::asImpl(JsonArray *) const  { return JsonArray(*this); }
+JsonObject JsonVariant::asImpl(JsonObject *) const { return JsonObject(*this); }
+
+int64_t JsonVariant::asInt() const {
+  if (!_slot) return 0;
+  switch (_slot->type) {
+    case TYPE_BOOL:   return _slot->b ? 1 : 0;
+    case TYPE_INT:    return _slot->i;
+    case TYPE_FLOAT:  return isfinite(_slot->f) ? (int64_t)_slot->f : 0;
+    case TYPE_STRING: return strtoll(_slot->s, nullptr, 10);
+    default:          return 0;
+  }
+}
+
+double JsonVariant::asDouble() const {
+  if (!_slot) return 0;
+  switch (_slot->type) {
+    case TYPE_BOOL:   return _slot->b ? 1 : 0;
+    case TYPE_INT:    return (double)_slot->i;
+    case TYPE_FLOAT:  return _slot->f;
+    case TYPE_STRING: return strtod(_slot->s, nullptr);
+    default:          return 0;
+  }
+}
+
+bool JsonVariant::operator==(const char *s) const {
+  const char *v = as<const char *>();
+  if (!v || !s) return v == s;
+  return strcmp(v, s) == 0;
+}
+
+// ------------------------------------------------------------
+// JsonVariant – pole a objekty
+// ------------------------------------------------------------
+JsonVariant JsonVariant::operator[](const char *key) const {
+  JsonVariant v;
+  v._pool = _pool;
+  Slot *self = _slot;
+  if (!self) return v;   // pod chybějícím klíčem se nezapisuje (viz hlavička)
+  v._slot = objectFind(self, key);
+  if (!v._slot && (self->type == TYPE_OBJECT || self->type == TYPE_NULL)) {
+    v._parent = self;
+    v._key    = key;
+  }
+  return v;
+}
+
+JsonVariant JsonVariant::operator[](const String &key) const {
+  JsonVariant v = (*this)[key.c_str()];
+  v._copyKey = true;
+  return v;
+}
+
+JsonVariant JsonVariant::operator[](int index) const {
+  JsonVariant v;
+  v._pool = _pool;
+  Slot *self = _slot;
+  if (!self || index < 0) return v;
+  v._slot = arrayAt(self, index);
+  if (!v._slot && (self->type == TYPE_ARRAY || self->type == TYPE_NULL)) {
+    v._parent = self;
+    v._index  = index;
+  }
+  return v;
+}
+
+size_t JsonVariant::size() const {
+  if (!_slot || (_slot->type != TYPE_ARRAY && _slot->type != TYPE_OBJECT)) return 0;
+  return _slot->coll.count;
+}
+
+bool JsonVariant::containsKey(const char *key) const {
+  return objectFind(_slot, key) != nullptr;
+}
+
+void JsonVariant::remove(const char *key) {
+  Slot *s = objectFind(_slot, key);
+  if (s) collectionUnlink(_slot, s);
+}
+
+void JsonVariant::remove(int index) {
+  Slot *s = index >= 0 ? arrayAt(_slot, index) : nullptr;
+  if (s) collectionUnlink(_slot, s);
+}
+
+JsonVariant JsonVariant::add() {
+  Slot *arr = ensureType(TYPE_ARRAY);
+  if (!arr) return JsonVariant();
+  return JsonVariant(_pool, collectionAdd(_pool, arr));
+}
+
+JsonArray JsonVariant::createNestedArray() {
+  JsonVariant v = add();
+  return JsonArray(JsonVariant(_pool, v.ensureType(TYPE_ARRAY)));
+}
+
+JsonObject JsonVariant::createNestedObject() {
+  JsonVariant v = add();
+  return JsonObject(JsonVariant(_pool, v.ensureType(TYPE_OBJECT)));
+}
+
+JsonArray JsonVariant::createNestedArray(const char *key) {
+  JsonVariant v = (*this)[key];
+  return JsonArray(JsonVariant(_pool, v.ensureType(TYPE_ARRAY)));
+}
+
+JsonObject JsonVariant::createNestedObject(const char *key) {
+  JsonVariant v = (*this)[key];
+  return JsonObject(JsonVariant(_pool, v.ensureType(TYPE_OBJECT)));
+}
+
+JsonArray::JsonArray(const JsonVariant &v)
+  : JsonVariant(v.pool(), v.slot() && v.slot()->type == TYPE_ARRAY ? v.slot() : nullptr) {}
+
+JsonIterator JsonArray::begin() const {
+  return JsonIterator(_pool, _slot ? _slot->coll.head : nullptr);
+}
+
+JsonObject::JsonObject(const JsonVariant &v)
+  : JsonVariant(v.pool(), v.slot() && v.slot()->type == TYPE_OBJECT ? v.slot() : nullptr) {}
+
+JsonIterator JsonObject::begin() const {
+  return JsonIterator(_pool, _slot ? _slot->coll.head : nullptr);
+}
+
+// ------------------------------------------------------------
+// Dokument
+// ------------------------------------------------------------
+JsonDocument::JsonDocument(Slot *slots, size_t slotCount, char *strings, size_t capacity) {
+  _poolData.slots     = slots;
+  _poolData.slotCount = slotCount;
+  _poolData.strings   = strings;
+  _poolData.capacity  = capacity;
+  _poolData.reset();
+  _root.next = nullptr;
+  _root.key  = nullptr;
+  slotSetNull(&_root);
+  _pool = &_poolData;
+  _slot = &_root;
+}
+
+void JsonDocument::clear() {
+  _poolData.reset();
+  slotSetNull(&_root);
+}
+
+template <> JsonArray JsonDocument::to<JsonArray>() {
+  clear();
+  slotSetCollection(&_root, TYPE_ARRAY);
+  return JsonArray(*this);
+}
+
+template <> JsonObject JsonDocument::to<JsonObject>() {
+  clear();
+  slotSetCollection(&_root, TYPE_OBJECT);
+  return JsonObject(*this);
+}
+
+template <> JsonVariant JsonDocument::to<JsonVariant>() {
+  clear();
+  return *this;
+}
+
+DynamicJsonDocument::DynamicJsonDocument(size_t capacity)
+  : JsonDocument(new Slot[capacity / SLOT_BYTES + 1], capacity / SLOT_BYTES + 1,
+                 new char[capacity + 1], capacity) {}
+
+DynamicJsonDocument::~DynamicJsonDocument() {
+  delete[] _poolData.slots;
+  delete[] _poolData.strings;
+}
+
+const char *DeserializationError::c_str() const {
+  static const char *const NAMES[] = {
+    "Ok", "EmptyInput", "IncompleteInput", "InvalidInput", "NoMemory", "TooDeep"
+  };
+  return NAMES[_code];
+}
+
+// ------------------------------------------------------------
+// Parser
+// ------------------------------------------------------------
+namespace {
+
+// Vstup z paměti; s inPlace se řetězce dekódují přímo do vstupu
+struct MemReader {
+  char       *mut;       // zapisovatelný vstup (zero-copy), jinak nullptr
+  const char *p;
+  const char *end;
+
+  int  peek() const { return p < end ? (uint8_t)*p : -1; }
+  int  next()       { return p < end ? (uint8_t)*p++ : -1; }
+  bool inPlace() const { return mut != nullptr; }
+  char *writePos()  { return mut + (p - mut); }
+};
+
+struct StreamReader {
+  Stream &s;
+  int     ahead;
+
+  int  peek() { if (ahead < 0) ahead = s.read(); return ahead; }
+  int  next() { int c = peek(); ahead = -1; return c; }
+  bool inPlace() const { return false; }
+  char *writePos() { return nullptr; }
+};
+
+template <typename Reader>
+class Parser {
+public:
+  Parser(Reader &r, Pool &pool) : _r(r), _pool(pool) {}
+
+  DeserializationError::Code parse(Slot *root) {
+    skipSpace();
+    if (_r.peek() < 0) return DeserializationError::EmptyInput;
+    return parseValue(root, 0);
+  }
+
+private:
+  void skipSpace() {
+    for (;;) {
+      int c = _r.peek();
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n') { _r.next(); continue; }
+      return;
+    }
+  }
+
+  DeserializationError::Code parseValue(Slot *s, uint8_t depth) {
+    skipSpace();
+    int c = _r.peek();
+    if (c < 0) return DeserializationError::IncompleteInput;
+    if (c == '{' || c == '[') {
+      if (depth >= NESTING_LIMIT) return DeserializationError::TooDeep;
+      return c == '{' ? parseObject(s, depth + 1) : parseArray(s, depth + 1);
+    }
+    if (c == '"' || c == '\'') {
+      const char *str;
+      DeserializationError::Code err = parseString(str);
+      if (err) return err;
+      s->type = TYPE_STRING;
+      s->s    = str;
+      return DeserializationError::Ok;
+    }
+    return parseLiteral(s);
+  }
+
+  DeserializationError::Code parseObject(Slot *s, uint8_t depth) {
+    _r.next();
+    slotSetCollection(s, TYPE_OBJECT);
+    skipSpace();
+    if (_r.peek() == '}') { _r.next(); return DeserializationError::Ok; }
+    for (;;) {
+      skipSpace();
+      int c = _r.peek();
+      if (c < 0) return DeserializationError::IncompleteInput;
+      if (c != '"' && c != '\'') return DeserializationError::InvalidInput;
+      const char *key;
+      DeserializationError::Code err = parseString(key);
+      if (err) return err;
+      skipSpace();
+      c = _r.next();
+      if (c < 0) return DeserializationError::IncompleteInput;
+      if (c != ':') return DeserializationError::InvalidInput;
+
+      // Duplicitní klíč přepíše hodnotu (jako v6)
+      Slot *member = objectFind(s, key);
+      if (!member) {
+        member = collectionAdd(&_pool, s);
+        if (!member) return DeserializationError::NoMemory;
+        member->key = key;
+      }
+      err = parseValue(member, depth);
+      if (err) return err;
+
+      skipSpace();
+      c = _r.next();
+      if (c == '}') return DeserializationError::Ok;
+      if (c < 0) return DeserializationError::IncompleteInput;
+      if (c != ',') return DeserializationError::InvalidInput;
+    }
+  }
+
+  DeserializationError::Code parseArray(Slot *s, uint8_t depth) {
+    _r.next();
+    slotSetCollection(s, TYPE_ARRAY);
+    skipSpace();
+    if (_r.peek() == ']') { _r.next(); return DeserializationError::Ok; }
+    for (;;) {
+      Slot *el = collectionAdd(&_pool, s);
+      if (!el) return DeserializationError::NoMemory;
+      DeserializationError::Code err = parseValue(el, depth);
+      if (err) return err;
+      skipSpace();
+      int c = _r.next();
+      if (c == ']') return DeserializationError::Ok;
+      if (c < 0) return DeserializationError::IncompleteInput;
+      if (c != ',') return DeserializationError::InvalidInput;
+    }
+  }
+
+  // Dekódovaný řetězec jde buď do vstupu (zero-copy), nebo do poolu
+  DeserializationError::Code parseString(const char *&out) {
+    int   quote = _r.next();
+    char *dst;
+    char *start;
+    if (_r.inPlace()) {
+      start = dst = _r.writePos();
+    } else {
+      start = dst = _pool.strings + _pool.stringsUsed;
+    }
+    size_t len = 0;
+    for (;;) {
+      int c = _r.next();
+      if (c < 0) return DeserializationError::IncompleteInput;
+      if (c == quote) break;
+      if (c == '\\') {
+        c = _r.next();
+        switch (c) {
+          case -1:  return DeserializationError::IncompleteInput;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'n': c = '\n'; break;
+          case 'r': c = '\r'; break;
+          case 't': c = '\t'; break;
+          case 'u': {
+            uint32_t cp = 0;
+            for (int k = 0; k < 4; k++) {
+              int h = _r.next();
+              if (h < 0) return DeserializationError::IncompleteInput;
+              if (!isxdigit(h)) return DeserializationError::InvalidInput;
+              cp = cp * 16 + (isdigit(h) ? h - '0' : (tolower(h) - 'a' + 10));
+            }
+            // UTF-8 (bez náhradních párů – na uzlech se nepoužívají)
+            char utf[3];
+            size_t n;
+            if (cp < 0x80)       { utf[0] = (char)cp; n = 1; }
+            else if (cp < 0x800) { utf[0] = (char)(0xC0 | (cp >> 6)); utf[1] = (char)(0x80 | (cp & 0x3F)); n = 2; }
+            else { utf[0] = (char)(0xE0 | (cp >> 12)); utf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                   utf[2] = (char)(0x80 | (cp & 0x3F)); n = 3; }
+            for (size_t k = 0; k < n; k++) {
+              if (!putChar(dst, len, utf[k])) return DeserializationError::NoMemory;
+            }
+            continue;
+          }
+          default: break;   // \" \\ \/ a cokoli jiného doslova
+        }
+      }
+      if (!putChar(dst, len, (char)c)) return DeserializationError::NoMemory;
+    }
+    if (!putChar(dst, len, 0)) return DeserializationError::NoMemory;
+    if (!_r.inPlace()) _pool.stringsUsed += len;
+    out = start;
+    return DeserializationError::Ok;
+  }
+
+  bool putChar(char *dst, size_t &len, char c) {
+    if (!_r.inPlace() && _pool.used() + len + 1 > _pool.capacity) {
+      _pool.overflowed = true;
+      return false;
+    }
+    dst[len++] = c;
+    return true;
+  }
+
+  DeserializationError::Code parseLiteral(Slot *s) {
+    char   buf[64];
+    size_t n = 0;
+    for (;;) {
+      int c = _r.peek();
+      if (c < 0 || c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' ||
+          c == '\r' || c == '\n' || c == ':') break;
+      if (n + 1 >= sizeof(buf)) return DeserializationError::InvalidInput;
+      buf[n++] = (char)_r.next();
+    }
+    buf[n] = 0;
+    if (n == 0) return DeserializationError::InvalidInput;
+
+    if (strcmp(buf, "true") == 0)  { s->type = TYPE_BOOL; s->b = true;  return DeserializationError::Ok; }
+    if (strcmp(buf, "false") == 0) { s->type = TYPE_BOOL; s->b = false; return DeserializationError::Ok; }
+    if (strcmp(buf, "null") == 0)  { slotSetNull(s); return DeserializationError::Ok; }
+    if (_r.peek() < 0 && (strncmp("true", buf, n) == 0 || strncmp("false", buf, n) == 0 ||
+                          strncmp("null", buf, n) == 0)) {
+      return DeserializationError::IncompleteInput;
+    }
+
+    char *endp;
+    if (!strpbrk(buf, ".eE")) {
+      errno = 0;
+      long long v = strtoll(buf, &endp, 10);
+      if (*endp == 0 && errno == 0) {
+        s->type = TYPE_INT;
+        s->i    = v;
+        return DeserializationError::Ok;
+      }
+    }
+    double d = strtod(buf, &endp);
+    if (*endp != 0 || !(buf[0] == '-' || isdigit((uint8_t)buf[0]))) return DeserializationError::InvalidInput;
+    s->type = TYPE_FLOAT;
+    s->f    = d;
+    return DeserializationError::Ok;
+  }
+
+  Reader &_r;
+  Pool   &_pool;
+};
+
+template <typename Reader>
+DeserializationError run(JsonDocument &doc, Reader &r) {
+  doc.clear();
+  Pool *pool = doc.pool();
+  Parser<Reader> p(r, *pool);
+  DeserializationError::Code err = p.parse(doc.slot());
+  if (err) slotSetNull(doc.slot());
+  return DeserializationError(err);
+}
+
+DeserializationError parseMem(JsonDocument &doc, const char *in, size_t len, bool inPlace) {
+  if (!in) return DeserializationError(DeserializationError::EmptyInput);
+  MemReader r = { inPlace ? const_cast<char *>(in) : nullptr, in, in + len };
+  return run(doc, r);
+}
+
+} // namespace
+
+DeserializationError deserializeJson(JsonDocument &doc, char *input) {
+  return parseMem(doc, input, input ? strlen(input) : 0, true);
+}
+DeserializationError deserializeJson(JsonDocument &doc, char *input, size_t len) {
+  return parseMem(doc, input, len, true);
+}
+DeserializationError deserializeJson(JsonDocument &doc, uint8_t *input, size_t len) {
+  return parseMem(doc, (char *)input, len, true);
+}
+DeserializationError deserializeJson(JsonDocument &doc, const char *input) {
+  return parseMem(doc, input, input ? strlen(input) : 0, false);
+}
+DeserializationError deserializeJson(JsonDocument &doc, const char *input, size_t len) {
+  return parseMem(doc, input, len, false);
+}
+DeserializationError deserializeJson(JsonDocument &doc, const uint8_t *input, size_t len) {
+  return parseMem(doc, (const char *)input, len, false);
+}
+DeserializationError deserializeJson(JsonDocument &doc, const String &input) {
+  return parseMem(doc, input.c_str(), input.length(), false);
+}
+DeserializationError deserializeJson(JsonDocument &doc, Stream &input) {
+  StreamReader r = { input, -1 };
+  return run(doc, r);
+}
+
+// ------------------------------------------------------------
+// Serializace
+// ------------------------------------------------------------
+namespace {
+
+struct Out {
+  virtual ~Out() {}
+  virtual void put(const char *s, size_t n) = 0;
+  void put(const char *s) { put(s, strlen(s)); }
+  size_t count = 0;
+};
+
+struct CountOut : Out {
+  void put(const char *, size_t n) override { count += n; }
+};
+
+struct BufOut : Out {
+  char  *buf;
+  size_t size;
+  void put(const char *s, size_t n) override {
+    if (size == 0) return;
+    size_t room = size - 1 - std::min(count, size - 1);
+    memcpy(buf + std::min(count, size - 1), s, std::min(n, room));
+    count += std::min(n, room);
+  }
+};
+
+struct PrintOut : Out {
+  Print *p;
+  void put(const char *s, size_t n) override { count += p->write((const uint8_t *)s, n); }
+};
+
+struct StringOut : Out {
+  String *s;
+  void put(const char *str, size_t n) override { s->concat(str, n); count += n; }
+};
+
+void writeString(Out &o, const char *s) {
+  o.put("\"", 1);
+  const char *run = s;
+  for (; *s; s++) {
+    const char *esc = nullptr;
+    char        hex[8];
+    switch (*s) {
+      case '"':  esc = "\\\""; break;
+      case '\\': esc = "\\\\"; break;
+      case '\b': esc = "\\b"; break;
+      case '\f': esc = "\\f"; break;
+      case '\n': esc = "\\n"; break;
+      case '\r': esc = "\\r"; break;
+      case '\t': esc = "\\t"; break;
+      default:
+        if ((uint8_t)*s < 0x20) {
+          snprintf(hex, sizeof(hex), "\\u%04x", (uint8_t)*s);
+          esc = hex;
+        }
+    }
+    if (!esc) continue;
+    o.put(run, s - run);
+    o.put(esc);
+    run = s + 1;
+  }
+  o.put(run, s - run);
+  o.put("\"", 1);
+}
+
+void writeValue(Out &o, const Slot *s) {
+  char num[32];
+  if (!s) { o.put("null", 4); return; }
+  switch (s->type) {
+    case TYPE_NULL:   o.put("null", 4); break;
+    case TYPE_BOOL:   o.put(s->b ? "true" : "false"); break;
+    case TYPE_INT:    snprintf(num, sizeof(num), "%lld", (long long)s->i); o.put(num); break;
+    case TYPE_FLOAT:
+      if (!isfinite(s->f)) { o.put("null", 4); break; }
+      snprintf(num, sizeof(num), s->float32 ? "%.7g" : "%.9g", s->f);
+      o.put(num);
+      break;
+    case TYPE_STRING: writeString(o, s->s); break;
+    case TYPE_ARRAY:
+      o.put("[", 1);
+      for (const Slot *e = s->coll.head; e; e = e->next) {
+        if (e != s->coll.head) o.put(",", 1);
+        writeValue(o, e);
+      }
+      o.put("]", 1);
+      break;
+    case TYPE_OBJECT:
+      o.put("{", 1);
+      for (const Slot *m = s->coll.head; m; m = m->next) {
+        if (m != s->coll.head) o.put(",", 1);
+        writeString(o, m->key ? m->key : "");
+        o.put(":", 1);
+        writeValue(o, m);
+      }
+      o.put("}", 1);
+      break;
+  }
+}
+
+} // namespace
+
+size_t serializeJson(const JsonVariant &v, char *out, size_t size) {
+  BufOut o;
+  o.buf  = out;
+  o.size = size;
+  writeValue(o, v.slot());
+  if (size) out[o.count] = 0;
+  return o.count;
+}
+
+size_t serializeJson(const JsonVariant &v, uint8_t *out, size_t size) {
+  return serializeJson(v, (char *)out, size);
+}
+
+size_t serializeJson(const JsonVariant &v, String &out) {
+  out = "";
+  StringOut o;
+  o.s = &out;
+  writeValue(o, v.slot());
+  return o.count;
+}
+
+size_t serializeJson(const JsonVariant &v, Print &out) {
+  PrintOut o;
+  o.p = &out;
+  writeValue(o, v.slot());
+  return o.count;
+}
+
+size_t measureJson(const JsonVariant &v) {
+  CountOut o;
+  writeValue(o, v.slot());
+  return o.count;
+}
@@ -0,0 +1,332 @@
+#ifndef FARM_HOST_ARDUINOJSON_H
+#define FARM_HOST_ARDUINOJSON_H
+
+// ------------------------------------------------------------
+// ArduinoJson 6 pro hostitelské sestavení (shim)
+//
+// Podmnožina API, kterou používá hub a FarmNet, se sémantikou v6:
+//  - dokument má pevný pool; hodnoty se účtují po 16 B jako na ESP8266
+//    (VariantSlot), zkopírované řetězce délkou + 1. Co se nevejde, se
+//    zahodí a overflowed() / DeserializationError::NoMemory to hlásí.
+//  - StaticJsonDocument nealokuje, takže testy alokací vidí jen kód hubu.
+//  - deserializeJson z char* (ne const) parsuje v místě – řetězce
+//    zůstávají ve vstupním bufferu (zero-copy), jinak se kopírují.
+//  - const char* se při přiřazení neukládá kopií (jen ukazatel),
+//    char* a String ano.
+//  - operator| vrací výchozí hodnotu, když hodnota není typu T
+//    (is<T>()), např. 40.5 | 0 dá 0.
+//  - NaN a nekonečno se serializují jako null.
+//
+// Zápis přes dvě úrovně chybějících klíčů (doc["a"]["b"] = 1) shim
+// neumí – kód hubu vnořené objekty vytváří createNested*().
+// ------------------------------------------------------------
+
+#include "Arduino.h"
+#include <type_traits>
+#include <limits>
+
+namespace farmjson {
+
+enum Type : uint8_t { TYPE_NULL, TYPE_BOOL, TYPE_INT, TYPE_FLOAT, TYPE_STRING, TYPE_ARRAY, TYPE_OBJECT };
+
+static const size_t SLOT_BYTES    = 16;   // sizeof(VariantSlot) na ESP8266
+static const uint8_t NESTING_LIMIT = 10;
+
+struct Slot {
+  Slot       *next;
+  const char *key;
+  Type        type;
+  bool        float32;   // hodnota přišla jako float (kratší výpis)
+  union {
+    bool        b;
+    int64_t     i;
+    double      f;
+    const char *s;
+    struct { Slot *head; Slot *tail; uint16_t count; } coll;
+  };
+};
+
+struct Pool {
+  Slot   *slots;
+  size_t  slotCount;
+  char   *strings;
+  size_t  capacity;      // účtovaná kapacita v B (parametr dokumentu)
+  size_t  slotsUsed;
+  size_t  stringsUsed;
+  bool    overflowed;
+
+  size_t used() const { return slotsUsed * SLOT_BYTES + stringsUsed; }
+  void   reset() { slotsUsed = stringsUsed = 0; overflowed = false; }
+  Slot  *allocSlot();
+  char  *copyString(const char *s, size_t len);
+};
+
+void slotSetNull(Slot *s);
+Slot *collectionAdd(Pool *pool, Slot *coll);
+Slot *objectFind(const Slot *obj, const char *key);
+Slot *arrayAt(const Slot *arr, size_t index);
+
+} // namespace farmjson
+
+class JsonArray;
+class JsonObject;
+class JsonDocument;
+
+class JsonVariant {
+public:
+  JsonVariant() : _pool(nullptr), _slot(nullptr), _parent(nullptr), _key(nullptr), _index(-1), _copyKey(false) {}
+  JsonVariant(farmjson::Pool *pool, farmjson::Slot *slot)
+    : _pool(pool), _slot(slot), _parent(nullptr), _key(nullptr), _index(-1), _copyKey(false) {}
+
+  // Zápis
+  template <typename T>
+  JsonVariant &operator=(const T &value) { set(value); return *this; }
+  template <size_t N>
+  JsonVariant &operator=(char (&value)[N]) { set((char *)value); return *this; }
+  JsonVariant(const JsonVariant &) = default;
+  JsonVariant &operator=(const JsonVariant &) = default;   // převázání, ne kopie hodnoty
+
+  bool set(bool v);
+  bool set(char v)               { return setInt(v); }
+  bool set(signed char v)        { return setInt(v); }
+  bool set(unsigned char v)      { return setInt(v); }
+  bool set(short v)              { return setInt(v); }
+  bool set(unsigned short v)     { return setInt(v); }
+  bool set(int v)                { return setInt(v); }
+  bool set(unsigned int v)       { return setInt(v); }
+  bool set(long v)               { return setInt(v); }
+  bool set(unsigned long v)      { return setInt((int64_t)v); }
+  bool set(long long v)          { return setInt(v); }
+  bool set(unsigned long long v) { return setInt((int64_t)v); }
+  bool set(float v)              { return setFloat(v, true); }
+  bool set(double v)             { return setFloat(v, false); }
+  bool set(const char *v);               // jen ukazatel
+  bool set(char *v);                     // kopie
+  bool set(const String &v);             // kopie
+  bool set(const __FlashStringHelper *v) { return set((char *)reinterpret_cast<const char *>(v)); }
+  template <typename E, typename std::enable_if<std::is_enum<E>::value, int>::type = 0>
+  bool set(E v) { return setInt((int64_t)v); }
+
+  // Čtení
+  template <typename T> T    as() const { return asImpl((T *)nullptr); }
+  template <typename T> bool is() const { return isImpl((T *)nullptr); }
+
+  template <typename T>
+  T operator|(const T &def) const { return is<T>() ? as<T>() : def; }
+  const char *operator|(const char *def) const {
+    const char *s = as<const char *>();
+    return s ? s : def;
+  }
+
+  template <typename T,
+            typename std::enable_if<!std::is_base_of<JsonVariant, T>::value, int>::type = 0>
+  operator T() const { return as<T>(); }
+
+  bool operator==(const char *s) const;
+  bool operator!=(const char *s) const { return !(*this == s); }
+
+  JsonVariant operator[](const char *key) const;
+  JsonVariant operator[](const String &key) const;
+  JsonVariant operator[](int index) const;
+
+  bool   isNull() const { return !_slot || _slot->type == farmjson::TYPE_NULL; }
+  size_t size() const;
+  bool   containsKey(const char *key) const;
+  bool   containsKey(const String &key) const { return containsKey(key.c_str()); }
+  void   remove(const char *key);
+  void   remove(int index);
+
+  // Pole / objekty (null se převede)
+  template <typename T>
+  bool add(const T &value) { JsonVariant v = add(); return v.set(value); }
+  JsonVariant add();
+  JsonArray   createNestedArray();
+  JsonObject  createNestedObject();
+  JsonArray   createNestedArray(const char *key);
+  JsonObject  createNestedObject(const char *key);
+
+  farmjson::Slot *slot() const { return _slot; }
+  farmjson::Pool *pool() const { return _pool; }
+
+protected:
+  bool setInt(int64_t v);
+  bool setFloat(double v, bool float32);
+  bool setString(const char *v, bool copy);
+  farmjson::Slot *resolve();   // vytvoří čekající člen/prvek
+  farmjson::Slot *ensureType(farmjson::Type type);
+
+  bool        asImpl(bool *) const;
+  const char *asImpl(const char **) const;
+  String      asImpl(String *) const;
+  JsonVariant asImpl(JsonVariant *) const { return *this; }
+  JsonArray   asImpl(JsonArray *) const;
+  JsonObject  asImpl(JsonObject *) const;
+  template <typename T>
+  T asImpl(T *) const {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "unsupported as<T>()");
+    return asNumber<T>();
+  }
+  template <typename T>
+  typename std::enable_if<std::is_floating_point<T>::value, T>::type asNumber() const {
+    return (T)asDouble();
+  }
+  template <typename T>
+  typename std::enable_if<!std::is_floating_point<T>::value, T>::type asNumber() const {
+    return (T)asInt();
+  }
+  int64_t asInt() const;
+  double  asDouble() const;
+
+  bool isImpl(bool *) const         { return _slot && _slot->type == farmjson::TYPE_BOOL; }
+  bool isImpl(const char **) const  { return _slot && _slot->type == farmjson::TYPE_STRING; }
+  bool isImpl(char **) const        { return isImpl((const char **)nullptr); }
+  bool isImpl(String *) const       { return isImpl((const char **)nullptr); }
+  bool isImpl(JsonVariant *) const  { return true; }
+  bool isImpl(JsonArray *) const    { return _slot && _slot->type == farmjson::TYPE_ARRAY; }
+  bool isImpl(JsonObject *) const   { return _slot && _slot->type == farmjson::TYPE_OBJECT; }
+  template <typename T>
+  bool isImpl(T *) const {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "unsupported is<T>()");
+    return isNumber<T>();
+  }
+  template <typename T>
+  typename std::enable_if<std::is_floating_point<T>::value, bool>::type isNumber() const {
+    return _slot && (_slot->type == farmjson::TYPE_INT || _slot->type == farmjson::TYPE_FLOAT);
+  }
+  template <typename T>
+  typename std::enable_if<std::is_enum<T>::value, bool>::type isNumber() const {
+    return isNumber<int>();
+  }
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value, bool>::type isNumber() const {
+    if (!_slot || _slot->type != farmjson::TYPE_INT) return false;
+    int64_t v = _slot->i;
+    if (std::is_signed<T>::value) {
+      return v >= (int64_t)std::numeric_limits<T>::min() && v <= (int64_t)std::numeric_limits<T>::max();
+    }
+    return v >= 0 && (uint64_t)v <= (uint64_t)std::numeric_limits<T>::max();
+  }
+
+  farmjson::Pool *_pool;
+  farmjson::Slot *_slot;
+  // Čekající člen / prvek: vznikne až při zápisu (čtení nic nepřidává)
+  farmjson::Slot *_parent;
+  const char     *_key;
+  int             _index;
+  bool            _copyKey;
+
+  friend class JsonDocument;
+};
+
+// Iterace prvků pole / hodnot objektu
+class JsonIterator {
+public:
+  JsonIterator(farmjson::Pool *pool, farmjson::Slot *slot) : _pool(pool), _slot(slot) {}
+  JsonVariant   operator*() const { return JsonVariant(_pool, _slot); }
+  JsonIterator &operator++() { _slot = _slot->next; return *this; }
+  bool operator!=(const JsonIterator &o) const { return _slot != o._slot; }
+  bool operator==(const JsonIterator &o) const { return _slot == o._slot; }
+  const char *key() const { return _slot->key; }
+
+private:
+  farmjson::Pool *_pool;
+  farmjson::Slot *_slot;
+};
+
+class JsonArray : public JsonVariant {
+public:
+  JsonArray() {}
+  JsonArray(const JsonVariant &v);
+  JsonIterator begin() const;
+  JsonIterator end() const { return JsonIterator(_pool, nullptr); }
+};
+
+class JsonObject : public JsonVariant {
+public:
+  JsonObject() {}
+  JsonObject(const JsonVariant &v);
+  JsonIterator begin() const;
+  JsonIterator end() const { return JsonIterator(_pool, nullptr); }
+};
+
+class JsonDocument : public JsonVariant {
+public:
+  JsonDocument(const JsonDocument &) = delete;
+  JsonDocument &operator=(const JsonDocument &) = delete;
+
+  void   clear();
+  bool   overflowed() const   { return _poolData.overflowed; }
+  size_t memoryUsage() const  { return _poolData.used(); }
+  size_t capacity() const     { return _poolData.capacity; }
+
+  template <typename T> T to();
+
+protected:
+  JsonDocument(farmjson::Slot *slots, size_t slotCount, char *strings, size_t capacity);
+
+  farmjson::Pool _poolData;
+  farmjson::Slot _root;
+};
+
+template <> JsonArray  JsonDocument::to<JsonArray>();
+template <> JsonObject JsonDocument::to<JsonObject>();
+template <> JsonVariant JsonDocument::to<JsonVariant>();
+
+template <size_t N>
+class StaticJsonDocument : public JsonDocument {
+public:
+  StaticJsonDocument() : JsonDocument(_slotStore, SLOTS, _stringStore, N) {}
+
+private:
+  static const size_t SLOTS = N / farmjson::SLOT_BYTES > 0 ? N / farmjson::SLOT_BYTES : 1;
+  farmjson::Slot _slotStore[SLOTS];
+  char           _stringStore[N];
+};
+
+// Pool na haldě (jedna alokace při vytvoření, jako v6)
+class DynamicJsonDocument : public JsonDocument {
+public:
+  explicit DynamicJsonDocument(size_t capacity);
+  ~DynamicJsonDocument();
+};
+
+// ------------------------------------------------------------
+// Chyby parsování
+// ------------------------------------------------------------
+class DeserializationError {
+public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+  DeserializationError() : _code(Ok) {}
+  DeserializationError(Code c) : _code(c) {}
+  explicit operator bool() const { return _code != Ok; }
+  bool operator==(Code c) const { return _code == c; }
+  bool operator!=(Code c) const { return _code != c; }
+  Code code() const { return _code; }
+  const char *c_str() const;
+  const __FlashStringHelper *f_str() const { return FPSTR(c_str()); }
+
+private:
+  Code _code;
+};
+
+// Zero-copy: vstup se při parsování přepisuje
+DeserializationError deserializeJson(JsonDocument &doc, char *input);
+DeserializationError deserializeJson(JsonDocument &doc, char *input, size_t len);
+DeserializationError deserializeJson(JsonDocument &doc, uint8_t *input, size_t len);
+// Kopie řetězců do poolu
+DeserializationError deserializeJson(JsonDocument &doc, const char *input);
+DeserializationError deserializeJson(JsonDocument &doc, const char *input, size_t len);
+DeserializationError deserializeJson(JsonDocument &doc, const uint8_t *input, size_t len);
+DeserializationError deserializeJson(JsonDocument &doc, const String &input);
+DeserializationError deserializeJson(JsonDocument &doc, Stream &input);
+
+size_t serializeJson(const JsonVariant &v, char *out, size_t size);
+size_t serializeJson(const JsonVariant &v, uint8_t *out, size_t size);
+size_t serializeJson(const JsonVariant &v, String &out);
+size_t serializeJson(const JsonVariant &v, Print &out);
+template <size_t N>
+size_t serializeJson(const JsonVariant &v, char (&out)[N]) { return serializeJson(v, out, N); }
+size_t measureJson(const JsonVariant &v);
+
+#endif // FARM_HOST_ARDUINOJSON_H
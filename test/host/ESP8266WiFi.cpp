@@ -0,0 +1,175 @@
+// ESP8266WiFi pro hostitelské sestavení (viz ESP8266WiFi.h)
+
+#include "ESP8266WiFi.h"
+
+ESP8266WiFiClass WiFi;
+
+struct HostWifiNetwork {
+  bool     present;
+  bool     up;
+  char     ssid[33];
+  char     pass[65];
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint32_t ip, gateway, mask, dns;
+};
+
+static HostWifiNetwork g_net;
+static HostWifiStats   g_wifiStats;
+static uint32_t        g_assocMs = 300;
+static uint32_t        g_scanMs  = 2000;
+static uint32_t        g_dhcpMs  = 1500;
+static uint8_t         g_noBssid[6];
+
+void hostWifiSetNetwork(const char *ssid, const char *pass, const uint8_t bssid[6], uint8_t channel) {
+  g_net.present = true;
+  g_net.up      = true;
+  snprintf(g_net.ssid, sizeof(g_net.ssid), "%s", ssid);
+  snprintf(g_net.pass, sizeof(g_net.pass), "%s", pass);
+  memcpy(g_net.bssid, bssid, 6);
+  g_net.channel = channel;
+  if (!g_net.ip) hostWifiSetLease(IPAddress(192, 168, 1, 50), IPAddress(192, 168, 1, 1),
+                                  IPAddress(255, 255, 255, 0), IPAddress(192, 168, 1, 1));
+}
+
+void hostWifiSetLease(IPAddress ip, IPAddress gateway, IPAddress mask, IPAddress dns) {
+  g_net.ip      = ip;
+  g_net.gateway = gateway;
+  g_net.mask    = mask;
+  g_net.dns     = dns;
+}
+
+void hostWifiSetTiming(uint32_t assocMs, uint32_t scanMs, uint32_t dhcpMs) {
+  g_assocMs = assocMs;
+  g_scanMs  = scanMs;
+  g_dhcpMs  = dhcpMs;
+}
+
+void hostWifiSetLink(bool up) {
+  WiFi.status();   // stav před změnou
+  g_net.up = up;
+}
+
+bool hostWifiLinkUp() { return g_net.up; }
+
+void hostWifiReset() {
+  memset(&g_net, 0, sizeof(g_net));
+  memset(&g_wifiStats, 0, sizeof(g_wifiStats));
+  hostWifiSetTiming(300, 2000, 1500);
+  WiFi.disconnect();
+  WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));
+}
+
+const HostWifiStats &hostWifi() { return g_wifiStats; }
+
+bool ESP8266WiFiClass::softAP(const char *ssid, const char *pass, int channel, int hidden,
+                              int maxConnection) {
+  if (_mode == WIFI_STA) _mode = WIFI_AP_STA;
+  else if (_mode == WIFI_OFF) _mode = WIFI_AP;
+  return true;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *pass, int32_t channel,
+                                    const uint8_t *bssid, bool connect) {
+  g_wifiStats.begins++;
+  _connected = false;
+  _joining   = connect;
+  _joinStart = millis();
+  _joinFast  = bssid && channel > 0;
+  if (_joinFast) g_wifiStats.fastBegins++;
+
+  // Se zadaným kanálem/BSSID SDK jinou síť nehledá
+  bool ssidOk = g_net.present && strcmp(ssid, g_net.ssid) == 0;
+  bool apOk   = !_joinFast || (channel == g_net.channel && memcmp(bssid, g_net.bssid, 6) == 0);
+  bool passOk = ssidOk && strcmp(pass ? pass : "", g_net.pass) == 0;
+  _joinCanSucceed = ssidOk && apOk && passOk;
+  _failStatus     = !ssidOk || !apOk ? WL_NO_SSID_AVAIL : WL_WRONG_PASSWORD;
+  return WL_DISCONNECTED;
+}
+
+bool ESP8266WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet,
+                              IPAddress dns1, IPAddress dns2) {
+  _staticIP      = local;
+  _staticGateway = gateway;
+  _staticMask    = subnet;
+  _staticDns     = dns1;
+  return true;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff) {
+  _joining   = false;
+  _connected = false;
+  return true;
+}
+
+void ESP8266WiFiClass::update() {
+  uint32_t now = millis();
+  if (_connected && !g_net.up) {
+    _connected = false;
+    _joining   = _autoReconnect;
+    _joinStart = now;
+  }
+  if (!_joining || !_joinCanSucceed) return;
+  if (!g_net.up) {
+    _joinStart = now;   // AP mimo provoz, SDK to zkouší dál
+    return;
+  }
+  uint32_t joinMs = g_assocMs + (_joinFast ? 0 : g_scanMs) + (_staticIP ? 0 : g_dhcpMs);
+  if (now - _joinStart >= joinMs) {
+    _joining   = false;
+    _connected = true;
+    g_wifiStats.joins++;
+  }
+}
+
+wl_status_t ESP8266WiFiClass::status() {
+  update();
+  if (_connected) return WL_CONNECTED;
+  if (_joining && !_joinCanSucceed && millis() - _joinStart >= g_assocMs + g_scanMs) return _failStatus;
+  return WL_DISCONNECTED;
+}
+
+IPAddress ESP8266WiFiClass::localIP()    { return status() != WL_CONNECTED ? 0U : _staticIP ? _staticIP : g_net.ip; }
+IPAddress ESP8266WiFiClass::gatewayIP()  { return status() != WL_CONNECTED ? 0U : _staticIP ? _staticGateway : g_net.gateway; }
+IPAddress ESP8266WiFiClass::subnetMask() { return status() != WL_CONNECTED ? 0U : _staticIP ? _staticMask : g_net.mask; }
+IPAddress ESP8266WiFiClass::dnsIP(uint8_t n) {
+  return status() != WL_CONNECTED || n > 0 ? 0U : _staticIP ? _staticDns : g_net.dns;
+}
+
+String   ESP8266WiFiClass::SSID()    { return status() == WL_CONNECTED ? String(g_net.ssid) : String(); }
+uint8_t *ESP8266WiFiClass::BSSID()   { return status() == WL_CONNECTED ? g_net.bssid : g_noBssid; }
+int32_t  ESP8266WiFiClass::channel() { return status() == WL_CONNECTED ? g_net.channel : 0; }
+int32_t  ESP8266WiFiClass::RSSI()    { return status() == WL_CONNECTED ? -60 : 31; }
+
+String ESP8266WiFiClass::BSSIDstr() {
+  const uint8_t *b = BSSID();
+  char buf[18];
+  snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", b[0], b[1], b[2], b[3], b[4], b[5]);
+  return String(buf);
+}
+
+int8_t ESP8266WiFiClass::scanNetworks(bool async, bool showHidden) {
+  g_wifiStats.scans++;
+  _scanRunning = true;
+  _scanDoneAt  = millis() + g_scanMs;
+  _scanResult  = g_net.present && g_net.up ? 1 : 0;
+  if (!async) {
+    delay(g_scanMs);
+    _scanRunning = false;
+    return _scanResult;
+  }
+  return WIFI_SCAN_RUNNING;
+}
+
+int8_t ESP8266WiFiClass::scanComplete() {
+  if (_scanRunning && (int32_t)(millis() - _scanDoneAt) >= 0) _scanRunning = false;
+  return _scanRunning ? WIFI_SCAN_RUNNING : _scanResult;
+}
+
+void ESP8266WiFiClass::scanDelete() {
+  _scanRunning = false;
+  _scanResult  = 0;
+}
+
+String  ESP8266WiFiClass::SSID(uint8_t i) { return i < _scanResult ? String(g_net.ssid) : String(); }
+int32_t ESP8266WiFiClass::RSSI(uint8_t i) { return i < _scanResult ? -60 : 0; }
@@ -0,0 +1,108 @@
+#ifndef FARM_HOST_ESP8266WIFI_H
+#define FARM_HOST_ESP8266WIFI_H
+
+// ------------------------------------------------------------
+// ESP8266WiFi pro hostitelské sestavení (shim)
+//
+// Jedna simulovaná domácí síť (SSID, heslo, BSSID, kanál, DHCP lease)
+// a AP hubu. Připojení trvá podle hodin z Arduino.cpp: asociace, k tomu
+// sken kanálů bez zadaného kanálu/BSSID a DHCP bez statické IP. Se
+// špatným BSSID/kanálem nebo údaji se nepřipojí nikdy. Po výpadku AP se
+// SDK připojuje samo (setAutoReconnect), jakmile je AP zpět.
+// ------------------------------------------------------------
+
+#include "Arduino.h"
+
+enum WiFiMode_t { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 };
+
+enum wl_status_t {
+  WL_IDLE_STATUS     = 0,
+  WL_NO_SSID_AVAIL   = 1,
+  WL_SCAN_COMPLETED  = 2,
+  WL_CONNECTED       = 3,
+  WL_CONNECT_FAILED  = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_WRONG_PASSWORD  = 6,
+  WL_DISCONNECTED    = 7
+};
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+class ESP8266WiFiClass {
+public:
+  bool       mode(WiFiMode_t m) { _mode = m; return true; }
+  WiFiMode_t getMode() const    { return _mode; }
+  bool       persistent(bool on) { return true; }
+  bool       setAutoReconnect(bool on) { _autoReconnect = on; return true; }
+
+  // AP
+  bool      softAP(const char *ssid, const char *pass = nullptr, int channel = 1,
+                   int hidden = 0, int maxConnection = 4);
+  IPAddress softAPIP() const { return IPAddress(192, 168, 4, 1); }
+  uint8_t   softAPgetStationNum() const { return 0; }
+
+  // STA
+  wl_status_t begin(const char *ssid, const char *pass = nullptr, int32_t channel = 0,
+                    const uint8_t *bssid = nullptr, bool connect = true);
+  wl_status_t begin(const String &ssid, const String &pass) { return begin(ssid.c_str(), pass.c_str()); }
+  bool        config(IPAddress local, IPAddress gateway, IPAddress subnet,
+                     IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+  bool        disconnect(bool wifiOff = false);
+  wl_status_t status();
+  bool        isConnected() { return status() == WL_CONNECTED; }
+
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  IPAddress subnetMask();
+  IPAddress dnsIP(uint8_t n = 0);
+  String    SSID();
+  uint8_t  *BSSID();
+  String    BSSIDstr();
+  int32_t   channel();
+  int32_t   RSSI();
+  String    macAddress() const { return "5C:CF:7F:C0:FF:EE"; }
+
+  // Sken (async: výsledek po době skenu)
+  int8_t scanNetworks(bool async = false, bool showHidden = false);
+  int8_t scanComplete();
+  void   scanDelete();
+  String SSID(uint8_t i);
+  int32_t RSSI(uint8_t i);
+
+private:
+  void update();
+
+  WiFiMode_t _mode          = WIFI_OFF;
+  bool       _autoReconnect = true;
+  bool       _joining       = false;
+  bool       _connected     = false;
+  bool       _joinCanSucceed = false;
+  bool       _joinFast      = false;   // kanál + BSSID zadané
+  uint32_t   _joinStart     = 0;
+  wl_status_t _failStatus   = WL_DISCONNECTED;
+  uint32_t   _staticIP = 0, _staticGateway = 0, _staticMask = 0, _staticDns = 0;
+  bool       _scanRunning   = false;
+  uint32_t   _scanDoneAt    = 0;
+  int8_t     _scanResult    = 0;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+// Řízení simulace Wi-Fi
+struct HostWifiStats {
+  uint32_t begins;       // volání WiFi.begin()
+  uint32_t fastBegins;   // z toho s kanálem a BSSID
+  uint32_t joins;        // úspěšná připojení (i automatická po výpadku)
+  uint32_t scans;
+};
+
+void hostWifiSetNetwork(const char *ssid, const char *pass, const uint8_t bssid[6], uint8_t channel);
+void hostWifiSetLease(IPAddress ip, IPAddress gateway, IPAddress mask, IPAddress dns);
+void hostWifiSetTiming(uint32_t assocMs, uint32_t scanMs, uint32_t dhcpMs);   // výchozí 300/2000/1500
+void hostWifiSetLink(bool up);        // výpadek AP a jeho návrat
+bool hostWifiLinkUp();
+void hostWifiReset();                 // bez sítě, STA odpojená, nulové statistiky
+const HostWifiStats &hostWifi();
+
+#endif // FARM_HOST_ESP8266WIFI_H
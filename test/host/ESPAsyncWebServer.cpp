@@ -0,0 +1,981 @@
+// ESPAsyncWebServer pro hostitelské sestavení (viz ESPAsyncWebServer.h)
+
+#include "ESPAsyncWebServer.h"
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// ------------------------------------------------------------
+// Buffer shimu (malloc – mimo měření haldy hubu)
+// ------------------------------------------------------------
+struct HostBuf {
+  uint8_t *data = nullptr;
+  size_t   len  = 0;
+  size_t   cap  = 0;
+
+  void append(const void *src, size_t n) {
+    if (len + n > cap) {
+      cap  = std::max(len + n, cap * 2 + 256);
+      data = (uint8_t *)realloc(data, cap);
+    }
+    memcpy(data + len, src, n);
+    len += n;
+  }
+  void append(const char *s) { append(s, strlen(s)); }
+  void consume(size_t n) {
+    memmove(data, data + n, len - n);
+    len -= n;
+  }
+  void release() {
+    free(data);
+    data = nullptr;
+    len = cap = 0;
+  }
+};
+
+static std::vector<AsyncWebServer *> g_servers;   // po begin()
+static size_t            g_httpWindow = 1460;      // jeden TCP segment
+static HostHttpChunkHook g_chunkHook  = nullptr;
+
+// ------------------------------------------------------------
+// Odpovědi
+// ------------------------------------------------------------
+class HostBasicResponse : public AsyncWebServerResponse {
+public:
+  HostBasicResponse(int code, const String &type, const String &content)
+    : AsyncWebServerResponse(code, type), _content(content) {}
+  size_t fill(uint8_t *buffer, size_t maxLen) override {
+    size_t n = std::min(maxLen, (size_t)_content.length() - _pos);
+    memcpy(buffer, _content.c_str() + _pos, n);
+    _pos += n;
+    return n;
+  }
+
+private:
+  String _content;
+  size_t _pos = 0;
+};
+
+class HostProgmemResponse : public AsyncWebServerResponse {
+public:
+  HostProgmemResponse(int code, const String &type, const uint8_t *data, size_t len)
+    : AsyncWebServerResponse(code, type), _data(data), _len(len) {}
+  size_t fill(uint8_t *buffer, size_t maxLen) override {
+    size_t n = std::min(maxLen, _len - _pos);
+    memcpy_P(buffer, _data + _pos, n);
+    _pos += n;
+    return n;
+  }
+
+private:
+  const uint8_t *_data;
+  size_t         _len;
+  size_t         _pos = 0;
+};
+
+class HostChunkedResponse : public AsyncWebServerResponse {
+public:
+  HostChunkedResponse(const String &type, AwsResponseFiller filler)
+    : AsyncWebServerResponse(200, type), _filler(filler) {}
+  size_t fill(uint8_t *buffer, size_t maxLen) override {
+    size_t n = _filler(buffer, maxLen, _index);
+    if (n != RESPONSE_TRY_AGAIN) _index += n;
+    return n;
+  }
+
+private:
+  AwsResponseFiller _filler;
+  size_t            _index = 0;
+};
+
+// Celé tělo odpovědi do out; mezi plněními háček testu
+static uint32_t drainResponse(AsyncWebServerResponse *response, HostBuf &out) {
+  uint8_t *window = (uint8_t *)malloc(g_httpWindow);
+  uint32_t fills  = 0;
+  for (;;) {
+    size_t n = response->fill(window, g_httpWindow);
+    fills++;
+    if (n == 0) break;
+    if (n != RESPONSE_TRY_AGAIN) out.append(window, std::min(n, g_httpWindow));
+    if (g_chunkHook) g_chunkHook(fills);
+  }
+  free(window);
+  return fills;
+}
+
+// ------------------------------------------------------------
+// Požadavek
+// ------------------------------------------------------------
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethodComposite method, const char *url)
+  : _method(method), _url(url) {}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() { delete _response; }
+
+AsyncWebParameter *AsyncWebServerRequest::getParam(size_t i) const {
+  return i < _params.size() ? const_cast<AsyncWebParameter *>(&_params[i]) : nullptr;
+}
+
+AsyncWebParameter *AsyncWebServerRequest::getParam(const String &name, bool post, bool file) const {
+  for (const AsyncWebParameter &p : _params) {
+    if (p.name() == name && p.isPost() == post) return const_cast<AsyncWebParameter *>(&p);
+  }
+  return nullptr;
+}
+
+bool AsyncWebServerRequest::hasParam(const String &name, bool post, bool file) const {
+  return getParam(name, post, file) != nullptr;
+}
+
+bool AsyncWebServerRequest::hasArg(const char *name) const {
+  for (const AsyncWebParameter &p : _params) {
+    if (p.name() == name) return true;
+  }
+  return false;
+}
+
+String AsyncWebServerRequest::arg(const char *name) const {
+  for (const AsyncWebParameter &p : _params) {
+    if (p.name() == name) return p.value();
+  }
+  return String();
+}
+
+AsyncWebHeader *AsyncWebServerRequest::getHeader(const String &name) const {
+  for (const AsyncWebHeader &h : _headers) {
+    if (h.name().equalsIgnoreCase(name)) return const_cast<AsyncWebHeader *>(&h);
+  }
+  return nullptr;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String &name) const { return getHeader(name) != nullptr; }
+
+void AsyncWebServerRequest::addParam(const String &name, const String &value, bool post) {
+  _params.emplace_back(name, value, post);
+}
+
+void AsyncWebServerRequest::addHeader(const String &name, const String &value) {
+  _headers.emplace_back(name, value);
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse *response) {
+  delete _response;
+  _response = response;
+}
+
+void AsyncWebServerRequest::send(int code, const String &contentType, const String &content) {
+  send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::send_P(int code, const String &contentType, const uint8_t *content, size_t len) {
+  send(beginResponse_P(code, contentType, content, len));
+}
+
+void AsyncWebServerRequest::send_P(int code, const String &contentType, PGM_P content) {
+  send(beginResponse_P(code, contentType, (const uint8_t *)content, strlen_P(content)));
+}
+
+void AsyncWebServerRequest::redirect(const String &url) {
+  AsyncWebServerResponse *response = beginResponse(302);
+  response->addHeader("Location", url);
+  send(response);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const String &contentType,
+                                                             const String &content) {
+  return new HostBasicResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse_P(int code, const String &contentType,
+                                                               const uint8_t *content, size_t len) {
+  return new HostProgmemResponse(code, contentType, content, len);
+}
+
+AsyncWebServerResponse *AsyncWebServerRequest::beginChunkedResponse(const String &contentType,
+                                                                    AwsResponseFiller filler) {
+  return new HostChunkedResponse(contentType, filler);
+}
+
+// ------------------------------------------------------------
+// Server a směrování
+// ------------------------------------------------------------
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest *request) {
+  if (!(_method & request->method())) return false;
+  if (_uri.endsWith("*")) return request->url().startsWith(_uri.substring(0, _uri.length() - 1));
+  return request->url() == _uri || request->url().startsWith(_uri + "/");
+}
+
+AsyncWebServer::~AsyncWebServer() {
+  end();
+  for (AsyncWebHandler *h : _owned) delete h;
+}
+
+void AsyncWebServer::begin() {
+  if (std::find(g_servers.begin(), g_servers.end(), this) == g_servers.end()) g_servers.push_back(this);
+}
+
+void AsyncWebServer::end() {
+  g_servers.erase(std::remove(g_servers.begin(), g_servers.end(), this), g_servers.end());
+}
+
+AsyncCallbackWebHandler &AsyncWebServer::on(const char *uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction fn) {
+  AsyncCallbackWebHandler *h = new AsyncCallbackWebHandler(uri, method, fn);
+  _owned.push_back(h);
+  _handlers.push_back(h);
+  return *h;
+}
+
+AsyncWebHandler &AsyncWebServer::addHandler(AsyncWebHandler *handler) {
+  _handlers.push_back(handler);
+  return *handler;
+}
+
+AsyncWebHandler *AsyncWebServer::findHandler(AsyncWebServerRequest *request) {
+  for (AsyncWebHandler *h : _handlers) {
+    if (h->canHandle(request)) return h;
+  }
+  return nullptr;
+}
+
+void AsyncWebServer::handle(AsyncWebServerRequest *request) {
+  AsyncWebHandler *h = findHandler(request);
+  if (h) {
+    h->handleRequest(request);
+  } else if (_notFound) {
+    _notFound(request);
+  }
+  if (!request->response()) request->send(404, "text/plain", "Not found");
+}
+
+// ------------------------------------------------------------
+// WebSocket: spojení (z testu nebo TCP) a klienti
+// ------------------------------------------------------------
+struct HostWsMsg {
+  HostWsMsg *next;
+  uint8_t    opcode;
+  size_t     len;
+  uint8_t    data[1];
+};
+
+struct HostWsConn {
+  int                   fd;        // -1 = klient z testu
+  AsyncWebSocket       *server;
+  AsyncWebSocketClient *client;
+  HostWsMsg            *outHead;   // přijaté zprávy pro test
+  HostWsMsg            *outTail;
+  bool                  dead;      // TCP spojení k zavření
+};
+
+static bool hostSocketSendFrame(int fd, uint8_t opcode, const uint8_t *data, size_t len);
+
+static HostWsConn *hostWsConnNew(int fd) {
+  HostWsConn *c = (HostWsConn *)calloc(1, sizeof(HostWsConn));
+  c->fd = fd;
+  return c;
+}
+
+static void hostWsConnSend(HostWsConn *c, uint8_t opcode, const uint8_t *data, size_t len) {
+  if (c->fd >= 0) {
+    if (!hostSocketSendFrame(c->fd, opcode, data, len)) c->dead = true;
+    return;
+  }
+  HostWsMsg *m = (HostWsMsg *)malloc(sizeof(HostWsMsg) + len);
+  m->next   = nullptr;
+  m->opcode = opcode;
+  m->len    = len;
+  memcpy(m->data, data, len);
+  if (c->outTail) c->outTail->next = m;
+  else            c->outHead = m;
+  c->outTail = m;
+}
+
+static std::vector<HostWsConn *> g_testConns;   // klienti z hostWsConnect()
+
+// Klient zanikl: zprávy z testu se zahodí, TCP spojení zavře síťová smyčka
+static void hostWsConnRelease(HostWsConn *c) {
+  c->client = nullptr;
+  if (c->fd >= 0) {
+    c->dead = true;
+    return;
+  }
+  g_testConns.erase(std::remove(g_testConns.begin(), g_testConns.end(), c), g_testConns.end());
+  while (c->outHead) {
+    HostWsMsg *next = c->outHead->next;
+    free(c->outHead);
+    c->outHead = next;
+  }
+  free(c);
+}
+
+AsyncWebSocketClient::~AsyncWebSocketClient() { hostWsConnRelease(_conn); }
+
+void AsyncWebSocketClient::close(uint16_t code, const char *message) {
+  if (_status != WS_CONNECTED) return;
+  uint8_t payload[2] = { (uint8_t)(code >> 8), (uint8_t)code };
+  hostWsConnSend(_conn, WS_DISCONNECT, payload, code ? 2 : 0);
+  _status = WS_DISCONNECTING;
+}
+
+void AsyncWebSocketClient::ping(const uint8_t *data, size_t len) {
+  if (_status == WS_CONNECTED) hostWsConnSend(_conn, WS_PING, data, len);
+}
+
+void AsyncWebSocketClient::text(const char *message, size_t len) {
+  if (_status == WS_CONNECTED) hostWsConnSend(_conn, WS_TEXT, (const uint8_t *)message, len);
+}
+
+void AsyncWebSocketClient::binary(const uint8_t *message, size_t len) {
+  if (_status == WS_CONNECTED) hostWsConnSend(_conn, WS_BINARY, message, len);
+}
+
+AsyncWebSocket::~AsyncWebSocket() {
+  for (AsyncWebSocketClient *c : _clients) delete c;
+}
+
+size_t AsyncWebSocket::count() const {
+  size_t n = 0;
+  for (AsyncWebSocketClient *c : _clients) {
+    if (c->status() == WS_CONNECTED) n++;
+  }
+  return n;
+}
+
+AsyncWebSocketClient *AsyncWebSocket::client(uint32_t id) {
+  for (AsyncWebSocketClient *c : _clients) {
+    if (c->id() == id && c->status() == WS_CONNECTED) return c;
+  }
+  return nullptr;
+}
+
+void AsyncWebSocket::close(uint32_t id, uint16_t code, const char *message) {
+  AsyncWebSocketClient *c = client(id);
+  if (c) c->close(code, message);
+  reapClosed();
+}
+
+void AsyncWebSocket::closeAll(uint16_t code, const char *message) {
+  for (AsyncWebSocketClient *c : _clients) c->close(code, message);
+  reapClosed();
+}
+
+void AsyncWebSocket::cleanupClients(uint16_t maxClients) {
+  if (count() > maxClients && !_clients.empty()) _clients.front()->close();
+  reapClosed();
+}
+
+void AsyncWebSocket::text(uint32_t id, const char *message, size_t len) {
+  AsyncWebSocketClient *c = client(id);
+  if (c) c->text(message, len);
+}
+
+void AsyncWebSocket::textAll(const char *message, size_t len) {
+  for (AsyncWebSocketClient *c : _clients) c->text(message, len);
+}
+
+void AsyncWebSocket::binary(uint32_t id, const uint8_t *message, size_t len) {
+  AsyncWebSocketClient *c = client(id);
+  if (c) c->binary(message, len);
+}
+
+void AsyncWebSocket::binaryAll(const uint8_t *message, size_t len) {
+  for (AsyncWebSocketClient *c : _clients) c->binary(message, len);
+}
+
+uint32_t AsyncWebSocket::hostAccept(HostWsConn *conn, IPAddress ip) {
+  AsyncWebSocketClient *c = new AsyncWebSocketClient(this, _nextId++, ip, conn);
+  uint32_t id = c->id();
+  conn->server = this;
+  conn->client = c;
+  _clients.push_back(c);
+  hostEvent(c, WS_EVT_CONNECT, nullptr, nullptr, 0);
+  return id;
+}
+
+void AsyncWebSocket::hostEvent(AsyncWebSocketClient *client, AwsEventType type, void *arg,
+                               uint8_t *data, size_t len) {
+  if (_handler) _handler(this, client, type, arg, data, len);
+  reapClosed();
+}
+
+// Odpojení: událost DISCONNECT a uvolnění klienta (jako po zavření TCP)
+void AsyncWebSocket::hostDrop(AsyncWebSocketClient *client) {
+  auto it = std::find(_clients.begin(), _clients.end(), client);
+  if (it == _clients.end()) return;
+  _clients.erase(it);
+  if (_handler) _handler(this, client, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+  delete client;
+}
+
+void AsyncWebSocket::reapClosed() {
+  for (size_t i = 0; i < _clients.size();) {
+    AsyncWebSocketClient *c = _clients[i];
+    if (c->status() == WS_CONNECTED && !(c->conn()->fd >= 0 && c->conn()->dead)) {
+      i++;
+      continue;
+    }
+    hostDrop(c);
+  }
+}
+
+// ------------------------------------------------------------
+// Požadavky z testu
+// ------------------------------------------------------------
+static String urlDecode(const char *s, size_t len) {
+  String out;
+  for (size_t i = 0; i < len; i++) {
+    if (s[i] == '+') {
+      out += ' ';
+    } else if (s[i] == '%' && i + 2 < len && isxdigit((uint8_t)s[i + 1]) && isxdigit((uint8_t)s[i + 2])) {
+      char hex[3] = { s[i + 1], s[i + 2], 0 };
+      out += (char)strtol(hex, nullptr, 16);
+      i += 2;
+    } else {
+      out += s[i];
+    }
+  }
+  return out;
+}
+
+static void parseParams(AsyncWebServerRequest *request, const char *s, size_t len, bool post) {
+  const char *end = s + len;
+  while (s < end) {
+    const char *amp = (const char *)memchr(s, '&', end - s);
+    if (!amp) amp = end;
+    const char *eq = (const char *)memchr(s, '=', amp - s);
+    if (amp > s) {
+      if (eq) request->addParam(urlDecode(s, eq - s), urlDecode(eq + 1, amp - eq - 1), post);
+      else    request->addParam(urlDecode(s, amp - s), String(), post);
+    }
+    s = amp + 1;
+  }
+}
+
+static void parseHeaders(AsyncWebServerRequest *request, const char *s) {
+  while (s && *s) {
+    const char *eol = strchr(s, '\n');
+    if (!eol) eol = s + strlen(s);
+    const char *colon = (const char *)memchr(s, ':', eol - s);
+    if (colon) {
+      const char *v = colon + 1;
+      while (v < eol && *v == ' ') v++;
+      const char *vend = eol;
+      while (vend > v && (vend[-1] == '\r' || vend[-1] == ' ')) vend--;
+      String name, value;
+      name.concat(s, colon - s);
+      value.concat(v, vend - v);
+      request->addHeader(name, value);
+    }
+    s = *eol ? eol + 1 : eol;
+  }
+}
+
+static AsyncWebServerRequest *newRequest(WebRequestMethodComposite method, const char *url) {
+  const char *q = strchr(url, '?');
+  std::string path(url, q ? q - url : strlen(url));
+  AsyncWebServerRequest *request = new AsyncWebServerRequest(method, path.c_str());
+  if (q) parseParams(request, q + 1, strlen(q + 1), false);
+  return request;
+}
+
+const String *HostHttpResponse::header(const char *name) const {
+  for (const AsyncWebHeader &h : headers) {
+    if (h.name().equalsIgnoreCase(name)) return &h.value();
+  }
+  return nullptr;
+}
+
+HostHttpResponse hostHttp(WebRequestMethodComposite method, const char *url, const char *form,
+                          const char *headers) {
+  HostHttpResponse res;
+  if (g_servers.empty()) return res;
+
+  size_t   heapBefore   = hostHeap().bytes;
+  uint64_t allocsBefore = hostHeap().allocs;
+  hostHeapResetPeak();
+
+  AsyncWebServerRequest *request = newRequest(method, url);
+  if (form) parseParams(request, form, strlen(form), true);
+  parseHeaders(request, headers);
+  g_servers.front()->handle(request);
+
+  HostBuf body;
+  AsyncWebServerResponse *response = request->response();
+  res.fills      = drainResponse(response, body);
+  res.heapPeak   = hostHeap().peak - heapBefore;
+  res.heapAllocs = hostHeap().allocs - allocsBefore;
+
+  // Výsledek se skládá až po měření
+  res.code        = response->code();
+  res.contentType = response->contentType();
+  res.headers     = response->headers();
+  const String *location = res.header("Location");
+  if (location) res.location = *location;
+  res.body.assign((const char *)body.data, body.len);
+  body.release();
+  delete request;
+  return res;
+}
+
+void hostHttpSetWindow(size_t bytes)              { g_httpWindow = bytes; }
+void hostHttpSetChunkHook(HostHttpChunkHook hook) { g_chunkHook = hook; }
+
+// ------------------------------------------------------------
+// WebSocket klienti z testu
+// ------------------------------------------------------------
+static AsyncWebSocket *findWebSocket(const char *path) {
+  for (AsyncWebServer *server : g_servers) {
+    AsyncWebServerRequest request(HTTP_GET, path);
+    AsyncWebSocket *ws = dynamic_cast<AsyncWebSocket *>(server->findHandler(&request));
+    if (ws) return ws;
+  }
+  return nullptr;
+}
+
+static HostWsConn *findTestConn(uint32_t id) {
+  for (HostWsConn *c : g_testConns) {
+    if (c->client && c->client->id() == id) return c;
+  }
+  return nullptr;
+}
+
+uint32_t hostWsConnect(const char *path) {
+  AsyncWebSocket *ws = findWebSocket(path);
+  if (!ws) return 0;
+  HostWsConn *conn = hostWsConnNew(-1);
+  g_testConns.push_back(conn);
+  uint32_t id = ws->hostAccept(conn, IPAddress(127, 0, 0, 1));
+  return ws->client(id) ? id : 0;
+}
+
+bool hostWsSend(uint32_t id, uint8_t opcode, const void *data, size_t len, size_t fragment,
+                size_t packet) {
+  HostWsConn *conn = findTestConn(id);
+  if (!conn) return false;
+  AsyncWebSocket *ws    = conn->server;
+  const uint8_t  *bytes = (const uint8_t *)data;
+  size_t          frag  = fragment ? fragment : std::max(len, (size_t)1);
+  size_t          off   = 0;
+  uint32_t        num   = 0;
+  do {
+    AwsFrameInfo info;
+    memset(&info, 0, sizeof(info));
+    info.message_opcode = opcode;
+    info.num            = num;
+    info.len            = std::min(frag, len - off);
+    info.final          = off + info.len >= len;
+    info.masked         = 1;
+    info.opcode         = num == 0 ? opcode : WS_CONTINUATION;
+
+    // Kus rámce v přesně velkém bufferu (čtení za konec najde ASan)
+    size_t idx = 0;
+    do {
+      size_t n = std::min(packet ? packet : (size_t)info.len, (size_t)info.len - idx);
+      AsyncWebSocketClient *client = ws->client(id);
+      if (!client) return false;
+      uint8_t *piece = (uint8_t *)malloc(n ? n : 1);
+      memcpy(piece, bytes + off + idx, n);
+      info.index = idx;
+      ws->hostEvent(client, WS_EVT_DATA, &info, piece, n);
+      free(piece);
+      idx += n;
+    } while (idx < info.len);
+
+    off += info.len;
+    num++;
+  } while (off < len);
+  return ws->client(id) != nullptr;
+}
+
+bool hostWsReceive(uint32_t id, std::string &message, uint8_t *opcode) {
+  HostWsConn *conn = findTestConn(id);
+  if (!conn || !conn->outHead) return false;
+  HostWsMsg *m = conn->outHead;
+  message.assign((const char *)m->data, m->len);
+  if (opcode) *opcode = m->opcode;
+  conn->outHead = m->next;
+  if (!conn->outHead) conn->outTail = nullptr;
+  free(m);
+  return true;
+}
+
+bool hostWsConnected(uint32_t id) {
+  HostWsConn *conn = findTestConn(id);
+  return conn && conn->client->status() == WS_CONNECTED;
+}
+
+void hostWsDisconnect(uint32_t id) {
+  HostWsConn *conn = findTestConn(id);
+  if (conn) conn->server->hostDrop(conn->client);
+}
+
+// ------------------------------------------------------------
+// TCP server (farmhub_host): HTTP/1.1 bez keep-alive a RFC 6455
+// ------------------------------------------------------------
+struct HostTcpConn {
+  int         fd;
+  IPAddress   ip;
+  HostBuf     in;
+  HostWsConn *ws;          // po upgradu na WebSocket
+  uint8_t     msgOpcode;   // opcode rozpracované zprávy
+  uint32_t    frameNum;
+  bool        done;        // odpověď odeslaná / spojení skončilo
+};
+
+static int                        g_listenFd = -1;
+static std::vector<HostTcpConn *> g_tcp;
+static std::vector<pollfd>        g_pollFds;
+
+static bool writeAll(int fd, const void *data, size_t len) {
+  const uint8_t *p = (const uint8_t *)data;
+  while (len > 0) {
+    ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+    if (n > 0) {
+      p   += n;
+      len -= n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      pollfd pfd = { fd, POLLOUT, 0 };
+      if (poll(&pfd, 1, 1000) <= 0) return false;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool hostSocketSendFrame(int fd, uint8_t opcode, const uint8_t *data, size_t len) {
+  uint8_t head[10];
+  size_t  h = 0;
+  head[h++] = 0x80 | opcode;
+  if (len < 126) {
+    head[h++] = (uint8_t)len;
+  } else if (len < 65536) {
+    head[h++] = 126;
+    head[h++] = (uint8_t)(len >> 8);
+    head[h++] = (uint8_t)len;
+  } else {
+    head[h++] = 127;
+    for (int i = 7; i >= 0; i--) head[h++] = (uint8_t)((uint64_t)len >> (8 * i));
+  }
+  return writeAll(fd, head, h) && (len == 0 || writeAll(fd, data, len));
+}
+
+// SHA-1 a Base64 pro Sec-WebSocket-Accept
+static void sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+  uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+  size_t   total = ((len + 8) / 64 + 1) * 64;
+  uint8_t *msg   = (uint8_t *)calloc(total, 1);
+  memcpy(msg, data, len);
+  msg[len] = 0x80;
+  uint64_t bits = (uint64_t)len * 8;
+  for (int i = 0; i < 8; i++) msg[total - 1 - i] = (uint8_t)(bits >> (8 * i));
+
+  for (size_t chunk = 0; chunk < total; chunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t *p = msg + chunk + 4 * i;
+      w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    }
+    for (int i = 16; i < 80; i++) {
+      uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+      w[i] = x << 1 | x >> 31;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20)      { f = (b & c) | (~b & d);           k = 0x5A827999; }
+      else if (i < 40) { f = b ^ c ^ d;                    k = 0x6ED9EBA1; }
+      else if (i < 60) { f = (b & c) | (b & d) | (c & d);  k = 0x8F1BBCDC; }
+      else             { f = b ^ c ^ d;                    k = 0xCA62C1D6; }
+      uint32_t t = (a << 5 | a >> 27) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = b << 30 | b >> 2;
+      b = a;
+      a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+  }
+  free(msg);
+  for (int i = 0; i < 20; i++) out[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+static void base64(const uint8_t *in, size_t len, char *out) {
+  static const char ABC[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)in[i] << 16 | (i + 1 < len ? in[i + 1] << 8 : 0) | (i + 2 < len ? in[i + 2] : 0);
+    *out++ = ABC[v >> 18 & 63];
+    *out++ = ABC[v >> 12 & 63];
+    *out++ = i + 1 < len ? ABC[v >> 6 & 63] : '=';
+    *out++ = i + 2 < len ? ABC[v & 63] : '=';
+  }
+  *out = 0;
+}
+
+static const char *reasonPhrase(int code) {
+  switch (code) {
+    case 101: return "Switching Protocols";
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    default:  return code < 400 ? "OK" : "Error";
+  }
+}
+
+static WebRequestMethodComposite methodFromName(const char *name, size_t len) {
+  static const struct { const char *name; WebRequestMethodComposite method; } METHODS[] = {
+    { "GET", HTTP_GET }, { "POST", HTTP_POST }, { "DELETE", HTTP_DELETE }, { "PUT", HTTP_PUT },
+    { "PATCH", HTTP_PATCH }, { "HEAD", HTTP_HEAD }, { "OPTIONS", HTTP_OPTIONS },
+  };
+  for (const auto &m : METHODS) {
+    if (strlen(m.name) == len && memcmp(m.name, name, len) == 0) return m.method;
+  }
+  return HTTP_GET;
+}
+
+static void tcpRespond(HostTcpConn *t, AsyncWebServerResponse *response) {
+  HostBuf body;
+  drainResponse(response, body);
+
+  HostBuf head;
+  char line[256];
+  snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", response->code(), reasonPhrase(response->code()));
+  head.append(line);
+  if (response->contentType().length() > 0) {
+    snprintf(line, sizeof(line), "Content-Type: %s\r\n", response->contentType().c_str());
+    head.append(line);
+  }
+  for (const AsyncWebHeader &h : response->headers()) {
+    snprintf(line, sizeof(line), "%s: %s\r\n", h.name().c_str(), h.value().c_str());
+    head.append(line);
+  }
+  snprintf(line, sizeof(line), "Content-Length: %u\r\nConnection: close\r\n\r\n", (unsigned)body.len);
+  head.append(line);
+  if (writeAll(t->fd, head.data, head.len)) writeAll(t->fd, body.data, body.len);
+  head.release();
+  body.release();
+}
+
+// Kompletní HTTP požadavek v t->in: odpověď, nebo upgrade na WebSocket
+static void tcpHttp(HostTcpConn *t) {
+  const uint8_t *end = (const uint8_t *)memmem(t->in.data, t->in.len, "\r\n\r\n", 4);
+  if (!end) {
+    if (t->in.len > 16384) t->done = true;
+    return;
+  }
+  size_t      headLen = end - t->in.data + 4;
+  std::string head((const char *)t->in.data, headLen);
+  size_t      sp1 = head.find(' ');
+  size_t      sp2 = head.find(' ', sp1 + 1);
+  size_t      eol = head.find("\r\n");
+  if (sp1 == std::string::npos || sp2 == std::string::npos || sp2 > eol) {
+    t->done = true;
+    return;
+  }
+
+  WebRequestMethodComposite method = methodFromName(head.c_str(), sp1);
+  std::string url = head.substr(sp1 + 1, sp2 - sp1 - 1);
+  AsyncWebServerRequest *request = newRequest(method, url.c_str());
+  parseHeaders(request, head.c_str() + eol + 2);
+
+  AsyncWebHeader *lengthHeader = request->getHeader("Content-Length");
+  size_t contentLength = lengthHeader ? (size_t)lengthHeader->value().toInt() : 0;
+  if (t->in.len < headLen + contentLength) {
+    delete request;   // tělo ještě nedorazilo
+    return;
+  }
+  AsyncWebHeader *type = request->getHeader("Content-Type");
+  if (contentLength > 0 && type && type->value().startsWith("application/x-www-form-urlencoded")) {
+    parseParams(request, (const char *)t->in.data + headLen, contentLength, true);
+  }
+  t->in.consume(headLen + contentLength);
+
+  AsyncWebServer *server  = g_servers.front();
+  AsyncWebHeader *upgrade = request->getHeader("Upgrade");
+  if (upgrade && upgrade->value().equalsIgnoreCase("websocket")) {
+    AsyncWebSocket *ws  = dynamic_cast<AsyncWebSocket *>(server->findHandler(request));
+    AsyncWebHeader *key = request->getHeader("Sec-WebSocket-Key");
+    if (!ws || !key) {
+      request->send(400, "text/plain", "Bad WebSocket request");
+      tcpRespond(t, request->response());
+      delete request;
+      t->done = true;
+      return;
+    }
+    String  accept = key->value() + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    uint8_t digest[20];
+    char    acceptB64[32];
+    char    reply[192];
+    sha1((const uint8_t *)accept.c_str(), accept.length(), digest);
+    base64(digest, sizeof(digest), acceptB64);
+    snprintf(reply, sizeof(reply),
+             "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+             "Sec-WebSocket-Accept: %s\r\n\r\n", acceptB64);
+    delete request;
+    if (!writeAll(t->fd, reply, strlen(reply))) {
+      t->done = true;
+      return;
+    }
+    t->ws = hostWsConnNew(t->fd);
+    ws->hostAccept(t->ws, t->ip);
+    return;
+  }
+
+  server->handle(request);
+  tcpRespond(t, request->response());
+  delete request;
+  t->done = true;
+}
+
+// Rámce WebSocketu v t->in (klient maskuje, celý rámec najednou)
+static void tcpWs(HostTcpConn *t) {
+  while (t->ws->client && !t->ws->dead) {
+    HostBuf &in = t->in;
+    if (in.len < 2) return;
+    const uint8_t *p      = in.data;
+    bool           fin    = p[0] & 0x80;
+    uint8_t        op     = p[0] & 0x0F;
+    bool           masked = p[1] & 0x80;
+    uint64_t       len    = p[1] & 0x7F;
+    size_t         h      = 2;
+    if (len == 126) {
+      if (in.len < 4) return;
+      len = (uint64_t)p[2] << 8 | p[3];
+      h   = 4;
+    } else if (len == 127) {
+      if (in.len < 10) return;
+      len = 0;
+      for (int i = 2; i < 10; i++) len = len << 8 | p[i];
+      h   = 10;
+    }
+    uint8_t mask[4] = { 0, 0, 0, 0 };
+    if (masked) {
+      if (in.len < h + 4) return;
+      memcpy(mask, p + h, 4);
+      h += 4;
+    }
+    if (len > 1024 * 1024) {
+      t->ws->dead = true;
+      return;
+    }
+    if (in.len < h + len) return;
+
+    uint8_t *data = in.data + h;
+    for (uint64_t i = 0; i < len; i++) data[i] ^= mask[i & 3];
+
+    AsyncWebSocket       *ws     = t->ws->server;
+    AsyncWebSocketClient *client = t->ws->client;
+    if (op == WS_DISCONNECT) {
+      hostSocketSendFrame(t->fd, WS_DISCONNECT, data, std::min(len, (uint64_t)2));
+      ws->hostDrop(client);
+      return;
+    } else if (op == WS_PING) {
+      hostSocketSendFrame(t->fd, WS_PONG, data, len);
+    } else if (op == WS_PONG) {
+      ws->hostEvent(client, WS_EVT_PONG, nullptr, data, len);
+    } else {
+      if (op != WS_CONTINUATION) {
+        t->msgOpcode = op;
+        t->frameNum  = 0;
+      }
+      AwsFrameInfo info;
+      memset(&info, 0, sizeof(info));
+      info.message_opcode = t->msgOpcode;
+      info.num            = t->frameNum++;
+      info.final          = fin;
+      info.masked         = masked;
+      info.opcode         = op;
+      info.len            = len;
+      memcpy(info.mask, mask, 4);
+      ws->hostEvent(client, WS_EVT_DATA, &info, data, len);
+    }
+    in.consume(h + len);
+  }
+}
+
+static void tcpClose(HostTcpConn *t) {
+  if (t->ws) {
+    if (t->ws->client) t->ws->server->hostDrop(t->ws->client);
+    free(t->ws);
+  }
+  close(t->fd);
+  t->in.release();
+  free(t);
+}
+
+static void hostNetPoll(uint32_t waitMs) {
+  g_pollFds.clear();
+  g_pollFds.push_back({ g_listenFd, POLLIN, 0 });
+  for (HostTcpConn *t : g_tcp) g_pollFds.push_back({ t->fd, POLLIN, 0 });
+  if (poll(g_pollFds.data(), g_pollFds.size(), (int)waitMs) < 0) return;
+
+  size_t known = g_tcp.size();
+  for (size_t i = 0; i < known; i++) {
+    HostTcpConn *t = g_tcp[i];
+    if (!(g_pollFds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+    uint8_t buf[4096];
+    for (;;) {
+      ssize_t n = recv(t->fd, buf, sizeof(buf), 0);
+      if (n > 0) {
+        t->in.append(buf, n);
+        continue;
+      }
+      if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) t->done = true;
+      break;
+    }
+    if (!t->ws) tcpHttp(t);
+    if (t->ws && !t->done) tcpWs(t);
+  }
+
+  if (g_pollFds[0].revents & POLLIN) {
+    for (;;) {
+      sockaddr_in addr;
+      socklen_t   addrLen = sizeof(addr);
+      int fd = accept4(g_listenFd, (sockaddr *)&addr, &addrLen, SOCK_NONBLOCK);
+      if (fd < 0) break;
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      HostTcpConn *t = (HostTcpConn *)calloc(1, sizeof(HostTcpConn));
+      t->fd = fd;
+      t->ip = IPAddress((uint32_t)addr.sin_addr.s_addr);
+      g_tcp.push_back(t);
+    }
+  }
+
+  for (size_t i = 0; i < g_tcp.size();) {
+    HostTcpConn *t = g_tcp[i];
+    if (t->done || (t->ws && t->ws->dead)) {
+      tcpClose(t);
+      g_tcp.erase(g_tcp.begin() + i);
+    } else {
+      i++;
+    }
+  }
+}
+
+bool hostHttpListen(uint16_t port, const char *bindAddress) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port   = htons(port);
+  if (fd < 0 || inet_pton(AF_INET, bindAddress, &addr.sin_addr) != 1 ||
+      bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+    fprintf(stderr, "hostHttpListen(%s:%u): %s\n", bindAddress, port, strerror(errno));
+    if (fd >= 0) close(fd);
+    return false;
+  }
+  g_listenFd = fd;
+  hostAddIdleHandler(hostNetPoll);
+  return true;
+}
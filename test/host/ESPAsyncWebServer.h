@@ -0,0 +1,315 @@
+#ifndef FARM_HOST_ESPASYNCWEBSERVER_H
+#define FARM_HOST_ESPASYNCWEBSERVER_H
+
+// ------------------------------------------------------------
+// ESPAsyncWebServer pro hostitelské sestavení (shim)
+//
+// Směrování, parametry, odpovědi (i chunked) a AsyncWebSocket s API
+// knihovny. Požadavky a WebSocket klienty lze vytvářet přímo z testu
+// (hostHttp(), hostWs*()) – bez sítě a se simulovanými hodinami;
+// farmhub_host navíc po hostHttpListen() obsluhuje skutečné TCP spojení
+// (HTTP/1.1 a RFC 6455), takže na hub jde pustit tools/fleet_sim.py.
+//
+// Chunked odpověď se plní po oknech jako na ESP8266 (výchozí 1460 B na
+// volání) a mezi voláními lze spustit háček – test tak změní data
+// uprostřed odesílání stránky. Vlastní buffery shimu (tělo odpovědi,
+// přijaté rámce, fronta odchozích zpráv) jdou přes malloc, takže se
+// do měření haldy (FarmHost.h) počítá jen to, co alokuje hub.
+// ------------------------------------------------------------
+
+#include "Arduino.h"
+#include "FS.h"
+#include "ESP8266WiFi.h"
+
+enum WebRequestMethod : uint8_t {
+  HTTP_GET     = 0b00000001,
+  HTTP_POST    = 0b00000010,
+  HTTP_DELETE  = 0b00000100,
+  HTTP_PUT     = 0b00001000,
+  HTTP_PATCH   = 0b00010000,
+  HTTP_HEAD    = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY     = 0b01111111
+};
+typedef uint8_t WebRequestMethodComposite;
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String &name, const String &value, bool form = false)
+    : _name(name), _value(value), _isForm(form) {}
+  const String &name() const  { return _name; }
+  const String &value() const { return _value; }
+  size_t        size() const  { return _value.length(); }
+  bool          isPost() const { return _isForm; }
+  bool          isFile() const { return false; }
+
+private:
+  String _name;
+  String _value;
+  bool   _isForm;
+};
+
+class AsyncWebHeader {
+public:
+  AsyncWebHeader(const String &name, const String &value) : _name(name), _value(value) {}
+  const String &name() const  { return _name; }
+  const String &value() const { return _value; }
+
+private:
+  String _name;
+  String _value;
+};
+
+typedef std::function<size_t(uint8_t *buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebServerResponse {
+public:
+  AsyncWebServerResponse(int code, const String &contentType) : _code(code), _contentType(contentType) {}
+  virtual ~AsyncWebServerResponse() {}
+
+  void setCode(int code) { _code = code; }
+  void setContentType(const String &type) { _contentType = type; }
+  void setContentLength(size_t len) {}
+  void addHeader(const String &name, const String &value) { _headers.emplace_back(name, value); }
+
+  // Shim: stav a další část těla (0 = konec, RESPONSE_TRY_AGAIN = zatím nic)
+  int                                code() const        { return _code; }
+  const String                      &contentType() const { return _contentType; }
+  const std::vector<AsyncWebHeader> &headers() const     { return _headers; }
+  virtual size_t fill(uint8_t *buffer, size_t maxLen) = 0;
+
+private:
+  int                         _code;
+  String                      _contentType;
+  std::vector<AsyncWebHeader> _headers;
+};
+
+class AsyncWebServerRequest {
+public:
+  AsyncWebServerRequest(WebRequestMethodComposite method, const char *url);
+  ~AsyncWebServerRequest();
+
+  WebRequestMethodComposite method() const { return _method; }
+  const String             &url() const    { return _url; }
+
+  size_t             params() const { return _params.size(); }
+  AsyncWebParameter *getParam(size_t i) const;
+  bool               hasParam(const String &name, bool post = false, bool file = false) const;
+  AsyncWebParameter *getParam(const String &name, bool post = false, bool file = false) const;
+  bool               hasArg(const char *name) const;
+  String             arg(const char *name) const;
+  bool               hasHeader(const String &name) const;
+  AsyncWebHeader    *getHeader(const String &name) const;
+
+  void send(AsyncWebServerResponse *response);
+  void send(int code, const String &contentType = String(), const String &content = String());
+  void send_P(int code, const String &contentType, const uint8_t *content, size_t len);
+  void send_P(int code, const String &contentType, PGM_P content);
+  void redirect(const String &url);
+
+  AsyncWebServerResponse *beginResponse(int code, const String &contentType = String(),
+                                        const String &content = String());
+  AsyncWebServerResponse *beginResponse_P(int code, const String &contentType,
+                                          const uint8_t *content, size_t len);
+  AsyncWebServerResponse *beginChunkedResponse(const String &contentType, AwsResponseFiller filler);
+  void onDisconnect(std::function<void()> fn) {}
+
+  // Shim: naplnění požadavku a odpověď po obsluze
+  void addParam(const String &name, const String &value, bool post);
+  void addHeader(const String &name, const String &value);
+  AsyncWebServerResponse *response() const { return _response; }
+
+private:
+  WebRequestMethodComposite      _method;
+  String                         _url;
+  std::vector<AsyncWebParameter> _params;
+  std::vector<AsyncWebHeader>    _headers;
+  AsyncWebServerResponse        *_response = nullptr;
+};
+
+typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunction;
+
+class AsyncWebHandler {
+public:
+  virtual ~AsyncWebHandler() {}
+  virtual bool canHandle(AsyncWebServerRequest *request) { return false; }
+  virtual void handleRequest(AsyncWebServerRequest *request) {}
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+  AsyncCallbackWebHandler(const String &uri, WebRequestMethodComposite method,
+                          ArRequestHandlerFunction fn)
+    : _uri(uri), _method(method), _fn(fn) {}
+  bool canHandle(AsyncWebServerRequest *request) override;
+  void handleRequest(AsyncWebServerRequest *request) override { if (_fn) _fn(request); }
+
+private:
+  String                    _uri;
+  WebRequestMethodComposite _method;
+  ArRequestHandlerFunction  _fn;
+};
+
+class AsyncWebServer {
+public:
+  explicit AsyncWebServer(uint16_t port) : _port(port) {}
+  ~AsyncWebServer();
+
+  void begin();
+  void end();
+  AsyncCallbackWebHandler &on(const char *uri, ArRequestHandlerFunction fn) { return on(uri, HTTP_ANY, fn); }
+  AsyncCallbackWebHandler &on(const char *uri, WebRequestMethodComposite method,
+                              ArRequestHandlerFunction fn);
+  AsyncWebHandler &addHandler(AsyncWebHandler *handler);
+  void onNotFound(ArRequestHandlerFunction fn) { _notFound = fn; }
+
+  // Shim: obsluha požadavku (první handler, který ho přijme)
+  void              handle(AsyncWebServerRequest *request);
+  AsyncWebHandler  *findHandler(AsyncWebServerRequest *request);
+  uint16_t          port() const { return _port; }
+
+private:
+  uint16_t                       _port;
+  std::vector<AsyncWebHandler *> _handlers;
+  std::vector<AsyncWebHandler *> _owned;
+  ArRequestHandlerFunction       _notFound;
+};
+
+// ------------------------------------------------------------
+// WebSocket
+// ------------------------------------------------------------
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef enum { WS_CONTINUATION, WS_TEXT, WS_BINARY, WS_DISCONNECT = 0x08, WS_PING, WS_PONG } AwsFrameType;
+typedef enum { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING } AwsClientStatus;
+
+typedef struct {
+  uint8_t  message_opcode;   // opcode první části zprávy
+  uint32_t num;              // pořadí rámce ve zprávě
+  uint8_t  final;            // poslední rámec zprávy
+  uint8_t  masked;
+  uint8_t  opcode;           // opcode tohoto rámce (CONTINUATION pro num > 0)
+  uint64_t len;              // délka rámce
+  uint8_t  mask[4];
+  uint64_t index;            // pozice dat v rámci (rámec po částech)
+} AwsFrameInfo;
+
+class AsyncWebSocket;
+struct HostWsConn;
+
+class AsyncWebSocketClient {
+public:
+  AsyncWebSocketClient(AsyncWebSocket *server, uint32_t id, IPAddress ip, HostWsConn *conn)
+    : _server(server), _id(id), _ip(ip), _conn(conn) {}
+  ~AsyncWebSocketClient();
+
+  uint32_t        id() const       { return _id; }
+  IPAddress       remoteIP() const { return _ip; }
+  AwsClientStatus status() const   { return _status; }
+  AsyncWebSocket *server()         { return _server; }
+  bool            canSend() const  { return _status == WS_CONNECTED; }
+  bool            queueIsFull() const { return false; }
+
+  void close(uint16_t code = 0, const char *message = nullptr);
+  void ping(const uint8_t *data = nullptr, size_t len = 0);
+  void text(const char *message, size_t len);
+  void text(const char *message) { text(message, strlen(message)); }
+  void text(const String &message) { text(message.c_str(), message.length()); }
+  void binary(const uint8_t *message, size_t len);
+  void binary(const char *message, size_t len) { binary((const uint8_t *)message, len); }
+
+  HostWsConn *conn() const { return _conn; }
+
+private:
+  AsyncWebSocket *_server;
+  uint32_t        _id;
+  IPAddress       _ip;
+  HostWsConn     *_conn;
+  AwsClientStatus _status = WS_CONNECTED;
+};
+
+typedef std::function<void(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type,
+                           void *arg, uint8_t *data, size_t len)> AwsEventHandler;
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+  explicit AsyncWebSocket(const String &url) : _url(url) {}
+  ~AsyncWebSocket();
+
+  const char *url() const { return _url.c_str(); }
+  void        onEvent(AwsEventHandler handler) { _handler = handler; }
+  bool        canHandle(AsyncWebServerRequest *request) override { return request->url() == _url; }
+
+  size_t                count() const;
+  AsyncWebSocketClient *client(uint32_t id);
+  bool                  hasClient(uint32_t id) { return client(id) != nullptr; }
+  void                  close(uint32_t id, uint16_t code = 0, const char *message = nullptr);
+  void                  closeAll(uint16_t code = 0, const char *message = nullptr);
+  void                  cleanupClients(uint16_t maxClients = 8);
+  bool                  availableForWrite(uint32_t id) { return client(id) != nullptr; }
+  bool                  availableForWriteAll() { return true; }
+
+  void text(uint32_t id, const char *message, size_t len);
+  void text(uint32_t id, const char *message) { text(id, message, strlen(message)); }
+  void text(uint32_t id, const String &message) { text(id, message.c_str(), message.length()); }
+  void textAll(const char *message, size_t len);
+  void textAll(const char *message) { textAll(message, strlen(message)); }
+  void textAll(const String &message) { textAll(message.c_str(), message.length()); }
+  void binary(uint32_t id, const uint8_t *message, size_t len);
+  void binaryAll(const uint8_t *message, size_t len);
+  void binaryAll(const char *message, size_t len) { binaryAll((const uint8_t *)message, len); }
+
+  // Shim: nové spojení, událost a odebrání zavřených klientů
+  uint32_t              hostAccept(HostWsConn *conn, IPAddress ip);   // id, klient může být hned zavřený
+  void                  hostEvent(AsyncWebSocketClient *client, AwsEventType type, void *arg,
+                                  uint8_t *data, size_t len);
+  void                  hostDrop(AsyncWebSocketClient *client);
+
+private:
+  void reapClosed();
+
+  String                               _url;
+  AwsEventHandler                      _handler;
+  std::vector<AsyncWebSocketClient *>  _clients;
+  uint32_t                             _nextId = 1;
+};
+
+// ------------------------------------------------------------
+// Řízení simulace: požadavky a WebSocket klienti z testu
+// ------------------------------------------------------------
+struct HostHttpResponse {
+  int         code = 0;
+  String      contentType;
+  String      location;     // cíl redirect()
+  std::string body;
+  uint32_t    fills = 0;    // volání plnicí funkce odpovědi
+  size_t      heapPeak = 0; // špička haldy hubu během obsluhy a odeslání (B nad výchozím stavem)
+  uint64_t    heapAllocs = 0;
+  std::vector<AsyncWebHeader> headers;
+  const String *header(const char *name) const;
+};
+
+typedef void (*HostHttpChunkHook)(uint32_t fill);
+
+// form = tělo application/x-www-form-urlencoded (parametry POST),
+// headers = řádky "Jméno: hodnota" oddělené '\n'
+HostHttpResponse hostHttp(WebRequestMethodComposite method, const char *url,
+                          const char *form = nullptr, const char *headers = nullptr);
+void hostHttpSetWindow(size_t bytes);               // max. bajtů na jedno plnění (výchozí 1460)
+void hostHttpSetChunkHook(HostHttpChunkHook hook);  // volá se po každém plnění
+
+// WebSocket klient bez sítě. Zpráva se pošle po rámcích o velikosti
+// fragment (0 = jeden rámec) a každý rámec po kusech o velikosti packet
+// (0 = celý), jak je knihovna dostává z TCP.
+uint32_t hostWsConnect(const char *path = "/ws");   // id klienta, 0 = odmítnuto
+bool     hostWsSend(uint32_t id, uint8_t opcode, const void *data, size_t len,
+                    size_t fragment = 0, size_t packet = 0);
+bool     hostWsReceive(uint32_t id, std::string &message, uint8_t *opcode = nullptr);
+bool     hostWsConnected(uint32_t id);
+void     hostWsDisconnect(uint32_t id);
+
+// Skutečný server na TCP portu (farmhub_host); volat před server.begin()
+bool     hostHttpListen(uint16_t port, const char *bindAddress = "127.0.0.1");
+
+#endif // FARM_HOST_ESPASYNCWEBSERVER_H
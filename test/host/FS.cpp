@@ -0,0 +1,375 @@
+// SPIFFS pro hostitelské sestavení (viz FS.h)
+
+#include "FS.h"
+
+FS SPIFFS;
+
+// Víc souborů, než pojme skutečný SPIFFS – bench_hub drží log s 1M
+// záznamy (přes 2000 segmentů)
+static const int HOST_FS_MAX_FILES = 4096;
+static const int HOST_FS_MAX_OPEN  = 16;
+
+struct HostFile {
+  bool     used;
+  uint32_t gen;      // mění se při smazání (otevřené handly pak neplatí)
+  char     name[HOST_FS_NAME_LEN];
+  uint8_t *data;
+  size_t   size;
+  size_t   cap;
+};
+
+struct HostHandle {
+  int      refs;     // kopie File, které handle drží
+  bool     open;
+  int      file;
+  uint32_t gen;
+  size_t   pos;
+  bool     canRead;
+  bool     canWrite;
+  bool     append;
+};
+
+static HostFile   g_files[HOST_FS_MAX_FILES];
+static HostHandle g_handles[HOST_FS_MAX_OPEN];
+static size_t     g_fsCapacity     = 2 * 1024 * 1024;
+static size_t     g_fsUsed         = 0;
+static bool       g_failTruncate   = false;
+static uint32_t   g_fsWrites       = 0;
+
+static int findFile(const char *path) {
+  for (int i = 0; i < HOST_FS_MAX_FILES; i++) {
+    if (g_files[i].used && strcmp(g_files[i].name, path) == 0) return i;
+  }
+  return -1;
+}
+
+static void dropFile(int i) {
+  HostFile &f = g_files[i];
+  g_fsUsed -= f.size;
+  free(f.data);
+  f.data = nullptr;
+  f.size = f.cap = 0;
+  f.used = false;
+  f.gen++;
+}
+
+static int createFile(const char *path) {
+  for (int i = 0; i < HOST_FS_MAX_FILES; i++) {
+    if (g_files[i].used) continue;
+    HostFile &f = g_files[i];
+    f.used = true;
+    f.gen++;
+    size_t len = strnlen(path, sizeof(f.name) - 1);
+    memcpy(f.name, path, len);
+    f.name[len] = 0;
+    f.data = nullptr;
+    f.size = f.cap = 0;
+    return i;
+  }
+  return -1;
+}
+
+static HostHandle *handleOf(int h) {
+  if (h < 0) return nullptr;
+  HostHandle &hh = g_handles[h];
+  if (!hh.open || !g_files[hh.file].used || g_files[hh.file].gen != hh.gen) return nullptr;
+  return &hh;
+}
+
+// ------------------------------------------------------------
+// FS
+// ------------------------------------------------------------
+bool FS::begin() { return true; }
+
+bool FS::format() {
+  for (int i = 0; i < HOST_FS_MAX_FILES; i++) {
+    if (g_files[i].used) dropFile(i);
+  }
+  return true;
+}
+
+File FS::open(const char *path, const char *mode) {
+  if (!path || strlen(path) >= HOST_FS_NAME_LEN) {
+    Serial.printf("SPIFFS: path too long: %s\n", path ? path : "");
+    return File();
+  }
+  bool plus   = strchr(mode, '+') != nullptr;
+  int  file   = findFile(path);
+  bool read   = mode[0] == 'r' || plus;
+  bool write  = mode[0] != 'r' || plus;
+  bool append = mode[0] == 'a';
+
+  if (mode[0] == 'r' && file < 0) return File();
+  if (file < 0) file = createFile(path);
+  if (file < 0) {
+    Serial.printf("SPIFFS: no free file slot for %s\n", path);
+    return File();
+  }
+  if (mode[0] == 'w') {
+    g_fsUsed -= g_files[file].size;
+    g_files[file].size = 0;
+  }
+
+  for (int h = 0; h < HOST_FS_MAX_OPEN; h++) {
+    if (g_handles[h].refs > 0) continue;
+    HostHandle &hh = g_handles[h];
+    hh.refs     = 0;
+    hh.open     = true;
+    hh.file     = file;
+    hh.gen      = g_files[file].gen;
+    hh.pos      = append ? g_files[file].size : 0;
+    hh.canRead  = read;
+    hh.canWrite = write;
+    hh.append   = append;
+    return File(h);
+  }
+  Serial.printf("SPIFFS: too many open files (%s)\n", path);
+  return File();
+}
+
+bool FS::exists(const char *path) { return findFile(path) >= 0; }
+
+bool FS::remove(const char *path) {
+  int i = findFile(path);
+  if (i < 0) return false;
+  dropFile(i);
+  return true;
+}
+
+bool FS::rename(const char *from, const char *to) {
+  int i = findFile(from);
+  if (i < 0 || findFile(to) >= 0 || strlen(to) >= HOST_FS_NAME_LEN) return false;
+  strcpy(g_files[i].name, to);
+  return true;
+}
+
+bool FS::info(FSInfo &info) {
+  info.totalBytes    = g_fsCapacity;
+  info.usedBytes     = g_fsUsed;
+  info.blockSize     = 8192;
+  info.pageSize      = 256;
+  info.maxOpenFiles  = HOST_FS_MAX_OPEN;
+  info.maxPathLength = HOST_FS_NAME_LEN;
+  return true;
+}
+
+// ------------------------------------------------------------
+// File
+// ------------------------------------------------------------
+File::File(int handle) : _h(handle) { g_handles[_h].refs++; }
+
+File::File(const File &o) : _h(o._h) {
+  if (_h >= 0) g_handles[_h].refs++;
+}
+
+File &File::operator=(const File &o) {
+  if (this == &o) return *this;
+  if (o._h >= 0) g_handles[o._h].refs++;
+  if (_h >= 0) g_handles[_h].refs--;
+  _h = o._h;
+  return *this;
+}
+
+File::~File() {
+  if (_h >= 0) g_handles[_h].refs--;
+}
+
+File::operator bool() const { return handleOf(_h) != nullptr; }
+
+void File::close() {
+  if (_h < 0) return;
+  g_handles[_h].open = false;
+  g_handles[_h].refs--;
+  _h = -1;
+}
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t *buf, size_t len) {
+  HostHandle *hh = handleOf(_h);
+  if (!hh || !hh->canWrite) return 0;
+  g_fsWrites++;
+  HostFile &f = g_files[hh->file];
+  if (hh->append) hh->pos = f.size;
+
+  // Za kapacitou flash se zapíše jen začátek (plný SPIFFS)
+  size_t room = g_fsCapacity > g_fsUsed ? g_fsCapacity - g_fsUsed : 0;
+  size_t end  = hh->pos + len;
+  if (end > f.size && end - f.size > room) {
+    end = f.size + room;
+    len = end > hh->pos ? end - hh->pos : 0;
+  }
+  if (end > f.cap) {
+    size_t cap = std::max(end, f.cap * 2 + 64);
+    uint8_t *p = (uint8_t *)realloc(f.data, cap);
+    if (!p) return 0;
+    f.data = p;
+    f.cap  = cap;
+  }
+  if (hh->pos > f.size) memset(f.data + f.size, 0, hh->pos - f.size);
+  memcpy(f.data + hh->pos, buf, len);
+  hh->pos += len;
+  if (hh->pos > f.size) {
+    g_fsUsed += hh->pos - f.size;
+    f.size = hh->pos;
+  }
+  return len;
+}
+
+int File::available() {
+  HostHandle *hh = handleOf(_h);
+  if (!hh || !hh->canRead) return 0;
+  size_t size = g_files[hh->file].size;
+  return hh->pos < size ? (int)(size - hh->pos) : 0;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+  HostHandle *hh = handleOf(_h);
+  if (!hh || !hh->canRead || hh->pos >= g_files[hh->file].size) return -1;
+  return g_files[hh->file].data[hh->pos];
+}
+
+size_t File::read(uint8_t *buf, size_t len) {
+  HostHandle *hh = handleOf(_h);
+  if (!hh || !hh->canRead) return 0;
+  const HostFile &f = g_files[hh->file];
+  if (hh->pos >= f.size) return 0;
+  size_t n = std::min(len, f.size - hh->pos);
+  memcpy(buf, f.data + hh->pos, n);
+  hh->pos += n;
+  return n;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  HostHandle *hh = handleOf(_h);
+  if (!hh) return false;
+  size_t size = g_files[hh->file].size;
+  size_t base = mode == SeekSet ? 0 : (mode == SeekCur ? hh->pos : size);
+  if (base + pos > size) return false;
+  hh->pos = base + pos;
+  return true;
+}
+
+size_t File::position() const {
+  HostHandle *hh = handleOf(_h);
+  return hh ? hh->pos : 0;
+}
+
+size_t File::size() const {
+  HostHandle *hh = handleOf(_h);
+  return hh ? g_files[hh->file].size : 0;
+}
+
+bool File::truncate(uint32_t size) {
+  HostHandle *hh = handleOf(_h);
+  if (!hh || !hh->canWrite || g_failTruncate) return false;
+  HostFile &f = g_files[hh->file];
+  if (size > f.size) return false;
+  g_fsUsed -= f.size - size;
+  f.size = size;
+  if (hh->pos > size) hh->pos = size;
+  return true;
+}
+
+const char *File::name() const {
+  HostHandle *hh = handleOf(_h);
+  return hh ? g_files[hh->file].name : "";
+}
+
+String File::readStringUntil(char terminator) {
+  String s;
+  int c;
+  while ((c = read()) >= 0 && c != terminator) s += (char)c;
+  return s;
+}
+
+String File::readString() {
+  String s;
+  int c;
+  while ((c = read()) >= 0) s += (char)c;
+  return s;
+}
+
+// ------------------------------------------------------------
+// Dir
+// ------------------------------------------------------------
+Dir::Dir(const char *prefix) : _pos(-1) {
+  strncpy(_prefix, prefix, sizeof(_prefix) - 1);
+  _prefix[sizeof(_prefix) - 1] = 0;
+}
+
+bool Dir::next() {
+  size_t len = strlen(_prefix);
+  while (++_pos < HOST_FS_MAX_FILES) {
+    if (g_files[_pos].used && strncmp(g_files[_pos].name, _prefix, len) == 0) return true;
+  }
+  return false;
+}
+
+String Dir::fileName() const {
+  return (_pos >= 0 && _pos < HOST_FS_MAX_FILES) ? String(g_files[_pos].name) : String();
+}
+
+size_t Dir::fileSize() const {
+  return (_pos >= 0 && _pos < HOST_FS_MAX_FILES) ? g_files[_pos].size : 0;
+}
+
+File Dir::openFile(const char *mode) {
+  return SPIFFS.open(fileName().c_str(), mode);
+}
+
+// ------------------------------------------------------------
+// Řízení simulace
+// ------------------------------------------------------------
+void   hostFsSetCapacity(size_t bytes) { g_fsCapacity = bytes; }
+size_t hostFsUsedBytes()               { return g_fsUsed; }
+void   hostFsFailTruncate(bool fail)   { g_failTruncate = fail; }
+uint32_t hostFsWrites()                { return g_fsWrites; }
+
+static const char HOST_FS_IMAGE_MAGIC[8] = "FHFSIMG";
+
+// Obraz: magic, pak pro každý soubor jméno (32 B), délka (u32) a data
+bool hostFsSaveImage(const char *path) {
+  FILE *out = fopen(path, "wb");
+  if (!out) return false;
+  fwrite(HOST_FS_IMAGE_MAGIC, 1, sizeof(HOST_FS_IMAGE_MAGIC), out);
+  for (int i = 0; i < HOST_FS_MAX_FILES; i++) {
+    const HostFile &f = g_files[i];
+    if (!f.used) continue;
+    uint32_t size = (uint32_t)f.size;
+    fwrite(f.name, 1, sizeof(f.name), out);
+    fwrite(&size, 1, sizeof(size), out);
+    if (size) fwrite(f.data, 1, size, out);
+  }
+  return fclose(out) == 0;
+}
+
+bool hostFsLoadImage(const char *path) {
+  FILE *in = fopen(path, "rb");
+  if (!in) return false;
+  char magic[sizeof(HOST_FS_IMAGE_MAGIC)];
+  bool ok = fread(magic, 1, sizeof(magic), in) == sizeof(magic) &&
+            memcmp(magic, HOST_FS_IMAGE_MAGIC, sizeof(magic)) == 0;
+  if (ok) SPIFFS.format();
+  char     name[HOST_FS_NAME_LEN];
+  uint32_t size;
+  while (ok && fread(name, 1, sizeof(name), in) == sizeof(name)) {
+    name[sizeof(name) - 1] = 0;
+    if (fread(&size, 1, sizeof(size), in) != sizeof(size)) { ok = false; break; }
+    int i = createFile(name);
+    if (i < 0) { ok = false; break; }
+    HostFile &f = g_files[i];
+    f.data = (uint8_t *)malloc(size ? size : 1);
+    f.cap  = size;
+    f.size = fread(f.data, 1, size, in);
+    g_fsUsed += f.size;
+    ok = f.size == size;
+  }
+  fclose(in);
+  return ok;
+}
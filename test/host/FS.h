@@ -0,0 +1,104 @@
+#ifndef FARM_HOST_FS_H
+#define FARM_HOST_FS_H
+
+// ------------------------------------------------------------
+// SPIFFS pro hostitelské sestavení (shim)
+//
+// Plochý jmenný prostor v RAM jako SPIFFS: jména včetně '/' (max. 31
+// znaků), openDir() vrací soubory podle prefixu a plná jména. Obsah
+// se alokuje přes malloc, takže se nepočítá do haldy firmwaru.
+//
+// Pro testy zotavení: kapacita "flash" (zápis za ni je krátký, jako
+// při plném SPIFFS), selhání truncate() a uložení/načtení obrazu.
+// ------------------------------------------------------------
+
+#include "Arduino.h"
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+static const size_t HOST_FS_NAME_LEN = 32;   // SPIFFS_OBJ_NAME_LEN
+
+class File : public Stream {
+public:
+  File() : _h(-1) {}
+  explicit File(int handle);
+  File(const File &o);
+  File &operator=(const File &o);
+  ~File();
+
+  operator bool() const;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t len) override;
+  using Print::write;
+  int    available() override;
+  int    read() override;
+  int    peek() override;
+  size_t read(uint8_t *buf, size_t len);
+  bool   seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  bool   truncate(uint32_t size);
+  void   flush() override {}
+  void   close();
+  const char *name() const;
+  const char *fullName() const { return name(); }
+  bool   isFile() const { return (bool)*this; }
+  String readStringUntil(char terminator);
+  String readString();
+
+private:
+  int _h;   // index do tabulky otevřených souborů
+};
+
+class Dir {
+public:
+  Dir() : _pos(-1) { _prefix[0] = 0; }
+  explicit Dir(const char *prefix);
+  bool   next();
+  String fileName() const;
+  size_t fileSize() const;
+  File   openFile(const char *mode);
+
+private:
+  char _prefix[HOST_FS_NAME_LEN];
+  int  _pos;
+};
+
+struct FSInfo {
+  size_t totalBytes;
+  size_t usedBytes;
+  size_t blockSize;
+  size_t pageSize;
+  size_t maxOpenFiles;
+  size_t maxPathLength;
+};
+
+class FS {
+public:
+  bool begin();
+  void end() {}
+  bool format();
+  File open(const char *path, const char *mode);
+  File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+  bool exists(const char *path);
+  bool exists(const String &path) { return exists(path.c_str()); }
+  bool remove(const char *path);
+  bool remove(const String &path) { return remove(path.c_str()); }
+  bool rename(const char *from, const char *to);
+  bool rename(const String &from, const String &to) { return rename(from.c_str(), to.c_str()); }
+  Dir  openDir(const char *prefix) { return Dir(prefix); }
+  Dir  openDir(const String &prefix) { return Dir(prefix.c_str()); }
+  bool info(FSInfo &info);
+};
+
+extern FS SPIFFS;
+
+// Řízení simulace flash
+void   hostFsSetCapacity(size_t bytes);       // výchozí 2 MB
+size_t hostFsUsedBytes();
+void   hostFsFailTruncate(bool fail);         // truncate() vrací false
+bool   hostFsSaveImage(const char *path);     // obsah do souboru na PC
+bool   hostFsLoadImage(const char *path);
+uint32_t hostFsWrites();                      // počet volání write() od startu
+
+#endif // FARM_HOST_FS_H
@@ -0,0 +1,51 @@
+#ifndef FARM_HOST_H
+#define FARM_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------
+// Řízení hostitelské simulace (jen pro testy, na ESP8266 neexistuje)
+//
+// Hodiny: výchozí jsou simulované – millis()/micros() stojí a posouvá je
+// jen delay() a hostAdvanceMs(), takže testy časování jsou
+// deterministické. Benchmarky a farmhub_host přepnou na skutečný čas.
+//
+// Halda: globální new/delete se počítají (počet alokací, aktuální
+// a špičkový objem). ESP.getFreeHeap() z nich odvozuje volnou haldu.
+//
+// Serial: výstup jde do kruhového bufferu (hledání textu v testech),
+// na stdout jen se zapnutým echem.
+// ------------------------------------------------------------
+
+// Hodiny
+void     hostUseRealClock(bool real);
+void     hostSetMillis(uint64_t ms);
+void     hostAdvanceMs(uint32_t ms);
+void     hostAdvanceUs(uint32_t us);
+
+// Obsluha "na pozadí" (síť) volaná z delay() a yield(); waitMs je,
+// kolik smí nejvýš blokovat (se simulovanými hodinami vždy 0)
+typedef void (*HostIdleFn)(uint32_t waitMs);
+void     hostAddIdleHandler(HostIdleFn fn);
+
+// Halda
+struct HostHeapStats {
+  uint64_t allocs;   // volání new od startu
+  uint64_t frees;
+  size_t   bytes;    // právě alokováno
+  size_t   peak;     // maximum od posledního hostHeapResetPeak()
+};
+const HostHeapStats &hostHeap();
+void     hostHeapResetPeak();
+void     hostSetHeapSize(uint32_t bytes);   // co hlásí ESP.getFreeHeap() při prázdné haldě
+
+// Serial
+void     hostSerialEcho(bool on);
+bool     hostSerialContains(const char *text);
+void     hostSerialClear();
+
+// Piny
+void     hostSetAnalog(uint8_t pin, int value);
+
+#endif // FARM_HOST_H
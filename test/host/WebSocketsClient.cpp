@@ -0,0 +1,69 @@
+// WebSocketsClient pro hostitelské sestavení (viz WebSocketsClient.h)
+
+#include "WebSocketsClient.h"
+#include "ESP8266WiFi.h"
+
+static bool     g_hubUp       = true;
+static uint32_t g_hubEpoch    = 1;   // mění se při každém pádu hubu
+static uint32_t g_hubConnects = 0;
+
+void hostWsHubSetUp(bool up) {
+  if (g_hubUp && !up) g_hubEpoch++;
+  g_hubUp = up;
+}
+
+bool     hostWsHubUp()       { return g_hubUp; }
+uint32_t hostWsHubConnects() { return g_hubConnects; }
+
+void WebSocketsClient::begin(const char *host, uint16_t port, const char *url, const char *protocol) {
+  _begun       = true;
+  _connected   = false;
+  _lastAttempt = 0;
+}
+
+void WebSocketsClient::loop() {
+  if (!_begun) return;
+  if (_connected) {
+    if (g_hubUp && _hubEpoch == g_hubEpoch) return;
+    _connected = false;
+    event(WStype_DISCONNECTED, nullptr, 0);
+    return;
+  }
+  unsigned long now = millis();
+  if (now - _lastAttempt < _reconnectMs) return;
+  _lastAttempt = now;
+  _attempts++;
+  if (!g_hubUp || WiFi.status() != WL_CONNECTED) return;
+  _connected = true;
+  _hubEpoch  = g_hubEpoch;
+  g_hubConnects++;
+  event(WStype_CONNECTED, (uint8_t *)"/", 1);
+}
+
+void WebSocketsClient::disconnect() {
+  _begun = false;
+  if (!_connected) return;
+  _connected = false;
+  event(WStype_DISCONNECTED, nullptr, 0);
+}
+
+bool WebSocketsClient::sendTXT(const char *payload, size_t length) {
+  if (!_connected) return false;
+  if (length == 0) length = strlen(payload);
+  _lastSent.assign(payload, length);
+  _sent++;
+  return true;
+}
+
+bool WebSocketsClient::sendBIN(const uint8_t *payload, size_t length) {
+  if (!_connected) return false;
+  _lastSent.assign((const char *)payload, length);
+  _sent++;
+  return true;
+}
+
+void WebSocketsClient::hostDeliver(WStype_t type, const uint8_t *payload, size_t length) {
+  if (!_connected) return;
+  std::string copy((const char *)payload, length);   // knihovna předává zapisovatelný buffer
+  event(type, (uint8_t *)&copy[0], length);
+}
@@ -0,0 +1,76 @@
+#ifndef FARM_HOST_WEBSOCKETSCLIENT_H
+#define FARM_HOST_WEBSOCKETSCLIENT_H
+
+// ------------------------------------------------------------
+// WebSocketsClient (arduinoWebSockets) pro hostitelské sestavení (shim)
+//
+// Klient uzlu proti jednomu simulovanému hubu. Pokus o spojení proběhne
+// v loop() po uplynutí intervalu opakování od předchozího pokusu (první
+// pokus se počítá od nuly, jako v knihovně) a uspěje, jen když je uzel
+// na Wi-Fi a hub přijímá spojení. Neúspěšný pokus událost nevyvolá.
+// Když hub spadne, spojení skončí při dalším loop() událostí
+// WStype_DISCONNECTED; stejně tak disconnect() navázaného spojení.
+// ------------------------------------------------------------
+
+#include "Arduino.h"
+#include <string>
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+typedef void (*WebSocketClientEvent)(WStype_t type, uint8_t *payload, size_t length);
+
+class WebSocketsClient {
+public:
+  void begin(const char *host, uint16_t port, const char *url = "/", const char *protocol = "arduino");
+  void begin(const String &host, uint16_t port, const String &url = "/") {
+    begin(host.c_str(), port, url.c_str());
+  }
+  void onEvent(WebSocketClientEvent cb)          { _cb = cb; }
+  void setReconnectInterval(unsigned long ms)    { _reconnectMs = ms; }
+  void enableHeartbeat(uint32_t pingMs, uint32_t pongTimeoutMs, uint8_t disconnectCount) {}
+  void loop();
+  void disconnect();
+  bool isConnected() const                       { return _connected; }
+
+  bool sendTXT(const char *payload, size_t length = 0);
+  bool sendTXT(const String &payload)            { return sendTXT(payload.c_str(), payload.length()); }
+  bool sendBIN(const uint8_t *payload, size_t length);
+
+  // Shim: zpráva od hubu a přehled provozu klienta
+  void               hostDeliver(WStype_t type, const uint8_t *payload, size_t length);
+  uint32_t           hostAttempts() const { return _attempts; }   // pokusy o TCP spojení
+  uint32_t           hostSent() const     { return _sent; }
+  const std::string &hostLastSent() const { return _lastSent; }
+
+private:
+  void event(WStype_t type, uint8_t *payload, size_t length) { if (_cb) _cb(type, payload, length); }
+
+  WebSocketClientEvent _cb          = nullptr;
+  bool                 _begun       = false;
+  bool                 _connected   = false;
+  uint32_t             _hubEpoch    = 0;      // běh hubu, ke kterému je spojení
+  unsigned long        _reconnectMs = 500;
+  unsigned long        _lastAttempt = 0;
+  uint32_t             _attempts    = 0;
+  uint32_t             _sent        = 0;
+  std::string          _lastSent;
+};
+
+// Řízení simulovaného hubu
+void     hostWsHubSetUp(bool up);   // hub přijímá spojení; pád ukončí navázaná
+bool     hostWsHubUp();
+uint32_t hostWsHubConnects();       // přijatá spojení od startu
+
+#endif // FARM_HOST_WEBSOCKETSCLIENT_H
@@ -0,0 +1,23 @@
+#ifndef FARM_HOST_WIRE_H
+#define FARM_HOST_WIRE_H
+
+// I2C (shim): přenosy se jen počítají
+#include "Arduino.h"
+
+class TwoWire {
+public:
+  void    begin() {}
+  void    begin(int sda, int scl) {}
+  void    setClock(uint32_t hz) {}
+  void    beginTransmission(uint8_t addr) { transmissions++; }
+  size_t  write(uint8_t b) { bytes++; return 1; }
+  size_t  write(const uint8_t *data, size_t len) { bytes += len; return len; }
+  uint8_t endTransmission(bool stop = true) { return 0; }
+
+  uint32_t transmissions = 0;
+  uint32_t bytes         = 0;
+};
+
+inline TwoWire Wire;
+
+#endif // FARM_HOST_WIRE_H
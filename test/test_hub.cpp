@@ -0,0 +1,174 @@
+// Celý hub (FarmHub.ino) nad shimy z host/ se simulovanými hodinami:
+// stránky, statické soubory, formuláře, /metrics a příjem dat přes /ws
+
+#include "farm_test.h"
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include "FarmHub.ino"
+
+static bool g_booted = false;
+
+static void boot() {
+  if (g_booted) return;
+  g_booted = true;
+  setup();
+  for (int i = 0; i < 20; i++) loop();
+}
+
+static bool contains(const std::string &body, const char *needle) {
+  return body.find(needle) != std::string::npos;
+}
+
+// Přijme zprávy klienta a vrátí true, pokud některá obsahuje `needle`
+static bool receivedText(uint32_t id, const char *needle) {
+  std::string msg;
+  bool found = false;
+  while (hostWsReceive(id, msg)) {
+    if (contains(msg, needle)) found = true;
+  }
+  return found;
+}
+
+TEST(pagesRender) {
+  boot();
+  const char *pages[] = { "/", "/charts", "/history", "/wifi", "/watering", "/lighting", "/sensors" };
+  for (const char *url : pages) {
+    HostHttpResponse r = hostHttp(HTTP_GET, url);
+    if (r.code != 200) printf("  %s -> %d\n", url, r.code);
+    CHECK_EQ(r.code, 200);
+    CHECK(contains(r.body, "</html>"));
+  }
+  CHECK_EQ(hostHttp(HTTP_GET, "/nope").code, 404);
+}
+
+TEST(staticAssetRevalidation) {
+  boot();
+  const StaticAsset &asset = STATIC_ASSETS[0];
+  HostHttpResponse r = hostHttp(HTTP_GET, asset.path);
+  CHECK_EQ(r.code, 200);
+  CHECK_EQ(r.body.size(), asset.length);
+  const String *etag = r.header("ETag");
+  CHECK(etag != nullptr);
+  if (!etag) return;
+
+  String cond = String("If-None-Match: ") + *etag;
+  HostHttpResponse again = hostHttp(HTTP_GET, asset.path, nullptr, cond.c_str());
+  CHECK_EQ(again.code, 304);
+  CHECK(again.body.empty());
+}
+
+// Grafy jsou z /static a /api/series, bez Wi-Fi se vykreslí stejně
+TEST(chartsRenderOffline) {
+  boot();
+  CHECK(WiFi.status() != WL_CONNECTED);
+  HostHttpResponse r = hostHttp(HTTP_GET, "/charts");
+  CHECK_EQ(r.code, 200);
+  CHECK(contains(r.body, "/static/charts.js"));
+  CHECK(!contains(r.body, "Není připojení"));
+}
+
+TEST(formPostRedirects) {
+  boot();
+  HostHttpResponse r = hostHttp(HTTP_POST, "/setlog", "logBudgetKB=512");
+  CHECK_EQ(r.code, 302);
+  CHECK(r.location == "/history");
+  CHECK_EQ(logBudgetKB, 512u);
+}
+
+TEST(wsJsonReadingIsStored) {
+  boot();
+  uint32_t id = hostWsConnect();
+  CHECK(id != 0);
+  CHECK(receivedText(id, "Welcome sensor!"));
+
+  const char *reading = "{\"sensorID\":\"soilDHTsensor\",\"soil\":41.5,\"temp\":22,\"hum\":55}";
+  CHECK(hostWsSend(id, WS_TEXT, reading, strlen(reading)));
+  CHECK(receivedText(id, "\"status\":\"OK\""));
+
+  const SensorReading *latest = getLatestReading(SENSOR_SOIL_DHT);
+  CHECK(latest != nullptr);
+  if (latest) CHECK_EQ(latest->soilMoisture, 41.5f);
+
+  // Stejná zpráva po rámcích a po kusech TCP dá stejný výsledek
+  const char *next = "{\"sensorID\":\"soilDHTsensor\",\"soil\":43,\"temp\":22,\"hum\":55}";
+  CHECK(hostWsSend(id, WS_TEXT, next, strlen(next), 16, 5));
+  CHECK(receivedText(id, "\"status\":\"OK\""));
+  latest = getLatestReading(SENSOR_SOIL_DHT);
+  if (latest) CHECK_EQ(latest->soilMoisture, 43.0f);
+
+  hostWsDisconnect(id);
+  CHECK(!hostWsConnected(id));
+}
+
+TEST(metricsCountTraffic) {
+  boot();
+  HostHttpResponse r = hostHttp(HTTP_GET, "/metrics?format=json");
+  CHECK_EQ(r.code, 200);
+  CHECK(r.contentType == "application/json");
+  CHECK(contains(r.body, "{"));
+
+  HostHttpResponse prom = hostHttp(HTTP_GET, "/metrics");
+  CHECK_EQ(prom.code, 200);
+  CHECK(contains(prom.body, "farmhub_"));
+}
+
+TEST(loopRunsOnSimulatedClock) {
+  boot();
+  uint32_t start = millis();
+  while (millis() - start < 60000) loop();
+  CHECK(millis() - start >= 60000);
+  CHECK_EQ(hostHttp(HTTP_GET, "/").code, 200);
+}
+
+// /datalog.csv ze starší verze firmwaru se při startu převede do logu
+TEST(legacyCsvIsImportedOnce) {
+  boot();
+  File f = SPIFFS.open("/datalog.csv", "w");
+  f.print("soilDHTsensor,1700000000,35.50,21.00,55.00,0.00\n"
+          "soilDHTsensor,120,36.00,21.00,55.00,0.00\n"        // čas před NTP
+          "rozbity radek\n"
+          "oldLightSensor,1700000060,0.00,0.00,0.00,812.50\n");
+  f.close();
+
+  initDataStore();
+  CHECK(!SPIFFS.exists("/datalog.csv"));
+  uint8_t oldLight = findSensorID("oldLightSensor");
+  CHECK(oldLight != SENSOR_ID_UNKNOWN);
+
+  LogCursor cur;
+  LogRecord rec;
+  int       found = 0;
+  logCursorBegin(cur, 1700000000, 1700000060);
+  while (logCursorNext(cur, rec)) {
+    if (rec.timestamp == 1700000000) {
+      CHECK_EQ(rec.sensorId, SENSOR_SOIL_DHT);
+      CHECK(rec.soilMoisture == 35.5f);
+      found++;
+    } else if (rec.timestamp == 1700000060) {
+      CHECK_EQ(rec.sensorId, oldLight);
+      CHECK(rec.lightLevel == 812.5f);
+      found++;
+    }
+  }
+  logCursorEnd(cur);
+  CHECK_EQ(found, 2);
+
+  // Druhý start už nic nepřevádí
+  uint32_t records = g_logActiveCount;
+  initDataStore();
+  CHECK_EQ(g_logActiveCount, records);
+
+  HostHttpResponse r = hostHttp(HTTP_GET, "/datalog.csv");
+  CHECK_EQ(r.code, 200);
+  CHECK(contains(r.body, "oldLightSensor,1700000060,0.00,0.00,0.00,812.50"));
+
+  // Záznamy v JSON poli oddělené čárkou, bez čárky před prvním
+  r = hostHttp(HTTP_GET, "/api/history?from=1700000000&to=1700000060");
+  CHECK_EQ(r.code, 200);
+  CHECK(contains(r.body, "{\"readings\":[{\"sensorID\":\"soilDHTsensor\",\"timestamp\":1700000000,"));
+  CHECK(contains(r.body, "},{\"sensorID\":\"oldLightSensor\",\"timestamp\":1700000060,"));
+  CHECK(contains(r.body, "}]}"));
+}
+
+FARM_TEST_MAIN()
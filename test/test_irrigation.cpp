@@ -0,0 +1,90 @@
+// Automatické zalévání (FarmHubIrrigation.h) v celém hubu na simulovaných
+// hodinách: nepotvrzený RUN_PUMP zónu vrátí do čekání, ale jeho sekundy
+// v hodinovém limitu zůstávají – čerpadlo mohlo běžet a ztratit se jen ACK.
+
+#include "farm_test.h"
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include "FarmHub.ino"
+
+static bool g_booted = false;
+
+static void boot() {
+  if (g_booted) return;
+  g_booted = true;
+  setup();
+  for (int i = 0; i < 20; i++) loop();
+}
+
+static void runFor(uint32_t ms) {
+  uint32_t start = millis();
+  while (millis() - start < ms) loop();
+}
+
+// Zóna 0 v klidu, limit přesně na jedno spuštění
+static IrrigationZone &resetZone() {
+  boot();
+  IrrigationZone &z = g_zones[0];
+  z.state = ZONE_IDLE;
+  memset(z.dutySlots, 0, sizeof(z.dutySlots));
+  zoneDutyAdvance(z, millis());
+  autoWatering      = true;
+  moistureThreshold = 40;
+  maxPumpSecPerHour = zonePumpSeconds(z);
+  return z;
+}
+
+static void drySoil() {
+  SensorReading sr;
+  memset(&sr, 0, sizeof(sr));
+  sr.sensorId     = SENSOR_SOIL_DHT;
+  sr.fields       = 1 << FIELD_SOIL;
+  sr.soilMoisture = 20;
+  sr.timestamp    = time(nullptr);
+  irrigationOnReading(sr);
+}
+
+TEST(expiredCommandStaysCharged) {
+  IrrigationZone &z = resetZone();
+  uint16_t sec  = zonePumpSeconds(z);
+  uint32_t runs = z.runs;
+  CHECK(sec > 0);
+
+  drySoil();
+  CHECK_EQ(z.state, ZONE_PUMPING);
+  CHECK_EQ(z.runs, runs + 1);
+  CHECK_EQ(z.dutySec, sec);
+
+  // Čerpadlo není připojené: příkaz vyprší bez PUMP_ACK
+  uint32_t expired = g_pumpStats.expired;
+  runFor(PUMP_CMD_TIMEOUT_MS + PUMP_RETRY_MS);
+  CHECK_EQ(g_pumpStats.expired, expired + 1);
+  CHECK_EQ(z.state, ZONE_IDLE);
+  CHECK_EQ(z.dutySec, sec);
+
+  // Další suché měření v téže hodině limit nepřekročí
+  uint32_t skips = z.dutySkips;
+  drySoil();
+  CHECK_EQ(z.state, ZONE_IDLE);
+  CHECK_EQ(z.runs, runs + 1);
+  CHECK_EQ(z.dutySkips, skips + 1);
+}
+
+TEST(expiredCommandRetriesAfterWindow) {
+  IrrigationZone &z = resetZone();
+  drySoil();
+  CHECK_EQ(z.state, ZONE_PUMPING);
+  runFor(PUMP_CMD_TIMEOUT_MS + PUMP_RETRY_MS);
+  CHECK_EQ(z.state, ZONE_IDLE);
+
+  // Po hodině sekundy z okna vypadnou a zóna zalévá znovu
+  uint32_t runs = z.runs;
+  runFor(IRRIGATION_DUTY_WINDOW_MS + IRRIGATION_DUTY_SLOT_MS);
+  CHECK_EQ(z.dutySec, 0);
+  drySoil();
+  CHECK_EQ(z.state, ZONE_PUMPING);
+  CHECK_EQ(z.runs, runs + 1);
+}
+
+FARM_TEST_MAIN()
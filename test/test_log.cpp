@@ -0,0 +1,285 @@
+// Segmentovaný log (FarmHubLog.h): dotazy přes časový index, rotace
+// a zotavení po neúplném zápisu a po zahozených segmentech
+
+#include "farm_test.h"
+#include <Arduino.h>
+#include <FS.h>
+#include "FarmHubLog.h"
+
+static const uint32_t TS0    = 1700000000;
+static const uint32_t BUDGET = 64 * LOG_SEGMENT_BYTES;
+
+static LogRecord makeRecord(uint32_t i) {
+  LogRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.timestamp    = TS0 + i * 60;
+  rec.sensorId     = i % 3;
+  rec.fields       = 1;
+  rec.soilMoisture = (float)i;
+  return rec;
+}
+
+static void appendRange(uint32_t from, uint32_t count, uint32_t budget = BUDGET) {
+  LogRecord batch[8];
+  for (uint32_t i = 0; i < count; i += 8) {
+    size_t n = std::min<uint32_t>(8, count - i);
+    for (size_t k = 0; k < n; k++) batch[k] = makeRecord(from + i + k);
+    CHECK_EQ(logAppendBatch(batch, n, budget), n);
+  }
+}
+
+// Přečte interval a ověří, že jde o souvislou řadu záznamů od `first`
+static uint32_t queryCount(uint32_t fromTs, uint32_t toTs, uint32_t first) {
+  LogCursor cur;
+  LogRecord rec;
+  uint32_t  n = 0;
+  logCursorBegin(cur, fromTs, toTs);
+  while (logCursorNext(cur, rec)) {
+    if (rec.soilMoisture != (float)(first + n) || rec.timestamp != TS0 + (first + n) * 60) {
+      printf("  record %u: got value %g ts %u\n", n, rec.soilMoisture, rec.timestamp);
+      CHECK(false);
+      break;
+    }
+    n++;
+  }
+  logCursorEnd(cur);
+  return n;
+}
+
+static void segmentPath(uint32_t seq, char *buf) {
+  logSegmentPath(seq, buf, 32);
+}
+
+static void freshLog() {
+  SPIFFS.format();
+  hostFsSetCapacity(4 * 1024 * 1024);
+  hostFsFailTruncate(false);
+  CHECK(logInit(BUDGET));
+}
+
+TEST(appendAndQueryAcrossSegments) {
+  freshLog();
+  appendRange(0, 3 * LOG_SEGMENT_RECORDS + 100);
+  CHECK_EQ(g_logFirstSeq, 1);
+  CHECK_EQ(g_logLastSeq, 4);
+  CHECK_EQ(g_logActiveCount, 100);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), 3 * LOG_SEGMENT_RECORDS + 100);
+
+  // Interval uprostřed druhého segmentu
+  uint32_t from = 600, to = 700;
+  CHECK_EQ(queryCount(TS0 + from * 60, TS0 + to * 60, from), to - from + 1);
+  // Poslední hodina
+  uint32_t last = 3 * LOG_SEGMENT_RECORDS + 99;
+  CHECK_EQ(queryCount(TS0 + (last - 59) * 60, 0xFFFFFFFF, last - 59), 60);
+}
+
+TEST(resumeContinuesActiveSegment) {
+  freshLog();
+  appendRange(0, 700);
+  CHECK(logInit(BUDGET));   // restart
+  CHECK_EQ(g_logLastSeq, 2);
+  CHECK_EQ(g_logActiveCount, 700 - LOG_SEGMENT_RECORDS);
+  appendRange(700, 50);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), 750);
+}
+
+TEST(resumeTruncatesTornRecord) {
+  freshLog();
+  appendRange(0, 40);
+
+  // Výpadek napájení uprostřed zápisu: na konci segmentu je kus záznamu
+  char path[32];
+  segmentPath(g_logLastSeq, path);
+  LogRecord torn = makeRecord(40);
+  File f = SPIFFS.open(path, "a");
+  f.write((const uint8_t *)&torn, 10);
+  f.close();
+
+  CHECK(logInit(BUDGET));
+  CHECK_EQ(g_logActiveCount, 40);
+  f = SPIFFS.open(path, "r");
+  CHECK_EQ(f.size(), LOG_RECORDS_OFFSET + 40 * sizeof(LogRecord));
+  f.close();
+
+  // Další záznamy jsou zarovnané a čtou se správně
+  appendRange(40, 30);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), 70);
+}
+
+TEST(resumeSealsWhenTruncateFails) {
+  freshLog();
+  appendRange(0, 40);
+  char path[32];
+  segmentPath(g_logLastSeq, path);
+  LogRecord torn = makeRecord(40);
+  File f = SPIFFS.open(path, "a");
+  f.write((const uint8_t *)&torn, 7);
+  f.close();
+
+  hostFsFailTruncate(true);
+  CHECK(logInit(BUDGET));
+  hostFsFailTruncate(false);
+  // Segment s ocasem se uzavřel (hlavička nese 40 platných záznamů), zápis jde do nového
+  CHECK_EQ(g_logLastSeq, 2);
+  CHECK_EQ(g_logActiveCount, 0);
+  appendRange(40, 30);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), 70);
+}
+
+TEST(shortWriteIsCutToRecordBoundary) {
+  freshLog();
+  appendRange(0, 16);
+
+  // Plná flash: vejde se jen 2,5 záznamu
+  hostFsSetCapacity(hostFsUsedBytes() + 2 * sizeof(LogRecord) + sizeof(LogRecord) / 2);
+  LogRecord batch[8];
+  for (int k = 0; k < 8; k++) batch[k] = makeRecord(16 + k);
+  CHECK_EQ(logAppendBatch(batch, 8, BUDGET), 2);
+  CHECK(g_logReady);
+  CHECK_EQ(g_logActiveCount, 18);
+
+  char path[32];
+  segmentPath(g_logLastSeq, path);
+  File f = SPIFFS.open(path, "r");
+  CHECK_EQ(f.size(), LOG_RECORDS_OFFSET + 18 * sizeof(LogRecord));
+  f.close();
+
+  // Po uvolnění místa pokračuje zarovnaně
+  hostFsSetCapacity(4 * 1024 * 1024);
+  appendRange(18, 20);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), 38);
+}
+
+TEST(shortWriteSealsWhenTruncateFails) {
+  freshLog();
+  appendRange(0, 16);
+  hostFsSetCapacity(hostFsUsedBytes() + sizeof(LogRecord) + 5);
+  hostFsFailTruncate(true);
+  LogRecord batch[4];
+  for (int k = 0; k < 4; k++) batch[k] = makeRecord(16 + k);
+  CHECK_EQ(logAppendBatch(batch, 4, BUDGET), 1);
+  hostFsFailTruncate(false);
+
+  // Segment s odřezkem je uzavřený; na nový už místo nezbylo, takže
+  // log přestane zapisovat, místo aby psal za neúplnou hlavičku
+  CHECK(!g_logReady);
+  char path[32];
+  segmentPath(2, path);
+  CHECK(!SPIFFS.exists(path));
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), 17);
+
+  // Po restartu s volným místem pokračuje novým segmentem
+  hostFsSetCapacity(4 * 1024 * 1024);
+  CHECK(logInit(BUDGET));
+  CHECK_EQ(g_logLastSeq, 2);
+  appendRange(17, 10);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), 27);
+}
+
+TEST(rotationWithoutSpaceStopsLog) {
+  freshLog();
+  appendRange(0, LOG_SEGMENT_RECORDS - 8);
+  // Poslední dávka segmentu se vejde, hlavička dalšího už ne
+  hostFsSetCapacity(hostFsUsedBytes() + 8 * sizeof(LogRecord) + LOG_RECORDS_OFFSET / 2);
+  appendRange(LOG_SEGMENT_RECORDS - 8, 8);
+  CHECK(!g_logReady);
+  LogRecord rec = makeRecord(LOG_SEGMENT_RECORDS);
+  CHECK(!logAppend(rec, BUDGET));
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), LOG_SEGMENT_RECORDS);
+}
+
+TEST(retentionDropsOldestSegments) {
+  freshLog();
+  uint32_t budget = 3 * LOG_SEGMENT_BYTES;
+  appendRange(0, 5 * LOG_SEGMENT_RECORDS, budget);
+  CHECK(logStoredSegments() * LOG_SEGMENT_BYTES <= budget);
+  CHECK_EQ(g_logLastSeq, 6);
+  CHECK_EQ(g_logFirstSeq, 4);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 3 * LOG_SEGMENT_RECORDS), 2 * LOG_SEGMENT_RECORDS);
+}
+
+TEST(invalidSegmentIsHoleNotCountedInRetention) {
+  freshLog();
+  appendRange(0, 2 * LOG_SEGMENT_RECORDS + 10);   // 1, 2 uzavřené, 3 aktivní
+
+  // Poškozená hlavička segmentu 2 => při startu se zahodí
+  char path[32];
+  segmentPath(2, path);
+  File f = SPIFFS.open(path, "r+");
+  uint32_t zero = 0;
+  f.write((const uint8_t *)&zero, sizeof(zero));
+  f.close();
+
+  uint32_t budget = 3 * LOG_SEGMENT_BYTES;
+  CHECK(logInit(budget));
+  CHECK(!SPIFFS.exists(path));
+  CHECK_EQ(g_logHoles, 1);
+  CHECK_EQ(logStoredSegments(), 2);
+  CHECK_EQ(logUsedBytes(), LOG_SEGMENT_BYTES + LOG_RECORDS_OFFSET + 10 * sizeof(LogRecord));
+
+  // Rotace do segmentu 4: na flash jsou 1, 3, 4 = 3 segmenty, limit se vejde
+  appendRange(2 * LOG_SEGMENT_RECORDS + 10, LOG_SEGMENT_RECORDS, budget);
+  CHECK_EQ(g_logLastSeq, 4);
+  segmentPath(1, path);
+  CHECK(SPIFFS.exists(path));
+  CHECK_EQ(g_logFirstSeq, 1);
+
+  // Další rotace: smaže se segment 1 a díra po 2 se jen přeskočí
+  appendRange(3 * LOG_SEGMENT_RECORDS + 10, LOG_SEGMENT_RECORDS, budget);
+  CHECK_EQ(g_logLastSeq, 5);
+  CHECK(!SPIFFS.exists(path));
+  CHECK_EQ(g_logFirstSeq, 3);
+  CHECK_EQ(g_logHoles, 0);
+}
+
+TEST(leadingInvalidSegmentMovesStart) {
+  freshLog();
+  appendRange(0, 2 * LOG_SEGMENT_RECORDS + 10);
+  char path[32];
+  segmentPath(1, path);
+  File f = SPIFFS.open(path, "r+");
+  uint32_t zero = 0;
+  f.write((const uint8_t *)&zero, sizeof(zero));
+  f.close();
+
+  CHECK(logInit(BUDGET));
+  CHECK_EQ(g_logFirstSeq, 2);
+  CHECK_EQ(g_logHoles, 0);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, LOG_SEGMENT_RECORDS), LOG_SEGMENT_RECORDS + 10);
+}
+
+TEST(corruptRecordDropsSealedSegment) {
+  freshLog();
+  appendRange(0, 2 * LOG_SEGMENT_RECORDS + 10);   // 1, 2 uzavřené, 3 aktivní
+
+  // Překlopený bit v záznamu segmentu 1 (hlavička zůstala platná)
+  char path[32];
+  segmentPath(1, path);
+  File f = SPIFFS.open(path, "r+");
+  f.seek(LOG_RECORDS_OFFSET + 100 * sizeof(LogRecord) + 5, SeekSet);
+  uint8_t b = 0x40;
+  f.write(&b, 1);
+  f.close();
+
+  uint32_t corrupt = g_logCorrupt;
+  CHECK(logInit(BUDGET));
+  CHECK_EQ(g_logCorrupt, corrupt + 1);
+  CHECK(!SPIFFS.exists(path));
+  CHECK_EQ(g_logFirstSeq, 2);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, LOG_SEGMENT_RECORDS), LOG_SEGMENT_RECORDS + 10);
+}
+
+TEST(segmentResumedAfterRebootSealsWithFullCrc) {
+  freshLog();
+  appendRange(0, 100);
+  CHECK(logInit(BUDGET));                          // restart uprostřed segmentu
+  appendRange(100, LOG_SEGMENT_RECORDS);           // uzavře segment 1
+
+  uint32_t corrupt = g_logCorrupt;
+  CHECK(logInit(BUDGET));
+  CHECK_EQ(g_logCorrupt, corrupt);
+  CHECK_EQ(g_logHoles, 0);
+  CHECK_EQ(queryCount(0, 0xFFFFFFFF, 0), LOG_SEGMENT_RECORDS + 100);
+}
+
+FARM_TEST_MAIN()
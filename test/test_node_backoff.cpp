@@ -0,0 +1,273 @@
+// Připojení uzlu k hubu (FarmNode.h, FarmBackoff.h) na simulovaných
+// hodinách: čekání mezi pokusy, přechody stavového automatu a restart
+// hubu s 50 uzly (rozložení opětovných připojení v čase)
+
+#include "farm_test.h"
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WebSocketsClient.h>
+#include <FarmNode.h>
+
+static const char    *AP_SSID  = "FarmHub-AP";
+static const char    *AP_PASS  = "farmhub123";
+static const uint8_t  AP_BSSID[6] = { 0x5C, 0xCF, 0x7F, 0x00, 0x00, 0x01 };
+static const uint32_t TICK_MS  = 10;
+static const uint32_t FAST_JOIN_MS = 300 + 1500;   // profil: asociace + DHCP (časy shimu)
+
+static const FarmNodeConfig NET_CONFIG = {
+  AP_SSID, AP_PASS, "192.168.4.1", 80, "/ws", NODE_SOIL_DHT, "soilDHTsensor", nullptr
+};
+
+// Jeden uzel simulace. FarmNode, WiFi i RTC paměť jsou na desce jednou,
+// pro krok uzlu se proto jeho stav nahraje do globálních a zase uloží.
+struct SimNode {
+  FarmNodeLink     link;
+  ESP8266WiFiClass wifi;
+  WebSocketsClient ws;
+  FarmWifiProfile  rtc;
+  long             onlineAt;   // millis() návratu do ONLINE, -1 = ještě ne
+};
+
+static void nodeLoad(SimNode &s) {
+  g_farmNode = s.link;
+  WiFi       = s.wifi;
+  ESP.rtcUserMemoryWrite(FARM_NODE_RTC_OFFSET, (uint32_t *)&s.rtc, sizeof(s.rtc));
+}
+
+static void nodeStore(SimNode &s) {
+  s.link = g_farmNode;
+  s.wifi = WiFi;
+  ESP.rtcUserMemoryRead(FARM_NODE_RTC_OFFSET, (uint32_t *)&s.rtc, sizeof(s.rtc));
+}
+
+static void nodeBoot(SimNode &s, bool keepRtc = false) {
+  if (!keepRtc) farmWifiProfileInvalidate(s.rtc);
+  s.wifi     = ESP8266WiFiClass();
+  s.onlineAt = -1;
+  nodeLoad(s);
+  farmNodeBegin(s.ws, NET_CONFIG, nullptr);
+  nodeStore(s);
+}
+
+static void nodeStep(SimNode &s) {
+  nodeLoad(s);
+  farmNodeLoop();
+  nodeStore(s);
+}
+
+static void resetNetwork() {
+  hostWifiReset();
+  hostWifiSetNetwork(AP_SSID, AP_PASS, AP_BSSID, 6);
+  hostWsHubSetUp(true);
+}
+
+// Jeden uzel krokuje, dokud není ve stavu `state` (nebo vyprší limit)
+static bool runUntil(SimNode &s, FarmNodeState state, uint32_t limitMs) {
+  uint32_t start = millis();
+  while (millis() - start < limitMs) {
+    nodeStep(s);
+    if (s.link.state == state) return true;
+    delay(TICK_MS);
+  }
+  return false;
+}
+
+TEST(backoffDoublesWithJitterUpToMax) {
+  uint32_t rng = 12345;
+  for (uint8_t attempt = 1; attempt <= 12; attempt++) {
+    uint32_t wait = FARM_BACKOFF_BASE_MS << (attempt - 1);
+    if (attempt > 7 || wait > FARM_BACKOFF_MAX_MS) wait = FARM_BACKOFF_MAX_MS;
+    for (int i = 0; i < 200; i++) {
+      uint32_t ms = farmBackoffMs(attempt, rng);
+      CHECK(ms >= wait / 2 && ms <= wait);
+    }
+  }
+  // Semínko podle uzlu: různé uzly čekají různě dlouho
+  uint32_t a = 1, b = 2;
+  int same = 0;
+  for (int i = 0; i < 100; i++) same += farmBackoffMs(3, a) == farmBackoffMs(3, b);
+  CHECK(same < 10);
+}
+
+TEST(firstConnectIsNotDelayed) {
+  resetNetwork();
+  hostSetMillis(60000);
+  static SimNode node;
+  nodeBoot(node);
+
+  // Úplné připojení: sken + DHCP, pak WebSocket hned (bez čekání na interval)
+  uint32_t start = millis();
+  CHECK(runUntil(node, FARM_NODE_ONLINE, 30000));
+  uint32_t fullMs = millis() - start;
+  printf("  full join to online: %u ms\n", fullMs);
+  CHECK(fullMs <= 300 + 2000 + 1500 + 2 * TICK_MS);
+  CHECK_EQ(node.link.attempts, 0);
+  CHECK(node.ws.hostLastSent().find("\"proto\"") != std::string::npos);
+
+  // Reset uzlu s profilem v RTC: kanál + BSSID bez skenu, adresa z DHCP
+  nodeBoot(node, true);
+  start = millis();
+  CHECK(runUntil(node, FARM_NODE_ONLINE, 30000));
+  uint32_t fastMs = millis() - start;
+  printf("  fast join to online: %u ms\n", fastMs);
+  CHECK(fastMs <= FAST_JOIN_MS + 2 * TICK_MS);
+  CHECK_EQ(node.link.stats.fastJoins, 1u);
+}
+
+// Lease z minula mohl vypršet (hub po restartu rozdává adresy znovu):
+// uzel s profilem v RTC nesmí použít starou adresu
+TEST(fastJoinTakesFreshLease) {
+  resetNetwork();
+  static SimNode node;
+  nodeBoot(node);
+  CHECK(runUntil(node, FARM_NODE_ONLINE, 30000));
+  nodeLoad(node);
+  CHECK(WiFi.localIP() == IPAddress(192, 168, 1, 50));
+
+  hostWifiSetLease(IPAddress(192, 168, 4, 9), IPAddress(192, 168, 4, 1),
+                   IPAddress(255, 255, 255, 0), IPAddress(192, 168, 4, 1));
+  nodeBoot(node, true);
+  CHECK(runUntil(node, FARM_NODE_ONLINE, 30000));
+  CHECK_EQ(node.link.stats.fastJoins, 1u);
+  CHECK_EQ(node.link.stats.fastFallbacks, 0u);
+  nodeLoad(node);
+  CHECK(WiFi.localIP() == IPAddress(192, 168, 4, 9));
+  hostWifiSetLease(IPAddress(192, 168, 1, 50), IPAddress(192, 168, 1, 1),
+                   IPAddress(255, 255, 255, 0), IPAddress(192, 168, 1, 1));
+}
+
+TEST(stateTransitionsOnHubOutage) {
+  resetNetwork();
+  static SimNode node;
+  nodeBoot(node);
+  CHECK(runUntil(node, FARM_NODE_ONLINE, 30000));
+
+  // Hello -> WELCOME: uzel přejde na binární protokol
+  uint8_t frame[FARM_HEADER_SIZE + 1];
+  FarmWriter w;
+  farmBegin(w, frame, sizeof(frame), MSG_WELCOME, NODE_HUB, 0);
+  farmPutU8(w, FARM_PROTO_VERSION);
+  node.ws.hostDeliver(WStype_BIN, frame, farmEnd(w));
+  CHECK(farmNodeBinary());
+
+  // Hub spadne (Wi-Fi zůstává): výpadek, první čekání 0,5–1 s
+  hostWsHubSetUp(false);
+  uint32_t down = millis();
+  nodeStep(node);
+  CHECK_EQ(node.link.state, FARM_NODE_BACKOFF);
+  CHECK_EQ(node.link.attempts, 1);
+  CHECK_EQ(node.link.stats.drops, 1u);
+  CHECK(node.link.waitMs >= FARM_BACKOFF_BASE_MS / 2 && node.link.waitMs <= FARM_BACKOFF_BASE_MS);
+  CHECK(!node.link.binary);
+
+  // Po čekání se připojuje jen WebSocket (Wi-Fi je spojená), bez hubu
+  // vyprší FARM_NODE_CONNECT_MS a čekání se zdvojnásobí
+  CHECK(runUntil(node, FARM_NODE_CONNECTING, 2000));
+  CHECK_EQ(hostWifi().begins, 1u);
+  CHECK(runUntil(node, FARM_NODE_BACKOFF, FARM_NODE_CONNECT_MS + 100));
+  CHECK_EQ(node.link.attempts, 2);
+  CHECK(node.link.waitMs >= FARM_BACKOFF_BASE_MS && node.link.waitMs <= 2 * FARM_BACKOFF_BASE_MS);
+  CHECK(node.ws.hostAttempts() >= FARM_NODE_CONNECT_MS / FARM_NODE_WS_RETRY_MS);
+
+  // Hub je zpět: připojení, počítadlo pokusů se nuluje, délka výpadku
+  hostWsHubSetUp(true);
+  CHECK(runUntil(node, FARM_NODE_ONLINE, 5000));
+  CHECK_EQ(node.link.attempts, 0);
+  CHECK_EQ(node.link.stats.failures, 1u);
+  CHECK(node.link.stats.lastOutageMs >= millis() - down - 5000);
+  CHECK(node.link.stats.lastOutageMs <= millis() - down);
+
+  // Ztráta Wi-Fi: znovu WiFi.begin() po čekání, ne jen WebSocket
+  uint32_t begins = hostWifi().begins;
+  hostWifiSetLink(false);
+  nodeStep(node);
+  CHECK_EQ(node.link.state, FARM_NODE_BACKOFF);
+  CHECK(runUntil(node, FARM_NODE_JOINING, 2000));
+  CHECK_EQ(hostWifi().begins, begins + 1);
+  hostWifiSetLink(true);
+  CHECK(runUntil(node, FARM_NODE_ONLINE, 30000));
+}
+
+// Restart hubu: AP i WebSocket zmizí, AP je zpět po HUB_AP_MS,
+// server /ws po HUB_WS_MS. Pokusy o spojení a spojení přijatá hubem se
+// sčítají po 100 ms. Bez odkladu WebSocketu po výpadku se všech 50 uzlů
+// připojilo v jednom okamžiku (AP se objeví všem současně).
+static const uint8_t  FLEET      = 50;
+static const uint32_t HUB_AP_MS  = 2000;
+static const uint32_t HUB_WS_MS  = 2500;
+static const uint32_t SIM_MS     = 90000;
+static const uint32_t BUCKET_MS  = 100;
+
+TEST(hubRestartWithFiftyNodes) {
+  resetNetwork();
+  static SimNode fleet[FLEET];
+  for (SimNode &s : fleet) nodeBoot(s);
+
+  // Všechny uzly online (ustálený stav před restartem)
+  uint32_t start = millis();
+  bool allOnline = false;
+  while (!allOnline && millis() - start < 60000) {
+    allOnline = true;
+    for (SimNode &s : fleet) {
+      nodeStep(s);
+      allOnline = allOnline && s.link.state == FARM_NODE_ONLINE;
+    }
+    delay(TICK_MS);
+  }
+  CHECK(allOnline);
+
+  hostWifiSetLink(false);
+  hostWsHubSetUp(false);
+  uint32_t t0 = millis();
+  uint32_t wsBuckets[SIM_MS / BUCKET_MS]      = { 0 };
+  uint32_t acceptBuckets[SIM_MS / BUCKET_MS]  = { 0 };
+  uint32_t joinBuckets[SIM_MS / BUCKET_MS]    = { 0 };
+  uint32_t online = 0;
+
+  while (millis() - t0 < SIM_MS && online < FLEET) {
+    uint32_t elapsed = millis() - t0;
+    if (elapsed >= HUB_AP_MS && !hostWifiLinkUp()) hostWifiSetLink(true);
+    if (elapsed >= HUB_WS_MS && !hostWsHubUp()) hostWsHubSetUp(true);
+
+    uint32_t begins  = hostWifi().begins;
+    uint32_t accepts = hostWsHubConnects();
+    for (SimNode &s : fleet) {
+      uint32_t attempts = s.ws.hostAttempts();
+      nodeStep(s);
+      wsBuckets[elapsed / BUCKET_MS] += s.ws.hostAttempts() - attempts;
+      if (s.onlineAt < 0 && s.link.state == FARM_NODE_ONLINE && elapsed >= HUB_WS_MS) {
+        s.onlineAt = (long)elapsed;
+        online++;
+      }
+    }
+    joinBuckets[elapsed / BUCKET_MS]   += hostWifi().begins - begins;
+    acceptBuckets[elapsed / BUCKET_MS] += hostWsHubConnects() - accepts;
+    delay(TICK_MS);
+  }
+  CHECK_EQ(online, (uint32_t)FLEET);
+
+  long times[FLEET];
+  for (uint8_t i = 0; i < FLEET; i++) times[i] = fleet[i].onlineAt;
+  std::sort(times, times + FLEET);
+  uint32_t wsPeak = 0, acceptPeak = 0, joinPeak = 0;
+  for (uint32_t b = 0; b < SIM_MS / BUCKET_MS; b++) {
+    wsPeak     = std::max(wsPeak, wsBuckets[b]);
+    acceptPeak = std::max(acceptPeak, acceptBuckets[b]);
+    joinPeak   = std::max(joinPeak, joinBuckets[b]);
+  }
+  printf("  %u nodes back online after restart: first %ld ms, median %ld ms, "
+         "90%% %ld ms, last %ld ms\n", (unsigned)FLEET, times[0], times[FLEET / 2],
+         times[FLEET * 9 / 10], times[FLEET - 1]);
+  printf("  peak per %u ms: %u WebSocket attempts, %u accepted, %u WiFi.begin()\n",
+         (unsigned)BUCKET_MS, wsPeak, acceptPeak, joinPeak);
+
+  // Uzly se vrátí do pár sekund po hubu a nepřipojují se všechny naráz
+  uint32_t ready = std::max(HUB_WS_MS, HUB_AP_MS + FAST_JOIN_MS);
+  CHECK(times[FLEET - 1] <= (long)(ready + FARM_NODE_CONNECT_JITTER_MS + FARM_NODE_WS_RETRY_MS));
+  CHECK(times[FLEET - 1] - times[0] >= (long)FARM_NODE_CONNECT_JITTER_MS / 2);
+  CHECK(acceptPeak < FLEET / 2);
+  CHECK(wsPeak < FLEET / 2);
+  CHECK(joinPeak < FLEET / 2);
+}
+
+FARM_TEST_MAIN()
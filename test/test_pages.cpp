@@ -0,0 +1,204 @@
+// Stránky hubu po částech (PageWriter, sendRendered): špička haldy na
+// request a konzistence stránky, když se data změní mezi částmi
+
+#include "farm_test.h"
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include "FarmHub.ino"
+
+// Horní mez špičky haldy na jednu stránku včetně requestu a odpovědi
+// shimu. PageWriter sám nealokuje; navíc smí stránka jen svůj snapshot.
+static const size_t PAGE_HEAP_BUDGET = 1024;
+
+struct PageCase {
+  const char *url;
+  size_t      snapshot;   // B navíc pro zafixovaná data
+};
+
+static bool g_booted = false;
+
+static void boot() {
+  if (g_booted) return;
+  g_booted = true;
+  setup();
+  for (int i = 0; i < 20; i++) loop();
+}
+
+static void storeSoil(float soil) {
+  SensorReading sr;
+  memset(&sr, 0, sizeof(sr));
+  sr.sensorId     = SENSOR_SOIL_DHT;
+  sr.fields       = (1 << FIELD_SOIL) | (1 << FIELD_TEMP) | (1 << FIELD_HUM);
+  sr.soilMoisture = soil;
+  sr.temperature  = 21.5f;
+  sr.humidity     = 48.0f;
+  sr.timestamp    = hubNow();
+  storeSensorData(sr);
+}
+
+TEST(peakHeapPerPage) {
+  boot();
+  for (int i = 0; i < 40; i++) storeSoil(30.0f + i);
+
+  const PageCase pages[] = {
+    { "/",                    0 },
+    { "/charts",              0 },
+    { "/history",             10 * sizeof(SensorReading) },
+    { "/history?limit=20",    20 * sizeof(SensorReading) },
+    { "/wifi",                WIFI_PAGE_MAX_NETWORKS * 33 + 16 },
+    { "/watering",            sizeof(g_zones) },
+    { "/lighting",            0 },
+    { "/sensors",             0 },
+    { "/metrics",             sizeof(MetricsSnapshot) },
+    { "/metrics?format=json", sizeof(MetricsSnapshot) },
+  };
+  printf("  %-22s %8s %8s %8s %6s %6s\n", "page", "body B", "peak B", "limit B", "allocs", "fills");
+  for (const PageCase &p : pages) {
+    HostHttpResponse r = hostHttp(HTTP_GET, p.url);
+    size_t limit = PAGE_HEAP_BUDGET + p.snapshot;
+    printf("  %-22s %8u %8u %8u %6llu %6u\n", p.url, (unsigned)r.body.size(),
+           (unsigned)r.heapPeak, (unsigned)limit, (unsigned long long)r.heapAllocs,
+           (unsigned)r.fills);
+    CHECK_EQ(r.code, 200);
+    CHECK(r.heapPeak < limit);
+  }
+}
+
+// Každá část stránky se vykresluje znovu od začátku. Změna dat během
+// odesílání (nové měření, posun hodin, uložený formulář, doběhnutý sken)
+// se nesmí do rozeslané stránky promítnout napůl – stránka musí být celá
+// taková, jaká byla při requestu.
+typedef void (*DataChange)();
+
+static DataChange g_hookChange = nullptr;
+static float      g_hookSoil   = 0;
+
+static void changeDataMidResponse(uint32_t fill) {
+  if (fill != 1 || !g_hookChange) return;
+  g_hookChange();
+}
+
+static void newReadingAndMinute() {
+  storeSoil(g_hookSoil);
+  delay(61000);
+}
+
+// Volná halda na stránce "/" je ze začátku requestu, a ten se v testu
+// liší podle toho, co drží předchozí odpovědi
+static std::string withoutFreeHeap(const std::string &body) {
+  size_t from = body.find("Volné místo v RAM");
+  if (from == std::string::npos) return body;
+  size_t to = body.find("</p>", from);
+  return body.substr(0, from) + body.substr(to);
+}
+
+// `marker` je v odpovědi jen po změně
+static void checkSnapshot(const char *url, DataChange change, const char *marker) {
+  hostHttpSetWindow(256);     // hodně malých částí
+  HostHttpResponse before = hostHttp(HTTP_GET, url);
+
+  g_hookChange = change;
+  hostHttpSetChunkHook(changeDataMidResponse);
+  HostHttpResponse during = hostHttp(HTTP_GET, url);
+  hostHttpSetChunkHook(nullptr);
+  g_hookChange = nullptr;
+
+  HostHttpResponse after = hostHttp(HTTP_GET, url);
+  hostHttpSetWindow(1460);
+
+  CHECK(during.fills > 2);
+  if (withoutFreeHeap(during.body) != withoutFreeHeap(before.body)) {
+    printf("  %s changed mid-response\n", url);
+  }
+  CHECK(withoutFreeHeap(during.body) == withoutFreeHeap(before.body));
+  CHECK(during.body.find(marker) == std::string::npos);
+  CHECK(after.body.find(marker) != std::string::npos);
+}
+
+static void checkSoilSnapshot(const char *url, float newSoil) {
+  char marker[16];
+  snprintf(marker, sizeof(marker), "%.2f", newSoil);
+  g_hookSoil = newSoil;
+  checkSnapshot(url, newReadingAndMinute, marker);
+}
+
+TEST(overviewIsSnapshotAtRequest) {
+  boot();
+  storeSoil(42.0f);
+  checkSoilSnapshot("/", 77.25f);
+}
+
+TEST(historyIsSnapshotAtRequest) {
+  boot();
+  checkSoilSnapshot("/history?limit=30", 88.75f);
+}
+
+// Sken doběhne a přestaví seznam sítí
+static void finishScan() {
+  delay(5000);
+  checkAsyncScan();
+}
+
+TEST(wifiIsSnapshotAtRequest) {
+  boot();
+  static const uint8_t bssid[6] = { 0x18, 0xE8, 0x29, 0x00, 0x00, 0x01 };
+  hostWifiSetNetwork("Zahrada", "rajcata2024", bssid, 6);
+  startAsyncScan();
+  checkSnapshot("/wifi", finishScan, "Zahrada");
+  hostWifiReset();
+}
+
+// Jako uložení formuláře /setlightauto a /setlightmanual
+static void saveLightForm() {
+  manualLightOn    = !manualLightOn;
+  autoLight        = !autoLight;
+  lightStartHour   = 17;
+  lightStartMinute = 43;
+  lightDays        = 0x41;
+}
+
+TEST(lightingIsSnapshotAtRequest) {
+  boot();
+  checkSnapshot("/lighting", saveLightForm, "name='startM' value='43'");
+}
+
+// Jako uložení formuláře /setwatering
+static void saveWateringForm() {
+  autoWatering      = !autoWatering;
+  moistureThreshold = 33.0f;
+  waterAmountML     = 321;
+  soakMinutes       = 12;
+  maxPumpSecPerHour = 99;
+}
+
+TEST(wateringIsSnapshotAtRequest) {
+  boot();
+  checkSnapshot("/watering", saveWateringForm, "value='321'");
+}
+
+// Hodnoty od uzlů nejsou ověřené: i float řádu 1e38 se musí vypsat celý
+// a nesmí se číst za koncem bufferu čísla
+TEST(hugeReadingsRender) {
+  boot();
+  uint8_t    out[128];
+  PageWriter w(out, sizeof(out), 0);
+  w.printFloat(3.0e38f, 255);
+  CHECK(w.length() < 48);
+  w.printFloat(-3.0e38f);
+  w.printULL(~0ULL);
+
+  const float huge = 3.0e38f;
+  char expect[64];
+  snprintf(expect, sizeof(expect), "%.2f", huge);
+  storeSoil(huge);
+  const char *pages[] = { "/", "/history" };
+  for (const char *url : pages) {
+    HostHttpResponse r = hostHttp(HTTP_GET, url);
+    CHECK_EQ(r.code, 200);
+    CHECK(r.body.find(expect) != std::string::npos);
+    CHECK(r.body.find("</html>") != std::string::npos);
+  }
+}
+
+FARM_TEST_MAIN()
@@ -0,0 +1,81 @@
+// Kruhový buffer (FarmHubRingBuffer.h): kapacita, přepis nejstaršího
+// a pořadí přístupu at() / fromNewest()
+
+#include "farm_test.h"
+#include "FarmHubRingBuffer.h"
+
+struct Item {
+  uint32_t seq;
+  uint8_t  tag;
+};
+
+TEST(startsEmpty) {
+  RingBuffer<Item, 4> rb;
+  CHECK(rb.empty());
+  CHECK(!rb.full());
+  CHECK_EQ(rb.size(), 0);
+  CHECK_EQ(rb.capacity(), 4);
+  CHECK_EQ(rb.pushedCount(), 0);
+}
+
+TEST(fillsInTimeOrder) {
+  RingBuffer<Item, 4> rb;
+  for (uint32_t i = 0; i < 3; i++) rb.push({ i, (uint8_t)(10 + i) });
+  CHECK_EQ(rb.size(), 3);
+  CHECK(!rb.full());
+  for (uint32_t i = 0; i < 3; i++) CHECK_EQ(rb.at(i).seq, i);
+  CHECK_EQ(rb.newest().seq, 2);
+  CHECK_EQ(rb.fromNewest(0).seq, 2);
+  CHECK_EQ(rb.fromNewest(2).seq, 0);
+}
+
+TEST(overwritesOldestWhenFull) {
+  RingBuffer<Item, 4> rb;
+  for (uint32_t i = 0; i < 10; i++) rb.push({ i, 0 });
+  CHECK(rb.full());
+  CHECK_EQ(rb.size(), 4);
+  CHECK_EQ(rb.pushedCount(), 10);
+  // Zůstaly poslední čtyři: 6..9, nejstarší na indexu 0
+  for (uint32_t i = 0; i < 4; i++) CHECK_EQ(rb.at(i).seq, 6 + i);
+  for (uint32_t i = 0; i < 4; i++) CHECK_EQ(rb.fromNewest(i).seq, 9 - i);
+}
+
+TEST(orderHoldsAcrossManyWraps) {
+  RingBuffer<Item, 7> rb;   // kapacita nesoudělná s počtem vložení
+  for (uint32_t n = 1; n <= 100; n++) {
+    rb.push({ n, 0 });
+    size_t expect = n < 7 ? n : 7;
+    CHECK_EQ(rb.size(), expect);
+    CHECK_EQ(rb.newest().seq, n);
+    CHECK_EQ(rb.at(0).seq, n - expect + 1);
+    for (size_t i = 1; i < rb.size(); i++) CHECK_EQ(rb.at(i).seq, rb.at(i - 1).seq + 1);
+  }
+}
+
+TEST(clearKeepsPushedCount) {
+  RingBuffer<Item, 4> rb;
+  for (uint32_t i = 0; i < 6; i++) rb.push({ i, 0 });
+  rb.clear();
+  CHECK(rb.empty());
+  CHECK_EQ(rb.pushedCount(), 6);
+  rb.push({ 42, 0 });
+  CHECK_EQ(rb.size(), 1);
+  CHECK_EQ(rb.at(0).seq, 42);
+  CHECK_EQ(rb.newest().seq, 42);
+}
+
+TEST(atAllowsInPlaceUpdate) {
+  // Oprava prozatímního času (correctProvisionalReadings) přepisuje záznamy na místě
+  RingBuffer<Item, 3> rb;
+  for (uint32_t i = 0; i < 5; i++) rb.push({ i, 0 });
+  for (size_t i = 0; i < rb.size(); i++) rb.at(i).tag = 7;
+  for (size_t i = 0; i < rb.size(); i++) CHECK_EQ(rb.fromNewest(i).tag, 7);
+  CHECK_EQ(rb.at(0).seq, 2);
+}
+
+TEST(storageIsInline) {
+  // Žádná halda: velikost je jen pole záznamů plus čítače
+  CHECK(sizeof(RingBuffer<Item, 300>) <= 300 * sizeof(Item) + 3 * sizeof(size_t));
+}
+
+FARM_TEST_MAIN()
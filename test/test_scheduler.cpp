@@ -0,0 +1,189 @@
+// Plánovač úloh (FarmHubScheduler.h) se stovkami úloh
+//
+// Překládá se s FARMHUB_SCHED_MAX_TASKS = TASKS (viz CMakeLists.txt).
+// Se simulovanými hodinami ověřuje pořadí podle termínů, nulové zpoždění
+// a to, že loop() spí až do další úlohy; se skutečnými hodinami měří
+// režii průchodu a jitter (řádky BENCH).
+
+#include "farm_test.h"
+#include "farm_bench.h"
+#include <array>
+#include <utility>
+#include "FarmHubScheduler.h"
+
+static const uint8_t TASKS = SCHED_MAX_TASKS;
+static_assert(TASKS >= 200, "test počítá se zvětšenou tabulkou úloh");
+
+static uint32_t g_runAt[4096];     // millis() jednotlivých běhů
+static uint8_t  g_runTask[4096];   // která úloha běžela
+static uint32_t g_runCount = 0;
+static uint32_t g_taskRuns[TASKS];
+static uint8_t  g_ids[TASKS];      // id v plánovači podle čísla úlohy
+
+template <size_t N>
+static void taskFn() {
+  if (g_runCount < sizeof(g_runAt) / sizeof(g_runAt[0])) {
+    g_runAt[g_runCount]   = millis();
+    g_runTask[g_runCount] = N;
+  }
+  g_runCount++;
+  g_taskRuns[N]++;
+}
+
+template <size_t... I>
+static std::array<SchedFn, sizeof...(I)> makeTaskFns(std::index_sequence<I...>) {
+  return {{ &taskFn<I>... }};
+}
+static const std::array<SchedFn, TASKS> TASK_FNS = makeTaskFns(std::make_index_sequence<TASKS>());
+
+static uint32_t g_rng = 12345;
+static uint32_t nextRandom() {
+  g_rng ^= g_rng << 13;
+  g_rng ^= g_rng >> 17;
+  g_rng ^= g_rng << 5;
+  return g_rng;
+}
+
+static void resetScheduler() {
+  for (uint8_t id = 0; id < SCHED_MAX_TASKS; id++) schedulerCancel(id);
+  memset(&g_schedStats, 0, sizeof(g_schedStats));
+  memset(g_taskRuns, 0, sizeof(g_taskRuns));
+  g_runCount = 0;
+  hostUseRealClock(false);
+  hostSetMillis(1000000);
+}
+
+static void loopUntil(uint32_t endMs) {
+  while (schedBefore(millis(), endMs)) schedulerLoop();
+}
+
+static uint32_t maxLateMs() {
+  uint32_t late = 0;
+  for (uint8_t id = 0; id < SCHED_MAX_TASKS; id++) {
+    if (g_tasks[id].used && g_tasks[id].maxLateMs > late) late = g_tasks[id].maxLateMs;
+  }
+  return late;
+}
+
+TEST(oneShotsRunInDeadlineOrder) {
+  resetScheduler();
+  uint32_t start = millis();
+  uint32_t due[TASKS];
+  for (uint8_t i = 0; i < TASKS; i++) {
+    uint32_t delayMs = nextRandom() % 5000;
+    due[i]   = start + delayMs;
+    g_ids[i] = schedulerOnce("once", TASK_FNS[i], delayMs);
+    CHECK(g_ids[i] != SCHED_NONE);
+  }
+  CHECK_EQ(schedulerOnce("extra", TASK_FNS[0], 1), SCHED_NONE);   // tabulka je plná
+
+  loopUntil(start + 6000);
+  CHECK_EQ(g_runCount, TASKS);
+  for (uint32_t r = 0; r < g_runCount; r++) {
+    CHECK_EQ(g_runAt[r], due[g_runTask[r]]);   // přesně v termínu
+    if (r > 0) CHECK(!schedBefore(g_runAt[r], g_runAt[r - 1]));
+  }
+  // Jednorázové úlohy uvolnily sloty
+  CHECK_EQ(g_schedHeapSize, 0);
+  CHECK(schedulerOnce("again", TASK_FNS[0], 1) != SCHED_NONE);
+}
+
+TEST(periodicTasksKeepTheirRate) {
+  resetScheduler();
+  uint32_t start = millis();
+  for (uint8_t i = 0; i < TASKS; i++) {
+    g_ids[i] = schedulerEvery("every", TASK_FNS[i], 10 + i * 7);
+  }
+  const uint32_t SPAN = 20000;
+  loopUntil(start + SPAN);
+  for (uint8_t i = 0; i < TASKS; i++) {
+    uint32_t period = 10 + i * 7;
+    CHECK_EQ(g_taskRuns[i], (SPAN - 1) / period + 1);
+    CHECK_EQ(g_tasks[g_ids[i]].maxLateMs, 0);
+  }
+  CHECK_EQ(maxLateMs(), 0);
+  // Probouzí se jen kvůli úlohám: průchodů nejvýš tolik, kolik bylo
+  // různých termínů (+ první průchod), ne každých 50 ms
+  CHECK(g_schedStats.wakeups <= g_schedStats.tasksRun + 1);
+  CHECK_EQ(g_schedStats.sleptMs, SPAN);
+}
+
+TEST(idleLoopSleepsUntilNextTask) {
+  resetScheduler();
+  uint32_t start = millis();
+  schedulerEvery("display", TASK_FNS[0], 2000);
+  loopUntil(start + 60000);
+  CHECK_EQ(g_taskRuns[0], 30);
+  // Spánek je omezen na SCHED_MAX_SLEEP_MS; dříve delay(50) => 1200 průchodů
+  CHECK_EQ(g_schedStats.wakeups, 60000 / SCHED_MAX_SLEEP_MS);
+
+  // Bez úloh spí po SCHED_MAX_SLEEP_MS
+  resetScheduler();
+  start = millis();
+  loopUntil(start + 10000);
+  CHECK_EQ(g_schedStats.wakeups, 10000 / SCHED_MAX_SLEEP_MS);
+}
+
+TEST(cancelAndRescheduleUnderChurn) {
+  resetScheduler();
+  uint32_t start = millis();
+  for (uint8_t i = 0; i < TASKS; i++) g_ids[i] = schedulerOnce("churn", TASK_FNS[i], 1000 + i);
+
+  // Zrušit každou třetí, každou pátou posunout dopředu, zbytek nechat
+  uint32_t expected = 0;
+  uint32_t due[TASKS];
+  for (uint8_t i = 0; i < TASKS; i++) {
+    due[i] = start + 1000 + i;
+    if (i % 3 == 0) {
+      schedulerCancel(g_ids[i]);
+      continue;
+    }
+    if (i % 5 == 0) {
+      schedulerRunIn(g_ids[i], 10 + i);
+      due[i] = start + 10 + i;
+    }
+    expected++;
+  }
+  loopUntil(start + 2000);
+  CHECK_EQ(g_runCount, expected);
+  for (uint32_t r = 0; r < g_runCount; r++) {
+    CHECK(g_runTask[r] % 3 != 0);
+    CHECK_EQ(g_runAt[r], due[g_runTask[r]]);
+    if (r > 0) CHECK(!schedBefore(g_runAt[r], g_runAt[r - 1]));
+  }
+  CHECK_EQ(g_schedHeapSize, 0);
+}
+
+// Skutečné hodiny: plná tabulka periodických úloh s periodou 1–4 ms,
+// režie = čas průchodů, které něco spustily, bez doby běhu úloh
+TEST(dispatchOverheadAndJitter) {
+  resetScheduler();
+  hostUseRealClock(true);
+  for (uint8_t i = 0; i < TASKS; i++) g_ids[i] = schedulerEvery("bench", TASK_FNS[i], 1 + i % 4);
+
+  HostBench b;
+  hostBenchBegin(b, "schedulerDispatch", TASKS);
+  uint32_t start = millis();
+  uint32_t busyUs = 0;
+  while (millis() - start < 1000) {
+    uint32_t runs = g_schedStats.tasksRun;
+    uint32_t t0   = micros();
+    schedulerRunDue();
+    if (g_schedStats.tasksRun != runs) busyUs += micros() - t0;
+  }
+  uint32_t taskUs     = g_schedStats.busyUs;
+  uint32_t overheadUs = busyUs > taskUs ? busyUs - taskUs : 0;
+  uint32_t runs       = g_schedStats.tasksRun;
+  uint32_t late       = maxLateMs();
+  printf("BENCH {\"name\":\"schedulerOverhead\",\"param\":%u,\"ops\":%lu,\"us\":%lu,"
+         "\"usPerOp\":%.3f,\"bytes\":0,\"maxLateMs\":%lu}\n",
+         TASKS, (unsigned long)runs, (unsigned long)overheadUs,
+         runs ? (double)overheadUs / runs : 0.0, (unsigned long)late);
+  hostBenchEnd(b, runs);
+
+  CHECK(runs > TASKS * 100);
+  CHECK(runs ? (double)overheadUs / runs < 20.0 : false);
+  resetScheduler();
+}
+
+FARM_TEST_MAIN()
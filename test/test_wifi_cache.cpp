@@ -0,0 +1,225 @@
+// Profil rychlého připojení k Wi-Fi (FarmWifiCache.h) a jeho použití
+// v hubu (FarmHubWiFi.h) na simulovaných hodinách: úplné připojení profil
+// uloží, další je bez skenu (adresa z DHCP, i když se lease změnil), po
+// přesunu AP rychlé připojení selže, profil se zneplatní a hned následuje
+// úplné. Výpadek navázaného spojení profil nemaže.
+
+#include "farm_test.h"
+#include <Arduino.h>
+#include <FS.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncWebServer.h>
+#include "FarmHub.ino"
+
+static const char    *HOME_SSID     = "Zahrada";
+static const char    *HOME_PASS     = "rajcata2024";
+static const uint8_t  HOME_BSSID[6] = { 0x18, 0xE8, 0x29, 0x00, 0x00, 0x01 };
+static const uint8_t  MOVED_BSSID[6] = { 0x18, 0xE8, 0x29, 0x00, 0x00, 0x02 };
+
+// Časy shimu: asociace 300 ms, sken 2000 ms, DHCP 1500 ms
+static const uint32_t FULL_JOIN_MS = 300 + 2000 + 1500;
+static const uint32_t FAST_JOIN_MS = 300 + 1500;
+
+static bool g_booted = false;
+
+static void boot() {
+  if (g_booted) return;
+  g_booted = true;
+  setup();
+  for (int i = 0; i < 20; i++) loop();
+}
+
+static void runFor(uint32_t ms) {
+  uint32_t start = millis();
+  while (millis() - start < ms) loop();
+}
+
+// Smyčka hubu, dokud není domácí Wi-Fi ve stavu `state` (nebo vyprší limit)
+static bool runUntil(HomeWifiState state, uint32_t limitMs) {
+  uint32_t start = millis();
+  while (millis() - start < limitMs) {
+    loop();
+    if (g_homeWifi == state) return true;
+  }
+  return false;
+}
+
+// Čistá síť a hub bez profilu; údaje jako po uložení formuláře /wifi
+static void resetHome() {
+  boot();
+  homeWifiBegin("", "");
+  hostWifiReset();
+  hostWifiSetNetwork(HOME_SSID, HOME_PASS, HOME_BSSID, 6);
+  homeSsid = HOME_SSID;
+  homePass = HOME_PASS;
+  farmWifiProfileInvalidate(homeWifiProfile);
+  saveUserConfig();
+}
+
+static FarmWifiProfile sampleProfile() {
+  FarmWifiProfile p;
+  farmWifiProfileStore(p, HOME_SSID, HOME_BSSID, 6);
+  return p;
+}
+
+TEST(profileValidOnlyForItsNetwork) {
+  FarmWifiProfile p = sampleProfile();
+  CHECK(farmWifiProfileValid(p, HOME_SSID));
+  CHECK_EQ(farmWifiJoinMode(p, HOME_SSID), FARM_JOIN_FAST);
+  CHECK_EQ(farmWifiJoinMode(p, "Soused"), FARM_JOIN_FULL);
+
+  // Poškozená paměť (RTC po výpadku napájení, přepsaný config)
+  FarmWifiProfile bad = p;
+  bad.bssid[3] ^= 0x10;
+  CHECK(!farmWifiProfileValid(bad, HOME_SSID));
+
+  bad = p;
+  farmWifiProfileInvalidate(bad);
+  CHECK_EQ(farmWifiJoinMode(bad, HOME_SSID), FARM_JOIN_FULL);
+
+  FarmWifiProfile zeroed;
+  memset(&zeroed, 0, sizeof(zeroed));
+  CHECK(!farmWifiProfileValid(zeroed, HOME_SSID));
+}
+
+TEST(profileRejectsInvalidChannel) {
+  const uint8_t channels[] = { 0, 15 };
+  for (uint8_t ch : channels) {
+    FarmWifiProfile p;
+    farmWifiProfileStore(p, HOME_SSID, HOME_BSSID, ch);
+    CHECK(!farmWifiProfileValid(p, HOME_SSID));
+  }
+}
+
+TEST(hubFullJoinStoresProfileThenJoinsFast) {
+  resetHome();
+
+  // První start: sken + DHCP, profil do /config.json
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FULL);
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  printf("  full join: %u ms\n", (unsigned)g_homeWifiJoinMs);
+  CHECK(g_homeWifiJoinMs >= FULL_JOIN_MS);
+  CHECK(g_homeWifiJoinMs < FULL_JOIN_MS + HOME_WIFI_POLL_MS);
+  CHECK(farmWifiProfileValid(homeWifiProfile, HOME_SSID));
+  CHECK_EQ(homeWifiProfile.channel, 6);
+  CHECK(memcmp(homeWifiProfile.bssid, HOME_BSSID, 6) == 0);
+
+  // Restart hubu: profil z configu, kanál + BSSID bez skenu
+  farmWifiProfileInvalidate(homeWifiProfile);
+  loadUserConfig();
+  CHECK(farmWifiProfileValid(homeWifiProfile, HOME_SSID));
+  uint32_t scans = hostWifi().scans;
+  uint32_t fast  = hostWifi().fastBegins;
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FAST);
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  printf("  fast join: %u ms\n", (unsigned)g_homeWifiJoinMs);
+  CHECK(g_homeWifiJoinMs >= FAST_JOIN_MS);
+  CHECK(g_homeWifiJoinMs < FAST_JOIN_MS + HOME_WIFI_POLL_MS);
+  CHECK_EQ(hostWifi().fastBegins, fast + 1);
+  CHECK_EQ(hostWifi().scans, scans);
+  CHECK(WiFi.localIP() == IPAddress(192, 168, 1, 50));
+}
+
+TEST(hubFallsBackToFullJoinWhenApMoved) {
+  resetHome();
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+
+  // Router vyměněný a na jiném kanálu: rychlé připojení nikdy neprojde
+  hostWifiSetNetwork(HOME_SSID, HOME_PASS, MOVED_BSSID, 11);
+  uint32_t begins = hostWifi().begins;
+  uint32_t start  = millis();
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FAST);
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  uint32_t totalMs = millis() - start;
+  printf("  fast join failed, full join: %u ms total\n", (unsigned)totalMs);
+
+  // Limit rychlého připojení, pak hned úplné (ne až po HOME_WIFI_RETRY_MS)
+  CHECK_EQ(hostWifi().begins, begins + 2);
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FULL);
+  CHECK(totalMs >= FARM_WIFI_FAST_JOIN_MS + FULL_JOIN_MS);
+  CHECK(totalMs < FARM_WIFI_FAST_JOIN_MS + FULL_JOIN_MS + 2 * HOME_WIFI_POLL_MS);
+
+  // Nový profil je uložený i v configu
+  farmWifiProfileInvalidate(homeWifiProfile);
+  loadUserConfig();
+  CHECK(farmWifiProfileValid(homeWifiProfile, HOME_SSID));
+  CHECK_EQ(homeWifiProfile.channel, 11);
+  CHECK(memcmp(homeWifiProfile.bssid, MOVED_BSSID, 6) == 0);
+}
+
+// Lease z minula mohl vypršet: rychlé připojení si adresu bere z DHCP,
+// i když ji router mezitím změnil (jiná adresa, jiná podsíť)
+TEST(fastJoinTakesFreshLease) {
+  resetHome();
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  CHECK(WiFi.localIP() == IPAddress(192, 168, 1, 50));
+
+  hostWifiSetLease(IPAddress(10, 0, 7, 23), IPAddress(10, 0, 7, 1),
+                   IPAddress(255, 255, 255, 0), IPAddress(10, 0, 7, 1));
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FAST);
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FAST);
+  CHECK(WiFi.localIP() == IPAddress(10, 0, 7, 23));
+  CHECK(WiFi.gatewayIP() == IPAddress(10, 0, 7, 1));
+  CHECK(farmWifiProfileValid(homeWifiProfile, HOME_SSID));
+  hostWifiSetLease(IPAddress(192, 168, 1, 50), IPAddress(192, 168, 1, 1),
+                   IPAddress(255, 255, 255, 0), IPAddress(192, 168, 1, 1));
+}
+
+TEST(linkDropKeepsProfile) {
+  resetHome();
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FAST);
+  FarmWifiProfile saved = homeWifiProfile;
+
+  // Výpadek AP delší než limit rychlého připojení: SDK se připojí samo
+  uint32_t begins = hostWifi().begins;
+  hostWifiSetLink(false);
+  CHECK(runUntil(HOME_WIFI_RECONNECTING, 2000));
+  runFor(FARM_WIFI_FAST_JOIN_MS + 2000);
+  CHECK_EQ(g_homeWifi, HOME_WIFI_RECONNECTING);
+  CHECK(farmWifiProfileValid(homeWifiProfile, HOME_SSID));
+  hostWifiSetLink(true);
+  CHECK(runUntil(HOME_WIFI_CONNECTED, FAST_JOIN_MS + HOME_WIFI_POLL_MS));
+  CHECK_EQ(hostWifi().begins, begins);
+  CHECK(memcmp(&homeWifiProfile, &saved, sizeof(saved)) == 0);
+
+  // Ani výpadek přes HOME_WIFI_JOIN_MS profil nemaže: další pokus je rychlý
+  hostWifiSetLink(false);
+  CHECK(runUntil(HOME_WIFI_FAILED, HOME_WIFI_JOIN_MS + 2000));
+  CHECK(farmWifiProfileValid(homeWifiProfile, HOME_SSID));
+  hostWifiSetLink(true);
+  uint32_t fast = hostWifi().fastBegins;
+  CHECK(runUntil(HOME_WIFI_CONNECTED, HOME_WIFI_RETRY_MS + 2000));
+  CHECK_EQ(hostWifi().fastBegins, fast + 1);
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FAST);
+}
+
+TEST(otherNetworkIgnoresProfile) {
+  resetHome();
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+
+  // Změna sítě ve formuláři /wifi: profil staré sítě se nepoužije
+  hostWifiSetNetwork("Skleník", "okurky", MOVED_BSSID, 1);
+  homeSsid = "Skleník";
+  homePass = "okurky";
+  uint32_t fast = hostWifi().fastBegins;
+  CHECK(homeWifiBegin(homeSsid, homePass));
+  CHECK_EQ(g_homeWifiMode, FARM_JOIN_FULL);
+  CHECK(runUntil(HOME_WIFI_CONNECTED, 30000));
+  CHECK_EQ(hostWifi().fastBegins, fast);
+  CHECK(farmWifiProfileValid(homeWifiProfile, "Skleník"));
+  CHECK(!farmWifiProfileValid(homeWifiProfile, HOME_SSID));
+}
+
+FARM_TEST_MAIN()
@@ -0,0 +1,214 @@
+// Příjem zpráv od uzlů na /ws (FarmHubWebSocket.h): zpráva rozdělená do
+// rámců a TCP paketů dá stejný výsledek i počet alokací jako jeden rámec,
+// fragmenty se skládají v bufferu klienta a sloty uzlů mají strop.
+// Shim drží rámce a odchozí zprávy v malloc bufferech, hostHeap() tak
+// počítá jen alokace hubu (new).
+
+#include "farm_test.h"
+#include <Arduino.h>
+#include <FS.h>
+#include <ESPAsyncWebServer.h>
+#include <FarmProto.h>
+#include "FarmHub.ino"
+
+static const uint32_t BOOT_ID = 0xB007;
+
+static bool g_booted = false;
+
+static void boot() {
+  if (g_booted) return;
+  g_booted = true;
+  setup();
+  for (int i = 0; i < 20; i++) loop();
+}
+
+static void drain(uint32_t id) {
+  std::string msg;
+  while (hostWsReceive(id, msg)) {}
+}
+
+// Binární uzel soilDHT (ohlášení s "proto")
+static uint32_t connectBinaryNode() {
+  uint32_t id = hostWsConnect();
+  if (!id) return 0;
+  char hello[96];
+  int  n = snprintf(hello, sizeof(hello),
+                    "{\"sensorID\":\"soilDHTsensor\",\"node\":%u,\"topics\":[],\"proto\":%u}",
+                    (unsigned)NODE_SOIL_DHT, (unsigned)FARM_PROTO_VERSION);
+  hostWsSend(id, WS_TEXT, hello, n);
+  drain(id);
+  return id;
+}
+
+static size_t readingsFrame(uint8_t *frame, size_t cap, uint16_t seq, uint8_t samples) {
+  FarmWriter w;
+  farmBegin(w, frame, cap, MSG_READINGS, NODE_SOIL_DHT, seq);
+  farmPutU32(w, BOOT_ID);
+  farmPutU8(w, samples);
+  for (uint8_t i = 0; i < samples; i++) {
+    FarmSample s;
+    s.ts     = hubNow() - (samples - i) * 10;
+    s.fields = (1 << FARM_FIELD_SOIL) | (1 << FARM_FIELD_TEMP) | (1 << FARM_FIELD_HUM);
+    s.values[FARM_FIELD_SOIL]  = 30.0f + seq + i * 0.5f;
+    s.values[FARM_FIELD_TEMP]  = 20.0f;
+    s.values[FARM_FIELD_HUM]   = 50.0f;
+    s.values[FARM_FIELD_LIGHT] = 0.0f;
+    farmPutSample(w, s);
+  }
+  return farmEnd(w);
+}
+
+// Potvrzení MSG_ACK od hubu, vrací potvrzené seq (-1 = žádné).
+// Seq v hlavičce patří prvnímu vzorku, hub potvrzuje poslední.
+static long receiveAck(uint32_t id) {
+  std::string msg;
+  uint8_t     opcode;
+  long        acked = -1;
+  while (hostWsReceive(id, msg, &opcode)) {
+    FarmHeader hdr;
+    FarmReader r;
+    if (opcode == WS_BINARY && farmParse((const uint8_t *)msg.data(), msg.size(), hdr, r) &&
+        hdr.type == MSG_ACK) {
+      acked = hdr.seq;
+    }
+  }
+  return acked;
+}
+
+struct IngestRun {
+  uint64_t allocs;
+  long     acked;
+};
+
+static const uint8_t BATCH = 8;
+
+static IngestRun sendBatch(uint32_t id, uint16_t seq, size_t fragment, size_t packet) {
+  uint8_t frame[FARM_MAX_FRAME];
+  size_t  len = readingsFrame(frame, sizeof(frame), seq, BATCH);
+  uint64_t before = hostHeap().allocs;
+  hostWsSend(id, WS_BINARY, frame, len, fragment, packet);
+  IngestRun run;
+  run.allocs = hostHeap().allocs - before;
+  run.acked  = receiveAck(id);
+  return run;
+}
+
+TEST(splitFramesAllocateLikeOneFrame) {
+  boot();
+  uint32_t id = connectBinaryNode();
+  CHECK(id != 0);
+
+  // Zahřátí: první zápis do logu otevírá segment
+  sendBatch(id, 1, 0, 0);
+
+  struct Split { size_t fragment, packet; };
+  const Split splits[] = { { 0, 0 }, { 0, 7 }, { 16, 0 }, { 16, 5 }, { 1, 1 } };
+  uint16_t seq = 1 + BATCH;
+  uint64_t whole = 0;
+  for (const Split &s : splits) {
+    IngestRun run = sendBatch(id, seq, s.fragment, s.packet);
+    printf("  fragment %3u packet %3u: allocs %llu, ack %ld\n", (unsigned)s.fragment,
+           (unsigned)s.packet, (unsigned long long)run.allocs, run.acked);
+    CHECK_EQ(run.acked, (long)(seq + BATCH - 1));
+    if (s.fragment == 0 && s.packet == 0) whole = run.allocs;
+    CHECK_EQ(run.allocs, whole);
+    seq += BATCH;
+  }
+  CHECK_EQ(whole, 0ull);
+
+  const SensorReading *latest = getLatestReading(SENSOR_SOIL_DHT);
+  CHECK(latest != nullptr);
+  if (latest) CHECK_EQ(latest->soilMoisture, 30.0f + (seq - BATCH) + (BATCH - 1) * 0.5f);
+  hostWsDisconnect(id);
+}
+
+TEST(fragmentedJsonIsReassembled) {
+  boot();
+  uint32_t id = hostWsConnect();
+  CHECK(id != 0);
+  drain(id);
+
+  const char *reading = "{\"sensorID\":\"soilDHTsensor\",\"soil\":12.5,\"temp\":19,\"hum\":61}";
+  CHECK(hostWsSend(id, WS_TEXT, reading, strlen(reading), 10, 3));
+  std::string reply;
+  CHECK(hostWsReceive(id, reply));
+  CHECK(reply == "{\"status\":\"OK\"}");
+
+  const SensorReading *latest = getLatestReading(SENSOR_SOIL_DHT);
+  if (latest) CHECK_EQ(latest->soilMoisture, 12.5f);
+  hostWsDisconnect(id);
+}
+
+TEST(oversizedMessageIsDropped) {
+  boot();
+  uint32_t id = hostWsConnect();
+  drain(id);
+  uint32_t errors = g_metrics.jsonErrors;
+
+  std::string big = "{\"sensorID\":\"soilDHTsensor\",\"pad\":\"";
+  big.append(WS_RX_BUFFER, 'x');
+  big += "\",\"soil\":1}";
+  CHECK(hostWsSend(id, WS_TEXT, big.data(), big.size(), 256));
+  std::string reply;
+  CHECK(!hostWsReceive(id, reply));
+  CHECK_EQ(g_metrics.jsonErrors, errors);
+
+  // Buffer klienta je po zahození zase volný
+  const char *reading = "{\"sensorID\":\"soilDHTsensor\",\"soil\":13.5}";
+  CHECK(hostWsSend(id, WS_TEXT, reading, strlen(reading), 8));
+  CHECK(hostWsReceive(id, reply));
+  CHECK(reply == "{\"status\":\"OK\"}");
+  hostWsDisconnect(id);
+}
+
+TEST(clientsOverPeerSlotsAreRejected) {
+  boot();
+  uint32_t ids[WS_MAX_PEERS];
+  for (uint8_t i = 0; i < WS_MAX_PEERS; i++) {
+    ids[i] = hostWsConnect();
+    CHECK(ids[i] != 0);
+  }
+  uint32_t rejected = g_metrics.wsRejected;
+  CHECK_EQ(hostWsConnect(), 0u);
+  CHECK_EQ(g_metrics.wsRejected, rejected + 1);
+  CHECK_EQ(g_metrics.wsClients, (uint32_t)WS_MAX_PEERS);
+
+  // Uvolněný slot dostane další uzel
+  hostWsDisconnect(ids[0]);
+  ids[0] = hostWsConnect();
+  CHECK(ids[0] != 0);
+  for (uint8_t i = 0; i < WS_MAX_PEERS; i++) hostWsDisconnect(ids[i]);
+  CHECK_EQ(g_metrics.wsClients, 0u);
+}
+
+// Nastavení světla po ohlášení dostane jen nově ohlášený uzel
+static uint32_t countText(uint32_t id, const char *needle) {
+  std::string msg;
+  uint32_t    n = 0;
+  while (hostWsReceive(id, msg)) n += msg.find(needle) != std::string::npos;
+  return n;
+}
+
+TEST(lightSettingsGoOnlyToIdentifyingNode) {
+  boot();
+  char hello[96];
+  int  len = snprintf(hello, sizeof(hello), "{\"sensorID\":\"x\",\"node\":%u}",
+                      (unsigned)NODE_LIGHT_MODULE);
+  uint32_t first = hostWsConnect();
+  hostWsSend(first, WS_TEXT, hello, len);
+  CHECK_EQ(countText(first, "LIGHT_SETTINGS"), 1u);
+
+  uint32_t second = hostWsConnect();
+  hostWsSend(second, WS_TEXT, hello, len);
+  CHECK_EQ(countText(second, "LIGHT_SETTINGS"), 1u);
+  CHECK_EQ(countText(first, "LIGHT_SETTINGS"), 0u);
+
+  // Změna nastavení jde dál všem odběratelům
+  broadcastLightSettings();
+  CHECK_EQ(countText(first, "LIGHT_SETTINGS"), 1u);
+  CHECK_EQ(countText(second, "LIGHT_SETTINGS"), 1u);
+  hostWsDisconnect(first);
+  hostWsDisconnect(second);
+}
+
+FARM_TEST_MAIN()